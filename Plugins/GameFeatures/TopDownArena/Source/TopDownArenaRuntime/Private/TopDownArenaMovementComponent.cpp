@@ -2,17 +2,176 @@
 
 #include "TopDownArenaMovementComponent.h"
 
+#include "AbilitySystemComponent.h"
 #include "AbilitySystemGlobals.h"
+#include "Character/LyraPawnExtensionComponent.h"
+#include "Containers/Ticker.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameplayEffect.h"
+#include "HAL/IConsoleManager.h"
+#include "LyraLogChannels.h"
+#include "Player/LyraPlayerController.h"
 #include "TopDownArenaAttributeSet.h"
+#include "UObject/Package.h"
+#include "UObject/StrongObjectPtr.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(TopDownArenaMovementComponent)
 
+#if !UE_BUILD_SHIPPING
+namespace TopDownArenaMovement
+{
+	static bool bCheckMovementSpeedCache = false;
+	static FAutoConsoleVariableRef CVarCheckMovementSpeedCache(
+		TEXT("TopDownArena.CheckMovementSpeedCache"),
+		bCheckMovementSpeedCache,
+		TEXT("When true, every GetMaxSpeed call (including moves replayed during a client correction) compares the cached max speed against the ability system and logs mismatches"),
+		ECVF_Cheat);
+
+	static void CheckCachedMaxSpeed(const UTopDownArenaMovementComponent& MovementComponent, float CachedMaxSpeed)
+	{
+		const float UncachedMaxSpeed = MovementComponent.GetMaxSpeedUncached();
+		if (!FMath::IsNearlyEqual(CachedMaxSpeed, UncachedMaxSpeed))
+		{
+			const ACharacter* Character = MovementComponent.GetCharacterOwner();
+			UE_LOG(LogLyra, Error, TEXT("%s (%s%s): cached max speed %.2f != ability system %.2f"),
+				*GetNameSafe(Character),
+				Character ? *UEnum::GetValueAsString(Character->GetLocalRole()) : TEXT("no character"),
+				(Character && Character->bClientUpdating) ? TEXT(", replaying moves") : TEXT(""),
+				CachedMaxSpeed, UncachedMaxSpeed);
+		}
+	}
+}
+#endif // !UE_BUILD_SHIPPING
+
 UTopDownArenaMovementComponent::UTopDownArenaMovementComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
 }
 
+void UTopDownArenaMovementComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (ULyraPawnExtensionComponent* PawnExtComponent = ULyraPawnExtensionComponent::FindPawnExtensionComponent(GetOwner()))
+	{
+		PawnExtComponent->OnAbilitySystemInitialized_RegisterAndCall(FSimpleMulticastDelegate::FDelegate::CreateUObject(this, &ThisClass::OnAbilitySystemInitialized));
+		PawnExtComponent->OnAbilitySystemUninitialized_Register(FSimpleMulticastDelegate::FDelegate::CreateUObject(this, &ThisClass::OnAbilitySystemUninitialized));
+	}
+}
+
+void UTopDownArenaMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	OnAbilitySystemUninitialized();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UTopDownArenaMovementComponent::OnAbilitySystemInitialized()
+{
+	UAbilitySystemComponent* ASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(GetOwner());
+	if (ASC == AbilitySystemComponent.Get())
+	{
+		return;
+	}
+
+	OnAbilitySystemUninitialized();
+
+	if (ASC == nullptr)
+	{
+		return;
+	}
+
+	AbilitySystemComponent = ASC;
+	bHasAbilitySystem = true;
+
+	MovementSpeedChangedHandle = ASC->GetGameplayAttributeValueChangeDelegate(UTopDownArenaAttributeSet::GetMovementSpeedAttribute()).AddUObject(this, &ThisClass::HandleMovementSpeedChanged);
+	MovementStoppedTagChangedHandle = ASC->RegisterGameplayTagEvent(TAG_Gameplay_MovementStopped, EGameplayTagEventType::NewOrRemoved).AddUObject(this, &ThisClass::HandleMovementStoppedTagChanged);
+
+	bMovementStopped = ASC->HasMatchingGameplayTag(TAG_Gameplay_MovementStopped);
+	RefreshCachedMovementSpeed();
+}
+
+void UTopDownArenaMovementComponent::OnAbilitySystemUninitialized()
+{
+	if (UAbilitySystemComponent* ASC = AbilitySystemComponent.Get())
+	{
+		ASC->GetGameplayAttributeValueChangeDelegate(UTopDownArenaAttributeSet::GetMovementSpeedAttribute()).Remove(MovementSpeedChangedHandle);
+		ASC->RegisterGameplayTagEvent(TAG_Gameplay_MovementStopped, EGameplayTagEventType::NewOrRemoved).Remove(MovementStoppedTagChangedHandle);
+	}
+
+	MovementSpeedChangedHandle.Reset();
+	MovementStoppedTagChangedHandle.Reset();
+
+	AbilitySystemComponent.Reset();
+	bHasAbilitySystem = false;
+	bMovementStopped = false;
+	bMovementSpeedAttributePending = false;
+	CachedMovementSpeed = 0.0f;
+}
+
+void UTopDownArenaMovementComponent::HandleMovementSpeedChanged(const FOnAttributeChangeData& ChangeData)
+{
+	CachedMovementSpeed = ChangeData.NewValue;
+	bMovementSpeedAttributePending = false;
+}
+
+void UTopDownArenaMovementComponent::HandleMovementStoppedTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	bMovementStopped = (NewCount > 0);
+}
+
+void UTopDownArenaMovementComponent::RefreshCachedMovementSpeed() const
+{
+	if (UAbilitySystemComponent* ASC = AbilitySystemComponent.Get())
+	{
+		const FGameplayAttribute MovementSpeedAttribute = UTopDownArenaAttributeSet::GetMovementSpeedAttribute();
+		bMovementSpeedAttributePending = !ASC->HasAttributeSetForAttribute(MovementSpeedAttribute);
+		CachedMovementSpeed = bMovementSpeedAttributePending ? 0.0f : ASC->GetNumericAttribute(MovementSpeedAttribute);
+	}
+}
+
 float UTopDownArenaMovementComponent::GetMaxSpeed() const
+{
+	const float MaxSpeed = GetCachedMaxSpeed();
+
+#if !UE_BUILD_SHIPPING
+	if (TopDownArenaMovement::bCheckMovementSpeedCache)
+	{
+		TopDownArenaMovement::CheckCachedMaxSpeed(*this, MaxSpeed);
+	}
+#endif
+
+	return MaxSpeed;
+}
+
+float UTopDownArenaMovementComponent::GetCachedMaxSpeed() const
+{
+	// Called many times per tick (including while replaying moves), so everything here is read from the cache
+	if (bHasAbilitySystem && (MovementMode == MOVE_Walking))
+	{
+		if (bMovementStopped)
+		{
+			return 0;
+		}
+
+		if (bMovementSpeedAttributePending)
+		{
+			RefreshCachedMovementSpeed();
+		}
+
+		if (CachedMovementSpeed > 0.0f)
+		{
+			return CachedMovementSpeed;
+		}
+	}
+
+	return Super::GetMaxSpeed();
+}
+
+float UTopDownArenaMovementComponent::GetMaxSpeedUncached() const
 {
 	if (UAbilitySystemComponent* ASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(GetOwner()))
 	{
@@ -33,3 +192,253 @@ float UTopDownArenaMovementComponent::GetMaxSpeed() const
 
 	return Super::GetMaxSpeed();
 }
+
+//////////////////////////////////////////////////////////////////////
+
+#if !UE_BUILD_SHIPPING
+namespace TopDownArenaMovement
+{
+	// Makes a transient infinite effect that scales movement speed (stands in for a buff/debuff pickup)
+	static UGameplayEffect* MakeSpeedModifierEffect(float Multiplier)
+	{
+		UGameplayEffect* Effect = NewObject<UGameplayEffect>(GetTransientPackage(), NAME_None, RF_Transient);
+		Effect->DurationPolicy = EGameplayEffectDurationType::Infinite;
+
+		FGameplayModifierInfo& Modifier = Effect->Modifiers.AddDefaulted_GetRef();
+		Modifier.Attribute = UTopDownArenaAttributeSet::GetMovementSpeedAttribute();
+		Modifier.ModifierOp = EGameplayModOp::Multiplicitive;
+		Modifier.ModifierMagnitude = FGameplayEffectModifierMagnitude(FScalableFloat(Multiplier));
+
+		return Effect;
+	}
+
+	// Changes one pawn's movement speed in every way gameplay does, one random change at a time, and can put it all back
+	struct FMovementSpeedChanger
+	{
+		FMovementSpeedChanger(UTopDownArenaMovementComponent* InMovementComponent, UAbilitySystemComponent* InASC, int32 Seed)
+			: MovementComponent(InMovementComponent)
+			, AbilitySystemComponent(InASC)
+			, Random(Seed)
+		{
+			OriginalBaseSpeed = InASC->GetNumericAttributeBase(UTopDownArenaAttributeSet::GetMovementSpeedAttribute());
+		}
+
+		void ApplyRandomChange()
+		{
+			UAbilitySystemComponent* ASC = AbilitySystemComponent.Get();
+			if (ASC == nullptr)
+			{
+				return;
+			}
+
+			switch (Random.RandHelper(5))
+			{
+			case 0:
+				ASC->SetNumericAttributeBase(UTopDownArenaAttributeSet::GetMovementSpeedAttribute(), Random.FRandRange(100.0f, 900.0f));
+				break;
+			case 1:
+				ActiveEffects.Add(ASC->ApplyGameplayEffectToSelf(GetSpeedModifierEffect(Buff, 1.5f), 1.0f, ASC->MakeEffectContext()));
+				break;
+			case 2:
+				ActiveEffects.Add(ASC->ApplyGameplayEffectToSelf(GetSpeedModifierEffect(Debuff, 0.5f), 1.0f, ASC->MakeEffectContext()));
+				break;
+			case 3:
+				if (ActiveEffects.Num() > 0)
+				{
+					ASC->RemoveActiveGameplayEffect(ActiveEffects.Pop());
+				}
+				break;
+			default:
+				if ((NumLooseStopTags > 0) && Random.FRand() < 0.5f)
+				{
+					ASC->RemoveLooseGameplayTag(TAG_Gameplay_MovementStopped);
+					--NumLooseStopTags;
+				}
+				else
+				{
+					ASC->AddLooseGameplayTag(TAG_Gameplay_MovementStopped);
+					++NumLooseStopTags;
+				}
+				break;
+			}
+		}
+
+		// Returns false (and logs) if the cache disagrees with the ability system
+		bool Verify(int32 ChangeIdx) const
+		{
+			const UTopDownArenaMovementComponent* MoveComp = MovementComponent.Get();
+			if (MoveComp == nullptr)
+			{
+				return true;
+			}
+
+			const float Cached = MoveComp->GetMaxSpeed();
+			const float Uncached = MoveComp->GetMaxSpeedUncached();
+			if (!FMath::IsNearlyEqual(Cached, Uncached))
+			{
+				UE_LOG(LogLyra, Error, TEXT("  %s change %d: cached max speed %.2f != ability system %.2f"), *GetNameSafe(MoveComp->GetOwner()), ChangeIdx, Cached, Uncached);
+				return false;
+			}
+
+			return true;
+		}
+
+		void Restore()
+		{
+			if (UAbilitySystemComponent* ASC = AbilitySystemComponent.Get())
+			{
+				for (const FActiveGameplayEffectHandle& Handle : ActiveEffects)
+				{
+					ASC->RemoveActiveGameplayEffect(Handle);
+				}
+				ASC->RemoveLooseGameplayTag(TAG_Gameplay_MovementStopped, NumLooseStopTags);
+				ASC->SetNumericAttributeBase(UTopDownArenaAttributeSet::GetMovementSpeedAttribute(), OriginalBaseSpeed);
+			}
+
+			ActiveEffects.Reset();
+			NumLooseStopTags = 0;
+		}
+
+	private:
+		static UGameplayEffect* GetSpeedModifierEffect(TStrongObjectPtr<UGameplayEffect>& Effect, float Multiplier)
+		{
+			if (!Effect.IsValid())
+			{
+				Effect.Reset(MakeSpeedModifierEffect(Multiplier));
+			}
+			return Effect.Get();
+		}
+
+		TWeakObjectPtr<UTopDownArenaMovementComponent> MovementComponent;
+		TWeakObjectPtr<UAbilitySystemComponent> AbilitySystemComponent;
+		TStrongObjectPtr<UGameplayEffect> Buff;
+		TStrongObjectPtr<UGameplayEffect> Debuff;
+		TArray<FActiveGameplayEffectHandle> ActiveEffects;
+		FRandomStream Random;
+		float OriginalBaseSpeed = 0.0f;
+		int32 NumLooseStopTags = 0;
+	};
+
+	// Every player pawn in the world whose ability system we have authority over
+	static TArray<TSharedRef<FMovementSpeedChanger>> MakeChangersForAuthoritativePawns(UWorld* World, int32 Seed)
+	{
+		TArray<TSharedRef<FMovementSpeedChanger>> Changers;
+		for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+		{
+			APawn* Pawn = It->IsValid() ? (*It)->GetPawn() : nullptr;
+			UTopDownArenaMovementComponent* MovementComponent = Pawn ? Pawn->FindComponentByClass<UTopDownArenaMovementComponent>() : nullptr;
+			UAbilitySystemComponent* ASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Pawn);
+			if (MovementComponent && ASC && ASC->IsOwnerActorAuthoritative())
+			{
+				Changers.Add(MakeShared<FMovementSpeedChanger>(MovementComponent, ASC, Seed + Changers.Num()));
+			}
+		}
+		return Changers;
+	}
+
+	// Applies one change per frame to every player's pawn, so each change replicates (and is predicted against) on its own.
+	// The server checks its copy after each change, autonomous proxies check theirs through TopDownArena.CheckMovementSpeedCache.
+	static void RunPacedVerification(UWorld* World, int32 NumChanges)
+	{
+		TArray<TSharedRef<FMovementSpeedChanger>> Changers = MakeChangersForAuthoritativePawns(World, NumChanges);
+		if (Changers.Num() == 0)
+		{
+			UE_LOG(LogLyra, Warning, TEXT("TopDownArena.VerifyMovementSpeedCache: no top-down arena pawns with an authoritative ability system"));
+			return;
+		}
+
+		int32 ChangeIdx = 0;
+		int32 NumMismatches = 0;
+		FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(World, [Changers, NumChanges, ChangeIdx, NumMismatches](float DeltaTime) mutable
+		{
+			if (ChangeIdx < NumChanges)
+			{
+				for (const TSharedRef<FMovementSpeedChanger>& Changer : Changers)
+				{
+					Changer->ApplyRandomChange();
+					NumMismatches += Changer->Verify(ChangeIdx) ? 0 : 1;
+				}
+				++ChangeIdx;
+				return true;
+			}
+
+			for (const TSharedRef<FMovementSpeedChanger>& Changer : Changers)
+			{
+				Changer->Restore();
+			}
+
+			UE_LOG(LogLyra, Display, TEXT("TopDownArena.VerifyMovementSpeedCache: %d changes per frame on %d pawn(s), %d mismatches on the server"),
+				NumChanges, Changers.Num(), NumMismatches);
+			return false;
+		}));
+	}
+
+	static void VerifyMovementSpeedCache(const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 NumChanges = (Args.Num() > 0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 500;
+		const bool bPaced = (Args.Num() > 1) && (Args[1] == TEXT("Paced"));
+
+		if (World == nullptr)
+		{
+			return;
+		}
+
+		APlayerController* PC = World->GetFirstPlayerController();
+		APawn* Pawn = PC ? PC->GetPawn() : nullptr;
+		UTopDownArenaMovementComponent* MovementComponent = Pawn ? Pawn->FindComponentByClass<UTopDownArenaMovementComponent>() : nullptr;
+		UAbilitySystemComponent* ASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Pawn);
+
+		// On a client the pawn is an autonomous proxy: the server drives the changes and we check every GetMaxSpeed call here,
+		// which covers predicted changes, rollbacks, replicated updates and moves replayed during corrections
+		if (MovementComponent && ASC && !ASC->IsOwnerActorAuthoritative())
+		{
+			ALyraPlayerController* LyraPC = Cast<ALyraPlayerController>(PC);
+			if (LyraPC == nullptr)
+			{
+				return;
+			}
+
+			bCheckMovementSpeedCache = true;
+			LyraPC->ServerCheat(FString::Printf(TEXT("TopDownArena.VerifyMovementSpeedCache %d Paced"), NumChanges));
+			UE_LOG(LogLyra, Display, TEXT("TopDownArena.VerifyMovementSpeedCache: asked the server for %d paced changes (needs cheats on the server). TopDownArena.CheckMovementSpeedCache is now on, mismatches on this client are logged as errors"),
+				NumChanges);
+			return;
+		}
+
+		if (bPaced)
+		{
+			RunPacedVerification(World, NumChanges);
+			return;
+		}
+
+		if ((MovementComponent == nullptr) || (ASC == nullptr))
+		{
+			UE_LOG(LogLyra, Warning, TEXT("TopDownArena.VerifyMovementSpeedCache needs a local top-down arena pawn"));
+			return;
+		}
+
+		// Change the speed in every way gameplay does, one change at a time, and compare against the uncached path after each
+		FMovementSpeedChanger Changer(MovementComponent, ASC, NumChanges);
+		int32 NumMismatches = 0;
+		for (int32 ChangeIdx = 0; ChangeIdx < NumChanges; ++ChangeIdx)
+		{
+			Changer.ApplyRandomChange();
+			NumMismatches += Changer.Verify(ChangeIdx) ? 0 : 1;
+		}
+
+		// Put everything back the way it was
+		Changer.Restore();
+
+		const bool bRestored = FMath::IsNearlyEqual(MovementComponent->GetMaxSpeed(), MovementComponent->GetMaxSpeedUncached());
+		UE_LOG(LogLyra, Display, TEXT("TopDownArena.VerifyMovementSpeedCache: %d changes, %d mismatches%s"),
+			NumChanges, NumMismatches, bRestored ? TEXT("") : TEXT(" (and still mismatched after restoring)"));
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs TopDownArenaVerifyMovementSpeedCacheCmd(
+	TEXT("TopDownArena.VerifyMovementSpeedCache"),
+	TEXT("Rapidly applies base speed changes, speed buffs/debuffs and movement stopped tags and checks the cached max speed against the ability system after each. ")
+	TEXT("With authority over the local pawn the changes are applied and checked immediately. On a client the server applies them one per frame to every player's pawn (Paced) and this client checks every GetMaxSpeed call. ")
+	TEXT("Usage: TopDownArena.VerifyMovementSpeedCache [NumChanges=500] [Paced]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&TopDownArenaMovement::VerifyMovementSpeedCache));
+#endif // !UE_BUILD_SHIPPING
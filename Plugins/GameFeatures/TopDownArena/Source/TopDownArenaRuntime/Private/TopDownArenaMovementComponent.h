@@ -6,7 +6,10 @@
 
 #include "TopDownArenaMovementComponent.generated.h"
 
+class UAbilitySystemComponent;
 class UObject;
+struct FGameplayTag;
+struct FOnAttributeChangeData;
 
 UCLASS()
 class UTopDownArenaMovementComponent : public ULyraCharacterMovementComponent
@@ -21,4 +24,43 @@ public:
 	virtual float GetMaxSpeed() const override;
 	//~End of UMovementComponent interface
 
+	// Resolves the max speed straight from the ability system, the way GetMaxSpeed did before it was cached (used to verify the cache)
+	float GetMaxSpeedUncached() const;
+
+protected:
+	//~UActorComponent interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	//~End of UActorComponent interface
+
+private:
+	void OnAbilitySystemInitialized();
+	void OnAbilitySystemUninitialized();
+
+	void HandleMovementSpeedChanged(const FOnAttributeChangeData& ChangeData);
+	void HandleMovementStoppedTagChanged(const FGameplayTag Tag, int32 NewCount);
+
+	// Reads the movement speed attribute into the cache
+	void RefreshCachedMovementSpeed() const;
+
+	// GetMaxSpeed without the optional verification against the ability system
+	float GetCachedMaxSpeed() const;
+
+private:
+	// The ability system we're listening to (the pawn's avatar ASC, usually on the player state)
+	TWeakObjectPtr<UAbilitySystemComponent> AbilitySystemComponent;
+
+	FDelegateHandle MovementSpeedChangedHandle;
+	FDelegateHandle MovementStoppedTagChangedHandle;
+
+	// MovementSpeed attribute, kept up to date by the attribute change delegate (predicted changes, rollbacks and replication all go through it)
+	mutable float CachedMovementSpeed = 0.0f;
+
+	// The attribute set can be granted after the ability system is initialized, and granting it doesn't fire the change delegate
+	mutable bool bMovementSpeedAttributePending = false;
+
+	// Whether the owner has TAG_Gameplay_MovementStopped, kept up to date by the tag event
+	bool bMovementStopped = false;
+
+	bool bHasAbilitySystem = false;
 };
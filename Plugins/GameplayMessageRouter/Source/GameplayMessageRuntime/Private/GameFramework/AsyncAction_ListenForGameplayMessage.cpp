@@ -46,7 +46,8 @@ void UAsyncAction_ListenForGameplayMessage::Activate()
 					}
 				},
 				MessageStructType.Get(),
-				MessageMatchType);
+				MessageMatchType,
+				EGameplayMessageDelivery::ChannelDefault);
 
 			return;
 		}
@@ -3,7 +3,12 @@
 #include "GameFramework/GameplayMessageSubsystem.h"
 #include "Engine/Engine.h"
 #include "Engine/GameInstance.h"
+#include "Engine/Level.h"
 #include "Engine/World.h"
+#include "GameplayTagsManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "UObject/Package.h"
 #include "UObject/ScriptMacros.h"
 #include "UObject/Stack.h"
 
@@ -19,6 +24,12 @@ namespace UE
 		static FAutoConsoleVariableRef CVarShouldLogMessages(TEXT("GameplayMessageSubsystem.LogMessages"),
 			ShouldLogMessages,
 			TEXT("Should messages broadcast through the gameplay message subsystem be logged?"));
+
+		// Listeners can queue more messages while a flush delivers; those are delivered by the same flush, up to this many rounds
+		static int32 MaxFlushPasses = 4;
+		static FAutoConsoleVariableRef CVarMaxFlushPasses(TEXT("GameplayMessageSubsystem.MaxFlushPasses"),
+			MaxFlushPasses,
+			TEXT("How many rounds of messages queued by deferred listeners are delivered in the same flush before the rest are left for the next frame"));
 	}
 }
 
@@ -36,6 +47,27 @@ void FGameplayMessageListenerHandle::Unregister()
 	}
 }
 
+//////////////////////////////////////////////////////////////////////
+// FGameplayMessageQueueTickFunction
+
+void FGameplayMessageQueueTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target)
+	{
+		Target->FlushQueuedMessages();
+	}
+}
+
+FString FGameplayMessageQueueTickFunction::DiagnosticMessage()
+{
+	return TEXT("FGameplayMessageQueueTickFunction");
+}
+
+FName FGameplayMessageQueueTickFunction::DiagnosticContext(bool bDetailed)
+{
+	return FName(TEXT("GameplayMessageQueue"));
+}
+
 //////////////////////////////////////////////////////////////////////
 // UGameplayMessageSubsystem
 
@@ -55,14 +87,37 @@ bool UGameplayMessageSubsystem::HasInstance(const UObject* WorldContextObject)
 	return Router != nullptr;
 }
 
+void UGameplayMessageSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	for (const FGameplayMessageChannelQueueMode& ChannelQueueMode : DefaultChannelQueueModes)
+	{
+		if (ChannelQueueMode.Channel.IsValid())
+		{
+			SetChannelQueueMode(ChannelQueueMode.Channel, ChannelQueueMode.QueueMode);
+		}
+	}
+}
+
 void UGameplayMessageSubsystem::Deinitialize()
 {
+	DiscardQueuedMessages();
+
+	if (QueueTickFunction.IsTickFunctionRegistered())
+	{
+		QueueTickFunction.UnRegisterTickFunction();
+	}
+	QueueTickFunction.Target = nullptr;
+
 	ListenerMap.Reset();
+	DispatchCache.Reset();
+	++ListenerGeneration;
 
 	Super::Deinitialize();
 }
 
-void UGameplayMessageSubsystem::BroadcastMessageInternal(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes)
+void UGameplayMessageSubsystem::BroadcastMessageInternal(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes, const UObject* CoalesceKey)
 {
 	// Log the message if enabled
 	if (UE::GameplayMessageSubsystem::ShouldLogMessages != 0)
@@ -82,43 +137,252 @@ void UGameplayMessageSubsystem::BroadcastMessageInternal(FGameplayTag Channel, c
 	}
 
 	// Broadcast the message
+	// Hold a reference to the dispatch list rather than copying it, in case there are registrations or removals while handling callbacks
+	const TSharedRef<const FChannelDispatchList> DispatchList = GetDispatchList(Channel);
+	DispatchToListeners(Channel, StructType, MessageBytes, DispatchList->Entries);
+
+	if (DispatchList->DeferredEntries.Num() > 0)
+	{
+		QueueMessage(Channel, StructType, MessageBytes, CoalesceKey, DispatchList);
+	}
+}
+
+void UGameplayMessageSubsystem::DispatchToListeners(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes, TConstArrayView<FChannelDispatchEntry> Entries)
+{
+	for (const FChannelDispatchEntry& Entry : Entries)
+	{
+		const FGameplayMessageListenerData& Listener = *Entry.Listener;
+		if (Listener.bUnregistered)
+		{
+			continue;
+		}
+
+		if (Listener.bHadValidType && !Listener.ListenerStructType.IsValid())
+		{
+			UE_LOG(LogGameplayMessageSubsystem, Warning, TEXT("Listener struct type has gone invalid on Channel %s. Removing listener from list"), *Channel.ToString());
+			UnregisterListenerInternal(Entry.ListenerChannel, Listener.HandleID);
+			continue;
+		}
+
+		// The receiving type must be either a parent of the sending type or completely ambiguous (for internal use)
+		if (!Listener.bHadValidType || StructType->IsChildOf(Listener.ListenerStructType.Get()))
+		{
+			Listener.ReceivedCallback(Channel, StructType, MessageBytes);
+		}
+		else
+		{
+			UE_LOG(LogGameplayMessageSubsystem, Error, TEXT("Struct type mismatch on channel %s (broadcast type %s, listener at %s was expecting type %s)"),
+				*Channel.ToString(),
+				*StructType->GetPathName(),
+				*Entry.ListenerChannel.ToString(),
+				*Listener.ListenerStructType->GetPathName());
+		}
+	}
+}
+
+TSharedRef<const UGameplayMessageSubsystem::FChannelDispatchList> UGameplayMessageSubsystem::GetDispatchList(FGameplayTag Channel)
+{
+	if (const TSharedRef<const FChannelDispatchList>* pCachedList = DispatchCache.Find(Channel))
+	{
+		if ((*pCachedList)->ListenerGeneration == ListenerGeneration)
+		{
+			return *pCachedList;
+		}
+	}
+
+	// Walk the channel hierarchy once and remember every listener that matches
+	TSharedRef<FChannelDispatchList> NewList = MakeShared<FChannelDispatchList>();
+	NewList->ListenerGeneration = ListenerGeneration;
+
+	// The closest configured channel decides the queue mode
+	for (FGameplayTag Tag = Channel; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	{
+		if (const EGameplayMessageQueueMode* pQueueMode = ChannelQueueModes.Find(Tag))
+		{
+			NewList->QueueMode = *pQueueMode;
+			break;
+		}
+	}
+
 	bool bOnInitialTag = true;
 	for (FGameplayTag Tag = Channel; Tag.IsValid(); Tag = Tag.RequestDirectParent())
 	{
 		if (const FChannelListenerList* pList = ListenerMap.Find(Tag))
 		{
-			// Copy in case there are removals while handling callbacks
-			TArray<FGameplayMessageListenerData> ListenerArray(pList->Listeners);
-
-			for (const FGameplayMessageListenerData& Listener : ListenerArray)
+			for (const TSharedRef<FGameplayMessageListenerData>& Listener : pList->Listeners)
 			{
-				if (bOnInitialTag || (Listener.MatchType == EGameplayMessageMatch::PartialMatch))
+				if (bOnInitialTag || (Listener->MatchType == EGameplayMessageMatch::PartialMatch))
 				{
-					if (Listener.bHadValidType && !Listener.ListenerStructType.IsValid())
-					{
-						UE_LOG(LogGameplayMessageSubsystem, Warning, TEXT("Listener struct type has gone invalid on Channel %s. Removing listener from list"), *Channel.ToString());
-						UnregisterListenerInternal(Channel, Listener.HandleID);
-						continue;
-					}
+					const bool bDeferred = (Listener->Delivery == EGameplayMessageDelivery::Deferred) ||
+						((Listener->Delivery == EGameplayMessageDelivery::ChannelDefault) && (NewList->QueueMode != EGameplayMessageQueueMode::Immediate));
 
-					// The receiving type must be either a parent of the sending type or completely ambiguous (for internal use)
-					if (!Listener.bHadValidType || StructType->IsChildOf(Listener.ListenerStructType.Get()))
-					{
-						Listener.ReceivedCallback(Channel, StructType, MessageBytes);
-					}
-					else
-					{
-						UE_LOG(LogGameplayMessageSubsystem, Error, TEXT("Struct type mismatch on channel %s (broadcast type %s, listener at %s was expecting type %s)"),
-							*Channel.ToString(),
-							*StructType->GetPathName(),
-							*Tag.ToString(),
-							*Listener.ListenerStructType->GetPathName());
-					}
+					(bDeferred ? NewList->DeferredEntries : NewList->Entries).Add(FChannelDispatchEntry{ Listener, Tag });
 				}
 			}
 		}
 		bOnInitialTag = false;
 	}
+
+	DispatchCache.Add(Channel, NewList);
+
+	return NewList;
+}
+
+void UGameplayMessageSubsystem::QueueMessage(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes, const UObject* CoalesceKey, const TSharedRef<const FChannelDispatchList>& DispatchList)
+{
+	// Nowhere to flush (e.g., no world yet), so deliver right away rather than holding the message indefinitely
+	if (!RegisterQueueTickFunction())
+	{
+		DispatchToListeners(Channel, StructType, MessageBytes, DispatchList->DeferredEntries);
+		return;
+	}
+
+	// Replace the pending message from the same sender in place, it keeps its original spot in the queue
+	if (DispatchList->QueueMode == EGameplayMessageQueueMode::QueuedCoalesced)
+	{
+		int32& QueuedIndex = CoalescedMessageIndices.FindOrAdd(TPair<FGameplayTag, FObjectKey>(Channel, FObjectKey(CoalesceKey)), INDEX_NONE);
+		if (QueuedMessages.IsValidIndex(QueuedIndex))
+		{
+			FQueuedMessage& PendingMessage = QueuedMessages[QueuedIndex];
+			if (PendingMessage.StructType == StructType)
+			{
+				StructType->CopyScriptStruct(PendingMessage.MessageBytes, MessageBytes);
+			}
+			else
+			{
+				PendingMessage.StructType->DestroyStruct(PendingMessage.MessageBytes);
+				PendingMessage.StructType = StructType;
+				PendingMessage.MessageBytes = QueuedMessageMemory.PushBytes(StructType->GetStructureSize(), StructType->GetMinAlignment());
+				StructType->InitializeStruct(PendingMessage.MessageBytes);
+				StructType->CopyScriptStruct(PendingMessage.MessageBytes, MessageBytes);
+			}
+			PendingMessage.DispatchList = DispatchList;
+			return;
+		}
+
+		QueuedIndex = QueuedMessages.Num();
+	}
+
+	FQueuedMessage& QueuedMessage = QueuedMessages.AddDefaulted_GetRef();
+	QueuedMessage.Channel = Channel;
+	QueuedMessage.StructType = StructType;
+	QueuedMessage.MessageBytes = QueuedMessageMemory.PushBytes(StructType->GetStructureSize(), StructType->GetMinAlignment());
+	QueuedMessage.DispatchList = DispatchList;
+
+	StructType->InitializeStruct(QueuedMessage.MessageBytes);
+	StructType->CopyScriptStruct(QueuedMessage.MessageBytes, MessageBytes);
+
+	QueueTickFunction.SetTickFunctionEnable(true);
+}
+
+void UGameplayMessageSubsystem::FlushQueuedMessages()
+{
+	if (bFlushingQueuedMessages)
+	{
+		return;
+	}
+	TGuardValue<bool> FlushGuard(bFlushingQueuedMessages, true);
+
+	for (int32 Pass = 0; (Pass < UE::GameplayMessageSubsystem::MaxFlushPasses) && (QueuedMessages.Num() > 0); ++Pass)
+	{
+		// Messages queued by deferred listeners go into the (now empty) queue and are picked up by the next pass
+		Swap(QueuedMessages, DeliveringMessages);
+		CoalescedMessageIndices.Reset();
+
+		for (FQueuedMessage& Message : DeliveringMessages)
+		{
+			DispatchToListeners(Message.Channel, Message.StructType, Message.MessageBytes, Message.DispatchList->DeferredEntries);
+			Message.StructType->DestroyStruct(Message.MessageBytes);
+
+			// Delivered, no longer reported to the garbage collector
+			Message.StructType = nullptr;
+		}
+		DeliveringMessages.Reset();
+	}
+
+	if (QueuedMessages.Num() == 0)
+	{
+		QueuedMessageMemory.Flush();
+		QueueTickFunction.SetTickFunctionEnable(false);
+	}
+	else
+	{
+		// The payloads stay in the frame buffer until a flush empties the queue
+		UE_LOG(LogGameplayMessageSubsystem, Warning, TEXT("Deferred listeners kept queueing messages for %d rounds, %d messages left for the next flush"), UE::GameplayMessageSubsystem::MaxFlushPasses, QueuedMessages.Num());
+	}
+}
+
+bool UGameplayMessageSubsystem::RegisterQueueTickFunction()
+{
+	// Not GetGameInstance(), routers made outside a game instance (e.g., the broadcast benchmark) deliver immediately
+	UGameInstance* GameInstance = Cast<UGameInstance>(GetOuter());
+	UWorld* World = GameInstance ? GameInstance->GetWorld() : nullptr;
+	if ((World == nullptr) || (World->PersistentLevel == nullptr))
+	{
+		return false;
+	}
+
+	if ((QueueTickWorld.Get() != World) || !QueueTickFunction.IsTickFunctionRegistered())
+	{
+		if (QueueTickFunction.IsTickFunctionRegistered())
+		{
+			QueueTickFunction.UnRegisterTickFunction();
+		}
+
+		// After all gameplay ticking, before the frame is rendered and the UI is painted
+		QueueTickFunction.Target = this;
+		QueueTickFunction.TickGroup = TG_PostUpdateWork;
+		QueueTickFunction.bCanEverTick = true;
+		QueueTickFunction.bTickEvenWhenPaused = true;
+		QueueTickFunction.bStartWithTickEnabled = false;
+		QueueTickFunction.RegisterTickFunction(World->PersistentLevel);
+
+		QueueTickWorld = World;
+	}
+
+	return true;
+}
+
+void UGameplayMessageSubsystem::DiscardQueuedMessages()
+{
+	for (FQueuedMessage& Message : QueuedMessages)
+	{
+		Message.StructType->DestroyStruct(Message.MessageBytes);
+	}
+	QueuedMessages.Reset();
+	CoalescedMessageIndices.Reset();
+
+	QueuedMessageMemory.Flush();
+}
+
+void UGameplayMessageSubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	Super::AddReferencedObjects(InThis, Collector);
+
+	// Queued payloads are copied into QueuedMessageMemory, so object references in them (and their struct types) aren't seen otherwise
+	UGameplayMessageSubsystem* This = CastChecked<UGameplayMessageSubsystem>(InThis);
+	for (TArray<FQueuedMessage>* Messages : { &This->QueuedMessages, &This->DeliveringMessages })
+	{
+		for (FQueuedMessage& Message : *Messages)
+		{
+			if (Message.StructType != nullptr)
+			{
+				Collector.AddReferencedObjects(Message.StructType, Message.MessageBytes, This);
+			}
+		}
+	}
+}
+
+void UGameplayMessageSubsystem::SetChannelQueueMode(FGameplayTag Channel, EGameplayMessageQueueMode Mode)
+{
+	const EGameplayMessageQueueMode* pExistingMode = ChannelQueueModes.Find(Channel);
+	if ((pExistingMode == nullptr) || (*pExistingMode != Mode))
+	{
+		ChannelQueueModes.Add(Channel, Mode);
+
+		// Listeners have to be split again between immediate and deferred
+		++ListenerGeneration;
+	}
 }
 
 void UGameplayMessageSubsystem::K2_BroadcastMessage(FGameplayTag Channel, const int32& Message)
@@ -144,16 +408,19 @@ DEFINE_FUNCTION(UGameplayMessageSubsystem::execK2_BroadcastMessage)
 	}
 }
 
-FGameplayMessageListenerHandle UGameplayMessageSubsystem::RegisterListenerInternal(FGameplayTag Channel, TFunction<void(FGameplayTag, const UScriptStruct*, const void*)>&& Callback, const UScriptStruct* StructType, EGameplayMessageMatch MatchType)
+FGameplayMessageListenerHandle UGameplayMessageSubsystem::RegisterListenerInternal(FGameplayTag Channel, TFunction<void(FGameplayTag, const UScriptStruct*, const void*)>&& Callback, const UScriptStruct* StructType, EGameplayMessageMatch MatchType, EGameplayMessageDelivery Delivery)
 {
 	FChannelListenerList& List = ListenerMap.FindOrAdd(Channel);
 
-	FGameplayMessageListenerData& Entry = List.Listeners.AddDefaulted_GetRef();
+	FGameplayMessageListenerData& Entry = *List.Listeners.Add_GetRef(MakeShared<FGameplayMessageListenerData>());
 	Entry.ReceivedCallback = MoveTemp(Callback);
 	Entry.ListenerStructType = StructType;
 	Entry.bHadValidType = StructType != nullptr;
 	Entry.HandleID = ++List.HandleID;
 	Entry.MatchType = MatchType;
+	Entry.Delivery = Delivery;
+
+	++ListenerGeneration;
 
 	return FGameplayMessageListenerHandle(this, Channel, Entry.HandleID);
 }
@@ -176,10 +443,14 @@ void UGameplayMessageSubsystem::UnregisterListenerInternal(FGameplayTag Channel,
 {
 	if (FChannelListenerList* pList = ListenerMap.Find(Channel))
 	{
-		int32 MatchIndex = pList->Listeners.IndexOfByPredicate([ID = HandleID](const FGameplayMessageListenerData& Other) { return Other.HandleID == ID; });
+		int32 MatchIndex = pList->Listeners.IndexOfByPredicate([ID = HandleID](const TSharedRef<FGameplayMessageListenerData>& Other) { return Other->HandleID == ID; });
 		if (MatchIndex != INDEX_NONE)
 		{
+			// Dispatch lists still referencing this listener will skip it
+			pList->Listeners[MatchIndex]->bUnregistered = true;
 			pList->Listeners.RemoveAtSwap(MatchIndex);
+
+			++ListenerGeneration;
 		}
 
 		if (pList->Listeners.Num() == 0)
@@ -189,3 +460,139 @@ void UGameplayMessageSubsystem::UnregisterListenerInternal(FGameplayTag Channel,
 	}
 }
 
+
+//////////////////////////////////////////////////////////////////////
+// Broadcast benchmark
+
+#if !UE_BUILD_SHIPPING
+namespace UE
+{
+	namespace GameplayMessageSubsystem
+	{
+		// The dispatch loop as it was before dispatch lists: walk the hierarchy and copy each level's listeners on every broadcast
+		static void LegacyBroadcast(const TMap<FGameplayTag, TArray<FGameplayMessageListenerData>>& LegacyListenerMap, FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes)
+		{
+			bool bOnInitialTag = true;
+			for (FGameplayTag Tag = Channel; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+			{
+				if (const TArray<FGameplayMessageListenerData>* pListeners = LegacyListenerMap.Find(Tag))
+				{
+					TArray<FGameplayMessageListenerData> ListenerArray(*pListeners);
+
+					for (const FGameplayMessageListenerData& Listener : ListenerArray)
+					{
+						if (bOnInitialTag || (Listener.MatchType == EGameplayMessageMatch::PartialMatch))
+						{
+							if (!Listener.bHadValidType || StructType->IsChildOf(Listener.ListenerStructType.Get()))
+							{
+								Listener.ReceivedCallback(Channel, StructType, MessageBytes);
+							}
+						}
+					}
+				}
+				bOnInitialTag = false;
+			}
+		}
+
+		// Picks the deepest registered tag so the benchmark walks a realistic hierarchy (e.g., Lyra.Elimination.Message)
+		static FGameplayTag FindDeepestGameplayTag()
+		{
+			FGameplayTagContainer AllTags;
+			UGameplayTagsManager::Get().RequestAllGameplayTags(AllTags, /*OnlyIncludeDictionaryTags=*/ true);
+
+			FGameplayTag DeepestTag;
+			int32 DeepestDepth = 0;
+			for (const FGameplayTag& Tag : AllTags)
+			{
+				int32 Depth = 0;
+				for (FGameplayTag Parent = Tag; Parent.IsValid(); Parent = Parent.RequestDirectParent())
+				{
+					++Depth;
+				}
+
+				if (Depth > DeepestDepth)
+				{
+					DeepestTag = Tag;
+					DeepestDepth = Depth;
+				}
+			}
+
+			return DeepestTag;
+		}
+
+		static void BenchmarkBroadcasts(const TArray<FString>& Args)
+		{
+			const int32 NumBroadcasts = (Args.Num() > 0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100000;
+			const int32 NumListeners = (Args.Num() > 1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 8;
+			const FGameplayTag Channel = (Args.Num() > 2) ? FGameplayTag::RequestGameplayTag(FName(*Args[2]), /*ErrorIfNotFound=*/ false) : FindDeepestGameplayTag();
+			if (!Channel.IsValid())
+			{
+				UE_LOG(LogGameplayMessageSubsystem, Warning, TEXT("GameplayMessageSubsystem.BenchmarkBroadcasts: no valid channel tag"));
+				return;
+			}
+
+			TArray<FGameplayTag> ChannelHierarchy;
+			for (FGameplayTag Tag = Channel; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+			{
+				ChannelHierarchy.Add(Tag);
+			}
+
+			// Use a private router so live listeners aren't called with the benchmark message
+			UGameplayMessageSubsystem* Router = NewObject<UGameplayMessageSubsystem>(GetTransientPackage());
+			TMap<FGameplayTag, TArray<FGameplayMessageListenerData>> LegacyListenerMap;
+
+			int64 NumReceived = 0;
+			const UScriptStruct* StructType = TBaseStructure<FVector>::Get();
+
+			// Same listeners for both: exact matches on the channel, partial matches spread over its parents
+			for (int32 ListenerIndex = 0; ListenerIndex < NumListeners; ++ListenerIndex)
+			{
+				const FGameplayTag ListenerChannel = ChannelHierarchy[ListenerIndex % ChannelHierarchy.Num()];
+				const EGameplayMessageMatch MatchType = (ListenerChannel == Channel) ? EGameplayMessageMatch::ExactMatch : EGameplayMessageMatch::PartialMatch;
+
+				FGameplayMessageListenerParams<FVector> Params;
+				Params.MatchType = MatchType;
+				Params.OnMessageReceivedCallback = [&NumReceived](FGameplayTag, const FVector&) { ++NumReceived; };
+				Router->RegisterListener(ListenerChannel, Params);
+
+				FGameplayMessageListenerData& LegacyListener = LegacyListenerMap.FindOrAdd(ListenerChannel).AddDefaulted_GetRef();
+				LegacyListener.ReceivedCallback = [&NumReceived](FGameplayTag, const UScriptStruct*, const void*) { ++NumReceived; };
+				LegacyListener.HandleID = ListenerIndex + 1;
+				LegacyListener.MatchType = MatchType;
+				LegacyListener.ListenerStructType = StructType;
+				LegacyListener.bHadValidType = true;
+			}
+
+			const FVector Message(1.0, 2.0, 3.0);
+
+			NumReceived = 0;
+			const double LegacyStart = FPlatformTime::Seconds();
+			for (int32 BroadcastIndex = 0; BroadcastIndex < NumBroadcasts; ++BroadcastIndex)
+			{
+				LegacyBroadcast(LegacyListenerMap, Channel, StructType, &Message);
+			}
+			const double LegacySeconds = FPlatformTime::Seconds() - LegacyStart;
+			const int64 LegacyReceived = NumReceived;
+
+			NumReceived = 0;
+			const double CachedStart = FPlatformTime::Seconds();
+			for (int32 BroadcastIndex = 0; BroadcastIndex < NumBroadcasts; ++BroadcastIndex)
+			{
+				Router->BroadcastMessage(Channel, Message);
+			}
+			const double CachedSeconds = FPlatformTime::Seconds() - CachedStart;
+			const int64 CachedReceived = NumReceived;
+
+			Router->MarkAsGarbage();
+
+			UE_LOG(LogGameplayMessageSubsystem, Display, TEXT("Broadcast benchmark: %d broadcasts on %s (%d levels), %d listeners"), NumBroadcasts, *Channel.ToString(), ChannelHierarchy.Num(), NumListeners);
+			UE_LOG(LogGameplayMessageSubsystem, Display, TEXT("  Hierarchy walk + copy: %.3f ms, %.0f broadcasts/s (%lld callbacks)"), LegacySeconds * 1000.0, NumBroadcasts / FMath::Max(LegacySeconds, UE_SMALL_NUMBER), LegacyReceived);
+			UE_LOG(LogGameplayMessageSubsystem, Display, TEXT("  Cached dispatch list:  %.3f ms, %.0f broadcasts/s (%lld callbacks)"), CachedSeconds * 1000.0, NumBroadcasts / FMath::Max(CachedSeconds, UE_SMALL_NUMBER), CachedReceived);
+		}
+
+		static FAutoConsoleCommand CmdBenchmarkBroadcasts(TEXT("GameplayMessageSubsystem.BenchmarkBroadcasts"),
+			TEXT("Compares broadcasts per second of the cached dispatch lists against walking the channel hierarchy and copying listeners. Usage: GameplayMessageSubsystem.BenchmarkBroadcasts [NumBroadcasts=100000] [NumListeners=8] [Channel]"),
+			FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkBroadcasts));
+	}
+}
+#endif // !UE_BUILD_SHIPPING
@@ -2,9 +2,12 @@
 
 #pragma once
 
+#include "Engine/EngineBaseTypes.h"
 #include "GameFramework/GameplayMessageTypes2.h"
 #include "GameplayTagContainer.h"
+#include "Misc/MemStack.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/ObjectKey.h"
 #include "UObject/WeakObjectPtr.h"
 
 #include "GameplayMessageSubsystem.generated.h"
@@ -62,10 +65,55 @@ struct FGameplayMessageListenerData
 
 	int32 HandleID;
 	EGameplayMessageMatch MatchType;
+	EGameplayMessageDelivery Delivery = EGameplayMessageDelivery::ChannelDefault;
 
 	// Adding some logging and extra variables around some potential problems with this
 	TWeakObjectPtr<const UScriptStruct> ListenerStructType = nullptr;
 	bool bHadValidType = false;
+
+	// Set when the listener is unregistered, so dispatch lists that are mid-broadcast skip it
+	bool bUnregistered = false;
+};
+
+/**
+ * Tick function that delivers queued messages at a fixed point in the frame
+ */
+USTRUCT()
+struct FGameplayMessageQueueTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	UGameplayMessageSubsystem* Target = nullptr;
+
+	//~FTickFunction interface
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+	virtual FName DiagnosticContext(bool bDetailed) override;
+	//~End of FTickFunction interface
+};
+
+template<>
+struct TStructOpsTypeTraits<FGameplayMessageQueueTickFunction> : public TStructOpsTypeTraitsBase2<FGameplayMessageQueueTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * A channel queue mode set from config, see UGameplayMessageSubsystem::DefaultChannelQueueModes
+ */
+USTRUCT()
+struct FGameplayMessageChannelQueueMode
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category=Messaging)
+	FGameplayTag Channel;
+
+	UPROPERTY(EditAnywhere, Category=Messaging)
+	EGameplayMessageQueueMode QueueMode = EGameplayMessageQueueMode::Immediate;
 };
 
 /**
@@ -81,8 +129,14 @@ struct FGameplayMessageListenerData
  *
  * Note that call order when there are multiple listeners for the same channel is
  * not guaranteed and can change over time!
+ *
+ * Channels can be made queued with SetChannelQueueMode, in which case messages are copied
+ * into a frame buffer and delivered in broadcast order during TG_PostUpdateWork instead of
+ * from inside BroadcastMessage. Listeners can override their channel's mode by registering
+ * with EGameplayMessageDelivery::Immediate or EGameplayMessageDelivery::Deferred.
+ * Project-wide queue modes are configured in DefaultChannelQueueModes (DefaultGame.ini).
  */
-UCLASS()
+UCLASS(Config=Game)
 class GAMEPLAYMESSAGERUNTIME_API UGameplayMessageSubsystem : public UGameInstanceSubsystem
 {
 	GENERATED_BODY()
@@ -102,9 +156,14 @@ public:
 	static bool HasInstance(const UObject* WorldContextObject);
 
 	//~USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	virtual void Deinitialize() override;
 	//~End of USubsystem interface
 
+	//~UObject interface
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+	//~End of UObject interface
+
 	/**
 	 * Broadcast a message on the specified channel
 	 *
@@ -115,7 +174,22 @@ public:
 	void BroadcastMessage(FGameplayTag Channel, const FMessageStructType& Message)
 	{
 		const UScriptStruct* StructType = TBaseStructure<FMessageStructType>::Get();
-		BroadcastMessageInternal(Channel, StructType, &Message);
+		BroadcastMessageInternal(Channel, StructType, &Message, nullptr);
+	}
+
+	/**
+	 * Broadcast a message on the specified channel, coalescing it with other messages broadcast with the same key this frame
+	 * (only matters for channels in EGameplayMessageQueueMode::QueuedCoalesced mode, e.g., one message per owner)
+	 *
+	 * @param Channel			The message channel to broadcast on
+	 * @param Message			The message to send (must be the same type of UScriptStruct expected by the listeners for this channel, otherwise an error will be logged)
+	 * @param CoalesceKey		Messages on the same channel with the same key replace each other until the queue is flushed
+	 */
+	template <typename FMessageStructType>
+	void BroadcastMessage(FGameplayTag Channel, const FMessageStructType& Message, const UObject* CoalesceKey)
+	{
+		const UScriptStruct* StructType = TBaseStructure<FMessageStructType>::Get();
+		BroadcastMessageInternal(Channel, StructType, &Message, CoalesceKey);
 	}
 
 	/**
@@ -123,11 +197,13 @@ public:
 	 *
 	 * @param Channel			The message channel to listen to
 	 * @param Callback			Function to call with the message when someone broadcasts it (must be the same type of UScriptStruct provided by broadcasters for this channel, otherwise an error will be logged)
+	 * @param MatchType			Whether to also receive messages broadcast on more derived channels
+	 * @param Delivery			Whether to be called from inside the broadcast or when the message queue is flushed
 	 *
 	 * @return a handle that can be used to unregister this listener (either by calling Unregister() on the handle or calling UnregisterListener on the router)
 	 */
 	template <typename FMessageStructType>
-	FGameplayMessageListenerHandle RegisterListener(FGameplayTag Channel, TFunction<void(FGameplayTag, const FMessageStructType&)>&& Callback, EGameplayMessageMatch MatchType = EGameplayMessageMatch::ExactMatch)
+	FGameplayMessageListenerHandle RegisterListener(FGameplayTag Channel, TFunction<void(FGameplayTag, const FMessageStructType&)>&& Callback, EGameplayMessageMatch MatchType = EGameplayMessageMatch::ExactMatch, EGameplayMessageDelivery Delivery = EGameplayMessageDelivery::ChannelDefault)
 	{
 		auto ThunkCallback = [InnerCallback = MoveTemp(Callback)](FGameplayTag ActualTag, const UScriptStruct* SenderStructType, const void* SenderPayload)
 		{
@@ -135,7 +211,7 @@ public:
 		};
 
 		const UScriptStruct* StructType = TBaseStructure<FMessageStructType>::Get();
-		return RegisterListenerInternal(Channel, ThunkCallback, StructType, MatchType);
+		return RegisterListenerInternal(Channel, ThunkCallback, StructType, MatchType, Delivery);
 	}
 
 	/**
@@ -145,11 +221,12 @@ public:
 	 * @param Channel			The message channel to listen to
 	 * @param Object			The object instance to call the function on
 	 * @param Function			Member function to call with the message when someone broadcasts it (must be the same type of UScriptStruct provided by broadcasters for this channel, otherwise an error will be logged)
+	 * @param Delivery			Whether to be called from inside the broadcast or when the message queue is flushed
 	 *
 	 * @return a handle that can be used to unregister this listener (either by calling Unregister() on the handle or calling UnregisterListener on the router)
 	 */
 	template <typename FMessageStructType, typename TOwner = UObject>
-	FGameplayMessageListenerHandle RegisterListener(FGameplayTag Channel, TOwner* Object, void(TOwner::* Function)(FGameplayTag, const FMessageStructType&))
+	FGameplayMessageListenerHandle RegisterListener(FGameplayTag Channel, TOwner* Object, void(TOwner::* Function)(FGameplayTag, const FMessageStructType&), EGameplayMessageDelivery Delivery = EGameplayMessageDelivery::ChannelDefault)
 	{
 		TWeakObjectPtr<TOwner> WeakObject(Object);
 		return RegisterListener<FMessageStructType>(Channel,
@@ -159,7 +236,7 @@ public:
 				{
 					(StrongObject->*Function)(Channel, Payload);
 				}
-			});
+			}, EGameplayMessageMatch::ExactMatch, Delivery);
 	}
 
 	/**
@@ -185,7 +262,7 @@ public:
 			};
 
 			const UScriptStruct* StructType = TBaseStructure<FMessageStructType>::Get();
-			Handle = RegisterListenerInternal(Channel, ThunkCallback, StructType, Params.MatchType);
+			Handle = RegisterListenerInternal(Channel, ThunkCallback, StructType, Params.MatchType, Params.Delivery);
 		}
 
 		return Handle;
@@ -198,6 +275,17 @@ public:
 	 */
 	void UnregisterListener(FGameplayMessageListenerHandle Handle);
 
+	/**
+	 * Set how messages broadcast on a channel (and any child channel without its own mode) reach listeners that use the channel's default delivery
+	 *
+	 * @param Channel	The message channel to configure
+	 * @param Mode		Immediate, queued until the flush, or queued and coalesced to the last message per coalesce key
+	 */
+	void SetChannelQueueMode(FGameplayTag Channel, EGameplayMessageQueueMode Mode);
+
+	/** Deliver all queued messages now (normally done automatically during TG_PostUpdateWork) */
+	void FlushQueuedMessages();
+
 protected:
 	/**
 	 * Broadcast a message on the specified channel
@@ -212,14 +300,15 @@ protected:
 
 private:
 	// Internal helper for broadcasting a message
-	void BroadcastMessageInternal(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes);
+	void BroadcastMessageInternal(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes, const UObject* CoalesceKey = nullptr);
 
 	// Internal helper for registering a message listener
 	FGameplayMessageListenerHandle RegisterListenerInternal(
 		FGameplayTag Channel, 
 		TFunction<void(FGameplayTag, const UScriptStruct*, const void*)>&& Callback,
 		const UScriptStruct* StructType,
-		EGameplayMessageMatch MatchType);
+		EGameplayMessageMatch MatchType,
+		EGameplayMessageDelivery Delivery);
 
 	void UnregisterListenerInternal(FGameplayTag Channel, int32 HandleID);
 
@@ -227,10 +316,83 @@ private:
 	// List of all entries for a given channel
 	struct FChannelListenerList
 	{
-		TArray<FGameplayMessageListenerData> Listeners;
+		TArray<TSharedRef<FGameplayMessageListenerData>> Listeners;
 		int32 HandleID = 0;
 	};
 
+	// A listener that should receive broadcasts on a given channel, and the channel it registered on
+	struct FChannelDispatchEntry
+	{
+		TSharedRef<FGameplayMessageListenerData> Listener;
+		FGameplayTag ListenerChannel;
+	};
+
+	// Flattened list of every listener that matches a broadcast channel (exact listeners first, then partial listeners on each parent)
+	// Never modified after it is built, so a broadcast can keep iterating it even if callbacks register or unregister listeners
+	struct FChannelDispatchList
+	{
+		// Listeners called from inside the broadcast
+		TArray<FChannelDispatchEntry> Entries;
+
+		// Listeners called when the message queue is flushed
+		TArray<FChannelDispatchEntry> DeferredEntries;
+
+		EGameplayMessageQueueMode QueueMode = EGameplayMessageQueueMode::Immediate;
+		uint32 ListenerGeneration = 0;
+	};
+
+	// A message waiting for the queue flush, copied into QueuedMessageMemory
+	struct FQueuedMessage
+	{
+		FGameplayTag Channel;
+		const UScriptStruct* StructType = nullptr;
+		void* MessageBytes = nullptr;
+		TSharedPtr<const FChannelDispatchList> DispatchList;
+	};
+
+	// Returns the dispatch list for a broadcast channel, rebuilding it if listeners changed since it was built
+	TSharedRef<const FChannelDispatchList> GetDispatchList(FGameplayTag Channel);
+
+	void DispatchToListeners(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes, TConstArrayView<FChannelDispatchEntry> Entries);
+
+	void QueueMessage(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes, const UObject* CoalesceKey, const TSharedRef<const FChannelDispatchList>& DispatchList);
+
+	// Makes sure the flush tick function is registered with the current world, returns false if there is no world to flush in
+	bool RegisterQueueTickFunction();
+
+	void DiscardQueuedMessages();
+
 private:
+	// Queue modes applied when the subsystem is initialized
+	UPROPERTY(Config)
+	TArray<FGameplayMessageChannelQueueMode> DefaultChannelQueueModes;
+
 	TMap<FGameplayTag, FChannelListenerList> ListenerMap;
+
+	// Dispatch lists per broadcast channel, built on demand
+	TMap<FGameplayTag, TSharedRef<const FChannelDispatchList>> DispatchCache;
+
+	// Incremented whenever a listener is registered or unregistered (or a queue mode changes), invalidating all dispatch lists
+	uint32 ListenerGeneration = 1;
+
+	TMap<FGameplayTag, EGameplayMessageQueueMode> ChannelQueueModes;
+
+	// Messages waiting for the flush, in broadcast order
+	TArray<FQueuedMessage> QueuedMessages;
+
+	// Messages being delivered by the current flush (kept to reuse the allocation)
+	TArray<FQueuedMessage> DeliveringMessages;
+
+	// Index into QueuedMessages of the pending message for each (channel, coalesce key) on coalesced channels
+	TMap<TPair<FGameplayTag, FObjectKey>, int32> CoalescedMessageIndices;
+
+	// Frame buffer the queued message payloads are copied into, released after each flush
+	// (invisible to the garbage collector, AddReferencedObjects reports the references in the payloads)
+	FMemStackBase QueuedMessageMemory;
+
+	FGameplayMessageQueueTickFunction QueueTickFunction;
+
+	TWeakObjectPtr<UWorld> QueueTickWorld;
+
+	bool bFlushingQueuedMessages = false;
 };
@@ -22,6 +22,34 @@ enum class EGameplayMessageMatch : uint8
 	PartialMatch
 };
 
+// When a listener receives messages
+UENUM(BlueprintType)
+enum class EGameplayMessageDelivery : uint8
+{
+	// Use the queue mode of the channel (immediate unless the channel was made queued)
+	ChannelDefault,
+
+	// Called synchronously from inside BroadcastMessage
+	Immediate,
+
+	// Called when the message queue is flushed later in the frame
+	Deferred
+};
+
+// How messages broadcast on a channel reach listeners that use the channel's default delivery
+UENUM(BlueprintType)
+enum class EGameplayMessageQueueMode : uint8
+{
+	// Listeners are called synchronously from inside BroadcastMessage
+	Immediate,
+
+	// Messages are queued and delivered when the message queue is flushed later in the frame
+	Queued,
+
+	// Like Queued, but only the last message broadcast on the channel (per coalesce key) in a frame is delivered
+	QueuedCoalesced
+};
+
 /**
  * Struct used to specify advanced behavior when registering a listener for gameplay messages
  */
@@ -31,6 +59,9 @@ struct FGameplayMessageListenerParams
 	/** Whether Callback should be called for broadcasts of more derived channels or if it will only be called for exact matches. */
 	EGameplayMessageMatch MatchType = EGameplayMessageMatch::ExactMatch;
 
+	/** Whether Callback should be called from inside the broadcast or when the message queue is flushed. */
+	EGameplayMessageDelivery Delivery = EGameplayMessageDelivery::ChannelDefault;
+
 	/** If bound this callback will trigger when a message is broadcast on the specified channel. */
 	TFunction<void(FGameplayTag, const FMessageStructType&)> OnMessageReceivedCallback;
 
@@ -50,6 +50,27 @@ public:
 	{
 	}
 
+	/**
+	 * Checks if we can afford NumUses uses at once (e.g., every shot in a sustained-fire batch).
+	 * The default only knows how to check a single use.
+	 */
+	virtual bool CheckCostMultiple(const ULyraGameplayAbility* Ability, const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, int32 NumUses, FGameplayTagContainer* OptionalRelevantTags) const
+	{
+		return CheckCost(Ability, Handle, ActorInfo, OptionalRelevantTags);
+	}
+
+	/**
+	 * Applies the cost of NumUses uses at once.
+	 * The default applies the single-use cost NumUses times; override this when the cost can be paid in one go.
+	 */
+	virtual void ApplyCostMultiple(const ULyraGameplayAbility* Ability, const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, int32 NumUses)
+	{
+		for (int32 UseIdx = 0; UseIdx < NumUses; ++UseIdx)
+		{
+			ApplyCost(Ability, Handle, ActorInfo, ActivationInfo);
+		}
+	}
+
 	/** If true, this cost should only be applied if this ability hits successfully */
 	bool ShouldOnlyApplyCostOnHit() const { return bOnlyApplyCostOnHit; }
 
@@ -58,3 +58,45 @@ void ULyraAbilityCost_ItemTagStack::ApplyCost(const ULyraGameplayAbility* Abilit
 	}
 }
 
+bool ULyraAbilityCost_ItemTagStack::CheckCostMultiple(const ULyraGameplayAbility* Ability, const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, int32 NumUses, FGameplayTagContainer* OptionalRelevantTags) const
+{
+	if (const ULyraGameplayAbility_FromEquipment* EquipmentAbility = Cast<const ULyraGameplayAbility_FromEquipment>(Ability))
+	{
+		if (ULyraInventoryItemInstance* ItemInstance = EquipmentAbility->GetAssociatedItem())
+		{
+			const int32 AbilityLevel = Ability->GetAbilityLevel(Handle, ActorInfo);
+
+			const float NumStacksReal = Quantity.GetValueAtLevel(AbilityLevel);
+			const int32 NumStacks = FMath::TruncToInt(NumStacksReal) * FMath::Max(NumUses, 1);
+			const bool bCanApplyCost = ItemInstance->GetStatTagStackCount(Tag) >= NumStacks;
+
+			// Inform other abilities why this cost cannot be applied
+			if (!bCanApplyCost && OptionalRelevantTags && FailureTag.IsValid())
+			{
+				OptionalRelevantTags->AddTag(FailureTag);
+			}
+			return bCanApplyCost;
+		}
+	}
+	return false;
+}
+
+void ULyraAbilityCost_ItemTagStack::ApplyCostMultiple(const ULyraGameplayAbility* Ability, const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, int32 NumUses)
+{
+	if (ActorInfo->IsNetAuthority() && (NumUses > 0))
+	{
+		if (const ULyraGameplayAbility_FromEquipment* EquipmentAbility = Cast<const ULyraGameplayAbility_FromEquipment>(Ability))
+		{
+			if (ULyraInventoryItemInstance* ItemInstance = EquipmentAbility->GetAssociatedItem())
+			{
+				const int32 AbilityLevel = Ability->GetAbilityLevel(Handle, ActorInfo);
+
+				const float NumStacksReal = Quantity.GetValueAtLevel(AbilityLevel);
+				const int32 NumStacks = FMath::TruncToInt(NumStacksReal);
+
+				// One stack change (and one replicated item update) for the whole batch
+				ItemInstance->RemoveStatTagStack(Tag, NumStacks * NumUses);
+			}
+		}
+	}
+}
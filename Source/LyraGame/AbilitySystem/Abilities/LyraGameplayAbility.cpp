@@ -226,28 +226,6 @@ void ULyraGameplayAbility::ApplyCost(const FGameplayAbilitySpecHandle Handle, co
 
 	check(ActorInfo);
 
-	// Used to determine if the ability actually hit a target (as some costs are only spent on successful attempts)
-	auto DetermineIfAbilityHitTarget = [&]()
-	{
-		if (ActorInfo->IsNetAuthority())
-		{
-			if (ULyraAbilitySystemComponent* ASC = Cast<ULyraAbilitySystemComponent>(ActorInfo->AbilitySystemComponent.Get()))
-			{
-				FGameplayAbilityTargetDataHandle TargetData;
-				ASC->GetAbilityTargetData(Handle, ActivationInfo, TargetData);
-				for (int32 TargetDataIdx = 0; TargetDataIdx < TargetData.Data.Num(); ++TargetDataIdx)
-				{
-					if (UAbilitySystemBlueprintLibrary::TargetDataHasHitResult(TargetData, TargetDataIdx))
-					{
-						return true;
-					}
-				}
-			}
-		}
-
-		return false;
-	};
-
 	// Pay any additional costs
 	bool bAbilityHitTarget = false;
 	bool bHasDeterminedIfAbilityHitTarget = false;
@@ -259,7 +237,7 @@ void ULyraGameplayAbility::ApplyCost(const FGameplayAbilitySpecHandle Handle, co
 			{
 				if (!bHasDeterminedIfAbilityHitTarget)
 				{
-					bAbilityHitTarget = DetermineIfAbilityHitTarget();
+					bAbilityHitTarget = DoesTargetDataHaveHit(Handle, ActorInfo, ActivationInfo);
 					bHasDeterminedIfAbilityHitTarget = true;
 				}
 
@@ -274,6 +252,79 @@ void ULyraGameplayAbility::ApplyCost(const FGameplayAbilitySpecHandle Handle, co
 	}
 }
 
+bool ULyraGameplayAbility::CheckCostMultiple(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, int32 NumUses, OUT FGameplayTagContainer* OptionalRelevantTags) const
+{
+	if (NumUses <= 1)
+	{
+		return CheckCost(Handle, ActorInfo, OptionalRelevantTags);
+	}
+
+	// The cost gameplay effect can only be checked for a single application
+	if (!Super::CheckCost(Handle, ActorInfo, OptionalRelevantTags) || !ActorInfo)
+	{
+		return false;
+	}
+
+	for (const TObjectPtr<ULyraAbilityCost>& AdditionalCost : AdditionalCosts)
+	{
+		if (AdditionalCost != nullptr)
+		{
+			if (!AdditionalCost->CheckCostMultiple(this, Handle, ActorInfo, NumUses, /*inout*/ OptionalRelevantTags))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void ULyraGameplayAbility::ApplyCostMultiple(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, int32 NumUses) const
+{
+	if (NumUses <= 0)
+	{
+		return;
+	}
+
+	check(ActorInfo);
+
+	for (int32 UseIdx = 0; UseIdx < NumUses; ++UseIdx)
+	{
+		Super::ApplyCost(Handle, ActorInfo, ActivationInfo);
+	}
+
+	const bool bAbilityHitTarget = DoesTargetDataHaveHit(Handle, ActorInfo, ActivationInfo);
+	for (const TObjectPtr<ULyraAbilityCost>& AdditionalCost : AdditionalCosts)
+	{
+		if ((AdditionalCost != nullptr) && (!AdditionalCost->ShouldOnlyApplyCostOnHit() || bAbilityHitTarget))
+		{
+			AdditionalCost->ApplyCostMultiple(this, Handle, ActorInfo, ActivationInfo, NumUses);
+		}
+	}
+}
+
+bool ULyraGameplayAbility::DoesTargetDataHaveHit(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo) const
+{
+	// Used to determine if the ability actually hit a target (as some costs are only spent on successful attempts)
+	if (ActorInfo->IsNetAuthority())
+	{
+		if (ULyraAbilitySystemComponent* ASC = Cast<ULyraAbilitySystemComponent>(ActorInfo->AbilitySystemComponent.Get()))
+		{
+			FGameplayAbilityTargetDataHandle TargetData;
+			ASC->GetAbilityTargetData(Handle, ActivationInfo, TargetData);
+			for (int32 TargetDataIdx = 0; TargetDataIdx < TargetData.Data.Num(); ++TargetDataIdx)
+			{
+				if (UAbilitySystemBlueprintLibrary::TargetDataHasHitResult(TargetData, TargetDataIdx))
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
 FGameplayEffectContextHandle ULyraGameplayAbility::MakeEffectContext(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo) const
 {
 	FGameplayEffectContextHandle ContextHandle = Super::MakeEffectContext(Handle, ActorInfo);
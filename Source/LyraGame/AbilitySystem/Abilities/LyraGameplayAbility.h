@@ -143,6 +143,12 @@ public:
 		ScriptOnAbilityFailedToActivate(FailedReason);
 	}
 
+	// Checks if NumUses uses of this ability can be paid for at once (e.g., every shot in a sustained-fire batch)
+	bool CheckCostMultiple(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, int32 NumUses, OUT FGameplayTagContainer* OptionalRelevantTags = nullptr) const;
+
+	// Pays for NumUses uses of this ability at once instead of committing each use separately
+	void ApplyCostMultiple(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, int32 NumUses) const;
+
 protected:
 
 	// Called when the ability fails to activate
@@ -168,6 +174,9 @@ protected:
 
 	virtual void OnPawnAvatarSet();
 
+	// Returns true if the replicated target data for this activation has a hit (used by costs that only apply on hit)
+	bool DoesTargetDataHaveHit(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo) const;
+
 	virtual void GetAbilitySource(FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, float& OutSourceLevel, const ILyraAbilitySourceInterface*& OutAbilitySource, AActor*& OutEffectCauser) const;
 
 	/** Called when this ability is granted to the ability system component. */
@@ -0,0 +1,331 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HaroDOTFieldSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "Character/LyraCharacter.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameplayEffect.h"
+#include "LyraLogChannels.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HaroDOTFieldSubsystem)
+
+DECLARE_STATS_GROUP(TEXT("HaroDOT"), STATGROUP_HaroDOT, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Fields"), STAT_HaroDOT_Fields, STATGROUP_HaroDOT);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Targets"), STAT_HaroDOT_Targets, STATGROUP_HaroDOT);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Applications"), STAT_HaroDOT_Applications, STATGROUP_HaroDOT);
+
+namespace HaroConsoleVariables
+{
+	static float DOTTickInterval = 0.25f;
+	static FAutoConsoleVariableRef CVarDOTTickInterval(
+		TEXT("Haro.DOT.TickInterval"),
+		DOTTickInterval,
+		TEXT("Fixed interval (in seconds) at which all DOT fields are evaluated"),
+		ECVF_Default);
+
+	static float DOTCellSize = 500.0f;
+	static FAutoConsoleVariableRef CVarDOTCellSize(
+		TEXT("Haro.DOT.CellSize"),
+		DOTCellSize,
+		TEXT("Size (in uu) of a cell in the DOT field spatial hash"),
+		ECVF_Default);
+
+	static bool bLogDOTTickStats = false;
+	static FAutoConsoleVariableRef CVarLogDOTTickStats(
+		TEXT("Haro.DOT.LogTickStats"),
+		bLogDOTTickStats,
+		TEXT("Log field/target/application counts for every DOT field evaluation"),
+		ECVF_Default);
+}
+
+namespace HaroDOTField
+{
+	// 해시에 넣을 때 필드 반지름에 더하는 여유 (캐릭터 캡슐 반지름 정도)
+	static constexpr float TargetRadiusMargin = 100.0f;
+}
+
+void UHaroDOTFieldSubsystem::Deinitialize()
+{
+	FieldActors.Reset();
+	FieldKeys.Reset();
+	FieldDescs.Reset();
+	FieldIndexByActor.Reset();
+	FieldCells.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UHaroDOTFieldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+ETickableTickType UHaroDOTFieldSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UHaroDOTFieldSubsystem::IsTickable() const
+{
+	return FieldActors.Num() > 0;
+}
+
+TStatId UHaroDOTFieldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHaroDOTFieldSubsystem, STATGROUP_Tickables);
+}
+
+void UHaroDOTFieldSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const float Interval = FMath::Max(HaroConsoleVariables::DOTTickInterval, 0.01f);
+
+	TimeUntilNextEvaluation -= DeltaTime;
+	if (TimeUntilNextEvaluation > 0.0f)
+	{
+		return;
+	}
+
+	// 프레임이 길어져도 한 번만 처리 (밀린 틱을 몰아서 처리하지 않음)
+	TimeUntilNextEvaluation = FMath::Max(TimeUntilNextEvaluation + Interval, 0.0f);
+
+	EvaluateFields(Interval);
+}
+
+void UHaroDOTFieldSubsystem::RegisterField(AActor* FieldActor, const FHaroDOTFieldDesc& Desc)
+{
+	if (!FieldActor || !Desc.TickEffectSpec.IsValid())
+	{
+		return;
+	}
+
+	if (const int32* ExistingIndex = FieldIndexByActor.Find(FieldActor))
+	{
+		FieldDescs[*ExistingIndex] = Desc;
+	}
+	else
+	{
+		// 첫 필드가 등록되면 바로 다음 틱에 평가하지 않고 간격만큼 기다림 (들어오자마자 데미지가 두 번 들어가지 않도록)
+		if (FieldActors.Num() == 0)
+		{
+			TimeUntilNextEvaluation = HaroConsoleVariables::DOTTickInterval;
+		}
+
+		FieldIndexByActor.Add(FieldActor, FieldActors.Num());
+		FieldActors.Add(FieldActor);
+		FieldKeys.Add(FieldActor);
+		FieldDescs.Add(Desc);
+	}
+
+	bSpatialHashDirty = true;
+}
+
+void UHaroDOTFieldSubsystem::UnregisterField(AActor* FieldActor)
+{
+	if (const int32* Index = FieldIndexByActor.Find(FieldActor))
+	{
+		RemoveFieldAt(*Index);
+	}
+}
+
+void UHaroDOTFieldSubsystem::RemoveFieldAt(int32 Index)
+{
+	FieldIndexByActor.Remove(FieldKeys[Index]);
+
+	// 마지막 필드를 빈 자리로 옮김
+	const int32 LastIndex = FieldKeys.Num() - 1;
+	if (Index != LastIndex)
+	{
+		FieldIndexByActor.Add(FieldKeys[LastIndex], Index);
+	}
+
+	FieldActors.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	FieldKeys.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	FieldDescs.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	bSpatialHashDirty = true;
+}
+
+void UHaroDOTFieldSubsystem::UpdateFieldLocation(AActor* FieldActor, const FVector& NewCenter)
+{
+	if (const int32* Index = FieldIndexByActor.Find(FieldActor))
+	{
+		FieldDescs[*Index].Center = NewCenter;
+		bSpatialHashDirty = true;
+	}
+}
+
+FIntPoint UHaroDOTFieldSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+void UHaroDOTFieldSubsystem::RebuildSpatialHash()
+{
+	CellSize = FMath::Max(HaroConsoleVariables::DOTCellSize, 100.0f);
+
+	for (TPair<FIntPoint, TArray<int32>>& Cell : FieldCells)
+	{
+		Cell.Value.Reset();
+	}
+
+	for (int32 FieldIndex = 0; FieldIndex < FieldDescs.Num(); ++FieldIndex)
+	{
+		const FHaroDOTFieldDesc& Desc = FieldDescs[FieldIndex];
+
+		// 타겟 캡슐 반지름만큼 걸친 경우도 찾을 수 있도록 여유를 둠
+		const float CellRadius = Desc.Radius + HaroDOTField::TargetRadiusMargin;
+		const FVector Extent(CellRadius, CellRadius, 0.0);
+
+		const FIntPoint MinCell = GetCell(Desc.Center - Extent);
+		const FIntPoint MaxCell = GetCell(Desc.Center + Extent);
+
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				FieldCells.FindOrAdd(FIntPoint(X, Y)).Add(FieldIndex);
+			}
+		}
+	}
+
+	bSpatialHashDirty = false;
+}
+
+void UHaroDOTFieldSubsystem::EvaluateFields(float Interval)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_HaroDOT_EvaluateFields);
+
+	UWorld* World = GetWorld();
+	if (!World || (World->GetNetMode() == NM_Client))
+	{
+		return;
+	}
+
+	// 파괴됐는데 등록 해제가 안 된 필드 정리
+	for (int32 FieldIndex = FieldActors.Num() - 1; FieldIndex >= 0; --FieldIndex)
+	{
+		if (!FieldActors[FieldIndex].IsValid())
+		{
+			RemoveFieldAt(FieldIndex);
+		}
+	}
+
+	if (bSpatialHashDirty)
+	{
+		RebuildSpatialHash();
+	}
+
+	FHaroDOTFieldTickStats Stats;
+	Stats.NumFields = FieldActors.Num();
+
+	for (TActorIterator<ALyraCharacter> It(World); It; ++It)
+	{
+		ALyraCharacter* Target = *It;
+
+		UAbilitySystemComponent* TargetASC = Target->GetAbilitySystemComponent();
+		if (!TargetASC)
+		{
+			continue;
+		}
+
+		const FVector TargetLocation = Target->GetActorLocation();
+		const TArray<int32>* CellFields = FieldCells.Find(GetCell(TargetLocation));
+		if (!CellFields || (CellFields->Num() == 0))
+		{
+			continue;
+		}
+
+		// 타겟은 캡슐(수직 선분 + 반지름)로 보고 구 필드와 3D로 비교
+		float TargetCollisionRadius;
+		float TargetHalfHeight;
+		Target->GetSimpleCollisionCylinder(TargetCollisionRadius, TargetHalfHeight);
+		const float TargetRadius = FMath::Min(TargetCollisionRadius, HaroDOTField::TargetRadiusMargin);
+		const FVector TargetSegmentOffset(0.0, 0.0, FMath::Max(TargetHalfHeight - TargetCollisionRadius, 0.0f));
+
+		ScratchApplications.Reset();
+		for (const int32 FieldIndex : *CellFields)
+		{
+			const FHaroDOTFieldDesc& Desc = FieldDescs[FieldIndex];
+
+			if (Desc.IgnoredActor.Get() == Target)
+			{
+				continue;
+			}
+
+			const FVector ClosestPoint = FMath::ClosestPointOnSegment(Desc.Center, TargetLocation - TargetSegmentOffset, TargetLocation + TargetSegmentOffset);
+			if (FVector::DistSquared(ClosestPoint, Desc.Center) > FMath::Square(Desc.Radius + TargetRadius))
+			{
+				continue;
+			}
+
+			if (Desc.bCheckLineOfSight)
+			{
+				FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HaroDOTLineOfSight), /*bTraceComplex=*/ false, FieldActors[FieldIndex].Get());
+				QueryParams.AddIgnoredActor(Target);
+				QueryParams.AddIgnoredActor(Desc.IgnoredActor.Get());
+
+				if (World->LineTraceTestByChannel(Desc.Center, TargetLocation, ECollisionChannel::ECC_Visibility, QueryParams))
+				{
+					continue;
+				}
+			}
+
+			// 같은 GE + 같은 소스 + 같은 태그면 하나로 합침
+			const FGameplayEffectSpec& Spec = *Desc.TickEffectSpec.Data.Get();
+			const float Magnitude = Desc.MagnitudePerSecond * Interval;
+
+			FPendingApplication* Existing = ScratchApplications.FindByPredicate([&](const FPendingApplication& Pending)
+			{
+				const FHaroDOTFieldDesc& OtherDesc = FieldDescs[Pending.TemplateFieldIndex];
+				const FGameplayEffectSpec& OtherSpec = *OtherDesc.TickEffectSpec.Data.Get();
+				return (OtherSpec.Def == Spec.Def)
+					&& (OtherSpec.GetContext().GetInstigatorAbilitySystemComponent() == Spec.GetContext().GetInstigatorAbilitySystemComponent())
+					&& (OtherDesc.SetByCallerTag == Desc.SetByCallerTag);
+			});
+
+			if (Existing)
+			{
+				Existing->Magnitude += Magnitude;
+			}
+			else
+			{
+				ScratchApplications.Add({ FieldIndex, Magnitude });
+			}
+		}
+
+		if (ScratchApplications.Num() == 0)
+		{
+			continue;
+		}
+
+		++Stats.NumTargets;
+
+		for (const FPendingApplication& Pending : ScratchApplications)
+		{
+			const FHaroDOTFieldDesc& Desc = FieldDescs[Pending.TemplateFieldIndex];
+
+			// Instant GE는 적용 시점에 바로 실행되므로 템플릿 스펙에 크기만 바꿔서 그대로 사용
+			FGameplayEffectSpec& Spec = *Desc.TickEffectSpec.Data.Get();
+			Spec.SetSetByCallerMagnitude(Desc.SetByCallerTag, Pending.Magnitude);
+
+			TargetASC->ApplyGameplayEffectSpecToSelf(Spec);
+			++Stats.NumApplications;
+		}
+	}
+
+	LastTickStats = Stats;
+
+	SET_DWORD_STAT(STAT_HaroDOT_Fields, Stats.NumFields);
+	SET_DWORD_STAT(STAT_HaroDOT_Targets, Stats.NumTargets);
+	SET_DWORD_STAT(STAT_HaroDOT_Applications, Stats.NumApplications);
+
+	if (HaroConsoleVariables::bLogDOTTickStats)
+	{
+		UE_LOG(LogLyra, Log, TEXT("DOT fields: %d fields, %d targets, %d applications"), Stats.NumFields, Stats.NumTargets, Stats.NumApplications);
+	}
+}
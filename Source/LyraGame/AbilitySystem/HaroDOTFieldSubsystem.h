@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GameplayEffectTypes.h"
+#include "GameplayTagContainer.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "HaroDOTFieldSubsystem.generated.h"
+
+class AActor;
+class UAbilitySystemComponent;
+
+/** 필드 하나를 등록할 때 넘기는 설정 */
+struct FHaroDOTFieldDesc
+{
+	FVector Center = FVector::ZeroVector;
+	/** 구 필드 반지름 (타겟 캡슐과 3D 거리로 비교) */
+	float Radius = 0.0f;
+
+	/**
+	 * 틱마다 적용할 Instant GE 스펙 (SetByCallerTag로 크기를 받아야 함)
+	 * 같은 GE + 같은 소스의 필드 여러 개에 겹친 타겟은 크기를 합산해서 한 번만 적용됨
+	 */
+	FGameplayEffectSpecHandle TickEffectSpec;
+	FGameplayTag SetByCallerTag;
+
+	/** 초당 크기 (틱 간격만큼 나눠서 적용) */
+	float MagnitudePerSecond = 0.0f;
+
+	/** 이 액터(보통 필드를 만든 무기/캐릭터)는 대상에서 제외 */
+	TWeakObjectPtr<AActor> IgnoredActor;
+
+	bool bCheckLineOfSight = false;
+};
+
+/** 마지막 필드 틱 통계 (stat HaroDOT에도 같은 값이 나옴) */
+struct FHaroDOTFieldTickStats
+{
+	int32 NumFields = 0;
+	int32 NumTargets = 0;
+	int32 NumApplications = 0;
+};
+
+/**
+ * 지속 데미지/회복 필드를 한곳에서 고정 간격으로 처리하는 월드 서브시스템 (서버 전용)
+ *
+ * 오버랩 시작/끝마다 Infinite GE를 붙였다 떼는 대신,
+ * 필드는 등록만 해두고 서브시스템이 Haro.DOT.TickInterval마다 모든 필드를 한 번에 평가함.
+ *  - 필드 볼륨은 XY 그리드 해시에 넣어두고, 타겟 위치가 속한 셀의 필드만 검사
+ *  - 타겟별로 겹친 필드의 크기를 합산해서 Instant 스펙 하나로 적용 (활성 GE 목록/복제 변경 없음)
+ *  - 필드 조회/제거는 소유 액터 기준 O(1)
+ */
+UCLASS()
+class LYRAGAME_API UHaroDOTFieldSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~USubsystem interface
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	//~FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	//~End of FTickableGameObject interface
+
+	/** 필드 등록 (같은 액터로 다시 등록하면 설정을 덮어씀) */
+	void RegisterField(AActor* FieldActor, const FHaroDOTFieldDesc& Desc);
+
+	/** 필드 제거 */
+	void UnregisterField(AActor* FieldActor);
+
+	/** 필드 위치 갱신 (움직이는 필드용) */
+	void UpdateFieldLocation(AActor* FieldActor, const FVector& NewCenter);
+
+	int32 GetNumFields() const { return FieldActors.Num(); }
+
+	const FHaroDOTFieldTickStats& GetLastTickStats() const { return LastTickStats; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void EvaluateFields(float Interval);
+	void RemoveFieldAt(int32 Index);
+	void RebuildSpatialHash();
+	FIntPoint GetCell(const FVector& Location) const;
+
+private:
+	// ========== 필드 (소유 액터 -> 인덱스, 제거는 RemoveAtSwap) ==========
+	TArray<TWeakObjectPtr<AActor>> FieldActors;
+	TArray<TObjectKey<AActor>> FieldKeys;
+	TArray<FHaroDOTFieldDesc> FieldDescs;
+	TMap<TObjectKey<AActor>, int32> FieldIndexByActor;
+
+	// ========== 공간 해시 (필드가 바뀔 때만 다시 만듦) ==========
+	TMap<FIntPoint, TArray<int32>> FieldCells;
+	float CellSize = 0.0f;
+	bool bSpatialHashDirty = false;
+
+	// ========== 재사용하는 임시 버퍼 ==========
+	struct FPendingApplication
+	{
+		int32 TemplateFieldIndex = INDEX_NONE;
+		float Magnitude = 0.0f;
+	};
+	TArray<FPendingApplication> ScratchApplications;
+
+	float TimeUntilNextEvaluation = 0.0f;
+
+	FHaroDOTFieldTickStats LastTickStats;
+};
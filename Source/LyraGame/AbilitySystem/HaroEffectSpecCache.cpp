@@ -0,0 +1,282 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HaroEffectSpecCache.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "Abilities/GameplayAbility.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameplayEffect.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTime.h"
+#include "LyraGameplayTags.h"
+#include "LyraLogChannels.h"
+#include "System/LyraAssetManager.h"
+#include "System/LyraGameData.h"
+
+FHaroEffectSpecCache::FEntry* FHaroEffectSpecCache::FindOrBuildEntry(UAbilitySystemComponent* SourceASC, const UGameplayAbility* Ability, TSubclassOf<UGameplayEffect> EffectClass, float Level, UObject* SourceObject, uint32 SourceSerial)
+{
+	if (!SourceASC || !EffectClass)
+	{
+		return nullptr;
+	}
+
+	FEntry* Entry = Entries.FindByPredicate([&](const FEntry& Candidate)
+	{
+		return (Candidate.EffectClass == EffectClass) && (Candidate.Level == Level) && (Candidate.SourceObject.Get() == SourceObject);
+	});
+
+	if (Entry && (Entry->SourceSerial == SourceSerial) && Entry->Template.IsValid())
+	{
+		return Entry;
+	}
+
+	if (!Entry)
+	{
+		Entry = &Entries.AddDefaulted_GetRef();
+		Entry->EffectClass = EffectClass;
+		Entry->Level = Level;
+		Entry->SourceObject = SourceObject;
+	}
+
+	// 장착 단위로 한 번만 컨텍스트를 만들고 소스 속성을 캡처함
+	FGameplayEffectContextHandle EffectContext = SourceASC->MakeEffectContext();
+	EffectContext.SetAbility(Ability);
+	EffectContext.AddSourceObject(SourceObject);
+
+	Entry->SourceSerial = SourceSerial;
+	Entry->Template = SourceASC->MakeOutgoingSpec(EffectClass, Level, EffectContext);
+	Entry->DerivedTag = FGameplayTag();
+	Entry->Derived.Clear();
+
+	++Stats.NumTemplatesBuilt;
+
+	return Entry;
+}
+
+FGameplayEffectSpecHandle FHaroEffectSpecCache::GetSpec(UAbilitySystemComponent* SourceASC, const UGameplayAbility* Ability, TSubclassOf<UGameplayEffect> EffectClass, float Level, UObject* SourceObject, uint32 SourceSerial)
+{
+	if (FEntry* Entry = FindOrBuildEntry(SourceASC, Ability, EffectClass, Level, SourceObject, SourceSerial))
+	{
+		++Stats.NumShared;
+		return Entry->Template;
+	}
+
+	return FGameplayEffectSpecHandle();
+}
+
+FGameplayEffectSpecHandle FHaroEffectSpecCache::GetSpecWithSetByCaller(UAbilitySystemComponent* SourceASC, const UGameplayAbility* Ability, TSubclassOf<UGameplayEffect> EffectClass, float Level, UObject* SourceObject, uint32 SourceSerial, FGameplayTag SetByCallerTag, float Magnitude)
+{
+	FEntry* Entry = FindOrBuildEntry(SourceASC, Ability, EffectClass, Level, SourceObject, SourceSerial);
+	if (!Entry || !Entry->Template.IsValid())
+	{
+		return FGameplayEffectSpecHandle();
+	}
+
+	// 같은 값이면 만들어둔 것을 공유
+	if (Entry->Derived.IsValid() && (Entry->DerivedTag == SetByCallerTag) && (Entry->DerivedMagnitude == Magnitude))
+	{
+		++Stats.NumShared;
+		return Entry->Derived;
+	}
+
+	// 스펙만 복사 (컨텍스트와 캡처한 속성은 템플릿과 같음)
+	FGameplayEffectSpecHandle Derived(new FGameplayEffectSpec(*Entry->Template.Data.Get()));
+	Derived.Data->SetSetByCallerMagnitude(SetByCallerTag, Magnitude);
+
+	Entry->DerivedTag = SetByCallerTag;
+	Entry->DerivedMagnitude = Magnitude;
+	Entry->Derived = Derived;
+
+	++Stats.NumDerived;
+
+	return Derived;
+}
+
+void FHaroEffectSpecCache::Reset()
+{
+	Entries.Reset();
+}
+
+FActiveGameplayEffectHandle FHaroEffectSpecCache::ApplySpecWithHitResult(UAbilitySystemComponent* TargetASC, const FGameplayEffectSpecHandle& SpecHandle, const FHitResult& HitResult)
+{
+	if (!TargetASC || !SpecHandle.IsValid())
+	{
+		return FActiveGameplayEffectHandle();
+	}
+
+	const FGameplayEffectSpec& Spec = *SpecHandle.Data.Get();
+
+	// 지속 GE는 활성 이펙트가 컨텍스트를 계속 들고 있고, 큐는 나중에(배치/지연) 컨텍스트를 읽을 수 있으므로
+	// 이런 경우에는 공유 컨텍스트를 덮어쓰면 안 됨
+	if (Spec.Def && ((Spec.Def->DurationPolicy != EGameplayEffectDurationType::Instant) || (Spec.Def->GameplayCues.Num() > 0)))
+	{
+		FGameplayEffectContextHandle OwnedContext = Spec.GetContext().Duplicate();
+		OwnedContext.AddHitResult(HitResult, /*bReset=*/ true);
+
+		FGameplayEffectSpec OwnedSpec(Spec);
+		OwnedSpec.SetContext(OwnedContext, /*bSkipRecaptureSourceActorTags=*/ true);
+
+		return TargetASC->ApplyGameplayEffectSpecToSelf(OwnedSpec);
+	}
+
+	// 큐가 없는 Instant GE는 적용하는 동안에만 컨텍스트를 읽음
+	FGameplayEffectContextHandle SharedContext = Spec.GetContext();
+	SharedContext.AddHitResult(HitResult, /*bReset=*/ true);
+
+	return TargetASC->ApplyGameplayEffectSpecToSelf(Spec);
+}
+
+FActiveGameplayEffectHandle FHaroEffectSpecCache::ApplySpecAtLevel(UAbilitySystemComponent* TargetASC, const FGameplayEffectSpecHandle& SpecHandle, float Level)
+{
+	if (!TargetASC || !SpecHandle.IsValid())
+	{
+		return FActiveGameplayEffectHandle();
+	}
+
+	FGameplayEffectSpec& Spec = *SpecHandle.Data.Get();
+	const float OriginalLevel = Spec.GetLevel();
+
+	Spec.SetLevel(Level);
+	const FActiveGameplayEffectHandle ActiveHandle = TargetASC->ApplyGameplayEffectSpecToSelf(Spec);
+	Spec.SetLevel(OriginalLevel);
+
+	return ActiveHandle;
+}
+
+#if !UE_BUILD_SHIPPING
+namespace HaroEffectSpecCacheBenchmark
+{
+	/**
+	 * 벤치마크 동안만 GMalloc 앞에 끼워넣어서 게임 스레드의 실제 할당 횟수를 세는 프록시
+	 * 다른 스레드의 할당은 그대로 넘기기만 함. 빼낸 뒤에도 다른 스레드가 호출 중일 수 있으므로 static으로 둠
+	 */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		void Install()
+		{
+			check(IsInGameThread() && (GMalloc != this));
+			Inner = GMalloc;
+			NumAllocations = 0;
+			GMalloc = this;
+		}
+
+		int64 Uninstall()
+		{
+			check(GMalloc == this);
+			GMalloc = Inner;
+			return NumAllocations;
+		}
+
+		virtual void* Malloc(SIZE_T Size, uint32 Alignment) override { CountAllocation(); return Inner->Malloc(Size, Alignment); }
+		virtual void* TryMalloc(SIZE_T Size, uint32 Alignment) override { CountAllocation(); return Inner->TryMalloc(Size, Alignment); }
+		virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override { CountAllocation(); return Inner->Realloc(Original, Size, Alignment); }
+		virtual void* TryRealloc(void* Original, SIZE_T Size, uint32 Alignment) override { CountAllocation(); return Inner->TryRealloc(Original, Size, Alignment); }
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual const TCHAR* GetDescriptiveName() override { return TEXT("HaroCountingMalloc"); }
+
+	private:
+		void CountAllocation()
+		{
+			if (IsInGameThread())
+			{
+				++NumAllocations;
+			}
+		}
+
+		FMalloc* Inner = nullptr;
+		int64 NumAllocations = 0;
+	};
+
+	static FCountingMalloc CountingMalloc;
+
+	static void Run(const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 NumShots = (Args.Num() > 0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+		const int32 NumTargetsPerShot = (Args.Num() > 1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 4;
+
+		APlayerController* PC = World ? World->GetFirstPlayerController() : nullptr;
+		UAbilitySystemComponent* SourceASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(PC ? PC->GetPawn() : nullptr);
+		const TSubclassOf<UGameplayEffect> EffectClass = ULyraAssetManager::GetSubclass(ULyraGameData::Get().DamageGameplayEffect_SetByCaller);
+		if (!SourceASC || !EffectClass || !SourceASC->IsOwnerActorAuthoritative())
+		{
+			UE_LOG(LogLyraAbilitySystem, Warning, TEXT("Haro.Ability.BenchmarkEffectSpecs needs an authoritative local pawn with an ability system component"));
+			return;
+		}
+
+		const FGameplayTag ChargeTag = LyraGameplayTags::SetByCaller_ChargeMultiplier;
+		const FGameplayTag DamageTag = LyraGameplayTags::SetByCaller_Damage;
+		UObject* SourceObject = PC->GetPawn();
+
+		// 두 방식 모두 로컬 폰에 실제로 적용함 (데미지 0이라 체력은 바뀌지 않음)
+
+		// 1. 예전 방식: 발사마다 컨텍스트 + MakeOutgoingSpec, AOE 대상마다 스펙 복사 후 적용
+		CountingMalloc.Install();
+		const double OldStart = FPlatformTime::Seconds();
+		for (int32 ShotIndex = 0; ShotIndex < NumShots; ++ShotIndex)
+		{
+			FGameplayEffectContextHandle EffectContext = SourceASC->MakeEffectContext();
+			EffectContext.AddSourceObject(SourceObject);
+			FGameplayEffectSpecHandle Spec = SourceASC->MakeOutgoingSpec(EffectClass, 1.0f, EffectContext);
+			Spec.Data->SetSetByCallerMagnitude(DamageTag, 0.0f);
+			Spec.Data->SetSetByCallerMagnitude(ChargeTag, 1.0f + (ShotIndex % 8) * 0.125f);
+
+			for (int32 TargetIndex = 0; TargetIndex < NumTargetsPerShot; ++TargetIndex)
+			{
+				FGameplayEffectSpec ModifiedSpec(*Spec.Data.Get());
+				ModifiedSpec.SetLevel(0.1f + TargetIndex * 0.2f);
+				SourceASC->ApplyGameplayEffectSpecToSelf(ModifiedSpec);
+			}
+		}
+		const double OldSeconds = FPlatformTime::Seconds() - OldStart;
+		const int64 OldAllocations = CountingMalloc.Uninstall();
+
+		// 2. 캐시: 템플릿 공유 + 차징 값이 바뀔 때만 복사, AOE 대상은 레벨만 잠깐 바꿔서 적용
+		FHaroEffectSpecCache Cache;
+		{
+			FGameplayEffectSpecHandle Template = Cache.GetSpec(SourceASC, nullptr, EffectClass, 1.0f, SourceObject, /*SourceSerial=*/ 1);
+			Template.Data->SetSetByCallerMagnitude(DamageTag, 0.0f);
+		}
+
+		CountingMalloc.Install();
+		const double NewStart = FPlatformTime::Seconds();
+		for (int32 ShotIndex = 0; ShotIndex < NumShots; ++ShotIndex)
+		{
+			FGameplayEffectSpecHandle Spec = Cache.GetSpecWithSetByCaller(SourceASC, nullptr, EffectClass, 1.0f, SourceObject, /*SourceSerial=*/ 1, ChargeTag, 1.0f + (ShotIndex % 8) * 0.125f);
+
+			for (int32 TargetIndex = 0; TargetIndex < NumTargetsPerShot; ++TargetIndex)
+			{
+				FHaroEffectSpecCache::ApplySpecAtLevel(SourceASC, Spec, 0.1f + TargetIndex * 0.2f);
+			}
+		}
+		const double NewSeconds = FPlatformTime::Seconds() - NewStart;
+		const int64 NewAllocations = CountingMalloc.Uninstall();
+
+		const FHaroEffectSpecCacheStats& Stats = Cache.GetStats();
+
+		UE_LOG(LogLyraAbilitySystem, Display, TEXT("Effect spec benchmark: %d shots x %d AOE targets applied, 8 distinct charge values (game thread allocations measured through GMalloc)"), NumShots, NumTargetsPerShot);
+		UE_LOG(LogLyraAbilitySystem, Display, TEXT("  Per-shot MakeOutgoingSpec: %.3f ms, %lld allocations"), OldSeconds * 1000.0, OldAllocations);
+		UE_LOG(LogLyraAbilitySystem, Display, TEXT("  Cached templates:          %.3f ms, %lld allocations (%d built, %d shared, %d derived)"),
+			NewSeconds * 1000.0, NewAllocations, Stats.NumTemplatesBuilt, Stats.NumShared, Stats.NumDerived);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs HaroBenchmarkEffectSpecsCmd(
+	TEXT("Haro.Ability.BenchmarkEffectSpecs"),
+	TEXT("Applies zero-damage specs to the local pawn, built per shot + copied per target vs. through FHaroEffectSpecCache, and reports time and measured allocations. Usage: Haro.Ability.BenchmarkEffectSpecs [NumShots=1000] [NumTargetsPerShot=4]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&HaroEffectSpecCacheBenchmark::Run));
+#endif // !UE_BUILD_SHIPPING
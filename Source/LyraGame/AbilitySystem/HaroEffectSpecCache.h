@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GameplayEffectTypes.h"
+#include "GameplayTagContainer.h"
+#include "Templates/SubclassOf.h"
+
+class UAbilitySystemComponent;
+class UGameplayAbility;
+class UGameplayEffect;
+struct FHitResult;
+
+/** 누적 캐시 통계 (Haro.Ability.BenchmarkEffectSpecs) */
+struct FHaroEffectSpecCacheStats
+{
+	/** MakeOutgoingSpec으로 템플릿을 만든 횟수 (컨텍스트 + 스펙 할당, 소스 속성 캡처) */
+	int32 NumTemplatesBuilt = 0;
+
+	/** 템플릿을 그대로 공유한 횟수 (할당 없음) */
+	int32 NumShared = 0;
+
+	/** 템플릿을 복사해서 SetByCaller만 바꾼 횟수 (스펙 할당 1번, 컨텍스트/캡처는 공유) */
+	int32 NumDerived = 0;
+};
+
+/**
+ * (GE 클래스, 레벨, 소스 오브젝트)마다 GE 스펙 템플릿을 한 번 만들어두고 발사마다 재사용하는 캐시
+ *
+ * 템플릿은 MakeOutgoingSpec으로 만들고 그때 소스 속성을 스냅샷함. 소스 오브젝트(무기)가 다시 장착되면
+ * (SourceSerial이 바뀌면) 새로 만듦. 반환되는 스펙은 여러 투사체/AOE가 같이 쓰므로 직접 수정하면 안 되고,
+ * 히트 결과/레벨처럼 대상마다 다른 값은 ApplySpecWithHitResult/ApplySpecAtLevel로 적용 직전에만 넣음.
+ */
+class LYRAGAME_API FHaroEffectSpecCache
+{
+public:
+	/** 템플릿을 그대로 반환 (없거나 다시 장착됐으면 새로 만듦) */
+	FGameplayEffectSpecHandle GetSpec(UAbilitySystemComponent* SourceASC, const UGameplayAbility* Ability, TSubclassOf<UGameplayEffect> EffectClass, float Level, UObject* SourceObject, uint32 SourceSerial);
+
+	/**
+	 * SetByCaller 하나만 템플릿과 다른 스펙 (쓸 때 복사)
+	 * 마지막으로 만든 파생 스펙과 값이 같으면 그것을 공유함
+	 */
+	FGameplayEffectSpecHandle GetSpecWithSetByCaller(UAbilitySystemComponent* SourceASC, const UGameplayAbility* Ability, TSubclassOf<UGameplayEffect> EffectClass, float Level, UObject* SourceObject, uint32 SourceSerial, FGameplayTag SetByCallerTag, float Magnitude);
+
+	void Reset();
+
+	const FHaroEffectSpecCacheStats& GetStats() const { return Stats; }
+
+	/**
+	 * 히트 결과를 넣어서 적용
+	 * 큐가 없는 Instant GE는 적용하는 동안에만 컨텍스트를 쓰므로 공유 컨텍스트에 덮어쓰고,
+	 * 지속 GE나 큐가 있는 GE는 컨텍스트를 복제함 (나중에 실행되는 큐가 다른 히트를 읽지 않도록)
+	 */
+	static FActiveGameplayEffectHandle ApplySpecWithHitResult(UAbilitySystemComponent* TargetASC, const FGameplayEffectSpecHandle& SpecHandle, const FHitResult& HitResult);
+
+	/** 레벨만 바꿔서 적용 (스펙을 복사하지 않고 잠깐 바꿨다가 되돌림, 적용할 때 ASC가 어차피 복사함) */
+	static FActiveGameplayEffectHandle ApplySpecAtLevel(UAbilitySystemComponent* TargetASC, const FGameplayEffectSpecHandle& SpecHandle, float Level);
+
+private:
+	struct FEntry
+	{
+		TSubclassOf<UGameplayEffect> EffectClass;
+		float Level = 0.0f;
+		TWeakObjectPtr<UObject> SourceObject;
+		uint32 SourceSerial = 0;
+
+		FGameplayEffectSpecHandle Template;
+
+		/** 마지막 파생 스펙 (투사체가 들고 있는 동안에는 새 값으로 바꿔도 그대로 살아 있음) */
+		FGameplayTag DerivedTag;
+		float DerivedMagnitude = 0.0f;
+		FGameplayEffectSpecHandle Derived;
+	};
+
+	FEntry* FindOrBuildEntry(UAbilitySystemComponent* SourceASC, const UGameplayAbility* Ability, TSubclassOf<UGameplayEffect> EffectClass, float Level, UObject* SourceObject, uint32 SourceSerial);
+
+private:
+	// 어빌리티 하나가 쓰는 GE는 보통 데미지/AOE 두 개라 선형 탐색
+	TArray<FEntry, TInlineAllocator<4>> Entries;
+
+	FHaroEffectSpecCacheStats Stats;
+};
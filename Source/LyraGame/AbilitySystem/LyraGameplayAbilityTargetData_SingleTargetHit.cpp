@@ -26,6 +26,8 @@ bool FLyraGameplayAbilityTargetData_SingleTargetHit::NetSerialize(FArchive& Ar,
 	FGameplayAbilityTargetData_SingleTargetHit::NetSerialize(Ar, Map, bOutSuccess);
 
 	Ar << CartridgeID;
+	Ar << Timestamp;
+	Ar << PelletIndex;
 
 	return true;
 }
@@ -18,6 +18,8 @@ struct FLyraGameplayAbilityTargetData_SingleTargetHit : public FGameplayAbilityT
 
 	FLyraGameplayAbilityTargetData_SingleTargetHit()
 		: CartridgeID(-1)
+		, Timestamp(0.0)
+		, PelletIndex(0)
 	{ }
 
 	virtual void AddTargetDataToContext(FGameplayEffectContextHandle& Context, bool bIncludeActorArray) const override;
@@ -26,6 +28,14 @@ struct FLyraGameplayAbilityTargetData_SingleTargetHit : public FGameplayAbilityT
 	UPROPERTY()
 	int32 CartridgeID;
 
+	/** Server world time at which the client fired, used by the server to rewind hitboxes when validating the hit */
+	UPROPERTY()
+	double Timestamp;
+
+	/** Which pellet of the cartridge produced this hit, so the server can regenerate that pellet's spread direction */
+	UPROPERTY()
+	uint8 PelletIndex;
+
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
 
 	virtual UScriptStruct* GetScriptStruct() const override
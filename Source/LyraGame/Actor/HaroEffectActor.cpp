@@ -4,6 +4,10 @@
 #include "HaroEffectActor.h"
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemBlueprintLibrary.h"
+#include "AbilitySystemGlobals.h"
+#include "AbilitySystem/HaroDOTFieldSubsystem.h"
+#include "GameplayEffect.h"
+#include "LyraGameplayTags.h"
 
 
 AHaroEffectActor::AHaroEffectActor()
@@ -17,6 +21,43 @@ void AHaroEffectActor::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// 필드 방식: 서버에서 서브시스템에 등록
+	if (FieldTickEffectClass && HasAuthority())
+	{
+		if (UHaroDOTFieldSubsystem* DOTFieldSubsystem = UWorld::GetSubsystem<UHaroDOTFieldSubsystem>(GetWorld()))
+		{
+			// 소스 ASC가 없으므로 스펙을 직접 생성
+			FGameplayEffectContextHandle EffectContextHandle(UAbilitySystemGlobals::Get().AllocGameplayEffectContext());
+			EffectContextHandle.AddSourceObject(this);
+
+			FHaroDOTFieldDesc FieldDesc;
+			FieldDesc.Center = GetActorLocation();
+			FieldDesc.Radius = FieldRadius;
+			FieldDesc.TickEffectSpec = FGameplayEffectSpecHandle(new FGameplayEffectSpec(FieldTickEffectClass.GetDefaultObject(), EffectContextHandle, ActorLevel));
+			FieldDesc.SetByCallerTag = FieldSetByCallerTag.IsValid() ? FieldSetByCallerTag : LyraGameplayTags::SetByCaller_Damage;
+			FieldDesc.MagnitudePerSecond = FieldMagnitudePerSecond;
+
+			DOTFieldSubsystem->RegisterField(this, FieldDesc);
+
+			// 움직이는 필드 (부착 등)
+			GetRootComponent()->TransformUpdated.AddUObject(this, &ThisClass::HandleFieldRootTransformUpdated);
+		}
+	}
+}
+
+void AHaroEffectActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (FieldTickEffectClass)
+	{
+		GetRootComponent()->TransformUpdated.RemoveAll(this);
+
+		if (UHaroDOTFieldSubsystem* DOTFieldSubsystem = UWorld::GetSubsystem<UHaroDOTFieldSubsystem>(GetWorld()))
+		{
+			DOTFieldSubsystem->UnregisterField(this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AHaroEffectActor::ApplyEffectToTarget(AActor* TargetActor, TSubclassOf<UGameplayEffect> GameplayEffectClass)
@@ -45,12 +86,26 @@ void AHaroEffectActor::ApplyEffectToTarget(AActor* TargetActor, TSubclassOf<UGam
 	 {
 		 // 맵으로 관리하는 이유?
 		 // 다중 타겟을 지원하기 위함, ex. 여러 플레이어가 동시에 버프 구역 안에 있음.
-		 ActiveEffectHandles.Add(ActiveEffectHandle, TargetASC);
+		 ActiveEffectHandles.FindOrAdd(TargetASC).Add(ActiveEffectHandle);
 	 }
 }
 
+void AHaroEffectActor::HandleFieldRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	if (UHaroDOTFieldSubsystem* DOTFieldSubsystem = UWorld::GetSubsystem<UHaroDOTFieldSubsystem>(GetWorld()))
+	{
+		DOTFieldSubsystem->UpdateFieldLocation(this, UpdatedComponent->GetComponentLocation());
+	}
+}
+
 void AHaroEffectActor::OnOverlap(AActor* TargetActor)
 {
+	// 필드 방식이면 서브시스템이 적용하므로 오버랩 적용은 건너뜀 (중첩 방지)
+	if (FieldTickEffectClass)
+	{
+		return;
+	}
+
 	if (InstantEffectApplicationPolicy == EEffectApplicationPolicy::ApplyOnOverlap)
 	{
 		ApplyEffectToTarget(TargetActor, InstantGameplayEffectClass);
@@ -67,6 +122,11 @@ void AHaroEffectActor::OnOverlap(AActor* TargetActor)
 
 void AHaroEffectActor::OnEndOverlap(AActor* TargetActor)
 {
+	if (FieldTickEffectClass)
+	{
+		return;
+	}
+
 	if (InstantEffectApplicationPolicy == EEffectApplicationPolicy::ApplyOnEndOverlap)
 	{
 		ApplyEffectToTarget(TargetActor, InstantGameplayEffectClass);
@@ -84,20 +144,14 @@ void AHaroEffectActor::OnEndOverlap(AActor* TargetActor)
 		UAbilitySystemComponent* TargetASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(TargetActor);
 		if (!IsValid(TargetASC)) return;
 
-		TArray<FActiveGameplayEffectHandle> HandlesToRemove; // for문 중에 요소를 삭제하면 문제 생기므로 이를 이용.
-		for (auto HandlePair : ActiveEffectHandles)
+		// 타겟 ASC로 바로 찾아서 제거
+		TArray<FActiveGameplayEffectHandle, TInlineAllocator<1>> HandlesToRemove;
+		if (ActiveEffectHandles.RemoveAndCopyValue(TargetASC, HandlesToRemove))
 		{
-			if (TargetASC == HandlePair.Value)
+			for (const FActiveGameplayEffectHandle& Handle : HandlesToRemove)
 			{
-				TargetASC->RemoveActiveGameplayEffect(HandlePair.Key, 1); // 스택을 한 개만 제거.
-				HandlesToRemove.Add(HandlePair.Key);
+				TargetASC->RemoveActiveGameplayEffect(Handle, 1); // 스택을 한 개만 제거.
 			}
 		}
-		// 별도 루프에서 맵에서 제거 (반복 중 삭제 방지)
-		for (auto& Handle : HandlesToRemove)
-		{
-			ActiveEffectHandles.FindAndRemoveChecked(Handle);
-		}
-
 	}
 }
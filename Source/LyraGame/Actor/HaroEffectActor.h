@@ -35,6 +35,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UFUNCTION(BlueprintCallable)
 	void ApplyEffectToTarget(AActor* TargetActor, TSubclassOf<UGameplayEffect> GameplayEffectClass);
@@ -45,6 +46,9 @@ protected:
 	UFUNCTION(BlueprintCallable)
 	void OnEndOverlap(AActor* TargetActor);
 
+	// 필드 방식일 때 액터가 움직이면 서브시스템의 필드 중심도 옮김
+	void HandleFieldRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
 protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effects")
 	bool bDestroyOnEffectRemoval = false;
@@ -70,8 +74,24 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effects")
 	EEffectRemovalPolicy InfiniteEffectRemovalPolicy = EEffectRemovalPolicy::RemoveOnEndOverlap;
 
-	TMap<FActiveGameplayEffectHandle, UAbilitySystemComponent*> ActiveEffectHandles;
+	// 타겟 ASC -> 적용한 Infinite 이펙트 핸들들 (EndOverlap에서 바로 찾기 위함)
+	TMap<TWeakObjectPtr<UAbilitySystemComponent>, TArray<FActiveGameplayEffectHandle, TInlineAllocator<1>>> ActiveEffectHandles;
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effects")
 	float ActorLevel = 1.f;
+
+	// 설정하면 UHaroDOTFieldSubsystem이 범위 안의 캐릭터에게 일정 간격으로 이 Instant GE를 적용함 (오버랩 불필요)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effects|Field")
+	TSubclassOf<UGameplayEffect> FieldTickEffectClass;
+
+	// 필드 반지름
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effects|Field", meta = (EditCondition = "FieldTickEffectClass != nullptr"))
+	float FieldRadius = 200.f;
+
+	// 초당 크기 (FieldSetByCallerTag로 전달)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effects|Field", meta = (EditCondition = "FieldTickEffectClass != nullptr"))
+	float FieldMagnitudePerSecond = 10.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effects|Field", meta = (EditCondition = "FieldTickEffectClass != nullptr", Categories = "SetByCaller"))
+	FGameplayTag FieldSetByCallerTag;
 };
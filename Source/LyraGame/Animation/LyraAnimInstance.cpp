@@ -7,6 +7,7 @@
 
 #include "Camera/LyraCameraComponent.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Components/SkeletalMeshComponent.h"
 #include "Weapons/HaroWeaponBase.h"
 
 #if WITH_EDITOR
@@ -28,6 +29,27 @@ void ULyraAnimInstance::InitializeWithAbilitySystem(UAbilitySystemComponent* ASC
 	GameplayTagPropertyMap.Initialize(this, ASC);
 }
 
+void ULyraAnimInstance::SetSignificanceFrameSkip(int32 FrameSkip)
+{
+	USkeletalMeshComponent* MeshComp = GetSkelMeshComponent();
+	if (!MeshComp || !MeshComp->bEnableUpdateRateOptimizations || !MeshComp->AnimUpdateRateParams)
+	{
+		return;
+	}
+
+	// Drive the update rate optimization through its LOD map, using the same frame skip for every LOD so
+	// significance replaces the default distance based rates (human controlled meshes are still never skipped)
+	FAnimUpdateRateParameters& UpdateRateParams = *MeshComp->AnimUpdateRateParams;
+	UpdateRateParams.bShouldUseLodMap = true;
+	UpdateRateParams.LODToFrameSkipMap.Reset();
+
+	const int32 NumLODs = FMath::Max(MeshComp->GetNumLODs(), 1);
+	for (int32 LODIndex = 0; LODIndex < NumLODs; ++LODIndex)
+	{
+		UpdateRateParams.LODToFrameSkipMap.Add(LODIndex, FrameSkip);
+	}
+}
+
 #if WITH_EDITOR
 EDataValidationResult ULyraAnimInstance::IsDataValid(FDataValidationContext& Context) const
 {
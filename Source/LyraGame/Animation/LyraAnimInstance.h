@@ -25,6 +25,10 @@ public:
 
 	virtual void InitializeWithAbilitySystem(UAbilitySystemComponent* ASC);
 
+	// Sets how many frames the owning mesh skips between animation updates (driven by ULyraSignificanceManager)
+	// Locally controlled characters always update every frame
+	void SetSignificanceFrameSkip(int32 FrameSkip);
+
 protected:
 
 #if WITH_EDITOR
@@ -16,6 +16,7 @@
 #include "Player/LyraPlayerState.h"
 #include "System/LyraSignificanceManager.h"
 #include "TimerManager.h"
+#include "Weapons/HaroLagCompensationSubsystem.h"
 
 #include "Animation/LyraAnimInstance.h"
 
@@ -108,7 +109,16 @@ void ALyraCharacter::BeginPlay()
 	{
 		if (ULyraSignificanceManager* SignificanceManager = USignificanceManager::Get<ULyraSignificanceManager>(World))
 		{
-//@TODO: SignificanceManager->RegisterObject(this, (EFortSignificanceType)SignificanceType);
+			SignificanceManager->RegisterActor(this, ULyraSignificanceManager::CharacterTag);
+		}
+	}
+
+	// 서버 히트 검증용 히트박스 기록
+	if (HasAuthority())
+	{
+		if (UHaroLagCompensationSubsystem* LagCompensation = UWorld::GetSubsystem<UHaroLagCompensationSubsystem>(World))
+		{
+			LagCompensation->RegisterPawn(this);
 		}
 	}
 }
@@ -124,9 +134,14 @@ void ALyraCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	{
 		if (ULyraSignificanceManager* SignificanceManager = USignificanceManager::Get<ULyraSignificanceManager>(World))
 		{
-			SignificanceManager->UnregisterObject(this);
+			SignificanceManager->UnregisterActor(this);
 		}
 	}
+
+	if (UHaroLagCompensationSubsystem* LagCompensation = UWorld::GetSubsystem<UHaroLagCompensationSubsystem>(World))
+	{
+		LagCompensation->UnregisterPawn(this);
+	}
 }
 
 void ALyraCharacter::Reset()
@@ -45,6 +45,7 @@ void UHaroSkillData::RefreshSkillCache()
 {
 	CachedSkillsByTag.Empty();
 	CachedAbilityClassToSkillID.Empty();
+	bCompiledSkillGraphDirty = true;
 
 	CacheDefaultSkills(DefaultSkillDataTable);
 	CacheSkillsByCategory(WeaponSkillDataTable);
@@ -125,5 +126,100 @@ FName UHaroSkillData::FindSkillIDByAbilityClass(TSubclassOf<ULyraGameplayAbility
 	return NAME_None;
 }
 
+TSoftClassPtr<ULyraGameplayAbility> UHaroSkillData::FindAbilityClassBySkillID(const FName& SkillID) const
+{
+	const FHaroCompiledSkillGraph& SkillGraph = GetCompiledSkillGraph();
+
+	const int32 SkillIndex = SkillGraph.FindSkillIndex(SkillID);
+	return (SkillIndex != INDEX_NONE) ? SkillGraph.Skills[SkillIndex].SkillData.AbilityClass : TSoftClassPtr<ULyraGameplayAbility>();
+}
+
+const FHaroCompiledSkillGraph& UHaroSkillData::GetCompiledSkillGraph() const
+{
+	if (bCompiledSkillGraphDirty)
+	{
+		CompileSkillGraph();
+	}
+
+	return CompiledSkillGraph;
+}
 
+void UHaroSkillData::CompileSkillGraph() const
+{
+	FHaroCompiledSkillGraph& Graph = CompiledSkillGraph;
+	Graph = FHaroCompiledSkillGraph();
+
+	// 1. 모든 스킬에 dense 인덱스 부여 (필수/충돌 조건이 디폴트 스킬을 가리킬 수 있으므로 둘 다 포함)
+	auto AddSkillsFromTable = [&Graph](UDataTable* Table, bool bOfferable)
+	{
+		if (!Table)
+		{
+			return;
+		}
+
+		Table->ForeachRow<FHaroSkillDataRow>("CompileSkillGraph",
+			[&Graph, bOfferable](const FName& RowName, const FHaroSkillDataRow& Row)
+			{
+				if (Graph.SkillIndexByID.Contains(RowName))
+				{
+					return true;
+				}
+
+				const int32 SkillIndex = Graph.Skills.Num();
+				FHaroSkillDataEntry& Entry = Graph.Skills.AddDefaulted_GetRef();
+				Entry.SkillID = RowName;
+				Entry.SkillData = Row;
+				Graph.SkillIndexByID.Add(RowName, SkillIndex);
 
+				if (bOfferable && Row.CategoryTag.IsValid())
+				{
+					Graph.SkillIndicesByTag.FindOrAdd(Row.CategoryTag).Add(SkillIndex);
+				}
+
+				return true;
+			});
+	};
+
+	AddSkillsFromTable(DefaultSkillDataTable, /*bOfferable=*/ false);
+	AddSkillsFromTable(WeaponSkillDataTable, /*bOfferable=*/ true);
+
+	// 2. 필수/충돌 관계를 비트셋으로
+	const int32 NumSkills = Graph.NumSkills();
+	Graph.RequiredMasks.SetNum(NumSkills);
+	Graph.ConflictMasks.SetNum(NumSkills);
+
+	for (int32 SkillIndex = 0; SkillIndex < NumSkills; ++SkillIndex)
+	{
+		const FHaroSkillDataRow& Row = Graph.Skills[SkillIndex].SkillData;
+
+		FHaroSkillBitSet& RequiredMask = Graph.RequiredMasks[SkillIndex];
+		RequiredMask.Init(NumSkills);
+		for (const FName& RequiredSkillID : Row.RequiredSkillIDs)
+		{
+			const int32 RequiredIndex = Graph.FindSkillIndex(RequiredSkillID);
+			if (RequiredIndex == INDEX_NONE)
+			{
+				// 없는 스킬이 필수면 절대 나오면 안 되므로 자기 자신을 필수로 (보유 중이면 어차피 제외됨)
+				UE_LOG(LogTemp, Warning, TEXT("[SkillData] %s requires unknown skill %s"), *Graph.Skills[SkillIndex].SkillID.ToString(), *RequiredSkillID.ToString());
+				RequiredMask.Set(SkillIndex);
+				continue;
+			}
+			RequiredMask.Set(RequiredIndex);
+		}
+
+		FHaroSkillBitSet& ConflictMask = Graph.ConflictMasks[SkillIndex];
+		ConflictMask.Init(NumSkills);
+		for (const FName& ConflictSkillID : Row.ConflictSkillIDs)
+		{
+			const int32 ConflictIndex = Graph.FindSkillIndex(ConflictSkillID);
+			if (ConflictIndex != INDEX_NONE)
+			{
+				ConflictMask.Set(ConflictIndex);
+			}
+		}
+	}
+
+	bCompiledSkillGraphDirty = false;
+
+	UE_LOG(LogTemp, Log, TEXT("[SkillData] Compiled skill graph: %d skills, %d categories"), NumSkills, Graph.SkillIndicesByTag.Num());
+}
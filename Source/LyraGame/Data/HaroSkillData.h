@@ -31,6 +31,100 @@ struct FHaroSkillDataArray
 	// 편의 함수들
 };
 
+/**
+ * 스킬 dense ID용 비트셋
+ * 스킬 256개까지는 인라인 저장이라 할당 없음, 조건 검사는 워드 단위 연산
+ */
+struct FHaroSkillBitSet
+{
+	void Init(int32 NumBits)
+	{
+		Words.Reset();
+		Words.SetNumZeroed(FMath::DivideAndRoundUp(NumBits, 64));
+	}
+
+	void Set(int32 Index, bool bValue = true)
+	{
+		if (Words.IsValidIndex(Index >> 6))
+		{
+			const uint64 Mask = uint64(1) << (Index & 63);
+			Words[Index >> 6] = bValue ? (Words[Index >> 6] | Mask) : (Words[Index >> 6] & ~Mask);
+		}
+	}
+
+	bool Test(int32 Index) const
+	{
+		return Words.IsValidIndex(Index >> 6) && ((Words[Index >> 6] >> (Index & 63)) & 1);
+	}
+
+	/** Other의 비트를 모두 갖고 있는지 */
+	bool ContainsAll(const FHaroSkillBitSet& Other) const
+	{
+		for (int32 WordIndex = 0; WordIndex < Other.Words.Num(); ++WordIndex)
+		{
+			const uint64 Mine = Words.IsValidIndex(WordIndex) ? Words[WordIndex] : 0;
+			if ((Other.Words[WordIndex] & ~Mine) != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** 겹치는 비트가 하나라도 있는지 */
+	bool Intersects(const FHaroSkillBitSet& Other) const
+	{
+		const int32 NumWords = FMath::Min(Words.Num(), Other.Words.Num());
+		for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+		{
+			if ((Words[WordIndex] & Other.Words[WordIndex]) != 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	TArray<uint64, TInlineAllocator<4>> Words;
+};
+
+/**
+ * 조회 전용으로 컴파일된 스킬 그래프 (런타임에 한 번 만듦, 저장 안 됨)
+ * 모든 스킬(디폴트 + 카테고리)에 0부터 시작하는 dense 인덱스를 부여하고
+ * 필수/충돌 관계를 비트셋으로 바꿔둠.
+ */
+struct FHaroCompiledSkillGraph
+{
+	// dense 인덱스 -> 스킬
+	TArray<FHaroSkillDataEntry> Skills;
+
+	// dense 인덱스 -> 필수/충돌 스킬 비트셋
+	TArray<FHaroSkillBitSet> RequiredMasks;
+	TArray<FHaroSkillBitSet> ConflictMasks;
+
+	// SkillID -> dense 인덱스
+	TMap<FName, int32> SkillIndexByID;
+
+	// 카테고리 태그 -> 선택지로 나올 수 있는 스킬 인덱스들
+	TMap<FGameplayTag, TArray<int32>> SkillIndicesByTag;
+
+	int32 NumSkills() const { return Skills.Num(); }
+
+	int32 FindSkillIndex(const FName& SkillID) const
+	{
+		const int32* Found = SkillIndexByID.Find(SkillID);
+		return Found ? *Found : INDEX_NONE;
+	}
+
+	/** 보유 스킬 비트셋 기준으로 선택 가능한지 (미보유 + 필수 전부 보유 + 충돌 없음) */
+	bool IsSkillEligible(int32 SkillIndex, const FHaroSkillBitSet& OwnedSkills) const
+	{
+		return !OwnedSkills.Test(SkillIndex)
+			&& OwnedSkills.ContainsAll(RequiredMasks[SkillIndex])
+			&& !OwnedSkills.Intersects(ConflictMasks[SkillIndex]);
+	}
+};
+
 /**
  * 스킬 데이터를 GameplayTag 기반으로 캐싱하여 관리하는 클래스
  * DataTable을 사용하되 자주 조회하는 카테고리들을 PreSave에서 미리 캐싱
@@ -63,6 +157,7 @@ private:
 	void RefreshSkillCache();
 	void CacheDefaultSkills(UDataTable* Table);
 	void CacheSkillsByCategory(UDataTable* Table);
+	void CompileSkillGraph() const;
 
 public:
 	UFUNCTION(BlueprintCallable)
@@ -72,6 +167,12 @@ public:
 	UFUNCTION(BlueprintCallable)
 	FName FindSkillIDByAbilityClass(TSubclassOf<ULyraGameplayAbility> AbilityClass) const;
 
+	// SkillID로 어빌리티 클래스 경로 찾기 (로드는 하지 않음)
+	TSoftClassPtr<ULyraGameplayAbility> FindAbilityClassBySkillID(const FName& SkillID) const;
+
+	// 선택지 생성용 컴파일된 그래프 (처음 접근할 때 만듦)
+	const FHaroCompiledSkillGraph& GetCompiledSkillGraph() const;
+
 public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 	TObjectPtr<UDataTable> DefaultSkillDataTable; // 미리 로드됨.
@@ -90,4 +191,8 @@ private:
 	// AbilityClass → SkillID 캐시 (디폴트 스킬들만)
 	UPROPERTY()
 	TMap<TSubclassOf<ULyraGameplayAbility>, FName> CachedAbilityClassToSkillID;
+
+	// 컴파일된 스킬 그래프 (RefreshSkillCache 이후 처음 조회할 때 다시 만듦)
+	mutable FHaroCompiledSkillGraph CompiledSkillGraph;
+	mutable bool bCompiledSkillGraphDirty = true;
 };
@@ -34,6 +34,8 @@ FString FHaroAppliedEquipmentEntry::GetDebugString() const
 
 void FHaroEquipmentList::PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize)
 {
+	MarkIndexDirty();
+
 	for (int32 Index : RemovedIndices)
 	{
 		const FHaroAppliedEquipmentEntry& Entry = Entries[Index];
@@ -46,6 +48,8 @@ void FHaroEquipmentList::PreReplicatedRemove(const TArrayView<int32> RemovedIndi
 
 void FHaroEquipmentList::PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize)
 {
+	MarkIndexDirty();
+
 	for (int32 Index : AddedIndices)
 	{
 		const FHaroAppliedEquipmentEntry& Entry = Entries[Index];
@@ -58,6 +62,8 @@ void FHaroEquipmentList::PostReplicatedAdd(const TArrayView<int32> AddedIndices,
 
 void FHaroEquipmentList::PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize)
 {
+	MarkIndexDirty();
+
 	// 클라이언트에서 bIsActive가 변경되면 여기가 자동 실행됨!
 	for (int32 Index : ChangedIndices)
 	{
@@ -95,6 +101,99 @@ void FHaroEquipmentList::PostReplicatedChange(const TArrayView<int32> ChangedInd
 	}
 }
 
+void FHaroEquipmentList::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	// PreReplicatedRemove 이후 실제 제거가 끝난 시점
+	MarkIndexDirty();
+}
+
+void FHaroEquipmentList::MarkIndexDirty()
+{
+	bIndexDirty = true;
+	ActiveInstanceByClass.Reset();
+}
+
+void FHaroEquipmentList::RebuildIndexIfNeeded() const
+{
+	if (!bIndexDirty)
+	{
+		return;
+	}
+
+	SlotToEntryIndex.Reset();
+	ActiveEntryIndices.Reset();
+	ActiveInstanceByClass.Reset();
+
+	for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+	{
+		const FHaroAppliedEquipmentEntry& Entry = Entries[EntryIndex];
+
+		if (Entry.SlotIndex >= 0)
+		{
+			while (SlotToEntryIndex.Num() <= Entry.SlotIndex)
+			{
+				SlotToEntryIndex.Add(INDEX_NONE);
+			}
+
+			// 같은 슬롯이 여러 개면 기존처럼 앞쪽 항목 우선
+			if (SlotToEntryIndex[Entry.SlotIndex] == INDEX_NONE)
+			{
+				SlotToEntryIndex[Entry.SlotIndex] = EntryIndex;
+			}
+		}
+
+		if (Entry.bIsActive && (Entry.Instance != nullptr))
+		{
+			ActiveEntryIndices.Add(EntryIndex);
+		}
+	}
+
+	bIndexDirty = false;
+}
+
+int32 FHaroEquipmentList::FindEntryIndexBySlot(int32 SlotIndex) const
+{
+	if (SlotIndex < 0)
+	{
+		// 슬롯이 없는 장비는 인덱스에 없으므로 직접 찾음
+		return Entries.IndexOfByPredicate([SlotIndex](const FHaroAppliedEquipmentEntry& Entry) { return Entry.SlotIndex == SlotIndex; });
+	}
+
+	RebuildIndexIfNeeded();
+
+	return SlotToEntryIndex.IsValidIndex(SlotIndex) ? SlotToEntryIndex[SlotIndex] : INDEX_NONE;
+}
+
+FHaroAppliedEquipmentEntry* FHaroEquipmentList::FindEntryBySlot(int32 SlotIndex)
+{
+	const int32 EntryIndex = FindEntryIndexBySlot(SlotIndex);
+	return (EntryIndex != INDEX_NONE) ? &Entries[EntryIndex] : nullptr;
+}
+
+ULyraEquipmentInstance* FHaroEquipmentList::FindFirstActiveInstanceOfType(TSubclassOf<ULyraEquipmentInstance> InstanceType) const
+{
+	RebuildIndexIfNeeded();
+
+	if (ULyraEquipmentInstance* const* CachedInstance = ActiveInstanceByClass.Find(InstanceType.Get()))
+	{
+		return *CachedInstance;
+	}
+
+	ULyraEquipmentInstance* Result = nullptr;
+	for (const int32 EntryIndex : ActiveEntryIndices)
+	{
+		ULyraEquipmentInstance* Instance = Entries[EntryIndex].Instance;
+		if (Instance && Instance->IsA(InstanceType))
+		{
+			Result = Instance;
+			break;
+		}
+	}
+
+	ActiveInstanceByClass.Add(InstanceType.Get(), Result);
+	return Result;
+}
+
 ULyraAbilitySystemComponent* FHaroEquipmentList::GetAbilitySystemComponent() const
 {
 	check(OwnerComponent);
@@ -252,34 +351,35 @@ ULyraEquipmentInstance* FHaroEquipmentList::AddEntry(TSubclassOf<ULyraEquipmentD
 
 
 	MarkItemDirty(NewEntry); // 이 아이템이 변경되었으니 클라이언트들에게 복제해달라고 함.
+	MarkIndexDirty();
 
 	return Result;
 }
 
 void FHaroEquipmentList::RemoveEntry(int32 SlotIndex)
 {
-	// CreateIterator : 배열을 안전하게 순회하면서 요소를 제거할 수 있는 반복자 생성
-	// 일반 for문으로 제거하는 것이랑 다르게 안전한 방법임. (인덱스 조정 같은 것을 해줌.)
-	for (auto EntryIt = Entries.CreateIterator(); EntryIt; ++EntryIt)
+	const int32 EntryIndex = FindEntryIndexBySlot(SlotIndex);
+	if (EntryIndex == INDEX_NONE)
 	{
-		FHaroAppliedEquipmentEntry& Entry = *EntryIt;
-		if (Entry.SlotIndex == SlotIndex)
-		{
-			// ⭐ 스킬 매핑 해제 (Ability 제거 전에)
-			UnregisterSkillHandles(Entry);
+		return;
+	}
 
-			if (ULyraAbilitySystemComponent* ASC = GetAbilitySystemComponent())
-			{
-				Entry.GrantedHandles.TakeFromAbilitySystem(ASC);
-			}
+	FHaroAppliedEquipmentEntry& Entry = Entries[EntryIndex];
 
-			Entry.Instance->DestroyEquipmentActors();
+	// ⭐ 스킬 매핑 해제 (Ability 제거 전에)
+	UnregisterSkillHandles(Entry);
 
-			EntryIt.RemoveCurrent();
-			MarkArrayDirty();
-			return;
-		}
+	if (ULyraAbilitySystemComponent* ASC = GetAbilitySystemComponent())
+	{
+		Entry.GrantedHandles.TakeFromAbilitySystem(ASC);
 	}
+
+	Entry.Instance->DestroyEquipmentActors();
+
+	// 순서 유지 (클라이언트 쪽 순서와 맞추기 위함)
+	Entries.RemoveAt(EntryIndex);
+	MarkArrayDirty();
+	MarkIndexDirty();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -328,72 +428,68 @@ ULyraEquipmentInstance* UHaroEquipmentManagerComponent::EquipItem(TSubclassOf<UL
 
 void UHaroEquipmentManagerComponent::UnequipItem(int32 SlotIndex)
 {
-	for (FHaroAppliedEquipmentEntry& Entry : EquipmentList.Entries)
+	if (FHaroAppliedEquipmentEntry* Entry = EquipmentList.FindEntryBySlot(SlotIndex))
 	{
-		if (Entry.SlotIndex == SlotIndex)
+		if (IsUsingRegisteredSubObjectList())
 		{
-			if (IsUsingRegisteredSubObjectList())
-			{
-				RemoveReplicatedSubObject(Entry.Instance);
-			}
-
-			Entry.Instance->OnUnequipped();
-			EquipmentList.RemoveEntry(SlotIndex);
-			return;
+			RemoveReplicatedSubObject(Entry->Instance);
 		}
+
+		Entry->Instance->OnUnequipped();
+		EquipmentList.RemoveEntry(SlotIndex);
 	}
 }
 
 void UHaroEquipmentManagerComponent::SetItemActiveState(int32 SlotIndex, bool bActive)
 {
-	for (FHaroAppliedEquipmentEntry& Entry : EquipmentList.Entries)
+	FHaroAppliedEquipmentEntry* EntryPtr = EquipmentList.FindEntryBySlot(SlotIndex);
+	if (!EntryPtr)
+		return;
+
+	FHaroAppliedEquipmentEntry& Entry = *EntryPtr;
+
+	// 이미 원하는 상태면 스킵
+	if (Entry.bIsActive == bActive)
+		return;
+
+	if (bActive)
 	{
-		if (Entry.SlotIndex == SlotIndex)
+		// 활성화: 먼저 보이기 → 그 다음 OnEquipped
+		for (AActor* Actor : Entry.Instance->GetSpawnedActors())
 		{
-			// 이미 원하는 상태면 스킵
-			if (Entry.bIsActive == bActive)
-				return;
-
-			if (bActive)
+			if (Actor)
 			{
-				// 활성화: 먼저 보이기 → 그 다음 OnEquipped
-				for (AActor* Actor : Entry.Instance->GetSpawnedActors())
-				{
-					if (Actor)
-					{
-						Actor->SetActorHiddenInGame(false);
-						Actor->SetActorEnableCollision(true);
+				Actor->SetActorHiddenInGame(false);
+				Actor->SetActorEnableCollision(true);
 
-						// 무기인 경우 OnWeaponActivated 호출
-						if (AHaroWeaponBase* Weapon = Cast<AHaroWeaponBase>(Actor))
-						{
-							Weapon->OnWeaponActivated();
-						}
-					}
+				// 무기인 경우 OnWeaponActivated 호출
+				if (AHaroWeaponBase* Weapon = Cast<AHaroWeaponBase>(Actor))
+				{
+					Weapon->OnWeaponActivated();
 				}
-				Entry.Instance->OnEquipped();
 			}
-			else
+		}
+		Entry.Instance->OnEquipped();
+	}
+	else
+	{
+		// 비활성화: 먼저 OnUnequipped → 그 다음 숨기기
+		//Entry.Instance->OnUnequipped(); // 이거 필요 없을 수도 있음. (TEMP)
+		for (AActor* Actor : Entry.Instance->GetSpawnedActors())
+		{
+			if (Actor)
 			{
-				// 비활성화: 먼저 OnUnequipped → 그 다음 숨기기
-				//Entry.Instance->OnUnequipped(); // 이거 필요 없을 수도 있음. (TEMP)
-				for (AActor* Actor : Entry.Instance->GetSpawnedActors())
-				{
-					if (Actor)
-					{
-						Actor->SetActorHiddenInGame(true);
-						Actor->SetActorEnableCollision(false);
-					}
-				}
+				Actor->SetActorHiddenInGame(true);
+				Actor->SetActorEnableCollision(false);
 			}
-
-			// 상태 플래그 설정
-			Entry.Instance->bIsActive = bActive;
-			Entry.bIsActive = bActive;
-			EquipmentList.MarkItemDirty(Entry);
-			return;
 		}
 	}
+
+	// 상태 플래그 설정
+	Entry.Instance->bIsActive = bActive;
+	Entry.bIsActive = bActive;
+	EquipmentList.MarkItemDirty(Entry);
+	EquipmentList.MarkIndexDirty();
 }
 
 void UHaroEquipmentManagerComponent::ActivateItem(int32 SlotIndex)
@@ -489,21 +585,14 @@ ULyraEquipmentInstance* UHaroEquipmentManagerComponent::GetFirstInstanceOfType(T
 
 ULyraEquipmentInstance* UHaroEquipmentManagerComponent::GetFirstActiveInstanceOfType(TSubclassOf<ULyraEquipmentInstance> InstanceType)
 {
-	for (const FHaroAppliedEquipmentEntry& Entry : EquipmentList.Entries)
-	{
-		if (Entry.bIsActive) // 먼저 활성화 체크
-		{
-			if (ULyraEquipmentInstance* Instance = Entry.Instance)
-			{
-				if (Instance->IsA(InstanceType))
-				{
-					return Instance;
-				}
-			}
-		}
-	}
+	// 활성 인스턴스만 보고, 결과는 클래스별로 캐싱됨
+	return EquipmentList.FindFirstActiveInstanceOfType(InstanceType);
+}
 
-	return nullptr;
+ULyraEquipmentInstance* UHaroEquipmentManagerComponent::GetInstanceInSlot(int32 SlotIndex) const
+{
+	const int32 EntryIndex = EquipmentList.FindEntryIndexBySlot(SlotIndex);
+	return (EntryIndex != INDEX_NONE) ? EquipmentList.Entries[EntryIndex].Instance.Get() : nullptr;
 }
 
 TArray<ULyraEquipmentInstance*> UHaroEquipmentManagerComponent::GetEquipmentInstancesOfType(TSubclassOf<ULyraEquipmentInstance> InstanceType) const
@@ -524,21 +613,39 @@ TArray<ULyraEquipmentInstance*> UHaroEquipmentManagerComponent::GetEquipmentInst
 
 TArray<ULyraEquipmentInstance*> UHaroEquipmentManagerComponent::GetActiveEquipmentInstancesOfType(TSubclassOf<ULyraEquipmentInstance> InstanceType) const
 {
-	TArray<ULyraEquipmentInstance*> Results;
+	TArray<ULyraEquipmentInstance*, TInlineAllocator<4>> InlineResults;
+	FindActiveEquipmentInstancesOfType(InstanceType, InlineResults);
+
+	return TArray<ULyraEquipmentInstance*>(InlineResults);
+}
+
+void UHaroEquipmentManagerComponent::FindEquipmentInstancesOfType(TSubclassOf<ULyraEquipmentInstance> InstanceType, TArray<ULyraEquipmentInstance*, TInlineAllocator<4>>& OutInstances) const
+{
+	OutInstances.Reset();
 	for (const FHaroAppliedEquipmentEntry& Entry : EquipmentList.Entries)
 	{
-		if (Entry.bIsActive)  // 먼저 활성화 체크
+		if (ULyraEquipmentInstance* Instance = Entry.Instance)
 		{
-			if (ULyraEquipmentInstance* Instance = Entry.Instance)
+			if (Instance->IsA(InstanceType))
 			{
-				if (Instance->IsA(InstanceType))
-				{
-					Results.Add(Instance);
-				}
+				OutInstances.Add(Instance);
 			}
 		}
 	}
-	return Results;
 }
 
+void UHaroEquipmentManagerComponent::FindActiveEquipmentInstancesOfType(TSubclassOf<ULyraEquipmentInstance> InstanceType, TArray<ULyraEquipmentInstance*, TInlineAllocator<4>>& OutInstances) const
+{
+	OutInstances.Reset();
 
+	// 활성화된 항목만 순회
+	EquipmentList.RebuildIndexIfNeeded();
+	for (const int32 EntryIndex : EquipmentList.ActiveEntryIndices)
+	{
+		ULyraEquipmentInstance* Instance = EquipmentList.Entries[EntryIndex].Instance;
+		if (Instance->IsA(InstanceType))
+		{
+			OutInstances.Add(Instance);
+		}
+	}
+}
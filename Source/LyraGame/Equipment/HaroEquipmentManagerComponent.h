@@ -78,6 +78,7 @@ public:
 	void PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize); // 클라에서 제거되기 직전
 	void PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize); // 클라에서 추가된 직후
 	void PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize); // 클라에서 변경된 직후
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters); // 클라에서 한 번의 수신 처리가 끝난 후
 	//~End of FFastArraySerializer contract
 
 	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
@@ -96,6 +97,15 @@ private:
 	void RegisterSkillHandlesForAbilitySet( const ULyraAbilitySet* AbilitySet, FHaroAppliedEquipmentEntry& Entry, int32 StartIndex, int32 EndIndex);
 	void UnregisterSkillHandles(const FHaroAppliedEquipmentEntry& Entry);
 
+	// 슬롯/활성 인덱스 관리 (Entries가 바뀌면 dirty 표시, 다음 조회 때 다시 만듦)
+	void MarkIndexDirty();
+	void RebuildIndexIfNeeded() const;
+
+	int32 FindEntryIndexBySlot(int32 SlotIndex) const;
+	FHaroAppliedEquipmentEntry* FindEntryBySlot(int32 SlotIndex);
+
+	ULyraEquipmentInstance* FindFirstActiveInstanceOfType(TSubclassOf<ULyraEquipmentInstance> InstanceType) const;
+
 	friend UHaroEquipmentManagerComponent; // UHaroEquipmentManagerComponent 이 클래스에서만 접근 가능하게.
 
 private:
@@ -107,6 +117,18 @@ private:
 	// -> 아,,, GetAbilitySystemComponent(ASC)가 문제였던 이유가 이거때문이었구나.... (이미 다르게 해결함.)
 	UPROPERTY(NotReplicated)
 	TObjectPtr<UActorComponent> OwnerComponent; // 이 리스트를 소유한 컴포넌트 (각 클라에서 자체적으로 설정)
+
+	// ========== 조회용 인덱스 (복제 안 됨, 서버/클라 각자 유지) ==========
+	// 슬롯 번호 -> Entries 인덱스 (없으면 INDEX_NONE)
+	mutable TArray<int32, TInlineAllocator<4>> SlotToEntryIndex;
+
+	// 활성화된 Entries 인덱스들
+	mutable TArray<int32, TInlineAllocator<4>> ActiveEntryIndices;
+
+	// 클래스별 첫 번째 활성 인스턴스 캐시 (없음도 nullptr로 캐싱, 인스턴스는 Entries가 잡고 있으므로 raw 포인터)
+	mutable TMap<TObjectKey<UClass>, ULyraEquipmentInstance*> ActiveInstanceByClass;
+
+	mutable bool bIndexDirty = true;
 };
 
 template<>
@@ -160,6 +182,10 @@ public:
 	virtual void ReadyForReplication() override;
 	//~End of UActorComponent interface
 
+	/** 슬롯에 장착된 인스턴스 (없으면 nullptr) */
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	ULyraEquipmentInstance* GetInstanceInSlot(int32 SlotIndex) const;
+
 	/** Returns the first equipped instance of a given type, or nullptr if none are found */
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	ULyraEquipmentInstance* GetFirstInstanceOfType(TSubclassOf<ULyraEquipmentInstance> InstanceType);
@@ -176,6 +202,10 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	TArray<ULyraEquipmentInstance*> GetActiveEquipmentInstancesOfType(TSubclassOf<ULyraEquipmentInstance> InstanceType) const;
 
+	/** 할당 없는 버전 (매 프레임 호출하는 곳용), OutInstances는 비우고 채움 */
+	void FindEquipmentInstancesOfType(TSubclassOf<ULyraEquipmentInstance> InstanceType, TArray<ULyraEquipmentInstance*, TInlineAllocator<4>>& OutInstances) const;
+	void FindActiveEquipmentInstancesOfType(TSubclassOf<ULyraEquipmentInstance> InstanceType, TArray<ULyraEquipmentInstance*, TInlineAllocator<4>>& OutInstances) const;
+
 	template <typename T>
 	T* GetFirstInstanceOfType()
 	{
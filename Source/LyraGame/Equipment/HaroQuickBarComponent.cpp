@@ -252,7 +252,7 @@ void UHaroQuickBarComponent::OnRep_Slots()
 	Message.Slots = Slots;
 
 	UGameplayMessageSubsystem& MessageSystem = UGameplayMessageSubsystem::Get(this);
-	MessageSystem.BroadcastMessage(TAG_Haro_QuickBar_Message_SlotsChanged, Message);
+	MessageSystem.BroadcastMessage(TAG_Haro_QuickBar_Message_SlotsChanged, Message, Message.Owner);
 }
 
 void UHaroQuickBarComponent::OnRep_ActiveSlotIndex()
@@ -262,6 +262,6 @@ void UHaroQuickBarComponent::OnRep_ActiveSlotIndex()
 	Message.ActiveIndex = ActiveSlotIndex;
 
 	UGameplayMessageSubsystem& MessageSystem = UGameplayMessageSubsystem::Get(this);
-	MessageSystem.BroadcastMessage(TAG_Haro_QuickBar_Message_ActiveIndexChanged, Message);
+	MessageSystem.BroadcastMessage(TAG_Haro_QuickBar_Message_ActiveIndexChanged, Message, Message.Owner);
 }
 
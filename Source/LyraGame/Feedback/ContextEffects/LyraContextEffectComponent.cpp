@@ -3,8 +3,10 @@
 
 #include "LyraContextEffectComponent.h"
 
+#include "Components/AudioComponent.h"
 #include "Engine/World.h"
 #include "LyraContextEffectsSubsystem.h"
+#include "NiagaraComponent.h"
 #include "PhysicalMaterials/PhysicalMaterial.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraContextEffectComponent)
@@ -100,9 +102,10 @@ void ULyraContextEffectComponent::AnimMotionEffect_Implementation(const FName Bo
 	}
 
 	// Cycle through Active Audio Components and cache
+	// Effects come from pools, so finished components are dropped rather than waiting for them to be destroyed
 	for (UAudioComponent* ActiveAudioComponent : ActiveAudioComponents)
 	{
-		if (ActiveAudioComponent)
+		if (ActiveAudioComponent && ActiveAudioComponent->IsPlaying())
 		{
 			AudioComponentsToAdd.Add(ActiveAudioComponent);
 		}
@@ -111,7 +114,7 @@ void ULyraContextEffectComponent::AnimMotionEffect_Implementation(const FName Bo
 	// Cycle through Active Niagara Components and cache
 	for (UNiagaraComponent* ActiveNiagaraComponent : ActiveNiagaraComponents)
 	{
-		if (ActiveNiagaraComponent)
+		if (ActiveNiagaraComponent && ActiveNiagaraComponent->IsActive())
 		{
 			NiagaraComponentsToAdd.Add(ActiveNiagaraComponent);
 		}
@@ -132,9 +135,15 @@ void ULyraContextEffectComponent::AnimMotionEffect_Implementation(const FName Bo
 				LocationOffset, RotationOffset, MotionEffect, TotalContexts,
 				AudioComponents, NiagaraComponents, VFXScale, AudioVolume, AudioPitch);
 
-			// Append resultant effects
-			AudioComponentsToAdd.Append(AudioComponents);
-			NiagaraComponentsToAdd.Append(NiagaraComponents);
+			// Append resultant effects (a pooled component can already be in the list from an earlier effect)
+			for (UAudioComponent* AudioComponent : AudioComponents)
+			{
+				AudioComponentsToAdd.AddUnique(AudioComponent);
+			}
+			for (UNiagaraComponent* NiagaraComponent : NiagaraComponents)
+			{
+				NiagaraComponentsToAdd.AddUnique(NiagaraComponent);
+			}
 		}
 	}
 
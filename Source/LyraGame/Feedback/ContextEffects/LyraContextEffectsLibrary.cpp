@@ -2,32 +2,84 @@
 
 #include "Feedback/ContextEffects/LyraContextEffectsLibrary.h"
 
+#include "HAL/IConsoleManager.h"
 #include "NiagaraSystem.h"
 #include "Sound/SoundBase.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraContextEffectsLibrary)
 
 
+namespace Lyra::ContextEffects
+{
+	// Contexts are built at runtime, so cap how many distinct queries are remembered per library
+	static int32 MaxRememberedQueries = 512;
+	static FAutoConsoleVariableRef CVarMaxRememberedQueries(TEXT("Lyra.ContextEffects.MaxRememberedQueries"), MaxRememberedQueries, TEXT("How many (effect, context) query results each context effects library remembers before starting over"), ECVF_Default);
+}
+
 void ULyraContextEffectsLibrary::GetEffects(const FGameplayTag Effect, const FGameplayTagContainer Context, 
 	TArray<USoundBase*>& Sounds, TArray<UNiagaraSystem*>& NiagaraSystems)
+{
+	// Get all Matching Sounds and Niagara Systems
+	if (const FLyraContextEffectsQueryResult* Result = FindEffects(Effect, Context))
+	{
+		Sounds.Append(Result->Sounds);
+		NiagaraSystems.Append(Result->NiagaraSystems);
+	}
+}
+
+const FLyraContextEffectsQueryResult* ULyraContextEffectsLibrary::FindEffects(const FGameplayTag Effect, const FGameplayTagContainer& Context)
 {
 	// Make sure Effect is valid and Library is loaded
-	if (Effect.IsValid() && Context.IsValid() && EffectsLoadState == EContextEffectsLibraryLoadState::Loaded)
+	if (!Effect.IsValid() || !Context.IsValid() || EffectsLoadState != EContextEffectsLibraryLoadState::Loaded)
+	{
+		return nullptr;
+	}
+
+	const FQueryKey Key{ Effect, Context };
+	const uint32 KeyHash = GetTypeHash(Key);
+
+	if (const FLyraContextEffectsQueryResult* RememberedResult = QueryResults.FindByHash(KeyHash, Key))
+	{
+		return (RememberedResult->Sounds.Num() + RememberedResult->NiagaraSystems.Num() > 0) ? RememberedResult : nullptr;
+	}
+
+	if (QueryResults.Num() >= Lyra::ContextEffects::MaxRememberedQueries)
 	{
-		// Loop through Context Effects
-		for (const auto& ActiveContextEffect : ActiveContextEffects)
+		QueryResults.Reset();
+	}
+
+	FLyraContextEffectsQueryResult& Result = QueryResults.AddByHash(KeyHash, Key);
+
+	// Only Context Effects with the exact Effect Tag can match
+	if (const TArray<ULyraActiveContextEffects*>* Candidates = EffectsByTag.Find(Effect))
+	{
+		for (const ULyraActiveContextEffects* ActiveContextEffect : *Candidates)
 		{
-			// Make sure the Effect is an exact Tag Match and ensure the Context has all tags in the Effect (and neither or both are empty)
-			if (Effect.MatchesTagExact(ActiveContextEffect->EffectTag)
-				&& Context.HasAllExact(ActiveContextEffect->Context)
+			// Ensure the Context has all tags in the Effect (and neither or both are empty)
+			if (Context.HasAllExact(ActiveContextEffect->Context)
 				&& (ActiveContextEffect->Context.IsEmpty() == Context.IsEmpty()))
 			{
-				// Get all Matching Sounds and Niagara Systems
-				Sounds.Append(ActiveContextEffect->Sounds);
-				NiagaraSystems.Append(ActiveContextEffect->NiagaraSystems);
+				Result.Sounds.Append(ActiveContextEffect->Sounds);
+				Result.NiagaraSystems.Append(ActiveContextEffect->NiagaraSystems);
 			}
 		}
 	}
+
+	return (Result.Sounds.Num() + Result.NiagaraSystems.Num() > 0) ? &Result : nullptr;
+}
+
+void ULyraContextEffectsLibrary::RebuildEffectIndex()
+{
+	EffectsByTag.Reset();
+	QueryResults.Reset();
+
+	for (ULyraActiveContextEffects* ActiveContextEffect : ActiveContextEffects)
+	{
+		if (ActiveContextEffect)
+		{
+			EffectsByTag.FindOrAdd(ActiveContextEffect->EffectTag).Add(ActiveContextEffect);
+		}
+	}
 }
 
 void ULyraContextEffectsLibrary::LoadEffects()
@@ -40,6 +92,7 @@ void ULyraContextEffectsLibrary::LoadEffects()
 
 		// Clear out any old Active Effects
 		ActiveContextEffects.Empty();
+		RebuildEffectIndex();
 
 		// Call internal loading function
 		LoadEffectsInternal();
@@ -115,5 +168,8 @@ void ULyraContextEffectsLibrary::LyraContextEffectLibraryLoadingComplete(
 
 	// Append incoming Context Effects Array to current list of Active Context Effects
 	ActiveContextEffects.Append(LyraActiveContextEffects);
+
+	// Index the loaded effects for lookups
+	RebuildEffectIndex();
 }
 
@@ -63,6 +63,15 @@ public:
 	TArray<TObjectPtr<UNiagaraSystem>> NiagaraSystems;
 };
 
+/**
+ * All effects in a library that match an (effect tag, context) query
+ */
+struct FLyraContextEffectsQueryResult
+{
+	TArray<TObjectPtr<USoundBase>> Sounds;
+	TArray<TObjectPtr<UNiagaraSystem>> NiagaraSystems;
+};
+
 DECLARE_DYNAMIC_DELEGATE_OneParam(FLyraContextEffectLibraryLoadingComplete, TArray<ULyraActiveContextEffects*>, LyraActiveContextEffects);
 
 /**
@@ -86,9 +95,41 @@ public:
 
 	EContextEffectsLibraryLoadState GetContextEffectsLibraryLoadState();
 
+	/**
+	 * Returns the effects matching Effect and Context, or nullptr if there are none (or the library isn't loaded)
+	 * Results are remembered per (effect, context) pair, so repeated queries from footsteps and impacts don't scan the library
+	 * The result is only valid until the next call
+	 */
+	const FLyraContextEffectsQueryResult* FindEffects(const FGameplayTag Effect, const FGameplayTagContainer& Context);
+
 private:
 	void LoadEffectsInternal();
 
+	// Builds EffectsByTag from ActiveContextEffects and forgets remembered queries
+	void RebuildEffectIndex();
+
+	struct FQueryKey
+	{
+		FGameplayTag Effect;
+		FGameplayTagContainer Context;
+
+		bool operator==(const FQueryKey& Other) const
+		{
+			return (Effect == Other.Effect) && (Context == Other.Context);
+		}
+
+		friend uint32 GetTypeHash(const FQueryKey& Key)
+		{
+			// Order independent, the same contexts can be appended in any order
+			uint32 ContextHash = 0;
+			for (const FGameplayTag& Tag : Key.Context)
+			{
+				ContextHash ^= GetTypeHash(Tag);
+			}
+			return HashCombine(GetTypeHash(Key.Effect), ContextHash);
+		}
+	};
+
 	void LyraContextEffectLibraryLoadingComplete(TArray<ULyraActiveContextEffects*> LyraActiveContextEffects);
 
 	UPROPERTY(Transient)
@@ -96,4 +137,10 @@ private:
 
 	UPROPERTY(Transient)
 	EContextEffectsLibraryLoadState EffectsLoadState = EContextEffectsLibraryLoadState::Unloaded;
+
+	// Active Context Effects grouped by Effect Tag (built when loading completes, referenced by ActiveContextEffects)
+	TMap<FGameplayTag, TArray<ULyraActiveContextEffects*>> EffectsByTag;
+
+	// Remembered query results, an empty result is remembered too
+	TMap<FQueryKey, FLyraContextEffectsQueryResult> QueryResults;
 };
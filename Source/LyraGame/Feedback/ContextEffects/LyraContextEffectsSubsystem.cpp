@@ -3,11 +3,20 @@
 
 #include "LyraContextEffectsSubsystem.h"
 
+#include "AudioDevice.h"
+#include "Components/AudioComponent.h"
+#include "Engine/World.h"
 #include "Feedback/ContextEffects/LyraContextEffectsLibrary.h"
 #include "Feedback/ContextEffects/LyraContextEffectsSubsystem.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet/GameplayStatics.h"
 #include "NiagaraFunctionLibrary.h"
 #include "NiagaraSystem.h"
+#include "Sound/SoundBase.h"
+#include "Performance/LyraPerformanceSettings.h"
+#include "System/LyraSignificanceManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraContextEffectsSubsystem)
 
@@ -17,6 +26,18 @@ class UNiagaraSystem;
 class USceneComponent;
 class USoundBase;
 
+namespace Lyra::ContextEffects
+{
+	static int32 MaxSpawnsPerFrame = 24;
+	static FAutoConsoleVariableRef CVarMaxSpawnsPerFrame(TEXT("Lyra.ContextEffects.MaxSpawnsPerFrame"), MaxSpawnsPerFrame, TEXT("How many context effect sounds and Niagara systems other actors can spawn per frame (0 = unlimited, locally controlled pawns are never limited)"), ECVF_Default);
+
+	static float CullDistance = 6000.0f;
+	static FAutoConsoleVariableRef CVarCullDistance(TEXT("Lyra.ContextEffects.CullDistance"), CullDistance, TEXT("Distance from every local view beyond which context effects are skipped, for actors the significance manager doesn't track (0 = never cull)"), ECVF_Default);
+
+	static int32 MaxPooledAudioComponents = 32;
+	static FAutoConsoleVariableRef CVarMaxPooledAudioComponents(TEXT("Lyra.ContextEffects.MaxPooledAudioComponents"), MaxPooledAudioComponents, TEXT("How many audio components the context effects pool creates before falling back to one-off components"), ECVF_Default);
+}
+
 void ULyraContextEffectsSubsystem::SpawnContextEffects(
 	const AActor* SpawningActor
 	, USceneComponent* AttachToComponent
@@ -37,9 +58,8 @@ void ULyraContextEffectsSubsystem::SpawnContextEffects(
 		// Validate the pointers from the Map Find
 		if (ULyraContextEffectsSet* EffectsLibraries = *EffectsLibrariesSetPtr)
 		{
-			// Prepare Arrays for Sounds and Niagara Systems
-			TArray<USoundBase*> TotalSounds;
-			TArray<UNiagaraSystem*> TotalNiagaraSystems;
+			// Gather matching effects from each library without copying them
+			TArray<const FLyraContextEffectsQueryResult*, TInlineAllocator<4>> MatchingEffects;
 
 			// Cycle through Effect Libraries
 			for (ULyraContextEffectsLibrary* EffectLibrary : EffectsLibraries->LyraContextEffectsLibraries)
@@ -47,16 +67,11 @@ void ULyraContextEffectsSubsystem::SpawnContextEffects(
 				// Check if the Effect Library is valid and data Loaded
 				if (EffectLibrary && EffectLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Loaded)
 				{
-					// Set up local list of Sounds and Niagara Systems
-					TArray<USoundBase*> Sounds;
-					TArray<UNiagaraSystem*> NiagaraSystems;
-
 					// Get Sounds and Niagara Systems
-					EffectLibrary->GetEffects(Effect, Contexts, Sounds, NiagaraSystems);
-
-					// Append to accumulating array
-					TotalSounds.Append(Sounds);
-					TotalNiagaraSystems.Append(NiagaraSystems);
+					if (const FLyraContextEffectsQueryResult* Result = EffectLibrary->FindEffects(Effect, Contexts))
+					{
+						MatchingEffects.Add(Result);
+					}
 				}
 				else if (EffectLibrary && EffectLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Unloaded)
 				{
@@ -65,29 +80,221 @@ void ULyraContextEffectsSubsystem::SpawnContextEffects(
 				}
 			}
 
+			if (MatchingEffects.Num() == 0)
+			{
+				return;
+			}
+
+			// Skip effects nobody will notice before spawning anything
+			const FVector SpawnLocation = AttachToComponent ? AttachToComponent->GetSocketLocation(AttachPoint) : SpawningActor->GetActorLocation();
+			if (ShouldCullEffects(SpawningActor, SpawnLocation))
+			{
+				return;
+			}
+
+			const APawn* SpawningPawn = Cast<APawn>(SpawningActor);
+			const bool bIgnoreBudget = SpawningPawn && SpawningPawn->IsLocallyControlled();
+
 			// Cycle through found Sounds
-			for (USoundBase* Sound : TotalSounds)
+			for (const FLyraContextEffectsQueryResult* Result : MatchingEffects)
 			{
-				// Spawn Sounds Attached, add Audio Component to List of ACs
-				UAudioComponent* AudioComponent = UGameplayStatics::SpawnSoundAttached(Sound, AttachToComponent, AttachPoint, LocationOffset, RotationOffset, EAttachLocation::KeepRelativeOffset,
-					false, AudioVolume, AudioPitch, 0.0f, nullptr, nullptr, true);
+				for (USoundBase* Sound : Result->Sounds)
+				{
+					if (!bIgnoreBudget && !ConsumeSpawnBudget())
+					{
+						return;
+					}
 
-				AudioOut.Add(AudioComponent);
+					// Play Sounds Attached, add Audio Component to List of ACs
+					if (UAudioComponent* AudioComponent = PlayPooledSound(Sound, AttachToComponent, AttachPoint, LocationOffset, RotationOffset, AudioVolume, AudioPitch))
+					{
+						AudioOut.Add(AudioComponent);
+					}
+				}
 			}
 
 			// Cycle through found Niagara Systems
-			for (UNiagaraSystem* NiagaraSystem : TotalNiagaraSystems)
+			for (const FLyraContextEffectsQueryResult* Result : MatchingEffects)
 			{
-				// Spawn Niagara Systems Attached, add Niagara Component to List of NCs
-				UNiagaraComponent* NiagaraComponent = UNiagaraFunctionLibrary::SpawnSystemAttached(NiagaraSystem, AttachToComponent, AttachPoint, LocationOffset,
-					RotationOffset, VFXScale, EAttachLocation::KeepRelativeOffset, true, ENCPoolMethod::None, true, true);
+				for (UNiagaraSystem* NiagaraSystem : Result->NiagaraSystems)
+				{
+					if (!bIgnoreBudget && !ConsumeSpawnBudget())
+					{
+						return;
+					}
+
+					// Spawn Niagara Systems Attached from the world's component pool, add Niagara Component to List of NCs
+					UNiagaraComponent* NiagaraComponent = UNiagaraFunctionLibrary::SpawnSystemAttached(NiagaraSystem, AttachToComponent, AttachPoint, LocationOffset,
+						RotationOffset, VFXScale, EAttachLocation::KeepRelativeOffset, true, ENCPoolMethod::AutoRelease, true, true);
 
-				NiagaraOut.Add(NiagaraComponent);
+					NiagaraOut.Add(NiagaraComponent);
+				}
 			}
 		}
 	}
 }
 
+void ULyraContextEffectsSubsystem::Deinitialize()
+{
+	for (UAudioComponent* AudioComponent : PooledAudioComponents)
+	{
+		if (IsValid(AudioComponent))
+		{
+			AudioComponent->OnAudioFinishedNative.RemoveAll(this);
+			AudioComponent->DestroyComponent();
+		}
+	}
+	PooledAudioComponents.Reset();
+	FreeAudioComponents.Reset();
+
+	Super::Deinitialize();
+}
+
+bool ULyraContextEffectsSubsystem::ShouldCullEffects(const AActor* SpawningActor, const FVector& Location)
+{
+	// Never cull what the local player is doing
+	const APawn* SpawningPawn = Cast<APawn>(SpawningActor);
+	if (SpawningPawn && SpawningPawn->IsLocallyControlled())
+	{
+		return false;
+	}
+
+	// The significance tier already accounts for distance, visibility and importance of the actor
+	if (const ULyraSignificanceManager* SignificanceManager = USignificanceManager::Get<ULyraSignificanceManager>(GetWorld()))
+	{
+		if (const FLyraSignificanceTier* Tier = SignificanceManager->GetObjectTier(SpawningActor))
+		{
+			return !Tier->bAllowContextEffects;
+		}
+	}
+
+	// Otherwise fall back to the distance to the closest local view
+	const float CullDistance = Lyra::ContextEffects::CullDistance;
+	if (CullDistance <= 0.0f)
+	{
+		return false;
+	}
+
+	RefreshFrameState();
+	if (ViewLocations.Num() == 0)
+	{
+		return false;
+	}
+
+	for (const FVector& ViewLocation : ViewLocations)
+	{
+		if (FVector::DistSquared(ViewLocation, Location) <= FMath::Square(CullDistance))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool ULyraContextEffectsSubsystem::ConsumeSpawnBudget()
+{
+	RefreshFrameState();
+
+	const int32 MaxSpawnsPerFrame = Lyra::ContextEffects::MaxSpawnsPerFrame;
+	if ((MaxSpawnsPerFrame > 0) && (NumSpawnsThisFrame >= MaxSpawnsPerFrame))
+	{
+		return false;
+	}
+
+	++NumSpawnsThisFrame;
+	return true;
+}
+
+void ULyraContextEffectsSubsystem::RefreshFrameState()
+{
+	if (BudgetFrameNumber == GFrameCounter)
+	{
+		return;
+	}
+
+	BudgetFrameNumber = GFrameCounter;
+	NumSpawnsThisFrame = 0;
+
+	ViewLocations.Reset();
+	if (UWorld* World = GetWorld())
+	{
+		for (FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator)
+		{
+			const APlayerController* PlayerController = Iterator->Get();
+			if (PlayerController && PlayerController->IsLocalController())
+			{
+				FVector ViewLocation;
+				FRotator ViewRotation;
+				PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+				ViewLocations.Add(ViewLocation);
+			}
+		}
+	}
+}
+
+UAudioComponent* ULyraContextEffectsSubsystem::PlayPooledSound(USoundBase* Sound, USceneComponent* AttachToComponent, const FName AttachPoint, const FVector& LocationOffset, const FRotator& RotationOffset, float AudioVolume, float AudioPitch)
+{
+	UWorld* World = GetWorld();
+	if (!Sound || !AttachToComponent || !World || !World->bAllowAudioPlayback || World->IsNetMode(NM_DedicatedServer))
+	{
+		return nullptr;
+	}
+
+	// Same early out as SpawnSoundAttached, one shots that can't be heard aren't worth a component
+	if (FAudioDevice* AudioDevice = World->GetAudioDeviceRaw())
+	{
+		if (!Sound->IsLooping() && !AudioDevice->LocationIsAudible(AttachToComponent->GetSocketLocation(AttachPoint), Sound->GetMaxDistance()))
+		{
+			return nullptr;
+		}
+	}
+
+	UAudioComponent* AudioComponent = nullptr;
+	while (!AudioComponent && (FreeAudioComponents.Num() > 0))
+	{
+		AudioComponent = FreeAudioComponents.Pop(EAllowShrinking::No);
+		AudioComponent = IsValid(AudioComponent) ? AudioComponent : nullptr;
+	}
+
+	if (!AudioComponent)
+	{
+		// Pool is exhausted, play on a one-off component like before
+		if (PooledAudioComponents.Num() >= Lyra::ContextEffects::MaxPooledAudioComponents)
+		{
+			return UGameplayStatics::SpawnSoundAttached(Sound, AttachToComponent, AttachPoint, LocationOffset, RotationOffset, EAttachLocation::KeepRelativeOffset,
+				false, AudioVolume, AudioPitch, 0.0f, nullptr, nullptr, true);
+		}
+
+		AudioComponent = NewObject<UAudioComponent>(World);
+		AudioComponent->bAutoActivate = false;
+		AudioComponent->bAutoDestroy = false;
+		AudioComponent->OnAudioFinishedNative.AddUObject(this, &ThisClass::HandlePooledAudioFinished);
+		AudioComponent->RegisterComponentWithWorld(World);
+
+		PooledAudioComponents.Add(AudioComponent);
+	}
+
+	AudioComponent->SetSound(Sound);
+	AudioComponent->SetVolumeMultiplier(AudioVolume);
+	AudioComponent->SetPitchMultiplier(AudioPitch);
+	AudioComponent->AttachToComponent(AttachToComponent, FAttachmentTransformRules::KeepRelativeTransform, AttachPoint);
+	AudioComponent->SetRelativeLocationAndRotation(LocationOffset, RotationOffset);
+	AudioComponent->Play();
+
+	return AudioComponent;
+}
+
+void ULyraContextEffectsSubsystem::HandlePooledAudioFinished(UAudioComponent* AudioComponent)
+{
+	if (IsValid(AudioComponent) && !FreeAudioComponents.Contains(AudioComponent))
+	{
+		// Don't follow the old attach parent around (or keep it alive) while waiting in the pool
+		AudioComponent->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+		FreeAudioComponents.Add(AudioComponent);
+	}
+}
+
 bool ULyraContextEffectsSubsystem::GetContextFromSurfaceType(
 	TEnumAsByte<EPhysicalSurface> PhysicalSurface, FGameplayTag& Context)
 {
@@ -15,6 +15,7 @@ class UAudioComponent;
 class ULyraContextEffectsLibrary;
 class UNiagaraComponent;
 class USceneComponent;
+class USoundBase;
 struct FFrame;
 struct FGameplayTag;
 struct FGameplayTagContainer;
@@ -48,7 +49,12 @@ public:
 
 
 /**
- * 
+ * Spawns context effects (footsteps, impacts, ...) for actors from their registered libraries
+ *
+ * Sounds play on pooled audio components and Niagara systems use the Niagara component pool.
+ * Effects from actors other than locally controlled pawns are culled when their actor is insignificant
+ * (or too far from every local view if it isn't tracked by the significance manager), and count
+ * against a per-frame spawn budget.
  */
 UCLASS()
 class LYRAGAME_API ULyraContextEffectsSubsystem : public UWorldSubsystem
@@ -56,6 +62,10 @@ class LYRAGAME_API ULyraContextEffectsSubsystem : public UWorldSubsystem
 	GENERATED_BODY()
 	
 public:
+	//~USubsystem interface
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
 	/** */
 	UFUNCTION(BlueprintCallable, Category = "ContextEffects")
 	void SpawnContextEffects(
@@ -84,9 +94,37 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ContextEffects")
 	void UnloadAndRemoveContextEffectsLibraries(AActor* OwningActor);
 
+private:
+	/** Returns true if effects from SpawningActor at Location shouldn't be spawned at all */
+	bool ShouldCullEffects(const AActor* SpawningActor, const FVector& Location);
+
+	/** Takes one spawn from this frame's budget, returns false if it is used up */
+	bool ConsumeSpawnBudget();
+
+	/** Resets the spawn budget and gathers local view locations on the first call each frame */
+	void RefreshFrameState();
+
+	UAudioComponent* PlayPooledSound(USoundBase* Sound, USceneComponent* AttachToComponent, const FName AttachPoint, const FVector& LocationOffset, const FRotator& RotationOffset, float AudioVolume, float AudioPitch);
+
+	void HandlePooledAudioFinished(UAudioComponent* AudioComponent);
+
 private:
 
 	UPROPERTY(Transient)
 	TMap<TObjectPtr<AActor>, TObjectPtr<ULyraContextEffectsSet>> ActiveActorEffectsMap;
 
+	/** Every audio component created for the pool */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UAudioComponent>> PooledAudioComponents;
+
+	/** Pooled audio components that aren't playing */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UAudioComponent>> FreeAudioComponents;
+
+	/** Frame the spawn budget and view locations were last refreshed */
+	uint64 BudgetFrameNumber = 0;
+	int32 NumSpawnsThisFrame = 0;
+
+	/** Local player view locations for distance culling (refreshed once per frame) */
+	TArray<FVector, TInlineAllocator<2>> ViewLocations;
 };
@@ -7,6 +7,7 @@
 
 #include "LyraNumberPopComponent.generated.h"
 
+class AActor;
 class UObject;
 struct FFrame;
 
@@ -35,6 +36,10 @@ struct FLyraNumberPopRequest
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Lyra|Number Pops")
 	bool bIsCriticalDamage = false;
 
+	// The actor the number is for (optional, lets rapid pops on the same target be merged)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Lyra|Number Pops")
+	TObjectPtr<AActor> Target = nullptr;
+
 	FLyraNumberPopRequest()
 		: WorldLocation(ForceInitToZero)
 	{
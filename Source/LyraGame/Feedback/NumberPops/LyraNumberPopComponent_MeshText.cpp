@@ -2,6 +2,7 @@
 
 #include "LyraNumberPopComponent_MeshText.h"
 
+#include "Components/InstancedStaticMeshComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Engine/CollisionProfile.h"
 #include "Engine/Engine.h"
@@ -9,6 +10,8 @@
 #include "Feedback/NumberPops/LyraNumberPopComponent.h"
 #include "LyraDamagePopStyle.h"
 #include "Materials/MaterialInstanceDynamic.h"
+#include "Performance/LyraPerformanceSettings.h"
+#include "System/LyraSignificanceManager.h"
 #include "TimerManager.h"
 #include "UObject/Package.h"
 
@@ -40,6 +43,14 @@ ULyraNumberPopComponent_MeshText::ULyraNumberPopComponent_MeshText(const FObject
 	FontYSize = 21.0f;
 
 	NumberOfNumberRotations = 1.f;
+
+	MaxLiveInstancedPops = 64;
+	MergeWindow = 0.2f;
+	MergeRadius = 50.f;
+
+	// Only ticks while instanced pops are live, to expire them
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 }
 
 void ULyraNumberPopComponent_MeshText::AddNumberPop(const FLyraNumberPopRequest& NewRequest)
@@ -54,6 +65,28 @@ void ULyraNumberPopComponent_MeshText::AddNumberPop(const FLyraNumberPopRequest&
 		}
 	}
 
+	// Skip pops that are too far away or behind the camera to matter (critical hits are always shown)
+	if (!NewRequest.bIsCriticalDamage)
+	{
+		if (const ULyraSignificanceManager* SignificanceManager = USignificanceManager::Get<ULyraSignificanceManager>(GetWorld()))
+		{
+			const FLyraSignificanceTier* Tier = SignificanceManager->GetLocationTier(NewRequest.WorldLocation);
+			if (Tier && !Tier->bAllowNumberPops)
+			{
+				return;
+			}
+		}
+	}
+
+	if (bUseInstancedRenderer)
+	{
+		if (UStaticMesh* MeshToUse = DetermineStaticMesh(NewRequest))
+		{
+			AddInstancedNumberPop(NewRequest, MeshToUse);
+		}
+		return;
+	}
+
 	FTempNumberPopInfo PreparedNumberInfo;
 
 	// Prepare the DamageNumberArray with the digits from the damage.
@@ -143,25 +176,291 @@ void ULyraNumberPopComponent_MeshText::AddNumberPop(const FLyraNumberPopRequest&
 
 	// Determine the position
 	FTransform CameraTransform;
-	FVector NumberLocation(NewRequest.WorldLocation);
+	FVector NumberLocation;
+	DetermineCameraTransformAndLocation(NewRequest, /*out*/ CameraTransform, /*out*/ NumberLocation);
+	PreparedNumberInfo.StaticMeshComponent->SetWorldTransform(FTransform(CameraTransform.GetRotation(), NumberLocation));
+
+	// Now apply the material parameters to make the digits, etc...
+	SetMaterialParameters(NewRequest, PreparedNumberInfo, CameraTransform, NumberLocation);
+}
+
+void ULyraNumberPopComponent_MeshText::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	ExpireInstancedNumberPops();
+}
+
+void ULyraNumberPopComponent_MeshText::DetermineCameraTransformAndLocation(const FLyraNumberPopRequest& Request, FTransform& OutCameraTransform, FVector& OutNumberLocation) const
+{
+	OutCameraTransform = FTransform::Identity;
+	OutNumberLocation = Request.WorldLocation;
+
 	if (APlayerController* PC = GetController<APlayerController>())
 	{
 		if (APlayerCameraManager* PlayerCameraManager = PC->PlayerCameraManager)
 		{
-			CameraTransform = FTransform(PlayerCameraManager->GetCameraRotation(), PlayerCameraManager->GetCameraLocation());
+			OutCameraTransform = FTransform(PlayerCameraManager->GetCameraRotation(), PlayerCameraManager->GetCameraLocation());
 
 			FVector LocationOffset(ForceInitToZero);
 
 			const float RandomMagnitude = 5.0f; //@TODO: Make this style driven
 			LocationOffset += FMath::RandPointInBox(FBox(FVector(-RandomMagnitude), FVector(RandomMagnitude)));
 
-			NumberLocation += LocationOffset;
+			OutNumberLocation += LocationOffset;
 		}
 	}
-	PreparedNumberInfo.StaticMeshComponent->SetWorldTransform(FTransform(CameraTransform.GetRotation(), NumberLocation));
+}
 
-	// Now apply the material parameters to make the digits, etc...
-	SetMaterialParameters(NewRequest, PreparedNumberInfo, CameraTransform, NumberLocation);
+void ULyraNumberPopComponent_MeshText::AddInstancedNumberPop(const FLyraNumberPopRequest& Request, UStaticMesh* Mesh)
+{
+	UWorld* LocalWorld = GetWorld();
+	check(LocalWorld);
+
+	// Real time throughout, it is the clock the material animates the pop with
+	const float CurrentTime = LocalWorld->GetRealTimeSeconds();
+
+	FTransform CameraTransform;
+	FVector NumberLocation;
+	DetermineCameraTransformAndLocation(Request, /*out*/ CameraTransform, /*out*/ NumberLocation);
+
+	FInstancedNumberPopBatch& Batch = FindOrAddInstancedBatch(Mesh);
+
+	// Fold rapid hits on the same target into the pop that is already showing
+	int32 SlotIndex = FindInstancedMergeSlot(Batch, Request, CurrentTime);
+	if (SlotIndex != INDEX_NONE)
+	{
+		FInstancedNumberPopSlot& Slot = Batch.Slots[SlotIndex];
+		Slot.Number = (int32)FMath::Min<int64>((int64)Slot.Number + FMath::Max(Request.NumberToDisplay, 0), MAX_int32);
+	}
+	else
+	{
+		if (NumLiveInstancedPops >= MaxLiveInstancedPops)
+		{
+			RecycleOldestInstancedPop();
+		}
+
+		if (Batch.FreeSlots.Num() > 0)
+		{
+			SlotIndex = Batch.FreeSlots.Pop(EAllowShrinking::No);
+		}
+		else
+		{
+			SlotIndex = Batch.Component->AddInstance(FTransform(NumberLocation), /*bWorldSpace=*/ true);
+			check(SlotIndex == Batch.Slots.Num());
+			Batch.Slots.AddDefaulted();
+		}
+
+		FInstancedNumberPopSlot& Slot = Batch.Slots[SlotIndex];
+		Slot.WorldLocation = NumberLocation;
+		Slot.Target = Request.Target;
+		Slot.Number = FMath::Max(Request.NumberToDisplay, 0);
+		Slot.RandomSeed = FMath::FRand();
+		Slot.bIsCriticalDamage = Request.bIsCriticalDamage;
+		Slot.bLive = true;
+		Slot.SpawnTime = CurrentTime;
+
+		++NumLiveInstancedPops;
+	}
+
+	FInstancedNumberPopSlot& Slot = Batch.Slots[SlotIndex];
+	Slot.StartTime = CurrentTime;
+	Slot.ExpireTime = CurrentTime + ComponentLifespan;
+	NextInstancedExpireTime = FMath::Min(NextInstancedExpireTime, Slot.ExpireTime);
+
+	Batch.Component->UpdateInstanceTransform(SlotIndex, FTransform(CameraTransform.GetRotation(), Slot.WorldLocation), /*bWorldSpace=*/ true, /*bMarkRenderStateDirty=*/ false, /*bTeleport=*/ true);
+	WriteInstancedCustomData(Batch, SlotIndex, Request, CameraTransform);
+
+	SetComponentTickEnabled(true);
+}
+
+FInstancedNumberPopBatch& ULyraNumberPopComponent_MeshText::FindOrAddInstancedBatch(UStaticMesh* Mesh)
+{
+	FInstancedNumberPopBatch& Batch = InstancedBatches.FindOrAdd(Mesh);
+	if (Batch.Component == nullptr)
+	{
+		UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(GetOwner());
+		Component->SetupAttachment(nullptr);
+		Component->SetMobility(EComponentMobility::Movable);
+		Component->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+		Component->SetStaticMesh(Mesh);
+		Component->SetNumCustomDataFloats(LyraNumberPopCustomData::Num);
+
+		// Used to allow post-processes to opt out of affecting the number pop digits
+		Component->SetRenderCustomDepth(true);
+		Component->SetCustomDepthStencilValue(123);
+
+		// The digits travel a great distance from their original bounds due to
+		// world position offset (WPO) animation in the material, so expand bounds
+		Component->SetBoundsScale(2000.0f);
+
+		Component->RegisterComponent();
+
+		Batch.Component = Component;
+	}
+
+	return Batch;
+}
+
+int32 ULyraNumberPopComponent_MeshText::FindInstancedMergeSlot(const FInstancedNumberPopBatch& Batch, const FLyraNumberPopRequest& Request, float CurrentTime) const
+{
+	if (MergeWindow <= 0.0f)
+	{
+		return INDEX_NONE;
+	}
+
+	for (int32 SlotIndex = 0; SlotIndex < Batch.Slots.Num(); ++SlotIndex)
+	{
+		const FInstancedNumberPopSlot& Slot = Batch.Slots[SlotIndex];
+		// Measured from when the pop first appeared, so a steady stream of hits can't keep one pop alive and growing forever
+		if (!Slot.bLive || (Slot.bIsCriticalDamage != Request.bIsCriticalDamage) || ((CurrentTime - Slot.SpawnTime) > MergeWindow))
+		{
+			continue;
+		}
+
+		const bool bSameTarget = (Request.Target != nullptr)
+			? (Slot.Target.Get() == Request.Target)
+			: (!Slot.Target.IsValid() && (FVector::DistSquared(Slot.WorldLocation, Request.WorldLocation) <= FMath::Square(MergeRadius)));
+
+		if (bSameTarget)
+		{
+			return SlotIndex;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+void ULyraNumberPopComponent_MeshText::WriteInstancedCustomData(FInstancedNumberPopBatch& Batch, int32 SlotIndex, const FLyraNumberPopRequest& Request, const FTransform& CameraTransform)
+{
+	const FInstancedNumberPopSlot& Slot = Batch.Slots[SlotIndex];
+
+	// Custom data is stored as floats, which are only exact up to 2^24, so clamp to the largest 7 digit number
+	const int32 DisplayNumber = FMath::Min(Slot.Number, 9999999);
+
+	int32 NumDigits = 1;
+	for (int32 Remaining = DisplayNumber / 10; Remaining > 0; Remaining /= 10)
+	{
+		++NumDigits;
+	}
+
+	const float DistanceFromCameraToNumber = (CameraTransform.GetLocation() - Slot.WorldLocation).Size();
+	const float DistanceSpriteScale = DistanceFromCameraBeforeDoublingSize == 0.f ? 1.f : FMath::Clamp(DistanceFromCameraToNumber / DistanceFromCameraBeforeDoublingSize, 1.f, 1000000000.f);
+	const float HitSizeMultiplier = Slot.bIsCriticalDamage ? CriticalHitSizeMultiplier : 1.f;
+	const float FontSizeMultiplier = HitSizeMultiplier * DistanceSpriteScale;
+
+	const FLinearColor Color = DetermineColor(Request);
+
+	//@TODO: Determine whether or not we are spectating (see SetMaterialParameters)
+	const bool bIsSpectating = false;
+
+	float CustomData[LyraNumberPopCustomData::Num];
+	CustomData[LyraNumberPopCustomData::Number] = (float)DisplayNumber;
+	CustomData[LyraNumberPopCustomData::NumDigits] = (float)NumDigits;
+	CustomData[LyraNumberPopCustomData::ColorR] = Color.R;
+	CustomData[LyraNumberPopCustomData::ColorG] = Color.G;
+	CustomData[LyraNumberPopCustomData::ColorB] = Color.B;
+	CustomData[LyraNumberPopCustomData::SizeX] = FontXSize * FontSizeMultiplier;
+	CustomData[LyraNumberPopCustomData::SizeY] = FontYSize * FontSizeMultiplier;
+	CustomData[LyraNumberPopCustomData::StartTime] = Slot.StartTime;
+	CustomData[LyraNumberPopCustomData::Lifespan] = ComponentLifespan;
+	CustomData[LyraNumberPopCustomData::IsCriticalHit] = Slot.bIsCriticalDamage ? 1.f : 0.f;
+	CustomData[LyraNumberPopCustomData::RandomSeed] = Slot.RandomSeed;
+	CustomData[LyraNumberPopCustomData::MoveToCamera] = bIsSpectating ? 0.0f : 1.0f;
+
+	Batch.Component->SetCustomData(SlotIndex, MakeArrayView(CustomData), /*bMarkRenderStateDirty=*/ true);
+}
+
+void ULyraNumberPopComponent_MeshText::HideInstancedSlot(FInstancedNumberPopBatch& Batch, int32 SlotIndex)
+{
+	FInstancedNumberPopSlot& Slot = Batch.Slots[SlotIndex];
+	check(Slot.bLive);
+
+	Slot.bLive = false;
+	Slot.Target.Reset();
+	Batch.FreeSlots.Push(SlotIndex);
+	--NumLiveInstancedPops;
+
+	// Collapse the instance instead of removing it so the other instance indices stay stable
+	Batch.Component->UpdateInstanceTransform(SlotIndex, FTransform(FQuat::Identity, Slot.WorldLocation, FVector::ZeroVector), /*bWorldSpace=*/ true, /*bMarkRenderStateDirty=*/ false, /*bTeleport=*/ true);
+}
+
+void ULyraNumberPopComponent_MeshText::RecycleOldestInstancedPop()
+{
+	FInstancedNumberPopBatch* OldestBatch = nullptr;
+	int32 OldestSlotIndex = INDEX_NONE;
+	float OldestStartTime = TNumericLimits<float>::Max();
+
+	for (TPair<TObjectPtr<UStaticMesh>, FInstancedNumberPopBatch>& BatchPair : InstancedBatches)
+	{
+		FInstancedNumberPopBatch& Batch = BatchPair.Value;
+		for (int32 SlotIndex = 0; SlotIndex < Batch.Slots.Num(); ++SlotIndex)
+		{
+			const FInstancedNumberPopSlot& Slot = Batch.Slots[SlotIndex];
+			if (Slot.bLive && (Slot.StartTime < OldestStartTime))
+			{
+				OldestBatch = &Batch;
+				OldestSlotIndex = SlotIndex;
+				OldestStartTime = Slot.StartTime;
+			}
+		}
+	}
+
+	if (OldestBatch != nullptr)
+	{
+		HideInstancedSlot(*OldestBatch, OldestSlotIndex);
+		OldestBatch->Component->MarkRenderStateDirty();
+	}
+}
+
+void ULyraNumberPopComponent_MeshText::ExpireInstancedNumberPops()
+{
+	UWorld* LocalWorld = GetWorld();
+	check(LocalWorld);
+
+	const float CurrentTime = LocalWorld->GetRealTimeSeconds();
+	if (CurrentTime < NextInstancedExpireTime)
+	{
+		return;
+	}
+
+	NextInstancedExpireTime = TNumericLimits<float>::Max();
+
+	for (TPair<TObjectPtr<UStaticMesh>, FInstancedNumberPopBatch>& BatchPair : InstancedBatches)
+	{
+		FInstancedNumberPopBatch& Batch = BatchPair.Value;
+
+		bool bAnyExpired = false;
+		for (int32 SlotIndex = 0; SlotIndex < Batch.Slots.Num(); ++SlotIndex)
+		{
+			const FInstancedNumberPopSlot& Slot = Batch.Slots[SlotIndex];
+			if (!Slot.bLive)
+			{
+				continue;
+			}
+
+			if (CurrentTime >= Slot.ExpireTime)
+			{
+				HideInstancedSlot(Batch, SlotIndex);
+				bAnyExpired = true;
+			}
+			else
+			{
+				NextInstancedExpireTime = FMath::Min(NextInstancedExpireTime, Slot.ExpireTime);
+			}
+		}
+
+		// One render state update for everything that expired in this batch
+		if (bAnyExpired)
+		{
+			Batch.Component->MarkRenderStateDirty();
+		}
+	}
+
+	if (NumLiveInstancedPops == 0)
+	{
+		SetComponentTickEnabled(false);
+	}
 }
 
 void ULyraNumberPopComponent_MeshText::ReleaseNextComponents()
@@ -6,6 +6,8 @@
 
 #include "LyraNumberPopComponent_MeshText.generated.h"
 
+class AActor;
+class UInstancedStaticMeshComponent;
 class ULyraDamagePopStyle;
 class UMaterialInstanceDynamic;
 class UObject;
@@ -44,6 +46,77 @@ struct FLiveNumberPopEntry
 	{}
 };
 
+/**
+ * Per-instance custom data written by the instanced renderer, the text mesh material reads these
+ * with PerInstanceCustomData instead of the per-digit MID parameters
+ */
+namespace LyraNumberPopCustomData
+{
+	enum Type : int32
+	{
+		// The number to display (digits are extracted in the material)
+		Number = 0,
+		NumDigits,
+		ColorR,
+		ColorG,
+		ColorB,
+		// Digit size, already scaled for critical hits and camera distance
+		SizeX,
+		SizeY,
+		// Real time in seconds that the pop (re)started, the material derives the age from it
+		StartTime,
+		Lifespan,
+		IsCriticalHit,
+		RandomSeed,
+		MoveToCamera,
+
+		Num
+	};
+}
+
+/** One instance of an instanced number pop batch, expired instances are hidden and reused rather than removed */
+struct FInstancedNumberPopSlot
+{
+	/** The world location the pop was spawned at */
+	FVector WorldLocation = FVector::ZeroVector;
+
+	/** The target the pop is for, if the request had one */
+	TWeakObjectPtr<const AActor> Target;
+
+	/** The real time that this pop first appeared, merging is only allowed within MergeWindow of it */
+	float SpawnTime = 0.0f;
+
+	/** The real time that this pop was last (re)started, the material animates from it and the oldest pop is recycled first */
+	float StartTime = 0.0f;
+
+	/** The real time that this pop will be hidden */
+	float ExpireTime = 0.0f;
+
+	float RandomSeed = 0.0f;
+
+	int32 Number = 0;
+
+	bool bIsCriticalDamage = false;
+
+	bool bLive = false;
+};
+
+USTRUCT()
+struct FInstancedNumberPopBatch
+{
+	GENERATED_BODY()
+
+	/** Renders every pop that uses this mesh, one instance per slot */
+	UPROPERTY(transient)
+	TObjectPtr<UInstancedStaticMeshComponent> Component = nullptr;
+
+	/** Indexed by instance index */
+	TArray<FInstancedNumberPopSlot> Slots;
+
+	/** Slots that are not live and can be reused */
+	TArray<int32> FreeSlots;
+};
+
 /** Struct that holds the info for a new damage number */
 struct FTempNumberPopInfo
 {
@@ -70,7 +143,13 @@ public:
 	virtual void AddNumberPop(const FLyraNumberPopRequest& NewRequest) override;
 	//~End of ULyraNumberPopComponent interface
 
+	//~UActorComponent interface
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	//~End of UActorComponent interface
+
 protected:
+	void DetermineCameraTransformAndLocation(const FLyraNumberPopRequest& Request, FTransform& OutCameraTransform, FVector& OutNumberLocation) const;
+
 	void SetMaterialParameters(const FLyraNumberPopRequest& Request, FTempNumberPopInfo& NewDamageNumberInfo, const FTransform& CameraTransform, const FVector& NumberLocation);
 
 	FLinearColor DetermineColor(const FLyraNumberPopRequest& Request) const;
@@ -80,6 +159,20 @@ protected:
 	/** Releases components back to the pool that have exceeded their lifespan */
 	void ReleaseNextComponents();
 
+	/** Adds (or merges) a pop into the instanced batch for its mesh */
+	void AddInstancedNumberPop(const FLyraNumberPopRequest& Request, UStaticMesh* Mesh);
+
+	FInstancedNumberPopBatch& FindOrAddInstancedBatch(UStaticMesh* Mesh);
+	int32 FindInstancedMergeSlot(const FInstancedNumberPopBatch& Batch, const FLyraNumberPopRequest& Request, float CurrentTime) const;
+	void WriteInstancedCustomData(FInstancedNumberPopBatch& Batch, int32 SlotIndex, const FLyraNumberPopRequest& Request, const FTransform& CameraTransform);
+	void HideInstancedSlot(FInstancedNumberPopBatch& Batch, int32 SlotIndex);
+
+	/** Hides the oldest live instanced pop to make room for a new one */
+	void RecycleOldestInstancedPop();
+
+	/** Hides every instanced pop that has exceeded its lifespan in one pass */
+	void ExpireInstancedNumberPops();
+
 	/** Style patterns to attempt to apply to the incoming number pops */
 	UPROPERTY(EditDefaultsOnly, Category="Number Pop|Style")
 	TArray<TObjectPtr<ULyraDamagePopStyle>> Styles;
@@ -130,6 +223,25 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Material Bindings")
 	TArray<FName> DurationParameterNames;
 
+	/**
+	 * Render all pops with one instanced static mesh component per text mesh instead of a component and MIDs per pop.
+	 * The text mesh material has to read the per-instance custom data (see LyraNumberPopCustomData).
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Instancing")
+	bool bUseInstancedRenderer = false;
+
+	/** Maximum number of live instanced pops, the oldest one is recycled when a new one doesn't fit */
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Instancing", meta=(EditCondition=bUseInstancedRenderer, ClampMin=1))
+	int32 MaxLiveInstancedPops;
+
+	/** Pops for the same target that arrive within this many seconds of the first one are merged into it (0 = never merge) */
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Instancing", meta=(EditCondition=bUseInstancedRenderer, ClampMin=0.0, ForceUnits=s))
+	float MergeWindow;
+
+	/** Pops without a target are merged if they are closer than this */
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Instancing", meta=(EditCondition=bUseInstancedRenderer, ClampMin=0.0, ForceUnits=cm))
+	float MergeRadius;
+
 	UPROPERTY(Transient)
 	TMap<TObjectPtr<UStaticMesh>, FPooledNumberPopComponentList> PooledComponentMap;
 
@@ -137,4 +249,13 @@ protected:
 	TArray<FLiveNumberPopEntry> LiveComponents;
 
 	FTimerHandle ReleaseTimerHandle;
+
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UStaticMesh>, FInstancedNumberPopBatch> InstancedBatches;
+
+	/** Number of live instanced pops across all batches */
+	int32 NumLiveInstancedPops = 0;
+
+	/** The earliest real time that a live instanced pop expires */
+	float NextInstancedExpireTime = TNumericLimits<float>::Max();
 };
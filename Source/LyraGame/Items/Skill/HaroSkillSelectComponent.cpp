@@ -7,6 +7,9 @@
 #include "AbilitySystemComponent.h"
 #include "Equipment/LyraEquipmentInstance.h"
 #include "Net/UnrealNetwork.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "LyraLogChannels.h"
 
 
 
@@ -32,6 +35,41 @@ void UHaroSkillSelectComponent::BeginPlay()
 	// 테스트를 위해 여기서 무기 태그 임시로 넣기.
 	CurrentWeaponTags.Add(FGameplayTag::RequestGameplayTag("Skill.Weapon.Bow"));
 	CurrentWeaponTags.Add(FGameplayTag::RequestGameplayTag("Skill.Weapon.Rifle"));
+
+	if (SkillOptionSeed != 0)
+	{
+		SkillOptionRandomStream.Initialize(SkillOptionSeed);
+	}
+	else
+	{
+		SkillOptionRandomStream.GenerateNewSeed();
+	}
+}
+
+void UHaroSkillSelectComponent::SetSkillOptionSeed(int32 Seed)
+{
+	SkillOptionSeed = Seed;
+	SkillOptionRandomStream.Initialize(Seed);
+}
+
+void UHaroSkillSelectComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	for (FHaroPendingSkillGrant& PendingGrant : PendingSkillGrants)
+	{
+		if (PendingGrant.LoadHandle.IsValid())
+		{
+			PendingGrant.LoadHandle->CancelHandle();
+		}
+	}
+	PendingSkillGrants.Reset();
+
+	if (SkillOptionPreloadHandle.IsValid())
+	{
+		SkillOptionPreloadHandle->CancelHandle();
+		SkillOptionPreloadHandle.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 TArray<FHaroSkillDataEntry> UHaroSkillSelectComponent::GenerateSkillOptions(const FGameplayTag& SkillCategory)
@@ -39,7 +77,12 @@ TArray<FHaroSkillDataEntry> UHaroSkillSelectComponent::GenerateSkillOptions(cons
 	// 무기 스킬인 경우
 	if (SkillCategory.MatchesTag(FGameplayTag::RequestGameplayTag("Skill.Weapon")))
 	{
-		return GenerateSkillOptionsForWeapons();
+		TArray<FHaroSkillDataEntry> SkillOptions = GenerateSkillOptionsForWeapons();
+
+		// 플레이어가 고르는 동안 어빌리티 클래스를 미리 로드
+		PreloadSkillOptions(SkillOptions);
+
+		return SkillOptions;
 	}
 
 	// TODO
@@ -56,108 +99,161 @@ TArray<FHaroSkillDataEntry> UHaroSkillSelectComponent::GenerateSkillOptionsForWe
 		return TArray<FHaroSkillDataEntry>();
 	}
 
-	const UHaroSkillData& SkillData = UHaroSkillData::Get();
-	TArray<FHaroSkillDataEntry> AllAvailableSkills;
+	const FHaroCompiledSkillGraph& SkillGraph = UHaroSkillData::Get().GetCompiledSkillGraph();
 
-	// 각 무기 태그에 해당하는 스킬들을 수집
-	for (const FGameplayTag& WeaponTag : CurrentWeaponTags)
+	// 스킬 데이터가 다시 컴파일됐으면 비트셋도 다시 만듦
+	if (OwnedSkillBits.Words.Num() != FMath::DivideAndRoundUp(SkillGraph.NumSkills(), 64))
 	{
-		TArray<FHaroSkillDataEntry> WeaponSkills = SkillData.GetSkillsByTag(WeaponTag);
+		RebuildOwnedSkillBits();
+	}
 
-		for (const FHaroSkillDataEntry& SkillEntry : WeaponSkills)
+	// 각 무기 태그에 해당하는 스킬 중 선택 가능한 것만 수집 (인덱스만 다룸)
+	ScratchEligibleSkills.Reset();
+	for (const FGameplayTag& WeaponTag : CurrentWeaponTags)
+	{
+		if (const TArray<int32>* WeaponSkillIndices = SkillGraph.SkillIndicesByTag.Find(WeaponTag))
 		{
-			// 선택 가능한 스킬인지 확인
-			if (IsSkillSelectable(SkillEntry))
+			for (const int32 SkillIndex : *WeaponSkillIndices)
 			{
-				AllAvailableSkills.Add(SkillEntry);
-
-				UE_LOG(LogTemp, Log, TEXT("Added selectable skill: %s (ID: %s)"),
-					*SkillEntry.SkillData.Name, *SkillEntry.SkillID.ToString());
+				if (SkillGraph.IsSkillEligible(SkillIndex, OwnedSkillBits))
+				{
+					ScratchEligibleSkills.Add(SkillIndex);
+				}
 			}
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("Total available skills: %d"), AllAvailableSkills.Num());
+	UE_LOG(LogTemp, Log, TEXT("Total available skills: %d"), ScratchEligibleSkills.Num());
 
 	// 랜덤하게 MaxSkillOptions 개수만큼 선택
-	return SelectRandomSkills(AllAvailableSkills, MaxSkillOptions);
-}
+	const int32 NumSelected = SampleEligibleSkills(MaxSkillOptions);
 
+	// 반환할 때만 스킬 데이터를 복사
+	TArray<FHaroSkillDataEntry> SelectedSkills;
+	SelectedSkills.Reserve(NumSelected);
+	for (int32 Index = 0; Index < NumSelected; ++Index)
+	{
+		SelectedSkills.Add(SkillGraph.Skills[ScratchEligibleSkills[Index]]);
+	}
 
-bool UHaroSkillSelectComponent::IsSkillSelectable(const FHaroSkillDataEntry& SkillEntry) const
-{
-	// 1. 이미 보유한 스킬인지 확인 (중복 불허)
-	if (OwnedSkillIDs.Contains(SkillEntry.SkillID)) return false;
+	return SelectedSkills;
+}
 
-	// 2. 필수 스킬 조건 확인
-	if (!CheckRequiredSkills(SkillEntry)) return false;
+int32 UHaroSkillSelectComponent::SampleEligibleSkills(int32 Count)
+{
+	// 부분 Fisher-Yates: 앞에서부터 한 칸씩 나머지 중 하나와 교환
+	const int32 NumEligible = ScratchEligibleSkills.Num();
+	const int32 SelectionCount = FMath::Clamp(Count, 0, NumEligible);
 
-	// 3. 충돌 스킬 조건 확인
-	if (!CheckConflictSkills(SkillEntry)) return false;
+	for (int32 Index = 0; Index < SelectionCount; ++Index)
+	{
+		const int32 SwapIndex = SkillOptionRandomStream.RandRange(Index, NumEligible - 1);
+		ScratchEligibleSkills.Swap(Index, SwapIndex);
+	}
 
-	return true;
+	return SelectionCount;
 }
 
-bool UHaroSkillSelectComponent::CheckRequiredSkills(const FHaroSkillDataEntry& SkillEntry) const
+void UHaroSkillSelectComponent::SetSkillOwned(const FName& SkillID, bool bOwned)
 {
-	const FHaroSkillDataRow& Skill = SkillEntry.SkillData;
+	const FHaroCompiledSkillGraph& SkillGraph = UHaroSkillData::Get().GetCompiledSkillGraph();
 
-	// 필수 스킬이 없으면 통과
-	if (Skill.RequiredSkillIDs.IsEmpty()) return true;
+	if (OwnedSkillBits.Words.Num() != FMath::DivideAndRoundUp(SkillGraph.NumSkills(), 64))
+	{
+		// OwnedSkillIDs는 이미 갱신된 상태이므로 통째로 다시 만듦
+		RebuildOwnedSkillBits();
+		return;
+	}
 
-	// 모든 필수 스킬을 보유하고 있는지 확인
-	for (const FName& RequiredSkillID : Skill.RequiredSkillIDs)
+	const int32 SkillIndex = SkillGraph.FindSkillIndex(SkillID);
+	if (SkillIndex != INDEX_NONE)
 	{
-		if (!OwnedSkillIDs.Contains(RequiredSkillID))
-			return false;
+		OwnedSkillBits.Set(SkillIndex, bOwned);
 	}
+}
 
-	return true;
+void UHaroSkillSelectComponent::RebuildOwnedSkillBits()
+{
+	const FHaroCompiledSkillGraph& SkillGraph = UHaroSkillData::Get().GetCompiledSkillGraph();
+
+	OwnedSkillBits.Init(SkillGraph.NumSkills());
+	for (const FName& OwnedSkillID : OwnedSkillIDs)
+	{
+		const int32 SkillIndex = SkillGraph.FindSkillIndex(OwnedSkillID);
+		if (SkillIndex != INDEX_NONE)
+		{
+			OwnedSkillBits.Set(SkillIndex);
+		}
+	}
 }
 
-bool UHaroSkillSelectComponent::CheckConflictSkills(const FHaroSkillDataEntry& SkillEntry) const
+void UHaroSkillSelectComponent::OnRep_OwnedSkillIDs()
 {
-	const FHaroSkillDataRow& Skill = SkillEntry.SkillData;
+	RebuildOwnedSkillBits();
+}
 
-	// 충돌 스킬이 없으면 통과
-	if (Skill.ConflictSkillIDs.IsEmpty()) return true;
+void UHaroSkillSelectComponent::PreloadSkillOptions(const TArray<FHaroSkillDataEntry>& SkillOptions)
+{
+	TArray<FSoftObjectPath> AbilityClassPaths;
+	TArray<FName> SkillIDs;
 
-	// 충돌하는 스킬을 하나라도 보유하고 있으면 선택 불가
-	for (const FName& ConflictSkillID : Skill.ConflictSkillIDs)
+	for (const FHaroSkillDataEntry& SkillOption : SkillOptions)
 	{
-		if (OwnedSkillIDs.Contains(ConflictSkillID))
-			return false;
+		if (!SkillOption.SkillData.AbilityClass.IsNull())
+		{
+			AbilityClassPaths.Add(SkillOption.SkillData.AbilityClass.ToSoftObjectPath());
+			SkillIDs.Add(SkillOption.SkillID);
+		}
 	}
 
-	return true;
+	RequestSkillOptionPreload(MoveTemp(AbilityClassPaths));
+
+	// 실제 부여는 서버에서 하므로 서버에도 알려줌
+	if (GetOwner() && !GetOwner()->HasAuthority() && (SkillIDs.Num() > 0))
+	{
+		ServerPreloadSkillOptions(SkillIDs);
+	}
 }
 
-TArray<FHaroSkillDataEntry> UHaroSkillSelectComponent::SelectRandomSkills(const TArray<FHaroSkillDataEntry>& AvailableSkills, int32 Count) const
+void UHaroSkillSelectComponent::ServerPreloadSkillOptions_Implementation(const TArray<FName>& SkillIDs)
 {
-	TArray<FHaroSkillDataEntry> SelectedSkills;
-	TArray<FHaroSkillDataEntry> SkillPool = AvailableSkills;
+	const UHaroSkillData& SkillData = UHaroSkillData::Get();
 
-	// 요청된 개수만큼 또는 사용 가능한 스킬 개수만큼 선택
-	int32 SelectionCount = FMath::Min(Count, SkillPool.Num());
+	TArray<FSoftObjectPath> AbilityClassPaths;
 
-	for (int32 i = 0; i < SelectionCount; ++i)
+	// 한 번에 제시되는 개수 이상은 받지 않음
+	const int32 NumSkillIDs = FMath::Min(SkillIDs.Num(), MaxSkillOptions);
+	for (int32 Index = 0; Index < NumSkillIDs; ++Index)
 	{
-		if (SkillPool.IsEmpty())
+		const TSoftClassPtr<ULyraGameplayAbility> AbilityClass = SkillData.FindAbilityClassBySkillID(SkillIDs[Index]);
+		if (!AbilityClass.IsNull())
 		{
-			break;
+			AbilityClassPaths.Add(AbilityClass.ToSoftObjectPath());
 		}
+	}
 
-		// 랜덤 인덱스 선택
-		int32 RandomIndex = FMath::RandRange(0, SkillPool.Num() - 1);
-
-		// 선택된 스킬을 결과 배열에 추가
-		SelectedSkills.Add(SkillPool[RandomIndex]);
+	RequestSkillOptionPreload(MoveTemp(AbilityClassPaths));
+}
 
-		// 중복 선택 방지를 위해 풀에서 제거
-		SkillPool.RemoveAt(RandomIndex);
+void UHaroSkillSelectComponent::RequestSkillOptionPreload(TArray<FSoftObjectPath>&& AbilityClassPaths)
+{
+	// 이전 옵션들은 더 이상 붙잡고 있을 필요 없음
+	if (SkillOptionPreloadHandle.IsValid())
+	{
+		SkillOptionPreloadHandle->ReleaseHandle();
+		SkillOptionPreloadHandle.Reset();
 	}
 
-	return SelectedSkills;
+	if (AbilityClassPaths.Num() > 0)
+	{
+		SkillOptionPreloadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+			MoveTemp(AbilityClassPaths),
+			FStreamableDelegate(),
+			FStreamableManager::DefaultAsyncLoadPriority,
+			/*bManageActiveHandle=*/ false,
+			/*bStartStalled=*/ false,
+			TEXT("HaroSkillOptionPreload"));
+	}
 }
 
 void UHaroSkillSelectComponent::ServerApplySelectedSkill_Implementation(const FHaroSkillDataEntry& SelectedSkill)
@@ -168,8 +264,85 @@ void UHaroSkillSelectComponent::ServerApplySelectedSkill_Implementation(const FH
 	// 이미 있는 스킬이면 return
 	if (OwnedSkillIDs.Contains(SkillID)) return;
 
-	UClass* AbilityClass = Skill.AbilityClass.LoadSynchronous();
-	if (!AbilityClass) return;
+	// 이미 로드 대기 중인 스킬이면 return (RPC 중복)
+	if (PendingSkillGrants.ContainsByPredicate([&SkillID](const FHaroPendingSkillGrant& PendingGrant) { return PendingGrant.Skill.SkillID == SkillID; }))
+		return;
+
+	if (Skill.AbilityClass.IsNull()) return;
+
+	// 요청 순서대로 적용하기 위해 항상 큐에 넣음 (이미 로드된 클래스면 바로 처리됨)
+	const int32 PendingIndex = PendingSkillGrants.Num();
+	PendingSkillGrants.AddDefaulted_GetRef().Skill = SelectedSkill;
+
+	if (Skill.AbilityClass.Get() == nullptr)
+	{
+		// 서버 프레임을 막지 않도록 비동기로 로드
+		TSharedPtr<FStreamableHandle> LoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+			Skill.AbilityClass.ToSoftObjectPath(),
+			FStreamableDelegate::CreateUObject(this, &ThisClass::OnPendingSkillLoaded),
+			FStreamableManager::AsyncLoadHighPriority,
+			/*bManageActiveHandle=*/ false,
+			/*bStartStalled=*/ false,
+			TEXT("HaroSkillGrant"));
+
+		// 요청 중에 콜백이 바로 불려서 이미 처리됐을 수도 있음
+		if (PendingSkillGrants.IsValidIndex(PendingIndex) && (PendingSkillGrants[PendingIndex].Skill.SkillID == SkillID))
+		{
+			PendingSkillGrants[PendingIndex].LoadHandle = LoadHandle;
+		}
+	}
+
+	ProcessPendingSkillGrants();
+}
+
+void UHaroSkillSelectComponent::OnPendingSkillLoaded()
+{
+	ProcessPendingSkillGrants();
+}
+
+void UHaroSkillSelectComponent::ProcessPendingSkillGrants()
+{
+	// 앞에서부터 로드가 끝난 요청만 적용 (교체 스킬 순서가 바뀌지 않도록)
+	int32 NumProcessed = 0;
+	for (; NumProcessed < PendingSkillGrants.Num(); ++NumProcessed)
+	{
+		FHaroPendingSkillGrant& PendingGrant = PendingSkillGrants[NumProcessed];
+
+		if (PendingGrant.LoadHandle.IsValid() && PendingGrant.LoadHandle->IsLoadingInProgress())
+		{
+			break;
+		}
+
+		UClass* AbilityClass = PendingGrant.Skill.SkillData.AbilityClass.Get();
+		if (AbilityClass)
+		{
+			ApplySelectedSkill(PendingGrant.Skill, AbilityClass);
+		}
+		else
+		{
+			UE_LOG(LogLyra, Warning, TEXT("Failed to load ability class for skill %s (%s)"),
+				*PendingGrant.Skill.SkillID.ToString(), *PendingGrant.Skill.SkillData.AbilityClass.ToString());
+		}
+
+		if (PendingGrant.LoadHandle.IsValid())
+		{
+			PendingGrant.LoadHandle->ReleaseHandle();
+		}
+	}
+
+	if (NumProcessed > 0)
+	{
+		PendingSkillGrants.RemoveAt(0, NumProcessed);
+	}
+}
+
+void UHaroSkillSelectComponent::ApplySelectedSkill(const FHaroSkillDataEntry& SelectedSkill, UClass* AbilityClass)
+{
+	const FName& SkillID = SelectedSkill.SkillID;
+	const FHaroSkillDataRow& Skill = SelectedSkill.SkillData;
+
+	// 로드를 기다리는 동안 다른 경로로 얻었을 수 있음
+	if (OwnedSkillIDs.Contains(SkillID)) return;
 
 	UAbilitySystemComponent* ASC = GetAbilitySystemComponent();
 	if (!ASC) return;
@@ -218,6 +391,7 @@ bool UHaroSkillSelectComponent::RemoveReplacedSkill(const TArray<FName>& Replace
 			// 맵에서도 제거
 			OwnedSkillHandles.Remove(ReplaceSkillID);
 			OwnedSkillIDs.Remove(ReplaceSkillID);
+			SetSkillOwned(ReplaceSkillID, false);
 
 			UE_LOG(LogTemp, Log, TEXT("Successfully replaced skill: %s"), *ReplaceSkillID.ToString());
 		}
@@ -249,6 +423,7 @@ bool UHaroSkillSelectComponent::AddNewSkill(const FName& SkillID, const FHaroSki
 		// 이미 중복 체크 했으므로 바로
 		OwnedSkillHandles.Add(SkillID, Handle);
 		OwnedSkillIDs.AddUnique(SkillID);
+		SetSkillOwned(SkillID, true);
 		UE_LOG(LogTemp, Log, TEXT("Skill Added: %s (ID: %s, Level: %d)"),
 			*SkillData.Name, *SkillID.ToString(), SkillData.SkillLevel);
 		return true;
@@ -268,6 +443,7 @@ bool UHaroSkillSelectComponent::RegisterSkillHandle(const FName& SkillID, const
 
 	OwnedSkillHandles.Add(SkillID, Handle);
 	OwnedSkillIDs.AddUnique(SkillID);
+	SetSkillOwned(SkillID, true);
 
 	return true;
 }
@@ -285,6 +461,7 @@ bool UHaroSkillSelectComponent::UnregisterSkillHandle(const FName& SkillID)
 	// 맵에서 제거
 	OwnedSkillHandles.Remove(SkillID);
 	OwnedSkillIDs.Remove(SkillID);
+	SetSkillOwned(SkillID, false);
 
 	return true;
 }
@@ -8,6 +8,15 @@
 #include "Data/HaroSkillData.h" // 반환값으로 사용 중이니 완전체가 필요하므로 전방 선언 대신에 이를 사용.
 #include "HaroSkillSelectComponent.generated.h"
 
+struct FStreamableHandle;
+
+// 어빌리티 클래스 로드를 기다리는 스킬 부여 요청 (서버 전용)
+struct FHaroPendingSkillGrant
+{
+	FHaroSkillDataEntry Skill;
+	TSharedPtr<FStreamableHandle> LoadHandle;
+};
+
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class LYRAGAME_API UHaroSkillSelectComponent : public UActorComponent
@@ -25,27 +34,46 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Skill Selection")
 	TArray<FHaroSkillDataEntry> GenerateSkillOptions(const FGameplayTag& SkillCategory);
 
+	// 어빌리티 클래스를 비동기로 로드한 뒤 부여함 (요청 순서대로 적용)
 	UFUNCTION(Server, Reliable, BlueprintCallable, Category = "Skill Selection")
 	void ServerApplySelectedSkill(const FHaroSkillDataEntry& SelectedSkill);
 
+	// 클라이언트에 제시된 스킬 옵션들을 서버에서도 미리 로드
+	UFUNCTION(Server, Unreliable)
+	void ServerPreloadSkillOptions(const TArray<FName>& SkillIDs);
+
+	// 스킬 옵션 랜덤 시드 설정 (같은 시드 + 같은 보유 스킬이면 같은 옵션이 나옴)
+	UFUNCTION(BlueprintCallable, Category = "Skill Selection")
+	void SetSkillOptionSeed(int32 Seed);
+
 	// 소유한 스킬 맵 조작 관련 헬퍼 함수들 (맵만 조작함.) -> 이것도 playerState로 넘어갈지도.
 	bool RegisterSkillHandle(const FName& SkillID, const FGameplayAbilitySpecHandle& Handle);
 	bool UnregisterSkillHandle(const FName& SkillID);
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 		
 	// 현재 플레이어가 보유한 무기 태그들에 대한 스킬 옵션 생성
 	TArray<FHaroSkillDataEntry> GenerateSkillOptionsForWeapons();
 	
 private:
-	// 스킬이 선택 가능한지 확인하는 헬퍼 함수들
-	bool IsSkillSelectable(const FHaroSkillDataEntry& SkillEntry) const;
-	bool CheckRequiredSkills(const FHaroSkillDataEntry& SkillEntry) const;
-	bool CheckConflictSkills(const FHaroSkillDataEntry& SkillEntry) const;
+	// 보유 스킬 비트셋 관리 (OwnedSkillIDs와 항상 같이 갱신)
+	void SetSkillOwned(const FName& SkillID, bool bOwned);
+	void RebuildOwnedSkillBits();
+
+	UFUNCTION()
+	void OnRep_OwnedSkillIDs();
 
-	// 랜덤 선택 헬퍼
-	TArray<FHaroSkillDataEntry> SelectRandomSkills(const TArray<FHaroSkillDataEntry>& AvailableSkills, int32 Count) const;
+	// 랜덤 선택 헬퍼 (시드 기반 부분 셔플, 선택된 인덱스는 ScratchEligibleSkills 앞쪽에 모임)
+	int32 SampleEligibleSkills(int32 Count);
+
+	// 비동기 로드 관련 헬퍼 함수들
+	void PreloadSkillOptions(const TArray<FHaroSkillDataEntry>& SkillOptions);
+	void RequestSkillOptionPreload(TArray<FSoftObjectPath>&& AbilityClassPaths);
+	void OnPendingSkillLoaded();
+	void ProcessPendingSkillGrants();
+	void ApplySelectedSkill(const FHaroSkillDataEntry& SelectedSkill, UClass* AbilityClass);
 
 	// 선택된 스킬 부여 관련 헬퍼 함수들
 	bool RemoveReplacedSkill(const TArray<FName>& ReplaceSkillIDs, UAbilitySystemComponent* ASC, /*OUT*/ UObject*& OutSourceObject);
@@ -59,14 +87,33 @@ protected:
 	TArray<FGameplayTag> CurrentWeaponTags;
 
 	// 클라 UI 표시용
-	UPROPERTY(Replicated, BlueprintReadOnly)
+	UPROPERTY(ReplicatedUsing = OnRep_OwnedSkillIDs, BlueprintReadOnly)
 	TArray<FName> OwnedSkillIDs;
 
+	// OwnedSkillIDs를 컴파일된 스킬 그래프의 dense 인덱스로 바꾼 것 (선택 가능 여부 검사용)
+	FHaroSkillBitSet OwnedSkillBits;
+
+	// 선택 가능한 스킬 인덱스 (옵션 생성마다 재사용)
+	TArray<int32> ScratchEligibleSkills;
+
+	// 스킬 옵션 선택용 랜덤 스트림
+	FRandomStream SkillOptionRandomStream;
+
 	// 현재 플레이어가 보유한 스킬 {ID : Handle} -> playerstate로 뺄듯?
 	UPROPERTY(BlueprintReadOnly, Category = "Current State")
 	TMap<FName, FGameplayAbilitySpecHandle> OwnedSkillHandles; // 서버 전용
 
+	// 로드 대기 중인 스킬 부여 요청들 (서버 전용, 요청 순서 유지)
+	TArray<FHaroPendingSkillGrant> PendingSkillGrants;
+
+	// 현재 제시된 스킬 옵션들의 미리 로드 핸들 (다음 옵션 생성 때 교체)
+	TSharedPtr<FStreamableHandle> SkillOptionPreloadHandle;
+
 	// 한 번에 제공할 스킬 옵션 개수
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
 	int32 MaxSkillOptions = 3;
+
+	// 스킬 옵션 랜덤 시드 (0이면 BeginPlay에서 임의로 정함)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings")
+	int32 SkillOptionSeed = 0;
 };
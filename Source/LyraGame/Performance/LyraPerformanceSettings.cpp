@@ -38,5 +38,26 @@ ULyraPerformanceSettings::ULyraPerformanceSettings()
 	{
 		StatGroup.AllowedStats.Add(PerfStat);
 	}
+
+	// Default significance tiers
+	auto AddSignificanceTier = [this](FName Name, float MinSignificance, int32 MaxCharacters, int32 MaxProjectiles, int32 MaxAOEs, int32 AnimationFrameSkip, float ComponentTickInterval, bool bAllowContextEffects, bool bAllowNumberPops)
+	{
+		FLyraSignificanceTier& Tier = SignificanceTiers.AddDefaulted_GetRef();
+		Tier.Name = Name;
+		Tier.MinSignificance = MinSignificance;
+		Tier.MaxCharacters = MaxCharacters;
+		Tier.MaxProjectiles = MaxProjectiles;
+		Tier.MaxAOEs = MaxAOEs;
+		Tier.AnimationFrameSkip = AnimationFrameSkip;
+		Tier.ComponentTickInterval = ComponentTickInterval;
+		Tier.bAllowContextEffects = bAllowContextEffects;
+		Tier.bAllowNumberPops = bAllowNumberPops;
+	};
+
+	// Low still plays context effects: things behind the camera or occluded score low but should still be heard
+	AddSignificanceTier(TEXT("High"), 0.6f, 8, 16, 4, 0, 0.0f, true, true);
+	AddSignificanceTier(TEXT("Medium"), 0.3f, 16, 32, 8, 1, 0.05f, true, true);
+	AddSignificanceTier(TEXT("Low"), 0.05f, 0, 0, 0, 3, 0.2f, true, true);
+	AddSignificanceTier(TEXT("Insignificant"), 0.0f, 0, 0, 0, 7, 0.5f, false, false);
 }
 
@@ -50,6 +50,49 @@ struct FLyraPerformanceStatGroup
 	TSet<ELyraDisplayablePerformanceStat> AllowedStats;
 };
 
+// One significance tier (see ULyraSignificanceManager); tiers are listed from most to least significant
+USTRUCT()
+struct FLyraSignificanceTier
+{
+	GENERATED_BODY()
+
+	// Display name used by "showdebug Significance"
+	UPROPERTY(EditAnywhere)
+	FName Name;
+
+	// Objects need at least this significance (0..1) to be placed in this tier
+	UPROPERTY(EditAnywhere, meta=(ClampMin=0.0, ClampMax=1.0))
+	float MinSignificance = 0.0f;
+
+	// Maximum number of characters in this tier, anything over budget drops to the next tier (0 = unlimited)
+	UPROPERTY(EditAnywhere, meta=(ClampMin=0))
+	int32 MaxCharacters = 0;
+
+	// Maximum number of projectiles in this tier, budgeted separately so bursts of fire don't demote characters (0 = unlimited)
+	UPROPERTY(EditAnywhere, meta=(ClampMin=0))
+	int32 MaxProjectiles = 0;
+
+	// Maximum number of AOEs in this tier (0 = unlimited)
+	UPROPERTY(EditAnywhere, meta=(ClampMin=0))
+	int32 MaxAOEs = 0;
+
+	// Number of animation frames to skip between updates on simulated characters (0 = update every frame)
+	UPROPERTY(EditAnywhere, meta=(ClampMin=0, ClampMax=15))
+	int32 AnimationFrameSkip = 0;
+
+	// Minimum tick interval for ticking components on simulated actors (movement and meshes are never throttled)
+	UPROPERTY(EditAnywhere, meta=(ClampMin=0.0, ForceUnits=s))
+	float ComponentTickInterval = 0.0f;
+
+	// Whether context effects (footsteps, impacts, etc...) are spawned for actors in this tier
+	UPROPERTY(EditAnywhere)
+	bool bAllowContextEffects = true;
+
+	// Whether damage number pops are shown at locations in this tier
+	UPROPERTY(EditAnywhere)
+	bool bAllowNumberPops = true;
+};
+
 // How hare frame pacing and overall graphics settings controlled/exposed for the platform?
 UENUM()
 enum class ELyraFramePacingMode : uint8
@@ -140,4 +183,28 @@ public:
 	// The list of performance stats that can be enabled in Options by the user
 	UPROPERTY(EditAnywhere, Config, Category=Stats)
 	TArray<FLyraPerformanceStatGroup> UserFacingPerformanceStats;
+
+	// Significance tiers, from most to least significant (objects that don't fit anywhere go in the last one)
+	UPROPERTY(EditAnywhere, Config, Category=Significance)
+	TArray<FLyraSignificanceTier> SignificanceTiers;
+
+	// Distance from the viewer at which significance reaches zero
+	UPROPERTY(EditAnywhere, Config, Category=Significance, meta=(ClampMin=1.0, ForceUnits=cm))
+	float SignificanceMaxDistance = 10000.0f;
+
+	// Half angle of the view cone, objects outside of it are scaled by SignificanceOutOfViewScale
+	UPROPERTY(EditAnywhere, Config, Category=Significance, meta=(ClampMin=0.0, ClampMax=180.0, ForceUnits=deg))
+	float SignificanceViewHalfAngle = 60.0f;
+
+	// Significance scale for objects outside of the view cone
+	UPROPERTY(EditAnywhere, Config, Category=Significance, meta=(ClampMin=0.0, ClampMax=1.0))
+	float SignificanceOutOfViewScale = 0.5f;
+
+	// Significance scale for objects that haven't been rendered recently
+	UPROPERTY(EditAnywhere, Config, Category=Significance, meta=(ClampMin=0.0, ClampMax=1.0))
+	float SignificanceNotRenderedScale = 0.5f;
+
+	// Significance scale for objects on the same team as the viewer (enemies stay at full significance)
+	UPROPERTY(EditAnywhere, Config, Category=Significance, meta=(ClampMin=0.0, ClampMax=1.0))
+	float SignificanceTeammateScale = 0.75f;
 };
@@ -40,6 +40,11 @@
 *		to simulated connections at a low, steady frequency, and to take advantage of serialization sharing. Auto proxy player states are replicated at higher frequency (to the
 *		owning connection only) via ULyraReplicationGraphNode_AlwaysRelevant_ForConnection.
 *		
+*		ULyraReplicationGraphNode_TeamVisibility
+*		A custom node for pawns and projectiles. Actors on the viewing connection's team are returned every frame. Enemy actors that are not near the viewer
+*		and fail a cached line of sight test are only returned every Lyra.RepGraph.TeamVisibility.HiddenPeriodFrames frames. The visibility cache is per
+*		connection and refreshed on a staggered, budgeted schedule. Use Lyra.RepGraph.TeamVisibility.PrintStats to see how many updates it is holding back.
+*		
 *		UReplicationGraphNode_TearOff_ForConnection
 *		Connection specific node for handling tear off actors. This is created and managed in the base implementation of Replication Graph.
 *	
@@ -90,9 +95,16 @@
 #include "LyraReplicationGraphSettings.h"
 #include "Character/LyraCharacter.h"
 #include "Player/LyraPlayerController.h"
+#include "Teams/LyraTeamSubsystem.h"
+#include "Weapons/HaroProjectileBase.h"
 
 DEFINE_LOG_CATEGORY( LogLyraRepGraph );
 
+DECLARE_STATS_GROUP(TEXT("LyraRepGraph"), STATGROUP_LyraRepGraph, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TeamVisibility Gathered"), STAT_LyraRepGraph_TeamVisibility_Gathered, STATGROUP_LyraRepGraph);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TeamVisibility Throttled"), STAT_LyraRepGraph_TeamVisibility_Throttled, STATGROUP_LyraRepGraph);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TeamVisibility Traces"), STAT_LyraRepGraph_TeamVisibility_Traces, STATGROUP_LyraRepGraph);
+
 namespace Lyra::RepGraph
 {
 	float DestructionInfoMaxDist = 30000.f;
@@ -132,6 +144,29 @@ namespace Lyra::RepGraph
 	int32 EnableFastSharedPath = 1;
 	static FAutoConsoleVariableRef CVarLyraRepEnableFastSharedPath(TEXT("Lyra.RepGraph.EnableFastSharedPath"), EnableFastSharedPath, TEXT(""), ECVF_Default);
 
+	// Routes pawns and projectiles to ULyraReplicationGraphNode_TeamVisibility instead of the grid. Only read when the graph is initialized.
+	int32 EnableTeamVisibilityNode = 1;
+	static FAutoConsoleVariableRef CVarLyraRepEnableTeamVisibilityNode(TEXT("Lyra.RepGraph.TeamVisibility.Enable"), EnableTeamVisibilityNode, TEXT("Route pawns and projectiles through the team/visibility aware node"), ECVF_Default);
+
+	// Hidden enemies are returned once every this many frames.
+	int32 TeamVisibilityHiddenPeriodFrames = 4;
+	static FAutoConsoleVariableRef CVarLyraRepTeamVisibilityHiddenPeriodFrames(TEXT("Lyra.RepGraph.TeamVisibility.HiddenPeriodFrames"), TeamVisibilityHiddenPeriodFrames, TEXT("Hidden enemies are replicated once every this many frames"), ECVF_Default);
+
+	// How long a cached line of sight result is trusted before it is traced again.
+	int32 TeamVisibilityRecheckFrames = 6;
+	static FAutoConsoleVariableRef CVarLyraRepTeamVisibilityRecheckFrames(TEXT("Lyra.RepGraph.TeamVisibility.RecheckFrames"), TeamVisibilityRecheckFrames, TEXT("Frames a cached visibility result is kept before it is traced again"), ECVF_Default);
+
+	int32 TeamVisibilityMaxTracesPerFrame = 16;
+	static FAutoConsoleVariableRef CVarLyraRepTeamVisibilityMaxTracesPerFrame(TEXT("Lyra.RepGraph.TeamVisibility.MaxTracesPerFrame"), TeamVisibilityMaxTracesPerFrame, TEXT("Max visibility traces per connection per frame. Stale results past the budget are reused until the next frame"), ECVF_Default);
+
+	// Enemies closer than this are always treated as visible (no trace).
+	float TeamVisibilityNearDistance = 1500.f;
+	static FAutoConsoleVariableRef CVarLyraRepTeamVisibilityNearDistance(TEXT("Lyra.RepGraph.TeamVisibility.NearDistance"), TeamVisibilityNearDistance, TEXT("Enemies within this distance of the viewer always replicate at full rate"), ECVF_Default);
+
+	// Only used for the bandwidth savings estimate in the stats.
+	int32 TeamVisibilityEstimatedBytesPerUpdate = 40;
+	static FAutoConsoleVariableRef CVarLyraRepTeamVisibilityEstimatedBytesPerUpdate(TEXT("Lyra.RepGraph.TeamVisibility.EstimatedBytesPerUpdate"), TeamVisibilityEstimatedBytesPerUpdate, TEXT("Average bytes of one pawn/projectile update, used to estimate bandwidth saved"), ECVF_Default);
+
 	UReplicationDriver* ConditionalCreateReplicationDriver(UNetDriver* ForNetDriver, UWorld* World)
 	{
 		// Only create for GameNetDriver
@@ -369,6 +404,13 @@ void ULyraReplicationGraph::InitGlobalActorClassSettings()
 	const ULyraReplicationGraphSettings* LyraRepGraphSettings = GetDefault<ULyraReplicationGraphSettings>();
 	check(LyraRepGraphSettings);
 
+	// Pawns and projectiles go through the team/visibility node. Set before the class settings so the project config can still override them.
+	if (Lyra::RepGraph::EnableTeamVisibilityNode)
+	{
+		AddClassRepInfo(ALyraCharacter::StaticClass(), EClassRepNodeMapping::Spatialize_TeamVisibility);
+		AddClassRepInfo(AHaroProjectileBase::StaticClass(), EClassRepNodeMapping::Spatialize_TeamVisibility);
+	}
+
 	// Set Classes Node Mappings
 	for (const FRepGraphActorClassSettings& ActorClassSettings : LyraRepGraphSettings->ClassSettings)
 	{
@@ -557,6 +599,12 @@ void ULyraReplicationGraph::InitGlobalGraphNodes()
 	// -----------------------------------------------
 	ULyraReplicationGraphNode_PlayerStateFrequencyLimiter* PlayerStateNode = CreateNewNode<ULyraReplicationGraphNode_PlayerStateFrequencyLimiter>();
 	AddGlobalGraphNode(PlayerStateNode);
+
+	// -----------------------------------------------
+	//	Pawns and projectiles. Full rate for teammates and visible enemies, throttled for hidden enemies
+	// -----------------------------------------------
+	TeamVisibilityNode = CreateNewNode<ULyraReplicationGraphNode_TeamVisibility>();
+	AddGlobalGraphNode(TeamVisibilityNode);
 }
 
 void ULyraReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
@@ -620,6 +668,12 @@ void ULyraReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActo
 			GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
 			break;
 		}
+
+		case EClassRepNodeMapping::Spatialize_TeamVisibility:
+		{
+			TeamVisibilityNode->NotifyAddNetworkActor(ActorInfo);
+			break;
+		}
 	};
 }
 
@@ -670,6 +724,12 @@ void ULyraReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedA
 			GridNode->RemoveActor_Dormancy(ActorInfo);
 			break;
 		}
+
+		case EClassRepNodeMapping::Spatialize_TeamVisibility:
+		{
+			TeamVisibilityNode->NotifyRemoveNetworkActor(ActorInfo);
+			break;
+		}
 	};
 }
 
@@ -938,6 +998,240 @@ void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::LogNode(FReplication
 
 // ------------------------------------------------------------------------------
 
+ULyraReplicationGraphNode_TeamVisibility::ULyraReplicationGraphNode_TeamVisibility()
+{
+	bRequiresPrepareForReplicationCall = true;
+}
+
+void ULyraReplicationGraphNode_TeamVisibility::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	Actors.Add(ActorInfo.Actor);
+	ActorTeamIds.Add(INDEX_NONE);
+}
+
+bool ULyraReplicationGraphNode_TeamVisibility::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	const int32 ActorIndex = Actors.Find(ActorInfo.Actor);
+	if (ActorIndex == INDEX_NONE)
+	{
+		UE_CLOG(bWarnIfNotFound, LogLyraRepGraph, Warning, TEXT("Actor %s was not found in TeamVisibility node"), *GetActorRepListTypeDebugString(ActorInfo.Actor));
+		return false;
+	}
+
+	Actors.RemoveAtSwap(ActorIndex, 1, EAllowShrinking::No);
+	ActorTeamIds.RemoveAtSwap(ActorIndex, 1, EAllowShrinking::No);
+
+	for (FConnectionState& State : ConnectionStates)
+	{
+		State.VisibilityCache.Remove(ActorInfo.Actor);
+		State.GatheredActors.RemoveFast(ActorInfo.Actor);
+		State.FastSharedActors.RemoveFast(ActorInfo.Actor);
+	}
+
+	return true;
+}
+
+void ULyraReplicationGraphNode_TeamVisibility::NotifyResetAllNetworkActors()
+{
+	Actors.Reset();
+	ActorTeamIds.Reset();
+
+	for (FConnectionState& State : ConnectionStates)
+	{
+		State.VisibilityCache.Reset();
+		State.GatheredActors.Reset();
+		State.FastSharedActors.Reset();
+	}
+}
+
+void ULyraReplicationGraphNode_TeamVisibility::PrepareForReplication()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_LyraRepGraph_TeamVisibility_Prepare);
+
+	if (!TeamSubsystem.IsValid())
+	{
+		if (UWorld* World = GetWorld())
+		{
+			TeamSubsystem = World->GetSubsystem<ULyraTeamSubsystem>();
+		}
+	}
+
+	// Resolve every actor's team once per frame instead of once per connection
+	const ULyraTeamSubsystem* Teams = TeamSubsystem.Get();
+	for (int32 ActorIndex = 0; ActorIndex < Actors.Num(); ++ActorIndex)
+	{
+		ActorTeamIds[ActorIndex] = Teams ? Teams->FindTeamFromObject(Actors[ActorIndex]) : INDEX_NONE;
+	}
+
+	// Drop state for connections that have gone away
+	for (int32 StateIndex = ConnectionStates.Num() - 1; StateIndex >= 0; --StateIndex)
+	{
+		if (!ConnectionStates[StateIndex].Connection.IsValid())
+		{
+			ConnectionStates.RemoveAtSwap(StateIndex, 1, EAllowShrinking::No);
+		}
+	}
+}
+
+void ULyraReplicationGraphNode_TeamVisibility::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_LyraRepGraph_TeamVisibility_Gather);
+
+	FConnectionState* State = ConnectionStates.FindByPredicate([&Params](const FConnectionState& Other) { return Other.Connection.Get() == &Params.ConnectionManager; });
+	if (State == nullptr)
+	{
+		State = &ConnectionStates.AddDefaulted_GetRef();
+		State->Connection = &Params.ConnectionManager;
+	}
+
+	State->GatheredActors.Reset(Actors.Num());
+	State->FastSharedActors.Reset(Actors.Num());
+
+	FLyraTeamVisibilityConnectionStats& Stats = State->Stats;
+	Stats.NumGathered = 0;
+	Stats.NumThrottled = 0;
+	Stats.NumTraces = 0;
+
+	if ((Actors.Num() == 0) || (Params.Viewers.Num() == 0))
+	{
+		return;
+	}
+
+	// Lyra does not support online splitscreen, so the first viewer is the only one that matters
+	const FNetViewer& Viewer = Params.Viewers[0];
+
+	const ULyraTeamSubsystem* Teams = TeamSubsystem.Get();
+	const int32 ViewerTeamId = Teams ? Teams->FindTeamFromObject(Viewer.InViewer) : INDEX_NONE;
+
+	const uint32 FrameNum = Params.ReplicationFrameNum;
+	const uint32 HiddenPeriod = (uint32)FMath::Max(Lyra::RepGraph::TeamVisibilityHiddenPeriodFrames, 1);
+	const float NearDistanceSquared = FMath::Square(Lyra::RepGraph::TeamVisibilityNearDistance);
+	int32 TraceBudget = Lyra::RepGraph::TeamVisibilityMaxTracesPerFrame;
+
+	// Rotate the starting point every frame so the trace budget is shared fairly between actors
+	const int32 NumActors = Actors.Num();
+	const int32 StartIndex = (int32)(FrameNum % (uint32)NumActors);
+
+	for (int32 Offset = 0; Offset < NumActors; ++Offset)
+	{
+		const int32 ActorIndex = (StartIndex + Offset) % NumActors;
+		AActor* Actor = Actors[ActorIndex];
+		if (IsActorValidForReplicationGather(Actor) == false)
+		{
+			continue;
+		}
+
+		const int32 ActorTeamId = ActorTeamIds[ActorIndex];
+		const bool bSameTeam = (ViewerTeamId != INDEX_NONE) && (ActorTeamId == ViewerTeamId);
+		const bool bViewersOwn = (Actor == Viewer.ViewTarget) || (Actor->GetNetOwner() == Viewer.InViewer);
+
+		bool bFullRate = true;
+		if (!bSameTeam && !bViewersOwn)
+		{
+			bFullRate = (FVector::DistSquared(Viewer.ViewLocation, Actor->GetActorLocation()) <= NearDistanceSquared)
+				|| IsVisibleToViewer(*State, Viewer, Actor, FrameNum, TraceBudget);
+		}
+
+		if (!bFullRate && (((FrameNum + (uint32)ActorIndex) % HiddenPeriod) != 0))
+		{
+			FConnectionReplicationActorInfo& ConnectionActorInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(Actor);
+
+			// Actors the client has not received yet are never held back, otherwise they would pop in late
+			if (ConnectionActorInfo.Channel != nullptr)
+			{
+				// Same thing the driver does for actors skipped by their own update frequency: keep the channel from timing out while we hold the actor back
+				ConnectionActorInfo.ActorChannelCloseFrameNum = FMath::Max<uint32>(ConnectionActorInfo.ActorChannelCloseFrameNum, FrameNum + 1);
+
+				++Stats.NumThrottled;
+				continue;
+			}
+		}
+
+		State->GatheredActors.Add(Actor);
+
+		if (bFullRate)
+		{
+			State->FastSharedActors.Add(Actor);
+		}
+	}
+
+	Stats.NumGathered = State->GatheredActors.Num();
+	Stats.TotalThrottled += Stats.NumThrottled;
+	Stats.EstimatedBytesSaved += (uint64)Stats.NumThrottled * (uint64)FMath::Max(Lyra::RepGraph::TeamVisibilityEstimatedBytesPerUpdate, 0);
+
+	INC_DWORD_STAT_BY(STAT_LyraRepGraph_TeamVisibility_Gathered, Stats.NumGathered);
+	INC_DWORD_STAT_BY(STAT_LyraRepGraph_TeamVisibility_Throttled, Stats.NumThrottled);
+	INC_DWORD_STAT_BY(STAT_LyraRepGraph_TeamVisibility_Traces, Stats.NumTraces);
+
+	if (State->GatheredActors.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(State->GatheredActors);
+	}
+
+	// Pawns that replicate at full rate can also take the FastShared movement path (the grid did this for them before)
+	if (Lyra::RepGraph::EnableFastSharedPath && (State->FastSharedActors.Num() > 0))
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(State->FastSharedActors, EActorRepListTypeFlags::FastShared);
+	}
+}
+
+bool ULyraReplicationGraphNode_TeamVisibility::IsVisibleToViewer(FConnectionState& State, const FNetViewer& Viewer, AActor* Actor, uint32 FrameNum, int32& InOutTraceBudget)
+{
+	FVisibilityCacheEntry& Entry = State.VisibilityCache.FindOrAdd(Actor);
+
+	const uint32 RecheckFrames = (uint32)FMath::Max(Lyra::RepGraph::TeamVisibilityRecheckFrames, 1);
+	const bool bStale = !Entry.bHasResult || ((FrameNum - Entry.LastCheckFrame) >= RecheckFrames);
+
+	// Out of budget: keep using the old result (new entries default to visible, so nothing is held back before it has been traced)
+	if (bStale && (InOutTraceBudget > 0))
+	{
+		--InOutTraceBudget;
+		++State.Stats.NumTraces;
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(LyraRepGraphVisibility), /*bTraceComplex=*/ false, Actor);
+		QueryParams.AddIgnoredActor(Viewer.ViewTarget);
+
+		Entry.bVisible = !GetWorld()->LineTraceTestByChannel(Viewer.ViewLocation, Actor->GetActorLocation(), ECC_Visibility, QueryParams);
+		Entry.LastCheckFrame = FrameNum;
+		Entry.bHasResult = true;
+	}
+
+	return Entry.bVisible;
+}
+
+void ULyraReplicationGraphNode_TeamVisibility::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+{
+	DebugInfo.Log(NodeName);
+	DebugInfo.PushIndent();
+
+	DebugInfo.Log(FString::Printf(TEXT("Routed Actors: %d"), Actors.Num()));
+
+	for (const FConnectionState& State : ConnectionStates)
+	{
+		const UNetReplicationGraphConnection* Connection = State.Connection.Get();
+		const FLyraTeamVisibilityConnectionStats& Stats = State.Stats;
+		DebugInfo.Log(FString::Printf(TEXT("%s: Gathered %d, Throttled %d, Traces %d, Total Throttled %llu, Est. Saved %llu bytes"),
+			*GetNameSafe(Connection ? Connection->NetConnection : nullptr), Stats.NumGathered, Stats.NumThrottled, Stats.NumTraces, Stats.TotalThrottled, Stats.EstimatedBytesSaved));
+	}
+
+	DebugInfo.PopIndent();
+}
+
+void ULyraReplicationGraphNode_TeamVisibility::PrintConnectionStats() const
+{
+	UE_LOG(LogLyraRepGraph, Display, TEXT("TeamVisibility node: %d routed actors, %d connections"), Actors.Num(), ConnectionStates.Num());
+
+	for (const FConnectionState& State : ConnectionStates)
+	{
+		const UNetReplicationGraphConnection* Connection = State.Connection.Get();
+		const FLyraTeamVisibilityConnectionStats& Stats = State.Stats;
+		UE_LOG(LogLyraRepGraph, Display, TEXT("  %s: Gathered %d, Throttled %d, Traces %d, Total Throttled %llu, Est. Saved %.1f KB"),
+			*GetNameSafe(Connection ? Connection->NetConnection : nullptr), Stats.NumGathered, Stats.NumThrottled, Stats.NumTraces, Stats.TotalThrottled, (double)Stats.EstimatedBytesSaved / 1024.0);
+	}
+}
+
+// ------------------------------------------------------------------------------
+
 void ULyraReplicationGraph::PrintRepNodePolicies()
 {
 	UEnum* Enum = StaticEnum<EClassRepNodeMapping>();
@@ -970,6 +1264,16 @@ FAutoConsoleCommandWithWorldAndArgs LyraPrintRepNodePoliciesCmd(TEXT("Lyra.RepGr
 	})
 );
 
+FAutoConsoleCommandWithWorldAndArgs LyraPrintTeamVisibilityStatsCmd(TEXT("Lyra.RepGraph.TeamVisibility.PrintStats"), TEXT("Prints per connection throttling and estimated bandwidth savings of the team/visibility node"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		for (TObjectIterator<ULyraReplicationGraphNode_TeamVisibility> It; It; ++It)
+		{
+			It->PrintConnectionStats();
+		}
+	})
+);
+
 // ------------------------------------------------------------------------------
 
 FAutoConsoleCommandWithWorldAndArgs ChangeFrequencyBucketsCmd(TEXT("Lyra.RepGraph.FrequencyBuckets"), TEXT("Resets frequency bucket count."), FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray< FString >& Args, UWorld* World) 
@@ -7,6 +7,8 @@
 #include "LyraReplicationGraph.generated.h"
 
 class AGameplayDebuggerCategoryReplicator;
+class ULyraReplicationGraphNode_TeamVisibility;
+class ULyraTeamSubsystem;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogLyraRepGraph, Display, All);
 
@@ -36,6 +38,9 @@ public:
 	UPROPERTY()
 	TObjectPtr<UReplicationGraphNode_ActorList> AlwaysRelevantNode;
 
+	UPROPERTY()
+	TObjectPtr<ULyraReplicationGraphNode_TeamVisibility> TeamVisibilityNode;
+
 	TMap<FName, FActorRepListRefView> AlwaysRelevantStreamingLevelActors;
 
 #if WITH_GAMEPLAY_DEBUGGER
@@ -120,4 +125,80 @@ private:
 	
 	TArray<FActorRepListRefView> ReplicationActorLists;
 	FActorRepListRefView ForceNetUpdateReplicationActorList;
-};
\ No newline at end of file
+};
+
+/** Per connection bandwidth counters for ULyraReplicationGraphNode_TeamVisibility */
+struct FLyraTeamVisibilityConnectionStats
+{
+	/** Actors returned this frame (teammates, visible or nearby enemies, and throttled actors on their update frame) */
+	int32 NumGathered = 0;
+
+	/** Actors held back this frame because they are hidden enemies */
+	int32 NumThrottled = 0;
+
+	/** Visibility traces run this frame */
+	int32 NumTraces = 0;
+
+	/** Total actor updates skipped since the connection was created */
+	uint64 TotalThrottled = 0;
+
+	/** Rough bytes saved since the connection was created (TotalThrottled * Lyra.RepGraph.TeamVisibility.EstimatedBytesPerUpdate) */
+	uint64 EstimatedBytesSaved = 0;
+};
+
+/**
+	Node for pawns and projectiles that replicates based on the viewing connection's team and what it can actually see.
+	Actors on the viewer's team always replicate every frame. Enemy actors that are outside the near distance and fail a cached
+	line of sight test from the viewer are only returned every few frames. The visibility result is cached per connection/actor
+	pair and refreshed on a staggered, budgeted schedule so the trace cost stays bounded no matter how many actors are routed here.
+*/
+UCLASS()
+class ULyraReplicationGraphNode_TeamVisibility : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	ULyraReplicationGraphNode_TeamVisibility();
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+
+	virtual void PrepareForReplication() override;
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
+
+	void PrintConnectionStats() const;
+
+private:
+	struct FVisibilityCacheEntry
+	{
+		uint32 LastCheckFrame = 0;
+		bool bVisible = true;
+		bool bHasResult = false;
+	};
+
+	struct FConnectionState
+	{
+		TWeakObjectPtr<UNetReplicationGraphConnection> Connection;
+
+		FActorRepListRefView GatheredActors;
+		FActorRepListRefView FastSharedActors;
+
+		TMap<FActorRepListType, FVisibilityCacheEntry> VisibilityCache;
+
+		FLyraTeamVisibilityConnectionStats Stats;
+	};
+
+	bool IsVisibleToViewer(FConnectionState& State, const FNetViewer& Viewer, AActor* Actor, uint32 FrameNum, int32& InOutTraceBudget);
+
+	// Routed actors and their team, refreshed once per frame in PrepareForReplication so every connection can share it
+	TArray<AActor*> Actors;
+	TArray<int32> ActorTeamIds;
+
+	TArray<FConnectionState> ConnectionStates;
+
+	TWeakObjectPtr<ULyraTeamSubsystem> TeamSubsystem;
+};
@@ -59,6 +59,25 @@ public:
 	UPROPERTY(EditAnywhere, Category = DynamicSpatialFrequency, meta = (ConsoleVariable = "Lyra.RepGraph.DynamicActorFrequencyBuckets"))
 	int32 DynamicActorFrequencyBuckets = 3;
 
+	// Route pawns and projectiles through the team/visibility aware node instead of the spatial grid.
+	UPROPERTY(EditAnywhere, Category = TeamVisibility, meta = (ConsoleVariable = "Lyra.RepGraph.TeamVisibility.Enable"))
+	bool bEnableTeamVisibilityNode = true;
+
+	// Enemies that the connection cannot see are replicated once every this many frames.
+	UPROPERTY(EditAnywhere, Category = TeamVisibility, meta = (ClampMin = 1, ConsoleVariable = "Lyra.RepGraph.TeamVisibility.HiddenPeriodFrames"))
+	int32 TeamVisibilityHiddenPeriodFrames = 4;
+
+	// How many frames a cached line of sight result is reused before it is traced again.
+	UPROPERTY(EditAnywhere, Category = TeamVisibility, meta = (ClampMin = 1, ConsoleVariable = "Lyra.RepGraph.TeamVisibility.RecheckFrames"))
+	int32 TeamVisibilityRecheckFrames = 6;
+
+	UPROPERTY(EditAnywhere, Category = TeamVisibility, meta = (ClampMin = 0, ConsoleVariable = "Lyra.RepGraph.TeamVisibility.MaxTracesPerFrame"))
+	int32 TeamVisibilityMaxTracesPerFrame = 16;
+
+	// Enemies closer than this always replicate at full rate.
+	UPROPERTY(EditAnywhere, Category = TeamVisibility, meta = (ForceUnits = cm, ConsoleVariable = "Lyra.RepGraph.TeamVisibility.NearDistance"))
+	float TeamVisibilityNearDistance = 1500.0f;
+
 	// Array of Custom Settings for Specific Classes 
 	UPROPERTY(config, EditAnywhere, Category = ReplicationGraph)
 	TArray<FRepGraphActorClassSettings> ClassSettings;
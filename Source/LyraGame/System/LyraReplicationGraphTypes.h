@@ -17,6 +17,7 @@ enum class EClassRepNodeMapping : uint32
 	Spatialize_Static,				// Routes to GridNode: these actors don't move and don't need to be updated every frame.
 	Spatialize_Dynamic,				// Routes to GridNode: these actors mode frequently and are updated once per frame.
 	Spatialize_Dormancy,			// Routes to GridNode: While dormant we treat as static. When flushed/not dormant dynamic. Note this is for things that "move while not dormant".
+	Spatialize_TeamVisibility,		// Routes to TeamVisibilityNode: teammates replicate every frame, enemies the connection cannot see are throttled. Distance culling is still applied per connection.
 };
 
 // Actor Class Settings that can be assigned directly to a Class.  Can also be mapped to a FRepGraphActorTemplateSettings 
@@ -2,5 +2,412 @@
 
 #include "LyraSignificanceManager.h"
 
+#include "Animation/LyraAnimInstance.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "DisplayDebugHelpers.h"
+#include "Engine/Canvas.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/HUD.h"
+#include "GameFramework/MovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Performance/LyraPerformanceSettings.h"
+#include "Teams/LyraTeamSubsystem.h"
+
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraSignificanceManager)
 
+const FName ULyraSignificanceManager::CharacterTag(TEXT("Character"));
+const FName ULyraSignificanceManager::ProjectileTag(TEXT("Projectile"));
+const FName ULyraSignificanceManager::AOETag(TEXT("AOE"));
+
+static const FName NAME_ShowDebugSignificance(TEXT("Significance"));
+
+ULyraSignificanceManager::ULyraSignificanceManager()
+{
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		// Register "showdebug" hook.
+		if (!IsRunningDedicatedServer())
+		{
+			AHUD::OnShowDebugInfo.AddUObject(this, &ThisClass::OnShowDebugInfo);
+		}
+	}
+}
+
+void ULyraSignificanceManager::RegisterActor(AActor* Actor, FName Tag)
+{
+	check(Actor);
+
+	RegisterObject(Actor, Tag,
+		[this](FManagedObjectInfo* ObjectInfo, const FTransform& Viewpoint)
+		{
+			return CalculateActorSignificance(CastChecked<AActor>(ObjectInfo->GetObject()), Viewpoint);
+		});
+}
+
+void ULyraSignificanceManager::UnregisterActor(AActor* Actor)
+{
+	if (GetManagedObject(Actor))
+	{
+		UnregisterObject(Actor);
+	}
+	ObjectTierStates.Remove(FObjectKey(Actor));
+}
+
+const FLyraSignificanceTier* ULyraSignificanceManager::GetObjectTier(const UObject* Object) const
+{
+	const TArray<FLyraSignificanceTier>& Tiers = GetDefault<ULyraPerformanceSettings>()->SignificanceTiers;
+
+	const FObjectTierState* TierState = ObjectTierStates.Find(FObjectKey(Object));
+	return (TierState && Tiers.IsValidIndex(TierState->TierIndex)) ? &Tiers[TierState->TierIndex] : nullptr;
+}
+
+const FLyraSignificanceTier* ULyraSignificanceManager::GetLocationTier(const FVector& Location) const
+{
+	const TArray<FLyraSignificanceTier>& Tiers = GetDefault<ULyraPerformanceSettings>()->SignificanceTiers;
+	if ((Tiers.Num() == 0) || (LocalViewpoints.Num() == 0))
+	{
+		return nullptr;
+	}
+
+	float Significance = 0.0f;
+	for (const FTransform& Viewpoint : LocalViewpoints)
+	{
+		Significance = FMath::Max(Significance, CalculateLocationSignificance(Location, Viewpoint));
+	}
+
+	for (const FLyraSignificanceTier& Tier : Tiers)
+	{
+		if (Significance >= Tier.MinSignificance)
+		{
+			return &Tier;
+		}
+	}
+
+	return &Tiers.Last();
+}
+
+void ULyraSignificanceManager::Tick(float DeltaTime)
+{
+	UWorld* World = GetWorld();
+	const ULyraPerformanceSettings* Settings = GetDefault<ULyraPerformanceSettings>();
+	const ULyraTeamSubsystem* TeamSubsystem = World->GetSubsystem<ULyraTeamSubsystem>();
+
+	LocalViewpoints.Reset();
+	LocalViewerTeamIds.Reset();
+	for (FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PC = Iterator->Get();
+		if (PC && PC->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PC->GetPlayerViewPoint(/*out*/ ViewLocation, /*out*/ ViewRotation);
+			LocalViewpoints.Emplace(ViewRotation, ViewLocation);
+
+			const int32 TeamId = TeamSubsystem ? TeamSubsystem->FindTeamFromObject(PC) : INDEX_NONE;
+			if (TeamId != INDEX_NONE)
+			{
+				LocalViewerTeamIds.AddUnique(TeamId);
+			}
+		}
+	}
+
+	// Nobody to score against (e.g., while the local player is still connecting), keep the current tiers
+	if (LocalViewpoints.Num() == 0)
+	{
+		return;
+	}
+
+	ViewConeCos = FMath::Cos(FMath::DegreesToRadians(Settings->SignificanceViewHalfAngle));
+
+	GatherScoringInputs(TeamSubsystem);
+	Update(LocalViewpoints);
+
+	UpdateTiers();
+}
+
+ETickableTickType ULyraSignificanceManager::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool ULyraSignificanceManager::IsTickable() const
+{
+	// Registration is skipped on dedicated servers, so there is never anything to score there
+	const UWorld* World = GetWorld();
+	return World && World->IsGameWorld() && (World->GetNetMode() != NM_DedicatedServer);
+}
+
+UWorld* ULyraSignificanceManager::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId ULyraSignificanceManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULyraSignificanceManager, STATGROUP_Tickables);
+}
+
+float ULyraSignificanceManager::CalculateLocationSignificance(const FVector& Location, const FTransform& Viewpoint) const
+{
+	const ULyraPerformanceSettings* Settings = GetDefault<ULyraPerformanceSettings>();
+
+	const FVector ToLocation = Location - Viewpoint.GetLocation();
+	const float Distance = ToLocation.Size();
+	if (Distance >= Settings->SignificanceMaxDistance)
+	{
+		return 0.0f;
+	}
+
+	float Significance = 1.0f - (Distance / Settings->SignificanceMaxDistance);
+
+	if ((Distance > UE_KINDA_SMALL_NUMBER) && (FVector::DotProduct(ToLocation / Distance, Viewpoint.GetRotation().GetForwardVector()) < ViewConeCos))
+	{
+		Significance *= Settings->SignificanceOutOfViewScale;
+	}
+
+	return Significance;
+}
+
+float ULyraSignificanceManager::CalculateActorSignificance(const AActor* Actor, const FTransform& Viewpoint) const
+{
+	// Hidden actors (e.g., projectiles sitting in their pool) don't need anything
+	const FActorScoringInputs* Inputs = ActorScoringInputs.Find(FObjectKey(Actor));
+	if ((Inputs == nullptr) || Inputs->bHidden)
+	{
+		return 0.0f;
+	}
+
+	const ULyraPerformanceSettings* Settings = GetDefault<ULyraPerformanceSettings>();
+
+	float Significance = CalculateLocationSignificance(Actor->GetActorLocation(), Viewpoint);
+	if (Significance <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	if (!Inputs->bRecentlyRendered)
+	{
+		Significance *= Settings->SignificanceNotRenderedScale;
+	}
+
+	// Enemies matter more than teammates
+	if (Inputs->bOnViewerTeam)
+	{
+		Significance *= Settings->SignificanceTeammateScale;
+	}
+
+	return Significance;
+}
+
+void ULyraSignificanceManager::GatherScoringInputs(const ULyraTeamSubsystem* TeamSubsystem)
+{
+	ActorScoringInputs.Reset();
+
+	SortedObjects.Reset();
+	GetManagedObjects(SortedObjects);
+
+	for (const FManagedObjectInfo* ObjectInfo : SortedObjects)
+	{
+		const AActor* Actor = Cast<AActor>(ObjectInfo->GetObject());
+		if (Actor == nullptr)
+		{
+			continue;
+		}
+
+		FActorScoringInputs& Inputs = ActorScoringInputs.Add(FObjectKey(Actor));
+		Inputs.bHidden = Actor->IsHidden();
+		Inputs.bRecentlyRendered = Actor->WasRecentlyRendered(0.25f);
+
+		if (TeamSubsystem && (LocalViewerTeamIds.Num() > 0))
+		{
+			const int32 TeamId = TeamSubsystem->FindTeamFromObject(Actor);
+			Inputs.bOnViewerTeam = (TeamId != INDEX_NONE) && LocalViewerTeamIds.Contains(TeamId);
+		}
+	}
+}
+
+int32 ULyraSignificanceManager::GetTierBudget(const FLyraSignificanceTier& Tier, FName Tag)
+{
+	if (Tag == CharacterTag)
+	{
+		return Tier.MaxCharacters;
+	}
+	else if (Tag == ProjectileTag)
+	{
+		return Tier.MaxProjectiles;
+	}
+	else if (Tag == AOETag)
+	{
+		return Tier.MaxAOEs;
+	}
+
+	return 0;
+}
+
+void ULyraSignificanceManager::UpdateTiers()
+{
+	const TArray<FLyraSignificanceTier>& Tiers = GetDefault<ULyraPerformanceSettings>()->SignificanceTiers;
+
+	TierCounts.Reset();
+	TierCounts.SetNumZeroed(Tiers.Num());
+	TierCountsByTag.Reset();
+
+	if (Tiers.Num() == 0)
+	{
+		ObjectTierStates.Reset();
+		return;
+	}
+
+	SortedObjects.Reset();
+	GetManagedObjects(SortedObjects);
+	SortedObjects.Sort([](const FManagedObjectInfo& A, const FManagedObjectInfo& B) { return A.GetSignificance() > B.GetSignificance(); });
+
+	const int32 LastTierIndex = Tiers.Num() - 1;
+	for (const FManagedObjectInfo* ObjectInfo : SortedObjects)
+	{
+		const FName Tag = ObjectInfo->GetTag();
+
+		TArray<int32>& TagCounts = TierCountsByTag.FindOrAdd(Tag);
+		TagCounts.SetNumZeroed(Tiers.Num());
+
+		// Start at the best tier the score qualifies for, then drop down while that tier is over budget for this tag
+		int32 TierIndex = 0;
+		while ((TierIndex < LastTierIndex) && (ObjectInfo->GetSignificance() < Tiers[TierIndex].MinSignificance))
+		{
+			++TierIndex;
+		}
+		while (TierIndex < LastTierIndex)
+		{
+			const int32 Budget = GetTierBudget(Tiers[TierIndex], Tag);
+			if ((Budget <= 0) || (TagCounts[TierIndex] < Budget))
+			{
+				break;
+			}
+			++TierIndex;
+		}
+
+		++TierCounts[TierIndex];
+		++TagCounts[TierIndex];
+
+		// Only throttle actors that are simulated from replicated state, anything we own runs gameplay on its components.
+		// Roles change at runtime (e.g., a pawn possessed by the local player), so that is checked every update too
+		AActor* Actor = Cast<AActor>(ObjectInfo->GetObject());
+		const bool bShouldThrottle = Actor && (Actor->GetLocalRole() == ROLE_SimulatedProxy);
+
+		FObjectTierState& TierState = ObjectTierStates.FindOrAdd(FObjectKey(ObjectInfo->GetObject()));
+		if ((TierState.TierIndex != TierIndex) || (TierState.bThrottled != bShouldThrottle))
+		{
+			if (bShouldThrottle)
+			{
+				ApplyTier(Actor, Tiers[TierIndex]);
+			}
+			else if (TierState.bThrottled && Actor)
+			{
+				RemoveTierThrottling(Actor);
+			}
+
+			TierState.TierIndex = TierIndex;
+			TierState.bThrottled = bShouldThrottle;
+		}
+	}
+}
+
+void ULyraSignificanceManager::ApplyTier(AActor* Actor, const FLyraSignificanceTier& Tier) const
+{
+	if (const ACharacter* Character = Cast<ACharacter>(Actor))
+	{
+		// Update rate optimization is only turned on for the simulated characters we manage
+		USkeletalMeshComponent* MeshComp = Character->GetMesh();
+		if (!MeshComp->bEnableUpdateRateOptimizations)
+		{
+			MeshComp->bEnableUpdateRateOptimizations = true;
+			if (MeshComp->AnimUpdateRateParams == nullptr)
+			{
+				MeshComp->AnimUpdateRateParams = FAnimUpdateRateManager::GetUpdateRateParameters(MeshComp);
+			}
+		}
+
+		if (ULyraAnimInstance* AnimInstance = Cast<ULyraAnimInstance>(MeshComp->GetAnimInstance()))
+		{
+			AnimInstance->SetSignificanceFrameSkip(Tier.AnimationFrameSkip);
+		}
+	}
+
+	Actor->ForEachComponent(/*bIncludeFromChildActors=*/ false, [&Tier](UActorComponent* Component)
+	{
+		if (ShouldThrottleComponentTick(Component))
+		{
+			// Never tick faster than the component was authored to
+			const UActorComponent* Archetype = CastChecked<UActorComponent>(Component->GetArchetype());
+			Component->SetComponentTickInterval(FMath::Max(Archetype->PrimaryComponentTick.TickInterval, Tier.ComponentTickInterval));
+		}
+	});
+}
+
+void ULyraSignificanceManager::RemoveTierThrottling(AActor* Actor) const
+{
+	if (const ACharacter* Character = Cast<ACharacter>(Actor))
+	{
+		if (ULyraAnimInstance* AnimInstance = Cast<ULyraAnimInstance>(Character->GetMesh()->GetAnimInstance()))
+		{
+			AnimInstance->SetSignificanceFrameSkip(0);
+		}
+	}
+
+	Actor->ForEachComponent(/*bIncludeFromChildActors=*/ false, [](UActorComponent* Component)
+	{
+		if (ShouldThrottleComponentTick(Component))
+		{
+			const UActorComponent* Archetype = CastChecked<UActorComponent>(Component->GetArchetype());
+			Component->SetComponentTickInterval(Archetype->PrimaryComponentTick.TickInterval);
+		}
+	});
+}
+
+bool ULyraSignificanceManager::ShouldThrottleComponentTick(const UActorComponent* Component)
+{
+	// Movement keeps network smoothing correct, meshes are throttled by the animation update rate and effects would visibly stutter
+	return Component->PrimaryComponentTick.bCanEverTick && !Component->IsA<UMovementComponent>() && !Component->IsA<USkinnedMeshComponent>() && !Component->IsA<UFXSystemComponent>();
+}
+
+void ULyraSignificanceManager::OnShowDebugInfo(AHUD* HUD, UCanvas* Canvas, const FDebugDisplayInfo& DisplayInfo, float& YL, float& YPos)
+{
+	if (!DisplayInfo.IsDisplayOn(NAME_ShowDebugSignificance) || (HUD->GetWorld() != GetWorld()))
+	{
+		return;
+	}
+
+	const TArray<FLyraSignificanceTier>& Tiers = GetDefault<ULyraPerformanceSettings>()->SignificanceTiers;
+
+	FDisplayDebugManager& DisplayDebugManager = Canvas->DisplayDebugManager;
+	DisplayDebugManager.SetFont(GEngine->GetSmallFont());
+	DisplayDebugManager.SetDrawColor(FColor::Yellow);
+	DisplayDebugManager.DrawString(FString::Printf(TEXT("Significance: %d objects, %d viewpoints"), ObjectTierStates.Num(), LocalViewpoints.Num()));
+
+	for (int32 TierIndex = 0; TierIndex < Tiers.Num(); ++TierIndex)
+	{
+		const FLyraSignificanceTier& Tier = Tiers[TierIndex];
+
+		// Per tag count against that tag's budget
+		bool bAnyOverBudget = false;
+		FString TagCountsString;
+		for (const TPair<FName, TArray<int32>>& TagCountsPair : TierCountsByTag)
+		{
+			const int32 TagCount = TagCountsPair.Value.IsValidIndex(TierIndex) ? TagCountsPair.Value[TierIndex] : 0;
+			const int32 Budget = GetTierBudget(Tier, TagCountsPair.Key);
+			bAnyOverBudget |= (Budget > 0) && (TagCount >= Budget);
+
+			const FString BudgetString = (Budget > 0) ? FString::FromInt(Budget) : TEXT("-");
+			TagCountsString += FString::Printf(TEXT(" %s=%d/%s"), *TagCountsPair.Key.ToString(), TagCount, *BudgetString);
+		}
+
+		const int32 Count = TierCounts.IsValidIndex(TierIndex) ? TierCounts[TierIndex] : 0;
+
+		DisplayDebugManager.SetDrawColor(bAnyOverBudget ? FColor::Orange : FColor::White);
+		DisplayDebugManager.DrawString(FString::Printf(TEXT("  %s (>= %.2f): %d [%s ]"), *Tier.Name.ToString(), Tier.MinSignificance, Count, *TagCountsString));
+	}
+}
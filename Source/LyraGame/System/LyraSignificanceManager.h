@@ -3,14 +3,114 @@
 #pragma once
 
 #include "SignificanceManager.h"
+#include "Tickable.h"
+#include "UObject/ObjectKey.h"
 
 #include "LyraSignificanceManager.generated.h"
 
+class AActor;
+class AHUD;
+class UActorComponent;
+class UCanvas;
+class ULyraTeamSubsystem;
 class UObject;
+struct FDebugDisplayInfo;
+struct FLyraSignificanceTier;
 
+/**
+ * ULyraSignificanceManager
+ *
+ *	Scores registered characters, projectiles and AOEs against the local viewers every frame (distance, whether they
+ *	are in view and were recently rendered, and whether they are on the viewer's team) and sorts them into the
+ *	significance tiers from ULyraPerformanceSettings. Each tier has a budget per tag (objects over budget drop to the
+ *	next tier) and decides the animation update rate and component tick intervals of simulated actors, as well as whether
+ *	context effects and number pops are spawned for them.
+ *
+ *	Use "showdebug Significance" to see how many objects are in each tier.
+ */
 UCLASS()
-class ULyraSignificanceManager : public USignificanceManager
+class ULyraSignificanceManager : public USignificanceManager, public FTickableGameObject
 {
 	GENERATED_BODY()
 
+public:
+	ULyraSignificanceManager();
+
+	static const FName CharacterTag;
+	static const FName ProjectileTag;
+	static const FName AOETag;
+
+	// Starts scoring an actor, it is assigned a tier on the next update
+	void RegisterActor(AActor* Actor, FName Tag);
+
+	// Stops scoring an actor
+	void UnregisterActor(AActor* Actor);
+
+	// Returns the tier an object is currently in, or nullptr if it isn't registered or hasn't been scored yet
+	const FLyraSignificanceTier* GetObjectTier(const UObject* Object) const;
+
+	// Returns the tier a location falls in based on distance and view direction only (ignores budgets)
+	const FLyraSignificanceTier* GetLocationTier(const FVector& Location) const;
+
+	//~FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+	//~End of FTickableGameObject interface
+
+private:
+	float CalculateLocationSignificance(const FVector& Location, const FTransform& Viewpoint) const;
+	float CalculateActorSignificance(const AActor* Actor, const FTransform& Viewpoint) const;
+
+	// Returns how many objects with this tag fit in the tier (0 = unlimited)
+	static int32 GetTierBudget(const FLyraSignificanceTier& Tier, FName Tag);
+
+	// Reads everything scoring needs from actors and other systems, so the significance functions only read plain data
+	void GatherScoringInputs(const ULyraTeamSubsystem* TeamSubsystem);
+
+	void UpdateTiers();
+	void ApplyTier(AActor* Actor, const FLyraSignificanceTier& Tier) const;
+
+	// Puts back what ApplyTier changed, for actors that stopped being simulated proxies (e.g., possessed by the local player)
+	void RemoveTierThrottling(AActor* Actor) const;
+
+	// Whether ApplyTier changes the tick interval of this component
+	static bool ShouldThrottleComponentTick(const UActorComponent* Component);
+
+	void OnShowDebugInfo(AHUD* HUD, UCanvas* Canvas, const FDebugDisplayInfo& DisplayInfo, float& YL, float& YPos);
+
+private:
+	// Local viewpoints and the teams they belong to, refreshed every tick before scoring
+	TArray<FTransform> LocalViewpoints;
+	TArray<int32, TInlineAllocator<4>> LocalViewerTeamIds;
+	float ViewConeCos = 0.5f;
+
+	// Per actor inputs to scoring that aren't safe to read while Update() scores in parallel, gathered on the game thread first
+	struct FActorScoringInputs
+	{
+		bool bHidden = false;
+		bool bRecentlyRendered = false;
+		bool bOnViewerTeam = false;
+	};
+	TMap<FObjectKey, FActorScoringInputs> ActorScoringInputs;
+
+	struct FObjectTierState
+	{
+		int32 TierIndex = INDEX_NONE;
+
+		// Whether the tier's throttling is applied (only for simulated proxies, re-evaluated when the actor's role changes)
+		bool bThrottled = false;
+	};
+
+	// Current tier of every scored object
+	TMap<FObjectKey, FObjectTierState> ObjectTierStates;
+
+	// Number of objects in each tier after the last update, in total and per tag
+	TArray<int32> TierCounts;
+	TMap<FName, TArray<int32>> TierCountsByTag;
+
+	// Scratch list reused every tick
+	TArray<const FManagedObjectInfo*> SortedObjects;
 };
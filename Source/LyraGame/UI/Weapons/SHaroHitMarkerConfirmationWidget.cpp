@@ -32,8 +32,9 @@ int32 SHaroHitMarkerConfirmationWidget::OnPaint(const FPaintArgs& Args, const FG
 
 	if (bDrawMarkers)
 	{
-		// Check if we should use screen-space damage location hit notifies
-		TArray<FHaroScreenSpaceHitLocation> LastWeaponDamageScreenLocations;
+		// Check if we should use screen-space damage location hit notifies (projected from the confirmed world locations now)
+		TArray<FHaroScreenSpaceHitLocation>& LastWeaponDamageScreenLocations = ScratchHitLocations;
+		LastWeaponDamageScreenLocations.Reset();
 		if (APlayerController* PC = MyContext.IsInitialized() ? MyContext.GetPlayerController() : nullptr)
 		{
 			if (UHaroWeaponStateComponent* WeaponStateComponent = PC->FindComponentByClass<UHaroWeaponStateComponent>())
@@ -9,6 +9,7 @@
 #include "Widgets/DeclarativeSyntaxSupport.h"
 #include "Widgets/Accessibility/SlateWidgetAccessibleTypes.h"
 #include "Widgets/SLeafWidget.h"
+#include "Weapons/HaroWeaponStateComponent.h"
 
 class FPaintArgs;
 class FSlateRect;
@@ -71,5 +72,8 @@ private:
 
 	/** Player context for the owning HUD */
 	FLocalPlayerContext MyContext;
+
+	/** Hit markers projected for the current paint (kept around so painting doesn't allocate every frame) */
+	mutable TArray<FHaroScreenSpaceHitLocation> ScratchHitLocations;
 	
 };
@@ -2,12 +2,17 @@
 
 
 #include "HaroAOEBase.h"
+#include "HaroAOEResolveSubsystem.h"
+#include "AbilitySystem/HaroDOTFieldSubsystem.h"
+#include "AbilitySystem/HaroEffectSpecCache.h"
+#include "LyraGameplayTags.h"
 #include "Components/SphereComponent.h"
 #include "Character/LyraCharacter.h"
 #include "NiagaraComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemGlobals.h"
+#include "System/LyraSignificanceManager.h"
 
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HaroAOEBase)
@@ -37,6 +42,15 @@ void AHaroAOEBase::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// 로컬 뷰어 기준 중요도 계산 (데디케이티드 서버는 제외)
+	if (!IsNetMode(NM_DedicatedServer))
+	{
+		if (ULyraSignificanceManager* SignificanceManager = USignificanceManager::Get<ULyraSignificanceManager>(GetWorld()))
+		{
+			SignificanceManager->RegisterActor(this, ULyraSignificanceManager::AOETag);
+		}
+	}
+
 	switch (AOEType)
 	{
 	case EHaroAOEType::Explosion:
@@ -51,25 +65,33 @@ void AHaroAOEBase::BeginPlay()
 
 void AHaroAOEBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+	if (bRegisteredDOTField)
+	{
+		if (UHaroDOTFieldSubsystem* DOTFieldSubsystem = UWorld::GetSubsystem<UHaroDOTFieldSubsystem>(GetWorld()))
+		{
+			DOTFieldSubsystem->UnregisterField(this);
+		}
+		bRegisteredDOTField = false;
+	}
+
 	// 모든 남은 DOT 효과들 제거
-	if (!ActiveEffectHandles.IsEmpty())
+	for (const auto& HandlePair : ActiveEffectHandles)
 	{
-		TArray<FActiveGameplayEffectHandle> HandlesToRemove;
-		for (auto HandlePair : ActiveEffectHandles)
+		if (UAbilitySystemComponent* ASC = HandlePair.Key.Get())
 		{
-			if (UAbilitySystemComponent* ASC = HandlePair.Value)
+			for (const FActiveGameplayEffectHandle& Handle : HandlePair.Value)
 			{
-				if (IsValid(ASC))
-				{
-					ASC->RemoveActiveGameplayEffect(HandlePair.Key, 1);
-				}
+				ASC->RemoveActiveGameplayEffect(Handle, 1);
 			}
-			HandlesToRemove.Add(HandlePair.Key);
 		}
+	}
+	ActiveEffectHandles.Reset();
 
-		for (auto& Handle : HandlesToRemove)
+	if (!IsNetMode(NM_DedicatedServer))
+	{
+		if (ULyraSignificanceManager* SignificanceManager = USignificanceManager::Get<ULyraSignificanceManager>(GetWorld()))
 		{
-			ActiveEffectHandles.FindAndRemoveChecked(Handle);
+			SignificanceManager->UnregisterActor(this);
 		}
 	}
 
@@ -97,50 +119,39 @@ void AHaroAOEBase::ExecuteExplosion()
 
 	if (!HasAuthority()) return;
 
-	// 1. 범위 내 모든 타겟 찾기
-	TArray<AActor*> AllTargets = FindTargetsInRange();
-	if (AllTargets.Num() == 0)
+	// 타겟 판정은 서브시스템에서 같은 프레임의 다른 폭발과 함께 처리
+	if (UHaroAOEResolveSubsystem* ResolveSubsystem = UWorld::GetSubsystem<UHaroAOEResolveSubsystem>(GetWorld()))
+	{
+		ResolveSubsystem->QueueExplosion(this);
+	}
+	else
 	{
 		OnAOECompleted();
-		return;
 	}
+}
 
-	FVector ExplosionCenter = GetActorLocation();
-
-	// 2. 각 타겟에 대해 개별적으로 처리
-	for (AActor* CurrentTarget : AllTargets)
+void AHaroAOEBase::ApplyExplosionToTargets(TConstArrayView<FHaroAOETargetHit> TargetHits)
+{
+	for (const FHaroAOETargetHit& TargetHit : TargetHits)
 	{
-		if (!CurrentTarget || !IsValidTarget(CurrentTarget))
-			continue;
-
-		// 3. 시야 확인 (Lyra LineTrace 방식)
-		if (bCheckLineOfSight)
-		{
-			if (!CheckLineOfSight(ExplosionCenter, CurrentTarget, AllTargets))
-			{
-				continue; // 벽에 막혔으면 데미지 없음
-			}
-		}
-
-		// 4. 거리별 데미지 계산 및 적용
+		// 거리별 데미지 계산 및 적용
 		if (bUseDistanceBasedDamage)
 		{
-			float Distance = FVector::Dist(ExplosionCenter, CurrentTarget->GetActorLocation());
-			float DamageLevel = CalculateDistanceDamageLevel(Distance);
+			float DamageLevel = CalculateDistanceDamageLevel(TargetHit.Distance);
 
 			if (DamageLevel > 0.0f)
 			{
-				ApplyDistanceBasedDamageToTarget(CurrentTarget, DamageLevel);
+				ApplyDistanceBasedDamageToTarget(TargetHit.Target, DamageLevel);
 			}
 		}
 		else
 		{
 			// 거리 상관없이 고정 데미지
-			ApplyDamageToTarget(CurrentTarget);
+			ApplyDamageToTarget(TargetHit.Target);
 		}
 	}
 
-	// 5. 완료 처리
+	// 완료 처리
 	OnAOECompleted();
 }
 
@@ -152,31 +163,32 @@ void AHaroAOEBase::ExecuteDOTField()
 
 	SetLifeSpan(DOTFieldLifeSpan);
 
+	// 틱 방식 DOT: 필드 서브시스템에 등록만 하고 오버랩은 쓰지 않음
+	UHaroDOTFieldSubsystem* DOTFieldSubsystem = UWorld::GetSubsystem<UHaroDOTFieldSubsystem>(GetWorld());
+	if (DOTTickEffectClass && DOTFieldSubsystem && AOEDamageEffectSpecHandle.IsValid())
+	{
+		const FGameplayEffectSpec& SourceSpec = *AOEDamageEffectSpecHandle.Data.Get();
+		if (UAbilitySystemComponent* SourceASC = SourceSpec.GetContext().GetInstigatorAbilitySystemComponent())
+		{
+			FHaroDOTFieldDesc FieldDesc;
+			FieldDesc.Center = GetActorLocation();
+			FieldDesc.Radius = CollisionComponent->GetScaledSphereRadius();
+			FieldDesc.TickEffectSpec = SourceASC->MakeOutgoingSpec(DOTTickEffectClass, SourceSpec.GetLevel(), SourceSpec.GetContext().Duplicate());
+			FieldDesc.SetByCallerTag = LyraGameplayTags::SetByCaller_Damage;
+			FieldDesc.MagnitudePerSecond = DOTDamagePerSecond;
+			FieldDesc.IgnoredActor = GetOwner();
+			FieldDesc.bCheckLineOfSight = bCheckLineOfSight;
+
+			DOTFieldSubsystem->RegisterField(this, FieldDesc);
+			bRegisteredDOTField = true;
+			return;
+		}
+	}
+
 	// 컬리전을 트리거로 설정하여 블루프린트에서 오버랩 감지 가능하게
 	CollisionComponent->SetCollisionProfileName(TEXT("Trigger"));
 }
 
-TArray<AActor*> AHaroAOEBase::FindTargetsInRange()
-{
-	TArray<TEnumAsByte<EObjectTypeQuery>> ObjectTypes;
-	ObjectTypes.Add(UEngineTypes::ConvertToObjectType(ECollisionChannel::ECC_Pawn));
-
-	TArray<AActor*> IgnoredActors = { this, GetOwner() };
-	TArray<AActor*> OverlappingActors;
-
-	UKismetSystemLibrary::SphereOverlapActors(
-		GetWorld(),
-		GetActorLocation(),
-		CollisionComponent->GetScaledSphereRadius(),
-		ObjectTypes,
-		APawn::StaticClass(), 
-		IgnoredActors,
-		OverlappingActors
-	);
-
-	return OverlappingActors;
-}
-
 void AHaroAOEBase::OnAOECompleted()
 {
 	// 블루프린트
@@ -185,15 +197,14 @@ void AHaroAOEBase::OnAOECompleted()
 
 void AHaroAOEBase::OnOverlap(AActor* TargetActor)
 {
-	if (!HasAuthority()) return;
+	if (!HasAuthority() || bRegisteredDOTField) return;
 
 	if (IsValidTarget(TargetActor))
 	{
 		// 시야 체크 (필요한 경우)
 		if (bCheckLineOfSight)
 		{
-			TArray<AActor*> AllTargets = { TargetActor }; // 단일 타겟용
-			if (!CheckLineOfSight(GetActorLocation(), TargetActor, AllTargets))
+			if (!CheckLineOfSight(GetActorLocation(), TargetActor))
 			{
 				return; // 시야 막힘
 			}
@@ -205,37 +216,22 @@ void AHaroAOEBase::OnOverlap(AActor* TargetActor)
 
 void AHaroAOEBase::OnEndOverlap(AActor* TargetActor)
 {
-	if (!HasAuthority()) return;
+	if (!HasAuthority() || bRegisteredDOTField) return;
 
 	RemoveDOTEffectFromTarget(TargetActor);
 
 }
 
-bool AHaroAOEBase::CheckLineOfSight(FVector ExplosionCenter, AActor* TargetActor, const TArray<AActor*>& AllTargets)
+bool AHaroAOEBase::CheckLineOfSight(const FVector& ExplosionCenter, AActor* TargetActor) const
 {
 	if (!TargetActor) return false;
 
-	// 다른 모든 타겟들을 무시 리스트에 추가
-	TArray<AActor*> IgnoredActors = AllTargets;
-	IgnoredActors.Add(this);
-	IgnoredActors.Add(GetOwner());
-	IgnoredActors.Remove(TargetActor); // 현재 타겟만 제외
-
-	FHitResult HitResult;
-	FVector TargetLocation = TargetActor->GetActorLocation();
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HaroAOELineOfSight), /*bTraceComplex=*/ false, this);
+	QueryParams.AddIgnoredActor(GetOwner());
 
 	// LineTrace로 시야 확인
-	bool bHit = UKismetSystemLibrary::LineTraceSingle(
-		GetWorld(),
-		ExplosionCenter,
-		TargetLocation,
-		UEngineTypes::ConvertToTraceType(ECollisionChannel::ECC_Visibility),
-		false, // bTraceComplex
-		IgnoredActors,
-		EDrawDebugTrace::None,
-		HitResult,
-		true // bIgnoreSelf
-	);
+	FHitResult HitResult;
+	const bool bHit = GetWorld()->LineTraceSingleByChannel(HitResult, ExplosionCenter, TargetActor->GetActorLocation(), ECollisionChannel::ECC_Visibility, QueryParams);
 
 	// 충돌이 없거나 충돌한 것이 타겟 자신이면 시야 확보
 	return !bHit || (HitResult.GetActor() == TargetActor);
@@ -276,13 +272,9 @@ void AHaroAOEBase::ApplyDistanceBasedDamageToTarget(AActor* Target, float Damage
 	if (!TargetASC)
 		return;
 
-	// 기존 스펙을 복사하고 레벨만 수정
-	FGameplayEffectSpec* OriginalSpec = AOEDamageEffectSpecHandle.Data.Get();
-	FGameplayEffectSpec ModifiedSpec(*OriginalSpec); // 스냅샷 복사!
-	ModifiedSpec.SetLevel(DamageLevel); // 레벨만 스케일링
-
-	// 수정된 스펙 적용
-	TargetASC->ApplyGameplayEffectSpecToSelf(ModifiedSpec);
+	// 레벨만 스케일링해서 적용
+	// 적용할 때 ASC가 어차피 스펙을 복사하므로 여기서 대상마다 한 번 더 복사하지 않고 잠깐 바꿨다가 되돌림
+	FHaroEffectSpecCache::ApplySpecAtLevel(TargetASC, AOEDamageEffectSpecHandle, DamageLevel);
 
 }
 
@@ -317,7 +309,7 @@ void AHaroAOEBase::ApplyDOTEffectToTarget(AActor* Target)
 	const bool bIsInfinite = AOEDamageEffectSpecHandle.Data.Get()->Def.Get()->DurationPolicy == EGameplayEffectDurationType::Infinite;
 	if (bIsInfinite && ActiveEffectHandle.IsValid())
 	{
-		ActiveEffectHandles.Add(ActiveEffectHandle, TargetASC);
+		ActiveEffectHandles.FindOrAdd(TargetASC).Add(ActiveEffectHandle);
 	}
 
 }
@@ -331,19 +323,13 @@ void AHaroAOEBase::RemoveDOTEffectFromTarget(AActor* Target)
 	UAbilitySystemComponent* TargetASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Target);
 	if (!IsValid(TargetASC)) return;
 
-	TArray<FActiveGameplayEffectHandle> HandlesToRemove;
-	for (auto HandlePair : ActiveEffectHandles)
+	// 타겟 ASC로 바로 찾아서 제거
+	TArray<FActiveGameplayEffectHandle, TInlineAllocator<1>> HandlesToRemove;
+	if (ActiveEffectHandles.RemoveAndCopyValue(TargetASC, HandlesToRemove))
 	{
-		if (TargetASC == HandlePair.Value)
+		for (const FActiveGameplayEffectHandle& Handle : HandlesToRemove)
 		{
-			TargetASC->RemoveActiveGameplayEffect(HandlePair.Key, 1);
-			HandlesToRemove.Add(HandlePair.Key);
+			TargetASC->RemoveActiveGameplayEffect(Handle, 1);
 		}
 	}
-
-	// 별도 루프에서 맵에서 제거
-	for (auto& Handle : HandlesToRemove)
-	{
-		ActiveEffectHandles.FindAndRemoveChecked(Handle);
-	}
-}
\ No newline at end of file
+}
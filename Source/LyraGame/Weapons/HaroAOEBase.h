@@ -7,6 +7,9 @@
 
 class USphereComponent;
 class UNiagaraComponent;
+class UAbilitySystemComponent;
+class UGameplayEffect;
+struct FHaroAOETargetHit;
 
 UENUM(BlueprintType)
 enum class EHaroAOEType : uint8
@@ -47,8 +50,10 @@ protected:
 	UFUNCTION(BlueprintCallable)
 	void OnEndOverlap(AActor* TargetActor);
 
-	TArray<AActor*> FindTargetsInRange();
-	bool CheckLineOfSight(FVector ExplosionCenter, AActor* TargetActor, const TArray<AActor*>& AllTargets);
+	// 판정이 끝난 타겟들에 폭발 데미지 적용 (UHaroAOEResolveSubsystem에서 호출)
+	void ApplyExplosionToTargets(TConstArrayView<FHaroAOETargetHit> TargetHits);
+
+	bool CheckLineOfSight(const FVector& ExplosionCenter, AActor* TargetActor) const;
 	bool IsValidTarget(AActor* Target) const;
 	
 	// 즉시 데미지 적용 (거리 기반)
@@ -94,10 +99,24 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "DOT")
 	float DOTFieldLifeSpan = 5.0f; 
 
+	// 설정하면 오버랩마다 GE를 붙이는 대신 UHaroDOTFieldSubsystem이 일정 간격으로 이 Instant GE를 적용함
+	// (SetByCaller.Damage로 데미지를 받아야 함, 비어 있으면 기존 오버랩 방식)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "DOT")
+	TSubclassOf<UGameplayEffect> DOTTickEffectClass;
+
+	// DOTTickEffectClass 사용 시 초당 데미지
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "DOT", meta = (EditCondition = "DOTTickEffectClass != nullptr"))
+	float DOTDamagePerSecond = 10.0f;
+
 private:
 	// 데미지 이펙트 스펙 (어빌리티->투사체->AOE)
 	FGameplayEffectSpecHandle AOEDamageEffectSpecHandle;
 
-	// Dot 효과 추적용
-	TMap<FActiveGameplayEffectHandle, UAbilitySystemComponent*> ActiveEffectHandles;
+	// Dot 효과 추적용 (타겟 ASC -> 적용한 핸들들)
+	TMap<TWeakObjectPtr<UAbilitySystemComponent>, TArray<FActiveGameplayEffectHandle, TInlineAllocator<1>>> ActiveEffectHandles;
+
+	// DOT 필드 서브시스템에 등록했는지
+	bool bRegisteredDOTField = false;
+
+	friend class UHaroAOEResolveSubsystem;
 };
@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HaroAOEResolveSubsystem.h"
+
+#include "Components/SphereComponent.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "HaroAOEBase.h"
+#include "LyraLogChannels.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HaroAOEResolveSubsystem)
+
+namespace HaroConsoleVariables
+{
+	static bool bBatchExplosions = true;
+	static FAutoConsoleVariableRef CVarBatchExplosions(
+		TEXT("Haro.AOE.BatchExplosions"),
+		bBatchExplosions,
+		TEXT("Should explosions requested in the same frame be resolved together in one pass at the end of the frame"),
+		ECVF_Default);
+
+	static bool bLogAOEResolveStats = false;
+	static FAutoConsoleVariableRef CVarLogAOEResolveStats(
+		TEXT("Haro.AOE.LogResolveStats"),
+		bLogAOEResolveStats,
+		TEXT("Log explosion/candidate/trace counts and timing for every AOE resolve pass"),
+		ECVF_Default);
+}
+
+bool UHaroAOEResolveSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+ETickableTickType UHaroAOEResolveSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UHaroAOEResolveSubsystem::IsTickable() const
+{
+	return PendingExplosions.Num() > 0;
+}
+
+TStatId UHaroAOEResolveSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHaroAOEResolveSubsystem, STATGROUP_Tickables);
+}
+
+void UHaroAOEResolveSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	FlushPendingExplosions();
+}
+
+void UHaroAOEResolveSubsystem::QueueExplosion(AHaroAOEBase* AOE)
+{
+	if (!AOE)
+	{
+		return;
+	}
+
+	// 처리 중에 들어온 연쇄 폭발은 임시 버퍼를 쓰는 중이므로 항상 큐에 넣음
+	if (HaroConsoleVariables::bBatchExplosions || bResolvingExplosions)
+	{
+		PendingExplosions.Add(AOE);
+		return;
+	}
+
+	const TWeakObjectPtr<AHaroAOEBase> SingleExplosion(AOE);
+	ResolveExplosions(MakeArrayView(&SingleExplosion, 1));
+
+	// 배치를 끈 상태에서는 연쇄 폭발도 이번 호출 안에서 끝냄
+	while (PendingExplosions.Num() > 0)
+	{
+		FlushPendingExplosions();
+	}
+}
+
+void UHaroAOEResolveSubsystem::FlushPendingExplosions()
+{
+	if ((PendingExplosions.Num() == 0) || bResolvingExplosions)
+	{
+		return;
+	}
+
+	// 처리 중에 연쇄 폭발이 큐에 들어와도 배열이 꼬이지 않도록 교체
+	ResolvingExplosions.Reset();
+	Swap(ResolvingExplosions, PendingExplosions);
+
+	ResolveExplosions(ResolvingExplosions);
+
+	ResolvingExplosions.Reset();
+}
+
+void UHaroAOEResolveSubsystem::ResolveExplosions(TArrayView<const TWeakObjectPtr<AHaroAOEBase>> Explosions)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_HaroAOE_ResolveExplosions);
+
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	TGuardValue<bool> ResolvingGuard(bResolvingExplosions, true);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FHaroAOEResolveStats Stats;
+	Stats.NumExplosions = Explosions.Num();
+
+	const FCollisionObjectQueryParams PawnObjectParams(ECollisionChannel::ECC_Pawn);
+
+	for (const TWeakObjectPtr<AHaroAOEBase>& WeakAOE : Explosions)
+	{
+		AHaroAOEBase* AOE = WeakAOE.Get();
+		if (!IsValid(AOE))
+		{
+			continue;
+		}
+
+		const FVector ExplosionCenter = AOE->GetActorLocation();
+		const float Radius = AOE->CollisionComponent->GetScaledSphereRadius();
+
+		// 1. 후보 수집 (오버랩 한 번)
+		ScratchQueryParams.ClearIgnoredActors();
+		ScratchQueryParams.TraceTag = SCENE_QUERY_STAT_NAME_ONLY(HaroAOE);
+		ScratchQueryParams.bTraceComplex = false;
+		ScratchQueryParams.AddIgnoredActor(AOE);
+		ScratchQueryParams.AddIgnoredActor(AOE->GetOwner());
+
+		ScratchOverlaps.Reset();
+		World->OverlapMultiByObjectType(ScratchOverlaps, ExplosionCenter, FQuat::Identity, PawnObjectParams, FCollisionShape::MakeSphere(Radius), ScratchQueryParams);
+		++Stats.NumOverlapQueries;
+
+		ScratchCandidates.Reset();
+		for (const FOverlapResult& Overlap : ScratchOverlaps)
+		{
+			AActor* Candidate = Overlap.GetActor();
+			if (Candidate && AOE->IsValidTarget(Candidate))
+			{
+				// 컴포넌트가 여러 개 걸리면 같은 액터가 중복될 수 있음
+				ScratchCandidates.AddUnique(Candidate);
+			}
+		}
+		Stats.NumCandidates += ScratchCandidates.Num();
+
+		// 2. 시야 확인 (쿼리 파라미터는 폭발마다 한 번만 만듦)
+		// 기존 CheckLineOfSight와 같이 후보 폰끼리는 서로 시야를 막지 않음
+		if (AOE->bCheckLineOfSight)
+		{
+			ScratchQueryParams.AddIgnoredActors(ScratchCandidates);
+		}
+
+		ScratchTargetHits.Reset();
+		for (AActor* Candidate : ScratchCandidates)
+		{
+			const FVector TargetLocation = Candidate->GetActorLocation();
+
+			if (AOE->bCheckLineOfSight)
+			{
+				++Stats.NumLineOfSightTraces;
+
+				// 후보가 아닌 것(벽 등)에 막혔으면 데미지 없음
+				FHitResult HitResult;
+				if (World->LineTraceSingleByChannel(HitResult, ExplosionCenter, TargetLocation, ECollisionChannel::ECC_Visibility, ScratchQueryParams)
+					&& (HitResult.GetActor() != Candidate))
+				{
+					continue;
+				}
+			}
+
+			FHaroAOETargetHit& TargetHit = ScratchTargetHits.AddDefaulted_GetRef();
+			TargetHit.Target = Candidate;
+			TargetHit.Distance = FVector::Dist(ExplosionCenter, TargetLocation);
+		}
+		Stats.NumTargetsHit += ScratchTargetHits.Num();
+
+		// 3. 데미지 적용
+		AOE->ApplyExplosionToTargets(ScratchTargetHits);
+	}
+
+	Stats.ResolveTimeSeconds = FPlatformTime::Seconds() - StartTime;
+	LastResolveStats = Stats;
+
+	if (HaroConsoleVariables::bLogAOEResolveStats)
+	{
+		UE_LOG(LogLyra, Log, TEXT("AOE resolve: %d explosions, %d overlaps, %d candidates, %d LOS traces, %d hits, %.3f ms"),
+			Stats.NumExplosions, Stats.NumOverlapQueries, Stats.NumCandidates, Stats.NumLineOfSightTraces, Stats.NumTargetsHit, Stats.ResolveTimeSeconds * 1000.0);
+	}
+}
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CollisionQueryParams.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "HaroAOEResolveSubsystem.generated.h"
+
+class AActor;
+class AHaroAOEBase;
+struct FOverlapResult;
+
+/** 폭발 판정으로 찾은 타겟 하나 */
+struct FHaroAOETargetHit
+{
+	AActor* Target = nullptr;
+	float Distance = 0.0f;
+};
+
+/** 마지막 판정 패스 통계 (프로파일링용) */
+struct FHaroAOEResolveStats
+{
+	int32 NumExplosions = 0;
+	int32 NumOverlapQueries = 0;
+	int32 NumCandidates = 0;
+	int32 NumLineOfSightTraces = 0;
+	int32 NumTargetsHit = 0;
+	double ResolveTimeSeconds = 0.0;
+};
+
+/**
+ * 폭발형 AOE의 타겟 판정을 모아서 처리하는 월드 서브시스템 (서버 전용)
+ *
+ * 같은 프레임에 터진 폭발들은 큐에 쌓였다가 한 번의 패스로 처리됨:
+ *   1. 폭발마다 오버랩 쿼리 한 번으로 후보 수집
+ *   2. 폭발마다 쿼리 파라미터를 한 번만 만들고 후보 전체의 시야 트레이스를 연속으로 실행
+ *   3. 결과를 각 AHaroAOEBase에 넘겨서 데미지 적용
+ * 모든 임시 배열은 서브시스템이 들고 있다가 재사용함.
+ */
+UCLASS()
+class LYRAGAME_API UHaroAOEResolveSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	//~End of FTickableGameObject interface
+
+	/**
+	 * 폭발 판정 요청
+	 * Haro.AOE.BatchExplosions가 켜져 있으면 이번 프레임 끝에 다른 폭발과 함께 처리하고, 꺼져 있으면 바로 처리함
+	 */
+	void QueueExplosion(AHaroAOEBase* AOE);
+
+	/** 대기 중인 폭발을 지금 모두 처리 */
+	void FlushPendingExplosions();
+
+	const FHaroAOEResolveStats& GetLastResolveStats() const { return LastResolveStats; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void ResolveExplosions(TArrayView<const TWeakObjectPtr<AHaroAOEBase>> Explosions);
+
+private:
+	// 이번 프레임에 요청된 폭발들
+	TArray<TWeakObjectPtr<AHaroAOEBase>> PendingExplosions;
+
+	// 처리 중인 폭발들 (처리 중에 새로 들어온 요청은 다음 패스로)
+	TArray<TWeakObjectPtr<AHaroAOEBase>> ResolvingExplosions;
+
+	// ResolveExplosions 실행 중 (연쇄 폭발이 임시 버퍼를 덮어쓰지 않도록 큐로 보냄)
+	bool bResolvingExplosions = false;
+
+	// ========== 재사용하는 임시 버퍼 ==========
+	TArray<FOverlapResult> ScratchOverlaps;
+	TArray<AActor*> ScratchCandidates;
+	TArray<FHaroAOETargetHit> ScratchTargetHits;
+	FCollisionQueryParams ScratchQueryParams;
+
+	FHaroAOEResolveStats LastResolveStats;
+};
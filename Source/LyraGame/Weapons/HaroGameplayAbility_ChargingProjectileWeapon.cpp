@@ -91,43 +91,30 @@ void UHaroGameplayAbility_ChargingProjectileWeapon::OnChargingTargetDataReadyCal
 	OnTargetDataReadyCallback(InData, ApplicationTag);
 }
 
-// 좀 더 보완이 가능할 것 같음.
-void UHaroGameplayAbility_ChargingProjectileWeapon::ConfigureProjectileDamageEffect(AHaroProjectileBase* Projectile, UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter)
+// 액터/시뮬레이션 투사체 모두 이 스펙을 사용함
+FGameplayEffectSpecHandle UHaroGameplayAbility_ChargingProjectileWeapon::MakeProjectileDamageSpec(UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter, float LaunchChargingTime)
 {
-	// Super 호출하지 않고 직접 처리
-	UAbilitySystemComponent* SourceASC = SourceCharacter->GetAbilitySystemComponent();
-	if (SourceASC && DamageEffectClass)
+	UAbilitySystemComponent* SourceASC = SourceCharacter ? SourceCharacter->GetAbilitySystemComponent() : nullptr;
+	UHaroRangedWeaponInstance* WeaponData = GetWeaponInstance();
+	if (!SourceASC || !DamageEffectClass || !WeaponData)
 	{
-		// 컨텍스트 생성
-		FGameplayEffectContextHandle EffectContext = SourceASC->MakeEffectContext();
-		EffectContext.SetAbility(this);
-		EffectContext.AddSourceObject(WeaponInstance);
-
-		// 새로운 스펙 생성 -> 이때 스냅샷
-		FGameplayEffectSpecHandle DamageSpec = SourceASC->MakeOutgoingSpec(
-			DamageEffectClass,
-			GetAbilityLevel(),
-			EffectContext
-		);
-
-		if (DamageSpec.IsValid())
-		{
-			// 차징 배율을 바로 설정
-			if (UHaroRangedWeaponInstance* WeaponData = GetWeaponInstance())
-			{
-				const EHaroFireInputType InputType = GetCurrentFireInputType();
-
-				float ChargeMultiplier = WeaponData->GetChargedDamageMultiplier(InputType);
-				DamageSpec.Data->SetSetByCallerMagnitude(
-					LyraGameplayTags::SetByCaller_ChargeMultiplier,
-					ChargeMultiplier
-				);
-			}
-
-			// 투사체에 설정
-			Projectile->SetDamageEffectSpec(DamageSpec);
-		}
+		return Super::MakeProjectileDamageSpec(WeaponInstance, SourceCharacter, LaunchChargingTime);
 	}
+
+	// 템플릿(장착 시점 스냅샷)은 공유하고, 차징 배율만 다른 스펙을 만듦 (같은 배율이면 그것도 공유)
+	const EHaroFireInputType InputType = GetCurrentFireInputType();
+	const float ChargeMultiplier = WeaponData->GetChargedDamageMultiplier(InputType, LaunchChargingTime);
+
+	return EffectSpecCache.GetSpecWithSetByCaller(
+		SourceASC,
+		this,
+		DamageEffectClass,
+		GetAbilityLevel(),
+		WeaponInstance,
+		WeaponInstance ? WeaponInstance->GetEquipSerial() : 0,
+		LyraGameplayTags::SetByCaller_ChargeMultiplier,
+		ChargeMultiplier
+	);
 }
 
 void UHaroGameplayAbility_ChargingProjectileWeapon::OnInputRelease(float TimeHeld)
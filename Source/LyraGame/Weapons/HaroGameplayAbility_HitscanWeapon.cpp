@@ -8,9 +8,17 @@
 #include "AIController.h"
 #include "NativeGameplayTags.h"
 #include "Weapons/HaroWeaponStateComponent.h"
+#include "Weapons/HaroLagCompensationSubsystem.h"
+#include "GameFramework/GameStateBase.h"
 #include "AbilitySystemComponent.h"
 #include "AbilitySystem/LyraGameplayAbilityTargetData_SingleTargetHit.h"
+#include "Weapons/HaroHitscanTargetData.h"
+#include "Abilities/Tasks/AbilityTask_WaitInputRelease.h"
 #include "DrawDebugHelpers.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "TimerManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HaroGameplayAbility_HitscanWeapon)
 
@@ -36,6 +44,102 @@ namespace HaroConsoleVariables
 		DrawBulletHitRadius,
 		TEXT("When bullet hit debug drawing is enabled (see DrawBulletHitDuration), how big should the hit radius be? (in uu)"),
 		ECVF_Default);
+
+	static bool bUseBatchedCartridgeTrace = true;
+	static FAutoConsoleVariableRef CVarUseBatchedCartridgeTrace(
+		TEXT("Haro.Weapon.UseBatchedCartridgeTrace"),
+		bUseBatchedCartridgeTrace,
+		TEXT("Should all of the pellets in a cartridge be traced as one batch (query params built once, sweep fallback only for missed pellets)"),
+		ECVF_Default);
+
+	static bool bValidateSpread = true;
+	static FAutoConsoleVariableRef CVarValidateSpread(
+		TEXT("Haro.Weapon.ValidateSpread"),
+		bValidateSpread,
+		TEXT("Should the server regenerate each cartridge's pellet directions from its seed and reject hits that are not on their pellet's ray"),
+		ECVF_Default);
+
+	static float SpreadValidationDistance = 30.0f;
+	static FAutoConsoleVariableRef CVarSpreadValidationDistance(
+		TEXT("Haro.Weapon.SpreadValidationDistance"),
+		SpreadValidationDistance,
+		TEXT("How far (in uu, on top of the sweep radius) a hit may be from its regenerated pellet ray before the server rejects it"),
+		ECVF_Default);
+
+	static float SpreadValidationMinScale = 0.5f;
+	static FAutoConsoleVariableRef CVarSpreadValidationMinScale(
+		TEXT("Haro.Weapon.SpreadValidationMinScale"),
+		SpreadValidationMinScale,
+		TEXT("A cartridge is rejected if its reported spread is below the server's current spread times this scale"),
+		ECVF_Default);
+
+	static bool bLogCartridgeTraceStats = false;
+	static FAutoConsoleVariableRef CVarLogCartridgeTraceStats(
+		TEXT("Haro.Weapon.LogCartridgeTraceStats"),
+		bLogCartridgeTraceStats,
+		TEXT("Should we log the trace counters and timing of every cartridge (to compare the batched and per-pellet paths)"),
+		ECVF_Default);
+
+	static bool bEnableSustainedFire = true;
+	static FAutoConsoleVariableRef CVarEnableSustainedFire(
+		TEXT("Haro.Weapon.SustainedFire"),
+		bEnableSustainedFire,
+		TEXT("Should hitscan abilities marked bSustainedFire keep firing inside one activation (if false, every shot is its own activation, as before)"),
+		ECVF_Default);
+
+	static float SustainedFireBatchInterval = 0.1f;
+	static FAutoConsoleVariableRef CVarSustainedFireBatchInterval(
+		TEXT("Haro.Weapon.SustainedFireBatchInterval"),
+		SustainedFireBatchInterval,
+		TEXT("How long (in seconds) sustained fire collects predicted shots before sending them to the server as one target data RPC (0 = send every shot)"),
+		ECVF_Default);
+
+	static int32 SustainedFireMaxBatchShots = 8;
+	static FAutoConsoleVariableRef CVarSustainedFireMaxBatchShots(
+		TEXT("Haro.Weapon.SustainedFireMaxBatchShots"),
+		SustainedFireMaxBatchShots,
+		TEXT("A sustained fire batch is sent early once it holds this many shots"),
+		ECVF_Default);
+
+	static float SustainedFireRateTolerance = 0.15f;
+	static FAutoConsoleVariableRef CVarSustainedFireRateTolerance(
+		TEXT("Haro.Weapon.SustainedFireRateTolerance"),
+		SustainedFireRateTolerance,
+		TEXT("How far ahead (in seconds) of the server's activation clock a sustained fire shot may be before the server rejects it as faster than the fire rate"),
+		ECVF_Default);
+}
+
+namespace HaroHitscanFireStats
+{
+	static int32 ScopeDepth = 0;
+
+	// Adds the game thread time of the outermost ability entry point to the fire stats (nested entry points are already covered)
+	struct FScopedCpuTimer
+	{
+		explicit FScopedCpuTimer(bool bInSustainedFire)
+			: bSustainedFire(bInSustainedFire)
+			, StartTime(FPlatformTime::Seconds())
+		{
+			++ScopeDepth;
+		}
+
+		~FScopedCpuTimer()
+		{
+			if (--ScopeDepth == 0)
+			{
+				UHaroGameplayAbility_HitscanWeapon::GetFireStats(bSustainedFire).CpuTimeSeconds += FPlatformTime::Seconds() - StartTime;
+			}
+		}
+
+		bool bSustainedFire;
+		double StartTime;
+	};
+
+	static bool IsPredictingClient(const FGameplayAbilityActorInfo* ActorInfo, const UGameplayAbility* Ability)
+	{
+		return ActorInfo && ActorInfo->IsLocallyControlled() && !ActorInfo->IsNetAuthority()
+			&& (Ability->GetNetExecutionPolicy() == EGameplayAbilityNetExecutionPolicy::LocalPredicted);
+	}
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -48,6 +152,13 @@ UHaroGameplayAbility_HitscanWeapon::UHaroGameplayAbility_HitscanWeapon(const FOb
 	//SourceBlockedTags.AddTag(FGameplayTag::RequestGameplayTag("Ability.Weapon.NoFiring"));
 }
 
+FHaroHitscanFireStats& UHaroGameplayAbility_HitscanWeapon::GetFireStats(bool bSustainedFire)
+{
+	static FHaroHitscanFireStats PerShotStats;
+	static FHaroHitscanFireStats SustainedStats;
+	return bSustainedFire ? SustainedStats : PerShotStats;
+}
+
 bool UHaroGameplayAbility_HitscanWeapon::CanActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayTagContainer* SourceTags, const FGameplayTagContainer* TargetTags, OUT FGameplayTagContainer* OptionalRelevantTags) const
 {
 	// 슬롯 활성화 체크
@@ -66,6 +177,11 @@ bool UHaroGameplayAbility_HitscanWeapon::CanActivateAbility(const FGameplayAbili
 				*UHaroRangedWeaponInstance::StaticClass()->GetName());
 			bResult = false;
 		}
+		else if (!ActorInfo->IsNetAuthority() && !GetWeaponInstance()->HasSpreadSeed())
+		{
+			// 탄퍼짐 시드가 복제되기 전에 쏘면 시드 0으로 탄퍼짐을 만들어서 서버가 모든 히트를 거부함
+			bResult = false;
+		}
 	}
 
 	return bResult;
@@ -122,22 +238,29 @@ FHitResult UHaroGameplayAbility_HitscanWeapon::WeaponTrace(const FVector& StartT
 
 	const ECollisionChannel TraceChannel = DetermineTraceChannel(TraceParams, bIsSimulated);
 
+	return WeaponTraceWithParams(StartTrace, EndTrace, SweepRadius, TraceParams, TraceChannel, /*scratch*/ HitResults, /*out*/ OutHitResults);
+}
+
+FHitResult UHaroGameplayAbility_HitscanWeapon::WeaponTraceWithParams(const FVector& StartTrace, const FVector& EndTrace, float SweepRadius, const FCollisionQueryParams& TraceParams, ECollisionChannel TraceChannel, TArray<FHitResult>& ScratchHits, OUT TArray<FHitResult>& OutHitResults) const
+{
+	ScratchHits.Reset();
+
 	if (SweepRadius > 0.0f)
 	{
-		GetWorld()->SweepMultiByChannel(HitResults, StartTrace, EndTrace, FQuat::Identity, TraceChannel, FCollisionShape::MakeSphere(SweepRadius), TraceParams);
+		GetWorld()->SweepMultiByChannel(ScratchHits, StartTrace, EndTrace, FQuat::Identity, TraceChannel, FCollisionShape::MakeSphere(SweepRadius), TraceParams);
 	}
 	else
 	{
-		GetWorld()->LineTraceMultiByChannel(HitResults, StartTrace, EndTrace, TraceChannel, TraceParams);
+		GetWorld()->LineTraceMultiByChannel(ScratchHits, StartTrace, EndTrace, TraceChannel, TraceParams);
 	}
 
 	FHitResult Hit(ForceInit);
-	if (HitResults.Num() > 0)
+	if (ScratchHits.Num() > 0)
 	{
 		// Filter the output list to prevent multiple hits on the same actor;
 		// this is to prevent a single bullet dealing damage multiple times to
 		// a single actor if using an overlap trace
-		for (FHitResult& CurHitResult : HitResults)
+		for (FHitResult& CurHitResult : ScratchHits)
 		{
 			auto Pred = [&CurHitResult](const FHitResult& Other)
 				{
@@ -161,7 +284,7 @@ FHitResult UHaroGameplayAbility_HitscanWeapon::WeaponTrace(const FVector& StartT
 	return Hit;
 }
 
-void UHaroGameplayAbility_HitscanWeapon::PerformLocalTargeting(OUT TArray<FHitResult>& OutHits)
+void UHaroGameplayAbility_HitscanWeapon::PerformLocalTargeting(OUT TArray<FHitResult>& OutHits, OUT FHitscanWeaponFiringInput* OutInputData, uint16 ShotIndex)
 {
 	APawn* const AvatarPawn = Cast<APawn>(GetAvatarActorFromActorInfo());
 
@@ -181,6 +304,11 @@ void UHaroGameplayAbility_HitscanWeapon::PerformLocalTargeting(OUT TArray<FHitRe
 
 		InputData.EndAim = InputData.StartTrace + InputData.AimDir * WeaponData->GetMaxDamageRange(InputType);
 
+		// Spread can't change while a cartridge is being traced, so resolve it once
+		const float ActualSpreadAngle = WeaponData->GetCalculatedSpreadAngle() * WeaponData->GetCalculatedSpreadAngleMultiplier();
+		InputData.SpreadHalfAngleRad = FMath::DegreesToRadians(ActualSpreadAngle * 0.5f);
+		InputData.CartridgeSeed = MakeCartridgeSeed(ShotIndex);
+
 #if ENABLE_DRAW_DEBUG
 		if (HaroConsoleVariables::DrawBulletTracesDuration > 0.0f)
 		{
@@ -190,10 +318,15 @@ void UHaroGameplayAbility_HitscanWeapon::PerformLocalTargeting(OUT TArray<FHitRe
 #endif
 
 		TraceBulletsInCartridge(InputData, /*out*/ OutHits);
+
+		if (OutInputData)
+		{
+			*OutInputData = InputData;
+		}
 	}
 }
 
-FHitResult UHaroGameplayAbility_HitscanWeapon::DoSingleBulletTrace(const FVector& StartTrace, const FVector& EndTrace, float SweepRadius, bool bIsSimulated, OUT TArray<FHitResult>& OutHits) const
+FHitResult UHaroGameplayAbility_HitscanWeapon::DoSingleBulletTrace(const FVector& StartTrace, const FVector& EndTrace, float SweepRadius, bool bIsSimulated, OUT TArray<FHitResult>& OutHits, FHaroCartridgeTraceStats* OutStats) const
 {
 #if ENABLE_DRAW_DEBUG
 	if (HaroConsoleVariables::DrawBulletTracesDuration > 0.0f)
@@ -210,6 +343,12 @@ FHitResult UHaroGameplayAbility_HitscanWeapon::DoSingleBulletTrace(const FVector
 	if (FindFirstPawnHitResult(OutHits) == INDEX_NONE)
 	{
 		Impact = WeaponTrace(StartTrace, EndTrace, /*SweepRadius=*/ 0.0f, bIsSimulated, /*out*/ OutHits);
+
+		if (OutStats)
+		{
+			++OutStats->NumLineTraces;
+			++OutStats->NumQueryParamBuilds;
+		}
 	}
 
 	if (FindFirstPawnHitResult(OutHits) == INDEX_NONE)
@@ -220,6 +359,12 @@ FHitResult UHaroGameplayAbility_HitscanWeapon::DoSingleBulletTrace(const FVector
 			TArray<FHitResult> SweepHits;
 			Impact = WeaponTrace(StartTrace, EndTrace, SweepRadius, bIsSimulated, /*out*/ SweepHits);
 
+			if (OutStats)
+			{
+				++OutStats->NumSweepTraces;
+				++OutStats->NumQueryParamBuilds;
+			}
+
 			// If the trace with sweep radius enabled hit a pawn, check if we should use its hit results
 			const int32 FirstPawnIdx = FindFirstPawnHitResult(SweepHits);
 			if (SweepHits.IsValidIndex(FirstPawnIdx))
@@ -255,6 +400,36 @@ FHitResult UHaroGameplayAbility_HitscanWeapon::DoSingleBulletTrace(const FVector
 
 void UHaroGameplayAbility_HitscanWeapon::TraceBulletsInCartridge(const FHitscanWeaponFiringInput& InputData, OUT TArray<FHitResult>& OutHits)
 {
+	FHaroCartridgeTraceStats Stats;
+
+	CartridgePelletIndices.Reset();
+
+	const double StartTime = FPlatformTime::Seconds();
+	if (HaroConsoleVariables::bUseBatchedCartridgeTrace)
+	{
+		TraceBulletsInCartridge_Batched(InputData, /*out*/ OutHits, /*out*/ Stats);
+	}
+	else
+	{
+		TraceBulletsInCartridge_PerPellet(InputData, /*out*/ OutHits, /*out*/ Stats);
+	}
+	Stats.TraceTimeSeconds = FPlatformTime::Seconds() - StartTime;
+
+	LastCartridgeTraceStats = Stats;
+
+	UE_CLOG(HaroConsoleVariables::bLogCartridgeTraceStats, LogLyraAbilitySystem, Log, TEXT("Cartridge trace (%s): Pellets=%d LineTraces=%d SweepTraces=%d QueryParamBuilds=%d Time=%.3fms"),
+		Stats.bBatched ? TEXT("batched") : TEXT("per-pellet"),
+		Stats.NumPellets,
+		Stats.NumLineTraces,
+		Stats.NumSweepTraces,
+		Stats.NumQueryParamBuilds,
+		Stats.TraceTimeSeconds * 1000.0);
+}
+
+void UHaroGameplayAbility_HitscanWeapon::TraceBulletsInCartridge_PerPellet(const FHitscanWeaponFiringInput& InputData, OUT TArray<FHitResult>& OutHits, OUT FHaroCartridgeTraceStats& OutStats)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_HaroHitscan_TraceBulletsInCartridge_PerPellet);
+
 	UHaroRangedWeaponInstance* WeaponData = InputData.WeaponData;
 	check(WeaponData);
 
@@ -262,22 +437,19 @@ void UHaroGameplayAbility_HitscanWeapon::TraceBulletsInCartridge(const FHitscanW
 
 	const int32 BulletsPerCartridge = WeaponData->GetBulletsPerCartridge(InputType);
 
+	OutStats.NumPellets = BulletsPerCartridge;
+	OutStats.bBatched = false;
+
 	for (int32 BulletIndex = 0; BulletIndex < BulletsPerCartridge; ++BulletIndex)
 	{
-		const float BaseSpreadAngle = WeaponData->GetCalculatedSpreadAngle();
-		const float SpreadAngleMultiplier = WeaponData->GetCalculatedSpreadAngleMultiplier();
-		const float ActualSpreadAngle = BaseSpreadAngle * SpreadAngleMultiplier;
-
-		const float HalfSpreadAngleInRadians = FMath::DegreesToRadians(ActualSpreadAngle * 0.5f);
-
-		const FVector BulletDir = VRandConeNormalDistribution_Haro(InputData.AimDir, HalfSpreadAngleInRadians, WeaponData->GetSpreadExponent());
+		const FVector BulletDir = GetPelletDirection(InputData.AimDir, InputData.SpreadHalfAngleRad, WeaponData->GetSpreadExponent(), InputData.CartridgeSeed, BulletIndex);
 
 		const FVector EndTrace = InputData.StartTrace + (BulletDir * WeaponData->GetMaxDamageRange(InputType));
 		FVector HitLocation = EndTrace;
 
 		TArray<FHitResult> AllImpacts;
 
-		FHitResult Impact = DoSingleBulletTrace(InputData.StartTrace, EndTrace, WeaponData->GetBulletTraceSweepRadius(InputType), /*bIsSimulated=*/ false, /*out*/ AllImpacts);
+		FHitResult Impact = DoSingleBulletTrace(InputData.StartTrace, EndTrace, WeaponData->GetBulletTraceSweepRadius(InputType), /*bIsSimulated=*/ false, /*out*/ AllImpacts, &OutStats);
 
 		const AActor* HitActor = Impact.GetActor();
 
@@ -293,6 +465,11 @@ void UHaroGameplayAbility_HitscanWeapon::TraceBulletsInCartridge(const FHitscanW
 			if (AllImpacts.Num() > 0)
 			{
 				OutHits.Append(AllImpacts);
+				CartridgePelletIndices.AddUninitialized(AllImpacts.Num());
+				for (int32 Idx = CartridgePelletIndices.Num() - AllImpacts.Num(); Idx < CartridgePelletIndices.Num(); ++Idx)
+				{
+					CartridgePelletIndices[Idx] = static_cast<uint8>(BulletIndex);
+				}
 			}
 
 			HitLocation = Impact.ImpactPoint;
@@ -309,12 +486,175 @@ void UHaroGameplayAbility_HitscanWeapon::TraceBulletsInCartridge(const FHitscanW
 			}
 
 			OutHits.Add(Impact);
+			CartridgePelletIndices.Add(static_cast<uint8>(BulletIndex));
+		}
+	}
+}
+
+void UHaroGameplayAbility_HitscanWeapon::TraceBulletsInCartridge_Batched(const FHitscanWeaponFiringInput& InputData, OUT TArray<FHitResult>& OutHits, OUT FHaroCartridgeTraceStats& OutStats)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_HaroHitscan_TraceBulletsInCartridge_Batched);
+
+	UHaroRangedWeaponInstance* WeaponData = InputData.WeaponData;
+	check(WeaponData);
+
+	const EHaroFireInputType InputType = GetCurrentFireInputType();
+
+	const int32 BulletsPerCartridge = WeaponData->GetBulletsPerCartridge(InputType);
+	const float MaxDamageRange = WeaponData->GetMaxDamageRange(InputType);
+	const float SweepRadius = WeaponData->GetBulletTraceSweepRadius(InputType);
+
+	const float SpreadExponent = WeaponData->GetSpreadExponent();
+
+	OutStats.NumPellets = BulletsPerCartridge;
+	OutStats.bBatched = true;
+
+	// Build the query params (and the attached actor ignore list) once for the whole cartridge
+	FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(WeaponTrace), /*bTraceComplex=*/ true, /*IgnoreActor=*/ GetAvatarActorFromActorInfo());
+	TraceParams.bReturnPhysicalMaterial = true;
+	AddAdditionalTraceIgnoreActors(TraceParams);
+	const ECollisionChannel TraceChannel = DetermineTraceChannel(TraceParams, /*bIsSimulated=*/ false);
+	OutStats.NumQueryParamBuilds = 1;
+
+	// Generate every pellet ray up front
+	CartridgeScratchTraceEnds.Reset(BulletsPerCartridge);
+	for (int32 BulletIndex = 0; BulletIndex < BulletsPerCartridge; ++BulletIndex)
+	{
+		const FVector BulletDir = GetPelletDirection(InputData.AimDir, InputData.SpreadHalfAngleRad, SpreadExponent, InputData.CartridgeSeed, BulletIndex);
+		CartridgeScratchTraceEnds.Add(InputData.StartTrace + (BulletDir * MaxDamageRange));
+	}
+
+	// Inner arrays keep their allocations between cartridges
+	if (CartridgeScratchPelletHits.Num() < BulletsPerCartridge)
+	{
+		CartridgeScratchPelletHits.SetNum(BulletsPerCartridge);
+	}
+
+	TArray<FHitResult, TInlineAllocator<16>> PelletImpacts;
+	PelletImpacts.SetNum(BulletsPerCartridge);
+
+	// Line trace every pellet, remembering which ones missed every pawn
+	CartridgeScratchMissedPellets.Reset();
+	for (int32 BulletIndex = 0; BulletIndex < BulletsPerCartridge; ++BulletIndex)
+	{
+		const FVector& EndTrace = CartridgeScratchTraceEnds[BulletIndex];
+
+#if ENABLE_DRAW_DEBUG
+		if (HaroConsoleVariables::DrawBulletTracesDuration > 0.0f)
+		{
+			static float DebugThickness = 1.0f;
+			DrawDebugLine(GetWorld(), InputData.StartTrace, EndTrace, FColor::Red, false, HaroConsoleVariables::DrawBulletTracesDuration, 0, DebugThickness);
+		}
+#endif // ENABLE_DRAW_DEBUG
+
+		TArray<FHitResult>& PelletHits = CartridgeScratchPelletHits[BulletIndex];
+		PelletHits.Reset();
+
+		PelletImpacts[BulletIndex] = WeaponTraceWithParams(InputData.StartTrace, EndTrace, /*SweepRadius=*/ 0.0f, TraceParams, TraceChannel, CartridgeScratchTraceHits, /*out*/ PelletHits);
+		++OutStats.NumLineTraces;
+
+		if (FindFirstPawnHitResult(PelletHits) == INDEX_NONE)
+		{
+			CartridgeScratchMissedPellets.Add(BulletIndex);
+		}
+	}
+
+	// Sweep fallback, only for the pellets that missed
+	if (SweepRadius > 0.0f)
+	{
+		for (const int32 BulletIndex : CartridgeScratchMissedPellets)
+		{
+			TArray<FHitResult>& PelletHits = CartridgeScratchPelletHits[BulletIndex];
+
+			CartridgeScratchSweepHits.Reset();
+			PelletImpacts[BulletIndex] = WeaponTraceWithParams(InputData.StartTrace, CartridgeScratchTraceEnds[BulletIndex], SweepRadius, TraceParams, TraceChannel, CartridgeScratchTraceHits, /*out*/ CartridgeScratchSweepHits);
+			++OutStats.NumSweepTraces;
+
+			// Same rules as DoSingleBulletTrace: only use the sweep hits if the pawn wasn't behind something the line trace blocked on
+			const int32 FirstPawnIdx = FindFirstPawnHitResult(CartridgeScratchSweepHits);
+			if (CartridgeScratchSweepHits.IsValidIndex(FirstPawnIdx))
+			{
+				bool bUseSweepHits = true;
+				for (int32 Idx = 0; Idx < FirstPawnIdx; ++Idx)
+				{
+					const FHitResult& CurHitResult = CartridgeScratchSweepHits[Idx];
+
+					auto Pred = [&CurHitResult](const FHitResult& Other)
+						{
+							return Other.HitObjectHandle == CurHitResult.HitObjectHandle;
+						};
+					if (CurHitResult.bBlockingHit && PelletHits.ContainsByPredicate(Pred))
+					{
+						bUseSweepHits = false;
+						break;
+					}
+				}
+
+				if (bUseSweepHits)
+				{
+					PelletHits = CartridgeScratchSweepHits;
+				}
+			}
+		}
+	}
+
+	// Gather the results in pellet order, exactly like the per-pellet path does
+	for (int32 BulletIndex = 0; BulletIndex < BulletsPerCartridge; ++BulletIndex)
+	{
+		FHitResult& Impact = PelletImpacts[BulletIndex];
+		const TArray<FHitResult>& PelletHits = CartridgeScratchPelletHits[BulletIndex];
+
+		if (Impact.GetActor())
+		{
+#if ENABLE_DRAW_DEBUG
+			if (HaroConsoleVariables::DrawBulletHitDuration > 0.0f)
+			{
+				DrawDebugPoint(GetWorld(), Impact.ImpactPoint, HaroConsoleVariables::DrawBulletHitRadius, FColor::Red, false, HaroConsoleVariables::DrawBulletHitRadius);
+			}
+#endif
+
+			OutHits.Append(PelletHits);
+			CartridgePelletIndices.AddUninitialized(PelletHits.Num());
+			for (int32 Idx = CartridgePelletIndices.Num() - PelletHits.Num(); Idx < CartridgePelletIndices.Num(); ++Idx)
+			{
+				CartridgePelletIndices[Idx] = static_cast<uint8>(BulletIndex);
+			}
+		}
+
+		// Make sure there's always an entry in OutHits so the direction can be used for tracers, etc...
+		if (OutHits.Num() == 0)
+		{
+			if (!Impact.bBlockingHit)
+			{
+				// Locate the fake 'impact' at the end of the trace
+				Impact.Location = CartridgeScratchTraceEnds[BulletIndex];
+				Impact.ImpactPoint = CartridgeScratchTraceEnds[BulletIndex];
+			}
+
+			OutHits.Add(Impact);
+			CartridgePelletIndices.Add(static_cast<uint8>(BulletIndex));
 		}
 	}
 }
 
 void UHaroGameplayAbility_HitscanWeapon::ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData)
 {
+	const bool bSustainedFireActivation = IsSustainedFireEnabled();
+	HaroHitscanFireStats::FScopedCpuTimer CpuTimer(bSustainedFireActivation);
+
+	FHaroHitscanFireStats& FireStats = GetFireStats(bSustainedFireActivation);
+	++FireStats.NumActivations;
+	if (HaroHitscanFireStats::IsPredictingClient(ActorInfo, this))
+	{
+		// ServerTryActivateAbility
+		++FireStats.NumAbilityRPCs;
+	}
+
+	// Every activation starts a new run of shot indices (they're mixed into the cartridge seeds)
+	NextSustainedShotIndex = 0;
+	bSustainedFireCommitted = false;
+	SustainedFireStartTime = GetWorld()->GetTimeSeconds();
+
 	// Bind target data callback
 	UAbilitySystemComponent* MyAbilityComponent = CurrentActorInfo->AbilitySystemComponent.Get();
 	check(MyAbilityComponent);
@@ -339,6 +679,34 @@ void UHaroGameplayAbility_HitscanWeapon::EndAbility(const FGameplayAbilitySpecHa
 			return;
 		}
 
+		const bool bSustainedFireActivation = IsSustainedFireEnabled();
+		HaroHitscanFireStats::FScopedCpuTimer CpuTimer(bSustainedFireActivation);
+
+		if (bReplicateEndAbility && HaroHitscanFireStats::IsPredictingClient(ActorInfo, this))
+		{
+			// ServerEndAbility
+			++GetFireStats(bSustainedFireActivation).NumAbilityRPCs;
+		}
+
+		// Shots still queued were already predicted locally, so the server has to hear about them before the end
+		if (PendingSustainedTargetData.Num() > 0)
+		{
+			FlushSustainedFireBatch();
+		}
+		PendingSustainedHits.Reset();
+
+		if (UWorld* World = GetWorld())
+		{
+			World->GetTimerManager().ClearTimer(SustainedFireTimerHandle);
+			World->GetTimerManager().ClearTimer(SustainedFireFlushTimerHandle);
+		}
+
+		if (SustainedFireReleaseTask)
+		{
+			SustainedFireReleaseTask->EndTask();
+			SustainedFireReleaseTask = nullptr;
+		}
+
 		UAbilitySystemComponent* MyAbilityComponent = CurrentActorInfo->AbilitySystemComponent.Get();
 		check(MyAbilityComponent);
 
@@ -352,6 +720,14 @@ void UHaroGameplayAbility_HitscanWeapon::EndAbility(const FGameplayAbilitySpecHa
 
 void UHaroGameplayAbility_HitscanWeapon::OnTargetDataReadyCallback(const FGameplayAbilityTargetDataHandle& InData, FGameplayTag ApplicationTag)
 {
+	// Sustained fire weapons are always processed per batch on the authority, whether the client batched its shots or not
+	if (IsSustainedFireEnabled() && CurrentActorInfo->IsNetAuthority())
+	{
+		FGameplayAbilityTargetDataHandle LocalTargetDataHandle(MoveTemp(const_cast<FGameplayAbilityTargetDataHandle&>(InData)));
+		ProcessSustainedTargetData(LocalTargetDataHandle);
+		return;
+	}
+
 	UAbilitySystemComponent* MyAbilityComponent = CurrentActorInfo->AbilitySystemComponent.Get();
 	check(MyAbilityComponent);
 
@@ -366,9 +742,25 @@ void UHaroGameplayAbility_HitscanWeapon::OnTargetDataReadyCallback(const FGamepl
 		if (bShouldNotifyServer)
 		{
 			MyAbilityComponent->CallServerSetReplicatedTargetData(CurrentSpecHandle, CurrentActivationInfo.GetActivationPredictionKey(), LocalTargetDataHandle, ApplicationTag, MyAbilityComponent->ScopedPredictionKey);
+			++GetFireStats(/*bSustainedFire=*/ false).NumTargetDataRPCs;
 		}
 
-		const bool bIsTargetDataValid = true;
+		// Unpack the compact cartridge into one SingleTargetHit per pellet hit for the lag compensation, damage and Blueprint paths
+		FHaroHitscanFireInfo FireInfo;
+		const bool bHasFireInfo = FHaroGameplayAbilityTargetData_HitscanCartridge::ExpandHandle(LocalTargetDataHandle, /*out*/ FireInfo, ExpandedHitPool);
+
+		bool bIsTargetDataValid = true;
+
+		// Indices of hits the server refused after rewinding (treated like replaced hits by the hit markers)
+		TArray<uint8> RejectedHits;
+
+#if WITH_SERVER_CODE
+		const bool bShouldValidateOnServer = CurrentActorInfo->IsNetAuthority() && !CurrentActorInfo->IsLocallyControlled();
+		if (bShouldValidateOnServer)
+		{
+			bIsTargetDataValid = ValidateTargetDataOnServer(LocalTargetDataHandle, bHasFireInfo ? &FireInfo : nullptr, /*out*/ RejectedHits);
+		}
+#endif //WITH_SERVER_CODE
 
 		bool bProjectileWeapon = false;
 
@@ -387,7 +779,7 @@ void UHaroGameplayAbility_HitscanWeapon::OnTargetDataReadyCallback(const FGamepl
 						{
 							if (FGameplayAbilityTargetData_SingleTargetHit* SingleTargetHit = static_cast<FGameplayAbilityTargetData_SingleTargetHit*>(LocalTargetDataHandle.Get(i)))
 							{
-								if (SingleTargetHit->bHitReplaced)
+								if (SingleTargetHit->bHitReplaced || RejectedHits.Contains(i))
 								{
 									HitReplaces.Add(i);
 								}
@@ -403,7 +795,27 @@ void UHaroGameplayAbility_HitscanWeapon::OnTargetDataReadyCallback(const FGamepl
 #endif //WITH_SERVER_CODE
 
 
+		// Don't let rejected hits reach the blueprint (and therefore apply damage)
+		if (bIsTargetDataValid && (RejectedHits.Num() > 0))
+		{
+			FGameplayAbilityTargetDataHandle AcceptedTargetData;
+			AcceptedTargetData.UniqueId = LocalTargetDataHandle.UniqueId;
+			for (int32 Idx = 0; Idx < LocalTargetDataHandle.Data.Num(); ++Idx)
+			{
+				if (!RejectedHits.Contains(Idx))
+				{
+					AcceptedTargetData.Data.Add(LocalTargetDataHandle.Data[Idx]);
+				}
+			}
+			LocalTargetDataHandle = MoveTemp(AcceptedTargetData);
+		}
+
 		// See if we still have ammo
+		if (bIsTargetDataValid)
+		{
+			++GetFireStats(/*bSustainedFire=*/ false).NumCommits;
+		}
+
 		if (bIsTargetDataValid && CommitAbility(CurrentSpecHandle, CurrentActorInfo, CurrentActivationInfo))
 		{
 			// We fired the weapon, add spread
@@ -425,10 +837,174 @@ void UHaroGameplayAbility_HitscanWeapon::OnTargetDataReadyCallback(const FGamepl
 	MyAbilityComponent->ConsumeClientReplicatedTargetData(CurrentSpecHandle, CurrentActivationInfo.GetActivationPredictionKey());
 }
 
+bool UHaroGameplayAbility_HitscanWeapon::ValidateTargetDataOnServer(const FGameplayAbilityTargetDataHandle& TargetData, const FHaroHitscanFireInfo* FireInfo, OUT TArray<uint8>& OutRejectedHits) const
+{
+	if (HaroConsoleVariables::bValidateSpread)
+	{
+		ValidateSpreadOnServer(TargetData, FireInfo, /*out*/ OutRejectedHits);
+	}
+
+	const UHaroLagCompensationSubsystem* LagCompensation = UWorld::GetSubsystem<UHaroLagCompensationSubsystem>(GetWorld());
+
+	const APawn* Shooter = Cast<APawn>(GetAvatarActorFromActorInfo());
+
+	for (int32 Idx = 0; (LagCompensation != nullptr) && (Idx < TargetData.Num()) && (Idx < 255); ++Idx)
+	{
+		const FGameplayAbilityTargetData* Data = TargetData.Get(Idx);
+		if ((Data == nullptr) || (Data->GetScriptStruct() != FLyraGameplayAbilityTargetData_SingleTargetHit::StaticStruct()))
+		{
+			continue;
+		}
+
+		if (OutRejectedHits.Contains(static_cast<uint8>(Idx)))
+		{
+			continue;
+		}
+
+		const FLyraGameplayAbilityTargetData_SingleTargetHit* SingleTargetHit = static_cast<const FLyraGameplayAbilityTargetData_SingleTargetHit*>(Data);
+		const FHitResult& HitResult = SingleTargetHit->HitResult;
+
+		const EHaroHitValidationResult Result = LagCompensation->ValidateHit(HitResult.GetActor(), HitResult.ImpactPoint, SingleTargetHit->Timestamp, Shooter);
+		if (!UHaroLagCompensationSubsystem::IsAccepted(Result))
+		{
+			UE_LOG(LogLyraAbilitySystem, Verbose, TEXT("Weapon ability %s rejected hit %d on %s (reason=%d)"),
+				*GetPathName(), Idx, *GetNameSafe(HitResult.GetActor()), static_cast<int32>(Result));
+
+			OutRejectedHits.Add(static_cast<uint8>(Idx));
+		}
+	}
+
+	// The shot itself is valid as long as at least one of its hits survived
+	return (TargetData.Num() == 0) || (OutRejectedHits.Num() < TargetData.Num());
+}
+
+void UHaroGameplayAbility_HitscanWeapon::ValidateSpreadOnServer(const FGameplayAbilityTargetDataHandle& TargetData, const FHaroHitscanFireInfo* FireInfo, OUT TArray<uint8>& OutRejectedHits) const
+{
+	const UHaroRangedWeaponInstance* WeaponData = GetWeaponInstance();
+	if ((WeaponData == nullptr) || (TargetData.Num() == 0))
+	{
+		return;
+	}
+
+	auto RejectAll = [&TargetData, &OutRejectedHits]()
+	{
+		for (int32 Idx = 0; (Idx < TargetData.Num()) && (Idx < 255); ++Idx)
+		{
+			OutRejectedHits.AddUnique(static_cast<uint8>(Idx));
+		}
+	};
+
+	// Our client always sends its hits as a cartridge with fire info, and the seed has to match the one we derive from the same prediction key
+	// (and shot index; only sustained fire may use anything but the first one, otherwise the client could pick its seed)
+	if ((FireInfo == nullptr) || (!IsSustainedFireEnabled() && (FireInfo->ShotIndex != 0)) || (FireInfo->CartridgeSeed != MakeCartridgeSeed(FireInfo->ShotIndex)))
+	{
+		UE_LOG(LogLyraAbilitySystem, Verbose, TEXT("Weapon ability %s rejected cartridge (missing fire info or seed mismatch)"), *GetPathName());
+		RejectAll();
+		return;
+	}
+
+	// The client can't claim to be more accurate than the server thinks it is (heat and movement multipliers are simulated on both sides)
+	if (!WeaponData->AllowsFirstShotAccuracy())
+	{
+		const float ServerHalfAngleDegrees = WeaponData->GetCalculatedSpreadAngle() * WeaponData->GetCalculatedSpreadAngleMultiplier() * 0.5f;
+		if (FireInfo->SpreadHalfAngleDegrees < (ServerHalfAngleDegrees * HaroConsoleVariables::SpreadValidationMinScale))
+		{
+			UE_LOG(LogLyraAbilitySystem, Verbose, TEXT("Weapon ability %s rejected cartridge (spread %.2f below server %.2f)"),
+				*GetPathName(), FireInfo->SpreadHalfAngleDegrees, ServerHalfAngleDegrees);
+			RejectAll();
+			return;
+		}
+	}
+
+	const EHaroFireInputType InputType = GetCurrentFireInputType();
+	const int32 NumPellets = FMath::Min<int32>(FireInfo->NumPellets, WeaponData->GetBulletsPerCartridge(InputType));
+	const float HalfAngleRad = FMath::DegreesToRadians(FireInfo->SpreadHalfAngleDegrees);
+	const float SpreadExponent = WeaponData->GetSpreadExponent();
+	const float AllowedDistance = WeaponData->GetBulletTraceSweepRadius(InputType) + HaroConsoleVariables::SpreadValidationDistance;
+	const FVector Origin = FireInfo->Origin;
+	const FVector AimDir = FVector(FireInfo->AimDir).GetSafeNormal();
+
+	// A shotgun usually has several hits per pellet, so only regenerate each pellet direction once
+	TArray<FVector, TInlineAllocator<16>> PelletDirs;
+	PelletDirs.SetNumZeroed(NumPellets);
+
+	for (int32 Idx = 0; (Idx < TargetData.Num()) && (Idx < 255); ++Idx)
+	{
+		const FGameplayAbilityTargetData* Data = TargetData.Get(Idx);
+		if ((Data == nullptr) || (Data->GetScriptStruct() != FLyraGameplayAbilityTargetData_SingleTargetHit::StaticStruct()))
+		{
+			continue;
+		}
+
+		const FLyraGameplayAbilityTargetData_SingleTargetHit* SingleTargetHit = static_cast<const FLyraGameplayAbilityTargetData_SingleTargetHit*>(Data);
+		const int32 PelletIndex = SingleTargetHit->PelletIndex;
+		if (PelletIndex >= NumPellets)
+		{
+			OutRejectedHits.AddUnique(static_cast<uint8>(Idx));
+			continue;
+		}
+
+		if (PelletDirs[PelletIndex].IsZero())
+		{
+			PelletDirs[PelletIndex] = GetPelletDirection(AimDir, HalfAngleRad, SpreadExponent, FireInfo->CartridgeSeed, PelletIndex);
+		}
+
+		// Distance from the impact point to the regenerated pellet ray
+		const FVector ToImpact = SingleTargetHit->HitResult.ImpactPoint - Origin;
+		const float AlongRay = FVector::DotProduct(ToImpact, PelletDirs[PelletIndex]);
+		const float OffRaySquared = (ToImpact - (PelletDirs[PelletIndex] * AlongRay)).SizeSquared();
+
+		if ((AlongRay < -AllowedDistance) || (OffRaySquared > FMath::Square(AllowedDistance)))
+		{
+			UE_LOG(LogLyraAbilitySystem, Verbose, TEXT("Weapon ability %s rejected hit %d (%.1f uu off pellet %d)"),
+				*GetPathName(), Idx, FMath::Sqrt(OffRaySquared), PelletIndex);
+
+			OutRejectedHits.AddUnique(static_cast<uint8>(Idx));
+		}
+	}
+}
+
+FHaroGameplayAbilityTargetData_HitscanCartridge* UHaroGameplayAbility_HitscanWeapon::MakeCartridgeTargetData(const FHitscanWeaponFiringInput& FiringInput, const TArray<FHitResult>& FoundHits, uint16 ShotIndex) const
+{
+	// The whole cartridge goes out as one compact target data entry instead of one full FHitResult per pellet
+	FHaroGameplayAbilityTargetData_HitscanCartridge* Cartridge = new FHaroGameplayAbilityTargetData_HitscanCartridge();
+	Cartridge->FireInfo.Origin = FiringInput.StartTrace;
+	Cartridge->FireInfo.AimDir = FiringInput.AimDir;
+	Cartridge->FireInfo.SpreadHalfAngleDegrees = FMath::RadiansToDegrees(FiringInput.SpreadHalfAngleRad);
+	Cartridge->FireInfo.CartridgeSeed = FiringInput.CartridgeSeed;
+	Cartridge->FireInfo.NumPellets = static_cast<uint8>(FMath::Min(FiringInput.WeaponData->GetBulletsPerCartridge(GetCurrentFireInputType()), 255));
+	Cartridge->FireInfo.ShotIndex = ShotIndex;
+
+	// Stamp hits with the server's clock so the server can rewind to the moment we fired
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	Cartridge->Timestamp = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
+	Cartridge->Hits.Reserve(FoundHits.Num());
+	for (int32 HitIdx = 0; HitIdx < FoundHits.Num(); ++HitIdx)
+	{
+		Cartridge->AddHit(FoundHits[HitIdx], CartridgePelletIndices.IsValidIndex(HitIdx) ? CartridgePelletIndices[HitIdx] : 0);
+	}
+
+	return Cartridge;
+}
+
 void UHaroGameplayAbility_HitscanWeapon::StartHitscanWeaponTargeting()
 {
 	check(CurrentActorInfo);
 
+	if (IsSustainedFireEnabled())
+	{
+		// One activation covers the whole hold, the shots are fired by the cadence timer
+		if (CurrentActorInfo->IsLocallyControlled())
+		{
+			StartSustainedFire();
+		}
+		return;
+	}
+
+	HaroHitscanFireStats::FScopedCpuTimer CpuTimer(/*bSustainedFire=*/ false);
+	++GetFireStats(/*bSustainedFire=*/ false).NumShots;
+
 	AActor* AvatarActor = CurrentActorInfo->AvatarActor.Get();
 	check(AvatarActor);
 
@@ -442,27 +1018,19 @@ void UHaroGameplayAbility_HitscanWeapon::StartHitscanWeaponTargeting()
 	FScopedPredictionWindow ScopedPrediction(MyAbilityComponent, CurrentActivationInfo.GetActivationPredictionKey());
 
 	TArray<FHitResult> FoundHits;
-	PerformLocalTargeting(/*out*/ FoundHits);
+	FHitscanWeaponFiringInput FiringInput;
+	PerformLocalTargeting(/*out*/ FoundHits, /*out*/ &FiringInput);
 
 	// Fill out the target data from the hit results
 	FGameplayAbilityTargetDataHandle TargetData;
-	TargetData.UniqueId = WeaponStateComponent ? WeaponStateComponent->GetUnconfirmedServerSideHitMarkerCount() : 0;
+	TargetData.UniqueId = WeaponStateComponent ? WeaponStateComponent->GetNextServerSideHitMarkerId() : 0;
 
 	if (FoundHits.Num() > 0)
 	{
-		const int32 CartridgeID = FMath::Rand();
-
-		for (const FHitResult& FoundHit : FoundHits)
-		{
-			FLyraGameplayAbilityTargetData_SingleTargetHit* NewTargetData = new FLyraGameplayAbilityTargetData_SingleTargetHit();
-			NewTargetData->HitResult = FoundHit;
-			NewTargetData->CartridgeID = CartridgeID;
-
-			TargetData.Add(NewTargetData);
-		}
+		TargetData.Add(MakeCartridgeTargetData(FiringInput, FoundHits, /*ShotIndex=*/ 0));
 	}
 
-	// Send hit marker information
+	// Send hit marker information (markers are matched by UniqueId and hit order, which the cartridge expansion preserves)
 	const bool bProjectileWeapon = false;
 	if (!bProjectileWeapon && (WeaponStateComponent != nullptr))
 	{
@@ -473,4 +1041,433 @@ void UHaroGameplayAbility_HitscanWeapon::StartHitscanWeaponTargeting()
 	OnTargetDataReadyCallback(TargetData, FGameplayTag());
 }
 
+//////////////////////////////////////////////////////////////////////
+// Sustained fire
+
+bool UHaroGameplayAbility_HitscanWeapon::IsSustainedFireEnabled() const
+{
+	return bSustainedFire && HaroConsoleVariables::bEnableSustainedFire;
+}
+
+float UHaroGameplayAbility_HitscanWeapon::GetSustainedFireInterval() const
+{
+	return 60.0f / FMath::Max(ShotsPerMinute, 1.0f);
+}
+
+void UHaroGameplayAbility_HitscanWeapon::StartSustainedFire()
+{
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+
+	// The blueprint may ask for targeting again while we're already firing
+	if (TimerManager.IsTimerActive(SustainedFireTimerHandle))
+	{
+		return;
+	}
+
+	TimerManager.SetTimer(SustainedFireTimerHandle, this, &ThisClass::FireSustainedShot, GetSustainedFireInterval(), /*bLoop=*/ true);
+
+	// The first shot goes out right away so a tap still fires once
+	FireSustainedShot();
+
+	// A hold ends on release, a fixed burst keeps going until its last shot
+	if (IsActive() && (MaxShotsPerActivation <= 0))
+	{
+		SustainedFireReleaseTask = UAbilityTask_WaitInputRelease::WaitInputRelease(this, /*bTestAlreadyReleased=*/ true);
+		if (SustainedFireReleaseTask)
+		{
+			SustainedFireReleaseTask->OnRelease.AddDynamic(this, &ThisClass::OnSustainedFireInputReleased);
+			SustainedFireReleaseTask->ReadyForActivation();
+		}
+	}
+}
+
+void UHaroGameplayAbility_HitscanWeapon::StopSustainedFire()
+{
+	GetWorld()->GetTimerManager().ClearTimer(SustainedFireTimerHandle);
+
+	// EndAbility sends whatever is still queued
+	if (IsActive())
+	{
+		K2_EndAbility();
+	}
+}
+
+void UHaroGameplayAbility_HitscanWeapon::OnSustainedFireInputReleased(float TimeHeld)
+{
+	StopSustainedFire();
+}
+
+void UHaroGameplayAbility_HitscanWeapon::FireSustainedShot()
+{
+	HaroHitscanFireStats::FScopedCpuTimer CpuTimer(/*bSustainedFire=*/ true);
+
+	if (!IsActive() || (CurrentActorInfo == nullptr))
+	{
+		return;
+	}
+
+	UAbilitySystemComponent* MyAbilityComponent = CurrentActorInfo->AbilitySystemComponent.Get();
+	check(MyAbilityComponent);
+
+	UHaroRangedWeaponInstance* WeaponData = GetWeaponInstance();
+	check(WeaponData);
+
+	// Stop once the burst is done, or once this shot plus the ones the server hasn't charged for yet (queued, or sent
+	// and not acknowledged) would use up all the ammo we know about
+	const int32 NumUnchargedShots = PendingSustainedTargetData.Num() + NumUnacknowledgedSustainedShots;
+	const bool bBurstDone = (MaxShotsPerActivation > 0) && (NextSustainedShotIndex >= MaxShotsPerActivation);
+	if (bBurstDone || (NextSustainedShotIndex == MAX_uint16) || !CheckCostMultiple(CurrentSpecHandle, CurrentActorInfo, NumUnchargedShots + 1))
+	{
+		StopSustainedFire();
+		return;
+	}
+
+	const uint16 ShotIndex = NextSustainedShotIndex++;
+
+	// Each locally predicted shot gets its own client prediction window (does nothing on the authority)
+	FScopedPredictionWindow ScopedPrediction(MyAbilityComponent);
+
+	TArray<FHitResult> FoundHits;
+	FHitscanWeaponFiringInput FiringInput;
+	PerformLocalTargeting(/*out*/ FoundHits, /*out*/ &FiringInput, ShotIndex);
+	if (FiringInput.WeaponData == nullptr)
+	{
+		StopSustainedFire();
+		return;
+	}
+
+	++GetFireStats(/*bSustainedFire=*/ true).NumShots;
+	WeaponData->UpdateFiringTime();
+
+	// Misses are sent too, the server needs every shot to check the fire rate and to pay for it
+	const TSharedPtr<FGameplayAbilityTargetData> Cartridge(MakeCartridgeTargetData(FiringInput, FoundHits, ShotIndex));
+
+	AController* Controller = GetControllerFromActorInfo();
+	UHaroWeaponStateComponent* WeaponStateComponent = Controller ? Controller->FindComponentByClass<UHaroWeaponStateComponent>() : nullptr;
+
+	if (CurrentActorInfo->IsNetAuthority())
+	{
+		// Nothing to send, process the shot right away
+		FGameplayAbilityTargetDataHandle TargetData;
+		TargetData.UniqueId = WeaponStateComponent ? WeaponStateComponent->GetNextServerSideHitMarkerId() : 0;
+		TargetData.Data.Add(Cartridge);
+
+		if (WeaponStateComponent != nullptr)
+		{
+			WeaponStateComponent->AddUnconfirmedServerSideHitMarkers(TargetData, FoundHits);
+		}
+
+		ProcessSustainedTargetData(TargetData);
+		return;
+	}
+
+	// Predict the shot locally right away (spread, blueprint effects); the server sees it with the next batch
+	FGameplayAbilityTargetDataHandle ShotTargetData;
+	ShotTargetData.Data.Add(Cartridge);
+
+	FHaroHitscanFireInfo FireInfo;
+	FHaroGameplayAbilityTargetData_HitscanCartridge::ExpandHandle(ShotTargetData, /*out*/ FireInfo, ExpandedHitPool);
+
+	WeaponData->AddSpread();
+	OnHitscanWeaponTargetDataReady(ShotTargetData);
+
+	PendingSustainedTargetData.Data.Add(Cartridge);
+	PendingSustainedHits.Append(FoundHits);
+
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	if ((HaroConsoleVariables::SustainedFireBatchInterval <= 0.0f) || (PendingSustainedTargetData.Num() >= HaroConsoleVariables::SustainedFireMaxBatchShots))
+	{
+		if (!FlushSustainedFireBatch())
+		{
+			StopSustainedFire();
+		}
+	}
+	else if (!TimerManager.IsTimerActive(SustainedFireFlushTimerHandle))
+	{
+		TimerManager.SetTimer(SustainedFireFlushTimerHandle, this, &ThisClass::OnSustainedFireFlushTimer, HaroConsoleVariables::SustainedFireBatchInterval, /*bLoop=*/ false);
+	}
+}
+
+void UHaroGameplayAbility_HitscanWeapon::OnSustainedFireFlushTimer()
+{
+	HaroHitscanFireStats::FScopedCpuTimer CpuTimer(/*bSustainedFire=*/ true);
+
+	if (!FlushSustainedFireBatch())
+	{
+		StopSustainedFire();
+	}
+}
+
+bool UHaroGameplayAbility_HitscanWeapon::FlushSustainedFireBatch()
+{
+	GetWorld()->GetTimerManager().ClearTimer(SustainedFireFlushTimerHandle);
+
+	if ((PendingSustainedTargetData.Num() == 0) || (CurrentActorInfo == nullptr))
+	{
+		return true;
+	}
+
+	UAbilitySystemComponent* MyAbilityComponent = CurrentActorInfo->AbilitySystemComponent.Get();
+	check(MyAbilityComponent);
+
+	FGameplayAbilityTargetDataHandle TargetData;
+	Swap(TargetData.Data, PendingSustainedTargetData.Data);
+	const TArray<FHitResult> FoundHits = MoveTemp(PendingSustainedHits);
+	PendingSustainedHits.Reset();
+
+	const int32 NumShots = TargetData.Num();
+
+	// One hit marker batch per RPC, the server confirms the whole batch by UniqueId with hit indices across every cartridge in it
+	AController* Controller = GetControllerFromActorInfo();
+	UHaroWeaponStateComponent* WeaponStateComponent = Controller ? Controller->FindComponentByClass<UHaroWeaponStateComponent>() : nullptr;
+	TargetData.UniqueId = WeaponStateComponent ? WeaponStateComponent->GetNextServerSideHitMarkerId() : 0;
+
+	if (WeaponStateComponent != nullptr)
+	{
+		WeaponStateComponent->AddUnconfirmedServerSideHitMarkers(TargetData, FoundHits);
+	}
+
+	FScopedPredictionWindow ScopedPrediction(MyAbilityComponent);
+
+	MyAbilityComponent->CallServerSetReplicatedTargetData(CurrentSpecHandle, CurrentActivationInfo.GetActivationPredictionKey(), TargetData, FGameplayTag(), MyAbilityComponent->ScopedPredictionKey);
+	++GetFireStats(/*bSustainedFire=*/ true).NumTargetDataRPCs;
+
+	const int32 NumPaidShots = CommitSustainedShots(NumShots);
+
+	// Ammo is only removed on the authority, so count these shots as spent until the server has processed the batch
+	if (MyAbilityComponent->ScopedPredictionKey.IsLocalClientKey())
+	{
+		NumUnacknowledgedSustainedShots += NumShots;
+		MyAbilityComponent->ScopedPredictionKey.NewRejectOrCaughtUpDelegate(FPredictionKeyEvent::CreateUObject(this, &ThisClass::OnSustainedFireBatchAcknowledged, NumShots));
+	}
+
+	if (NumPaidShots < NumShots)
+	{
+		UE_LOG(LogLyraAbilitySystem, Warning, TEXT("Weapon ability %s could only pay for %d of %d sustained fire shots"), *GetPathName(), NumPaidShots, NumShots);
+		return false;
+	}
+
+	return true;
+}
+
+void UHaroGameplayAbility_HitscanWeapon::ProcessSustainedTargetData(FGameplayAbilityTargetDataHandle& TargetData)
+{
+	UAbilitySystemComponent* MyAbilityComponent = CurrentActorInfo->AbilitySystemComponent.Get();
+	check(MyAbilityComponent);
+
+	if (const FGameplayAbilitySpec* AbilitySpec = MyAbilityComponent->FindAbilitySpecFromHandle(CurrentSpecHandle))
+	{
+		FScopedPredictionWindow ScopedPrediction(MyAbilityComponent);
+
+		UHaroRangedWeaponInstance* WeaponData = GetWeaponInstance();
+		check(WeaponData);
+
+		const bool bShouldValidateOnServer = !CurrentActorInfo->IsLocallyControlled();
+		const double ElapsedTime = GetWorld()->GetTimeSeconds() - SustainedFireStartTime;
+		const float ShotInterval = GetSustainedFireInterval();
+
+		FGameplayAbilityTargetDataHandle AcceptedTargetData;
+		AcceptedTargetData.UniqueId = TargetData.UniqueId;
+
+		// Hit marker indices run across the whole batch, in the order the client expanded its cartridges
+		TArray<uint8> HitReplaces;
+		int32 BatchHitIndex = 0;
+
+		// Where each accepted shot's hits end in AcceptedTargetData, so shots we can't pay for can be dropped after the commit
+		TArray<int32, TInlineAllocator<8>> AcceptedShotEnds;
+
+		for (const TSharedPtr<FGameplayAbilityTargetData>& Data : TargetData.Data)
+		{
+			if (!Data.IsValid() || (Data->GetScriptStruct() != FHaroGameplayAbilityTargetData_HitscanCartridge::StaticStruct()))
+			{
+				continue;
+			}
+
+			// Each cartridge is one shot with its own seed, validate them one at a time
+			FGameplayAbilityTargetDataHandle ShotTargetData;
+			ShotTargetData.Data.Add(Data);
+
+			FHaroHitscanFireInfo FireInfo;
+			FHaroGameplayAbilityTargetData_HitscanCartridge::ExpandHandle(ShotTargetData, /*out*/ FireInfo, ExpandedHitPool);
+
+			bool bIsShotValid = true;
+			TArray<uint8> RejectedHits;
+
+#if WITH_SERVER_CODE
+			if (bShouldValidateOnServer)
+			{
+				// Shot indices only ever move forward, so a client can't resend an index to pick a more favourable spread seed
+				if (FireInfo.ShotIndex < NextSustainedShotIndex)
+				{
+					UE_LOG(LogLyraAbilitySystem, Verbose, TEXT("Weapon ability %s rejected sustained fire shot %d (already past %d)"),
+						*GetPathName(), FireInfo.ShotIndex, NextSustainedShotIndex);
+
+					bIsShotValid = false;
+				}
+				else
+				{
+					// Whatever happens to this shot, it is used up; a rejected shot must not stall the rest of the batch
+					NextSustainedShotIndex = FireInfo.ShotIndex + 1;
+
+					const bool bWithinFireRate = ((MaxShotsPerActivation <= 0) || (FireInfo.ShotIndex < MaxShotsPerActivation))
+						&& ((FireInfo.ShotIndex * ShotInterval) <= (ElapsedTime + HaroConsoleVariables::SustainedFireRateTolerance));
+
+					if (bWithinFireRate)
+					{
+						bIsShotValid = ValidateTargetDataOnServer(ShotTargetData, &FireInfo, /*out*/ RejectedHits);
+					}
+					else
+					{
+						UE_LOG(LogLyraAbilitySystem, Verbose, TEXT("Weapon ability %s rejected sustained fire shot %d (burst size or fire rate, %.3f s into the activation)"),
+							*GetPathName(), FireInfo.ShotIndex, ElapsedTime);
+
+						bIsShotValid = false;
+					}
+				}
+			}
+#endif //WITH_SERVER_CODE
+
+			for (int32 Idx = 0; Idx < ShotTargetData.Num(); ++Idx, ++BatchHitIndex)
+			{
+				const bool bRejected = !bIsShotValid || RejectedHits.Contains(static_cast<uint8>(Idx));
+				const FGameplayAbilityTargetData_SingleTargetHit* SingleTargetHit = static_cast<const FGameplayAbilityTargetData_SingleTargetHit*>(ShotTargetData.Get(Idx));
+
+				if ((bRejected || (SingleTargetHit && SingleTargetHit->bHitReplaced)) && (BatchHitIndex < 255))
+				{
+					HitReplaces.Add(static_cast<uint8>(BatchHitIndex));
+				}
+
+				if (!bRejected)
+				{
+					AcceptedTargetData.Data.Add(ShotTargetData.Data[Idx]);
+				}
+			}
+
+			if (bIsShotValid)
+			{
+				AcceptedShotEnds.Add(AcceptedTargetData.Data.Num());
+			}
+		}
+
+		const int32 NumShots = AcceptedShotEnds.Num();
+
+#if WITH_SERVER_CODE
+		if (AController* Controller = GetControllerFromActorInfo())
+		{
+			if (Controller->GetLocalRole() == ROLE_Authority)
+			{
+				// Confirm hit markers for the whole batch at once
+				if (UHaroWeaponStateComponent* WeaponStateComponent = Controller->FindComponentByClass<UHaroWeaponStateComponent>())
+				{
+					WeaponStateComponent->ClientConfirmTargetData(TargetData.UniqueId, (NumShots > 0), HitReplaces);
+				}
+			}
+		}
+#endif //WITH_SERVER_CODE
+
+		const int32 NumPaidShots = CommitSustainedShots(NumShots);
+		if (NumPaidShots < NumShots)
+		{
+			// Out of ammo partway through the batch, the unpaid shots don't get to do anything
+			AcceptedTargetData.Data.SetNum((NumPaidShots > 0) ? AcceptedShotEnds[NumPaidShots - 1] : 0);
+		}
+
+		for (int32 ShotIdx = 0; ShotIdx < NumPaidShots; ++ShotIdx)
+		{
+			WeaponData->UpdateFiringTime();
+			WeaponData->AddSpread();
+		}
+
+		if (NumPaidShots > 0)
+		{
+			// Let the blueprint do stuff like apply effects to the targets (once for the whole batch)
+			OnHitscanWeaponTargetDataReady(AcceptedTargetData);
+		}
+
+		if (NumPaidShots < NumShots)
+		{
+			UE_LOG(LogLyraAbilitySystem, Warning, TEXT("Weapon ability %s failed to commit %d of %d sustained fire shots"), *GetPathName(), NumShots - NumPaidShots, NumShots);
+			K2_EndAbility();
+		}
+	}
+
+	// We've processed the data
+	MyAbilityComponent->ConsumeClientReplicatedTargetData(CurrentSpecHandle, CurrentActivationInfo.GetActivationPredictionKey());
+}
+
+int32 UHaroGameplayAbility_HitscanWeapon::CommitSustainedShots(int32 NumShots)
+{
+	if (NumShots <= 0)
+	{
+		return 0;
+	}
+
+	int32 NumPaidShots = 0;
+
+	// The activation's first shot goes through the regular commit (cooldown, commit notifications); the cadence replaces
+	// the cooldown for the rest of the hold, so later batches only pay their cost
+	if (!bSustainedFireCommitted)
+	{
+		if (!CommitAbility(CurrentSpecHandle, CurrentActorInfo, CurrentActivationInfo))
+		{
+			return 0;
+		}
+
+		bSustainedFireCommitted = true;
+		++NumPaidShots;
+	}
+
+	// Everything else in the batch is paid for in one go (on a client, earlier batches the server hasn't charged yet still count)
+	const int32 NumEarlierUnchargedShots = CurrentActorInfo->IsNetAuthority() ? 0 : NumUnacknowledgedSustainedShots;
+	int32 NumExtraShots = NumShots - NumPaidShots;
+	while ((NumExtraShots > 0) && !CheckCostMultiple(CurrentSpecHandle, CurrentActorInfo, NumEarlierUnchargedShots + NumExtraShots))
+	{
+		--NumExtraShots;
+	}
+
+	ApplyCostMultiple(CurrentSpecHandle, CurrentActorInfo, CurrentActivationInfo, NumExtraShots);
+	NumPaidShots += NumExtraShots;
+
+	++GetFireStats(/*bSustainedFire=*/ true).NumCommits;
+
+	return NumPaidShots;
+}
+
+void UHaroGameplayAbility_HitscanWeapon::OnSustainedFireBatchAcknowledged(int32 NumShots)
+{
+	// The server has processed the batch, its ammo change is (or is about to be) replicated
+	NumUnacknowledgedSustainedShots = FMath::Max(NumUnacknowledgedSustainedShots - NumShots, 0);
+}
+
+#if !UE_BUILD_SHIPPING
+namespace HaroHitscanFireStats
+{
+	static void LogFireStats(const TCHAR* Label, const FHaroHitscanFireStats& Stats)
+	{
+		const int32 NumShots = FMath::Max(Stats.NumShots, 1);
+		const int32 NumRPCs = Stats.NumAbilityRPCs + Stats.NumTargetDataRPCs;
+
+		UE_LOG(LogLyraAbilitySystem, Display, TEXT("  %-9s: %d shots in %d activations, %d RPCs (%d ability + %d target data, %.2f per shot), %d commits, %.1f us CPU per shot"),
+			Label, Stats.NumShots, Stats.NumActivations, NumRPCs, Stats.NumAbilityRPCs, Stats.NumTargetDataRPCs,
+			static_cast<float>(NumRPCs) / NumShots, Stats.NumCommits, (Stats.CpuTimeSeconds * 1000000.0) / NumShots);
+	}
+
+	static void PrintFireStats(const TArray<FString>& Args, UWorld* World)
+	{
+		UE_LOG(LogLyraAbilitySystem, Display, TEXT("Hitscan fire stats (this process):"));
+		LogFireStats(TEXT("Per-shot"), UHaroGameplayAbility_HitscanWeapon::GetFireStats(/*bSustainedFire=*/ false));
+		LogFireStats(TEXT("Sustained"), UHaroGameplayAbility_HitscanWeapon::GetFireStats(/*bSustainedFire=*/ true));
+
+		if ((Args.Num() > 0) && (Args[0] == TEXT("reset")))
+		{
+			UHaroGameplayAbility_HitscanWeapon::GetFireStats(/*bSustainedFire=*/ false) = FHaroHitscanFireStats();
+			UHaroGameplayAbility_HitscanWeapon::GetFireStats(/*bSustainedFire=*/ true) = FHaroHitscanFireStats();
+		}
+	}
+}
 
+static FAutoConsoleCommandWithWorldAndArgs HaroPrintSustainedFireStatsCmd(
+	TEXT("Haro.Weapon.PrintSustainedFireStats"),
+	TEXT("Prints shots, RPCs, commits and CPU time per shot for the per-shot activation path and sustained fire. Hold fire with Haro.Weapon.SustainedFire 0, then 1, to compare. Usage: Haro.Weapon.PrintSustainedFireStats [reset]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&HaroHitscanFireStats::PrintFireStats));
+#endif // !UE_BUILD_SHIPPING
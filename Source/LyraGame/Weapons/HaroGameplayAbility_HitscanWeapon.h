@@ -8,6 +8,7 @@
 enum ECollisionChannel : int;
 
 class APawn;
+class UAbilityTask_WaitInputRelease;
 class UHaroRangedWeaponInstance; 
 class UObject;
 struct FCollisionQueryParams;
@@ -16,6 +17,53 @@ struct FGameplayAbilityActorInfo;
 struct FGameplayEventData;
 struct FGameplayTag;
 struct FGameplayTagContainer;
+struct FHaroGameplayAbilityTargetData_HitscanCartridge;
+struct FHaroHitscanFireInfo;
+struct FLyraGameplayAbilityTargetData_SingleTargetHit;
+
+/** Counters gathered while tracing a single cartridge, used to compare the batched and per-pellet trace paths */
+struct FHaroCartridgeTraceStats
+{
+	// Number of pellets traced in the cartridge
+	int32 NumPellets = 0;
+
+	// Number of line traces issued
+	int32 NumLineTraces = 0;
+
+	// Number of sweep fallbacks issued (pellets whose line trace missed every pawn)
+	int32 NumSweepTraces = 0;
+
+	// Number of times the collision query params were built for this cartridge
+	int32 NumQueryParamBuilds = 0;
+
+	// Wall time spent tracing the cartridge
+	double TraceTimeSeconds = 0.0;
+
+	// Whether the cartridge went through the batched path
+	bool bBatched = false;
+};
+
+/** Counters used to compare the per-shot activation path against sustained fire (Haro.Weapon.PrintSustainedFireStats) */
+struct FHaroHitscanFireStats
+{
+	// Number of ability activations
+	int32 NumActivations = 0;
+
+	// Number of cartridges fired
+	int32 NumShots = 0;
+
+	// Number of activate/end ability RPCs sent by a predicting client
+	int32 NumAbilityRPCs = 0;
+
+	// Number of target data RPCs sent by a predicting client
+	int32 NumTargetDataRPCs = 0;
+
+	// Number of times cost was committed (one CommitAbility per shot, or one per sustained fire batch)
+	int32 NumCommits = 0;
+
+	// Game thread time spent inside the ability (activation, targeting, commit, end)
+	double CpuTimeSeconds = 0.0;
+};
 
 /**
  * 
@@ -34,6 +82,12 @@ public:
 	virtual void EndAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, bool bReplicateEndAbility, bool bWasCancelled) override;
 	//~End of UGameplayAbility interface
 
+	/** Returns the counters gathered while tracing the most recent cartridge */
+	const FHaroCartridgeTraceStats& GetLastCartridgeTraceStats() const { return LastCartridgeTraceStats; }
+
+	/** Returns the counters accumulated by every hitscan ability, for either the per-shot or the sustained fire path */
+	static FHaroHitscanFireStats& GetFireStats(bool bSustainedFire);
+
 protected:
 	struct FHitscanWeaponFiringInput
 	{
@@ -52,6 +106,12 @@ protected:
 		// Can we play bullet FX for hits during this trace
 		bool bCanPlayBulletFX = false;
 
+		// Half of the spread cone angle, resolved once for the whole cartridge
+		float SpreadHalfAngleRad = 0.0f;
+
+		// Seed every pellet direction is generated from (see FHaroSpreadRandom)
+		uint32 CartridgeSeed = 0;
+
 		FHitscanWeaponFiringInput()
 			: StartTrace(ForceInitToZero)
 			, EndAim(ForceInitToZero)
@@ -67,21 +127,40 @@ protected:
 	// Does a single weapon trace, either sweeping or ray depending on if SweepRadius is above zero
 	FHitResult WeaponTrace(const FVector& StartTrace, const FVector& EndTrace, float SweepRadius, bool bIsSimulated, OUT TArray<FHitResult>& OutHitResults) const;
 
+	// Same as WeaponTrace, but with query params and channel built by the caller so they can be shared by every pellet in a cartridge
+	FHitResult WeaponTraceWithParams(const FVector& StartTrace, const FVector& EndTrace, float SweepRadius, const FCollisionQueryParams& TraceParams, ECollisionChannel TraceChannel, TArray<FHitResult>& ScratchHits, OUT TArray<FHitResult>& OutHitResults) const;
+
 	// Wrapper around WeaponTrace to handle trying to do a ray trace before falling back to a sweep trace if there were no hits and SweepRadius is above zero 
-	FHitResult DoSingleBulletTrace(const FVector& StartTrace, const FVector& EndTrace, float SweepRadius, bool bIsSimulated, OUT TArray<FHitResult>& OutHits) const;
+	FHitResult DoSingleBulletTrace(const FVector& StartTrace, const FVector& EndTrace, float SweepRadius, bool bIsSimulated, OUT TArray<FHitResult>& OutHits, FHaroCartridgeTraceStats* OutStats = nullptr) const;
 
 	// Traces all of the bullets in a single cartridge
 	void TraceBulletsInCartridge(const FHitscanWeaponFiringInput& InputData, OUT TArray<FHitResult>& OutHits);
 
+	// Traces all of the bullets in a single cartridge one pellet at a time (each pellet builds its own query params)
+	void TraceBulletsInCartridge_PerPellet(const FHitscanWeaponFiringInput& InputData, OUT TArray<FHitResult>& OutHits, OUT FHaroCartridgeTraceStats& OutStats);
+
+	// Traces all of the bullets in a single cartridge as one batch: query params are built once, every pellet ray is
+	// issued back to back, and the sweep fallback only runs for the pellets whose ray missed every pawn
+	void TraceBulletsInCartridge_Batched(const FHitscanWeaponFiringInput& InputData, OUT TArray<FHitResult>& OutHits, OUT FHaroCartridgeTraceStats& OutStats);
+
 	virtual void AddAdditionalTraceIgnoreActors(FCollisionQueryParams& TraceParams) const;
 
 	// Determine the trace channel to use for the weapon trace(s)
 	virtual ECollisionChannel DetermineTraceChannel(FCollisionQueryParams& TraceParams, bool bIsSimulated) const;
 
-	void PerformLocalTargeting(OUT TArray<FHitResult>& OutHits);
+	void PerformLocalTargeting(OUT TArray<FHitResult>& OutHits, OUT FHitscanWeaponFiringInput* OutInputData = nullptr, uint16 ShotIndex = 0);
+
+	// Packs the traced hits of one cartridge into compact target data
+	FHaroGameplayAbilityTargetData_HitscanCartridge* MakeCartridgeTargetData(const FHitscanWeaponFiringInput& FiringInput, const TArray<FHitResult>& FoundHits, uint16 ShotIndex) const;
 
 	void OnTargetDataReadyCallback(const FGameplayAbilityTargetDataHandle& InData, FGameplayTag ApplicationTag);
 
+	// Re-validates client hits against their regenerated pellet rays and rewound hitboxes; returns false if every hit in the shot was rejected
+	bool ValidateTargetDataOnServer(const FGameplayAbilityTargetDataHandle& TargetData, const FHaroHitscanFireInfo* FireInfo, OUT TArray<uint8>& OutRejectedHits) const;
+
+	// Regenerates the cartridge's pellet directions from the fire info and rejects hits that don't lie on their pellet's ray
+	void ValidateSpreadOnServer(const FGameplayAbilityTargetDataHandle& TargetData, const FHaroHitscanFireInfo* FireInfo, OUT TArray<uint8>& OutRejectedHits) const;
+
 	UFUNCTION(BlueprintCallable)
 	void StartHitscanWeaponTargeting();
 
@@ -89,6 +168,90 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent)
 	void OnHitscanWeaponTargetDataReady(const FGameplayAbilityTargetDataHandle& TargetData);
 
+	// Whether this activation keeps firing on a fixed cadence instead of firing a single cartridge
+	bool IsSustainedFireEnabled() const;
+
+	// Time between two shots in sustained fire
+	float GetSustainedFireInterval() const;
+
+	// Starts the sustained fire cadence on the locally controlled side (first shot is fired immediately)
+	void StartSustainedFire();
+
+	// Fires the queued shots and ends the ability
+	void StopSustainedFire();
+
+	UFUNCTION()
+	void OnSustainedFireInputReleased(float TimeHeld);
+
+	// Timer callback, traces one cartridge and either processes it (authority) or predicts it and queues it for the server
+	void FireSustainedShot();
+
+	// Sends every queued cartridge to the server as one target data RPC and commits their cost in one go; returns false if some shots couldn't be paid for
+	bool FlushSustainedFireBatch();
+
+	void OnSustainedFireFlushTimer();
+
+	// Validates a batch of cartridges (one per shot) on the authority, commits their cost and hands the accepted hits to the blueprint
+	void ProcessSustainedTargetData(FGameplayAbilityTargetDataHandle& TargetData);
+
+	// Commits the ability once for the batch and pays the remaining shots through ApplyCostMultiple; returns how many shots were paid for
+	int32 CommitSustainedShots(int32 NumShots);
+
+	// Called once the server has caught up with (or rejected) a batch sent by FlushSustainedFireBatch
+	void OnSustainedFireBatchAcknowledged(int32 NumShots);
+
+protected:
+	// If set, one activation covers the whole burst/hold: shots are fired on a fixed cadence until the input is released,
+	// target data is sent to the server in batches, and ammo is committed per batch instead of per shot
+	UPROPERTY(EditDefaultsOnly, Category = "Sustained Fire")
+	bool bSustainedFire = false;
+
+	// Fire rate used by sustained fire
+	UPROPERTY(EditDefaultsOnly, Category = "Sustained Fire", meta = (EditCondition = "bSustainedFire", ClampMin = 1.0))
+	float ShotsPerMinute = 600.0f;
+
+	// Number of shots in a burst (0 = keep firing until the input is released or ammo runs out)
+	UPROPERTY(EditDefaultsOnly, Category = "Sustained Fire", meta = (EditCondition = "bSustainedFire", ClampMin = 0))
+	int32 MaxShotsPerActivation = 0;
+
 private:
 	FDelegateHandle OnTargetDataReadyCallbackDelegateHandle;
+
+	UPROPERTY()
+	TObjectPtr<UAbilityTask_WaitInputRelease> SustainedFireReleaseTask;
+
+	FTimerHandle SustainedFireTimerHandle;
+	FTimerHandle SustainedFireFlushTimerHandle;
+
+	/** Index of the next shot in this activation (client: next shot to fire, server: lowest shot index still accepted) */
+	uint16 NextSustainedShotIndex = 0;
+
+	/** Client only: shots sent to the server whose ammo cost hasn't been replicated back yet (kept across activations) */
+	int32 NumUnacknowledgedSustainedShots = 0;
+
+	/** Whether this activation already went through CommitAbility (later sustained fire batches only pay their cost) */
+	bool bSustainedFireCommitted = false;
+
+	/** World time the activation started at, used by the server to reject shots fired faster than the fire rate */
+	double SustainedFireStartTime = 0.0;
+
+	/** Cartridges predicted locally but not sent to the server yet, and their hits for the hit markers */
+	FGameplayAbilityTargetDataHandle PendingSustainedTargetData;
+	TArray<FHitResult> PendingSustainedHits;
+
+	/** Counters from the most recently traced cartridge */
+	FHaroCartridgeTraceStats LastCartridgeTraceStats;
+
+	/** Scratch buffers reused by the batched cartridge trace so a cartridge doesn't allocate per pellet */
+	TArray<FVector> CartridgeScratchTraceEnds;
+	TArray<TArray<FHitResult>> CartridgeScratchPelletHits;
+	TArray<FHitResult> CartridgeScratchTraceHits;
+	TArray<FHitResult> CartridgeScratchSweepHits;
+	TArray<int32> CartridgeScratchMissedPellets;
+
+	/** Pellet index of every hit written by the last cartridge trace (parallel to its OutHits) */
+	TArray<uint8> CartridgePelletIndices;
+
+	/** Per-hit target data reused when expanding received cartridges, so a shot doesn't allocate one SingleTargetHit per hit */
+	TArray<TSharedPtr<FLyraGameplayAbilityTargetData_SingleTargetHit>> ExpandedHitPool;
 };
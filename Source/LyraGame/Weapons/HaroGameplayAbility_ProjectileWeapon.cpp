@@ -3,12 +3,18 @@
 
 #include "HaroGameplayAbility_ProjectileWeapon.h"
 #include "HaroProjectileBase.h"
+#include "HaroProjectilePoolSubsystem.h"
+#include "HaroSimulatedProjectileSubsystem.h"
+#include "HaroWeaponBase.h"
 #include "HaroAOEBase.h"
+#include "HaroLaunchValidationSubsystem.h"
+#include "HaroPredictedProjectileSubsystem.h"
 #include "LyraLogChannels.h"
 #include "Character/LyraCharacter.h"
 #include "Player/LyraPlayerController.h"
 #include "HaroRangedWeaponInstance.h"
 #include "AbilitySystemComponent.h"
+#include "HAL/PlatformTime.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HaroGameplayAbility_ProjectileWeapon)
 
@@ -86,6 +92,20 @@ void UHaroGameplayAbility_ProjectileWeapon::EndAbility(const FGameplayAbilitySpe
 	}
 }
 
+void UHaroGameplayAbility_ProjectileWeapon::OnGiveAbility(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec)
+{
+	Super::OnGiveAbility(ActorInfo, Spec);
+
+	// 서버에서만 풀 미리 채우기
+	if (bUseProjectilePool && (ProjectilePoolPrewarmCount > 0) && ActorInfo && ActorInfo->IsNetAuthority())
+	{
+		if (UHaroProjectilePoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<UHaroProjectilePoolSubsystem>(GetWorld()))
+		{
+			PoolSubsystem->PrewarmPool(ProjectileClass, ProjectilePoolPrewarmCount);
+		}
+	}
+}
+
 void UHaroGameplayAbility_ProjectileWeapon::SpawnProjectile()
 {
 	// 서버에서만 투사체 스폰
@@ -131,55 +151,62 @@ void UHaroGameplayAbility_ProjectileWeapon::SpawnProjectileFromTargetData(const
 {
 	// 서버에서만 투사체 스폰
 	if (!HasAuthority(&CurrentActivationInfo))
+	{
+		// 쏜 클라이언트에서는 바로 보여줌 (판정은 서버)
+		UHaroRangedWeaponInstance* LocalWeaponInstance = GetWeaponInstance();
+		const FGameplayAbilityTargetData* LocalTargetData = (TargetData.Num() > 0) ? TargetData.Get(0) : nullptr;
+		if (LocalWeaponInstance && LocalTargetData && LocalTargetData->GetScriptStruct()->IsChildOf(FGameplayAbilityTargetData_LocationInfo::StaticStruct()) && IsLocallyControlled())
+		{
+			if (const FGameplayAbilityTargetData_LocationInfo* LocationData = static_cast<const FGameplayAbilityTargetData_LocationInfo*>(LocalTargetData))
+			{
+				const int16 PredictionKey = CurrentActivationInfo.GetActivationPredictionKey().Current;
+
+				if (UsesSimulatedProjectileBackend(LocalWeaponInstance))
+				{
+					FireSimulatedProjectile(LocationData->SourceLocation.LiteralTransform, LocalWeaponInstance, GetLyraCharacterFromActorInfo(), PredictionKey, LocalWeaponInstance->GetChargingTime(), /*bAuthoritative=*/ false);
+				}
+				else
+				{
+					SpawnPredictedProjectileProxy(LocationData->SourceLocation.LiteralTransform, LocalWeaponInstance, PredictionKey);
+				}
+			}
+		}
 		return;
+	}
 
 	UHaroRangedWeaponInstance* WeaponInstance = Cast<UHaroRangedWeaponInstance>(GetWeaponInstance());
 	ALyraCharacter* LyraCharacter = GetLyraCharacterFromActorInfo();
 
-	if (!LyraCharacter || !WeaponInstance || !ProjectileClass)
+	if (!LyraCharacter || !WeaponInstance)
 		return;
 
 	// 타겟 데이터에서 발사 정보 추출
-	if (TargetData.Num() > 0)
+	const FGameplayAbilityTargetData* FirstTargetData = (TargetData.Num() > 0) ? TargetData.Get(0) : nullptr;
+	if (FirstTargetData && FirstTargetData->GetScriptStruct()->IsChildOf(FGameplayAbilityTargetData_LocationInfo::StaticStruct()))
 	{
 		if (const FGameplayAbilityTargetData_LocationInfo* LocationData =
-			static_cast<const FGameplayAbilityTargetData_LocationInfo*>(TargetData.Get(0)))
+			static_cast<const FGameplayAbilityTargetData_LocationInfo*>(FirstTargetData))
 		{
 			// 클라이언트에서 계산된 발사 Transform 가져오기
 			FTransform LaunchTransform = LocationData->SourceLocation.LiteralTransform;
 
 			// 서버 검증: 클라이언트 데이터가 유효한가? (치팅 방지)
-			if (IsValidLaunchTransform(LaunchTransform, LyraCharacter))
+			// 벽 검사는 비동기 트레이스라 보통 다음 프레임에 OnLaunchValidated에서 스폰됨
+			if (UHaroLaunchValidationSubsystem* LaunchValidation = UWorld::GetSubsystem<UHaroLaunchValidationSubsystem>(GetWorld()))
 			{
-				// 무기 액터 가져오기
-				AActor* WeaponActor = WeaponInstance->GetPrimaryActor();
-
-				// 스폰 파라미터 설정
-				FActorSpawnParameters SpawnParams;
-				SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-				SpawnParams.Owner = WeaponActor ? WeaponActor : LyraCharacter;
-				SpawnParams.Instigator = LyraCharacter;
-
-				// SpawnActorDeferred써서 속성을 설정한 후에 스폰하는 식으로 변경
-				if (AHaroProjectileBase* SpawnedProjectile = GetWorld()->SpawnActorDeferred<AHaroProjectileBase>(
-					ProjectileClass,
-					LaunchTransform,
-					SpawnParams.Owner,
-					SpawnParams.Instigator,
-					SpawnParams.SpawnCollisionHandlingOverride))
-				{
-
-					// 스폰 전 설정.
-					ConfigureProjectilePreSpawn(SpawnedProjectile, WeaponInstance, LyraCharacter);
-
-					// 실제 스폰 완료 (이때 BeginPlay 호출됨)
-					SpawnedProjectile->FinishSpawning(LaunchTransform);
-
-					// 스폰 완료 후 추가 로직
-					OnProjectileSpawned(SpawnedProjectile, WeaponInstance);
-
-					UE_LOG(LogTemp, Log, TEXT("Projectile spawned at: %s"), *LaunchTransform.GetLocation().ToString());
-				}
+				FHaroPendingLaunch Launch;
+				Launch.Ability = this;
+				Launch.Pawn = LyraCharacter;
+				Launch.LaunchTransform = LaunchTransform;
+				Launch.PredictionKey = CurrentActivationInfo.GetActivationPredictionKey().Current;
+				Launch.ChargingTime = WeaponInstance->GetChargingTime();
+				Launch.QueueTime = FPlatformTime::Seconds();
+
+				LaunchValidation->QueueLaunch(Launch);
+			}
+			else if (IsValidLaunchTransform(LaunchTransform, LyraCharacter))
+			{
+				SpawnValidatedProjectile(LaunchTransform, CurrentActivationInfo.GetActivationPredictionKey().Current, WeaponInstance->GetChargingTime());
 			}
 			else
 			{
@@ -190,50 +217,193 @@ void UHaroGameplayAbility_ProjectileWeapon::SpawnProjectileFromTargetData(const
 	}
 }
 
-void UHaroGameplayAbility_ProjectileWeapon::ConfigureProjectilePreSpawn(AHaroProjectileBase* Projectile, UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter)
+void UHaroGameplayAbility_ProjectileWeapon::OnLaunchValidated(const FHaroPendingLaunch& Launch, EHaroLaunchValidationResult Result)
+{
+	if (Result != EHaroLaunchValidationResult::Accepted)
+	{
+		// 치팅 방지: 클라이언트가 이상한 데이터를 보냈음 (사유는 Haro.Projectile.PrintLaunchValidationStats)
+		return;
+	}
+
+	// 검증을 기다리는 동안 어빌리티가 끝나면서 차징 시간이 초기화됐을 수 있으므로 큐에 넣을 때 값으로 스폰
+	SpawnValidatedProjectile(Launch.LaunchTransform, Launch.PredictionKey, Launch.ChargingTime);
+}
+
+void UHaroGameplayAbility_ProjectileWeapon::SpawnValidatedProjectile(const FTransform& LaunchTransform, int16 PredictionKey, float LaunchChargingTime)
+{
+	UHaroRangedWeaponInstance* WeaponInstance = GetWeaponInstance();
+	ALyraCharacter* LyraCharacter = GetLyraCharacterFromActorInfo();
+
+	if (!LyraCharacter || !WeaponInstance)
+		return;
+
+	// 시뮬레이션 백엔드는 액터를 만들지 않음
+	if (UsesSimulatedProjectileBackend(WeaponInstance))
+	{
+		FireSimulatedProjectile(LaunchTransform, WeaponInstance, LyraCharacter, PredictionKey, LaunchChargingTime, /*bAuthoritative=*/ true);
+		return;
+	}
+
+	if (!ProjectileClass)
+		return;
+
+	// 무기 액터 가져오기
+	AActor* WeaponActor = WeaponInstance->GetPrimaryActor();
+
+	// 스폰 파라미터 설정
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.Owner = WeaponActor ? WeaponActor : LyraCharacter;
+	SpawnParams.Instigator = LyraCharacter;
+
+	// 풀을 쓸 수 있으면 풀에서 꺼내고, 아니면 기존처럼 스폰
+	UHaroProjectilePoolSubsystem* PoolSubsystem = (bUseProjectilePool && UHaroProjectilePoolSubsystem::IsPoolingEnabled())
+		? UWorld::GetSubsystem<UHaroProjectilePoolSubsystem>(GetWorld())
+		: nullptr;
+
+	// SpawnActorDeferred써서 속성을 설정한 후에 스폰하는 식으로 변경
+	AHaroProjectileBase* SpawnedProjectile = PoolSubsystem
+		? PoolSubsystem->AcquireProjectile(ProjectileClass, LaunchTransform, SpawnParams.Owner, SpawnParams.Instigator)
+		: GetWorld()->SpawnActorDeferred<AHaroProjectileBase>(
+			ProjectileClass,
+			LaunchTransform,
+			SpawnParams.Owner,
+			SpawnParams.Instigator,
+			SpawnParams.SpawnCollisionHandlingOverride);
+
+	if (SpawnedProjectile)
+	{
+		// 쏜 클라이언트가 자기 프록시와 맞출 수 있게 예측 키를 같이 복제
+		SpawnedProjectile->SetPredictionKey(PredictionKey);
+
+		// 스폰 전 설정.
+		ConfigureProjectilePreSpawn(SpawnedProjectile, WeaponInstance, LyraCharacter, LaunchChargingTime);
+
+		// 실제 스폰 완료 (이때 BeginPlay 호출됨, 풀에서 꺼낸 투사체는 다시 활성화됨)
+		if (PoolSubsystem)
+		{
+			PoolSubsystem->FinishAcquire(SpawnedProjectile, LaunchTransform);
+		}
+		else
+		{
+			SpawnedProjectile->FinishSpawning(LaunchTransform);
+		}
+
+		// 스폰 완료 후 추가 로직
+		OnProjectileSpawned(SpawnedProjectile, WeaponInstance);
+
+		UE_LOG(LogTemp, Log, TEXT("Projectile spawned at: %s"), *LaunchTransform.GetLocation().ToString());
+	}
+}
+
+void UHaroGameplayAbility_ProjectileWeapon::SpawnPredictedProjectileProxy(const FTransform& LaunchTransform, UHaroRangedWeaponInstance* WeaponInstance, int16 PredictionKey)
+{
+	UHaroPredictedProjectileSubsystem* PredictedProjectiles = UWorld::GetSubsystem<UHaroPredictedProjectileSubsystem>(GetWorld());
+	ALyraCharacter* LyraCharacter = GetLyraCharacterFromActorInfo();
+
+	if (!PredictedProjectiles || !LyraCharacter || !WeaponInstance || !ProjectileClass)
+		return;
+
+	const double FireTime = FPlatformTime::Seconds();
+
+	// 예측이 꺼져 있어도 발사는 기록해서 서버 투사체가 도착하기까지의 지연을 잼
+	AHaroProjectileBase* Proxy = nullptr;
+	if (UHaroPredictedProjectileSubsystem::IsPredictionEnabled())
+	{
+		AActor* WeaponActor = WeaponInstance->GetPrimaryActor();
+
+		Proxy = GetWorld()->SpawnActorDeferred<AHaroProjectileBase>(
+			ProjectileClass,
+			LaunchTransform,
+			WeaponActor ? WeaponActor : LyraCharacter,
+			LyraCharacter,
+			ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+		if (Proxy)
+		{
+			// 복제/데미지/AOE 없이 속도, 크기, 수명만 서버와 똑같이 설정
+			Proxy->InitPredictedProxy();
+			WeaponInstance->ConfigureProjectileForInput(Proxy, GetCurrentFireInputType());
+			Proxy->FinishSpawning(LaunchTransform);
+		}
+	}
+
+	PredictedProjectiles->RegisterShot(LyraCharacter, PredictionKey, Proxy, FireTime);
+
+	// 활성화 자체가 서버에서 거부되면 서버 투사체를 기다리지 않고 바로 정리
+	FPredictionKey ActivationPredictionKey = CurrentActivationInfo.GetActivationPredictionKey();
+	if (ActivationPredictionKey.IsLocalClientKey())
+	{
+		ActivationPredictionKey.NewRejectedDelegate().BindUObject(PredictedProjectiles, &UHaroPredictedProjectileSubsystem::HandleShotRejected, TWeakObjectPtr<APawn>(LyraCharacter), PredictionKey);
+	}
+}
+
+void UHaroGameplayAbility_ProjectileWeapon::ConfigureProjectilePreSpawn(AHaroProjectileBase* Projectile, UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter, float LaunchChargingTime)
 {
 	if (!Projectile || !WeaponInstance || !SourceCharacter)
 		return;
 
 	const EHaroFireInputType InputType = GetCurrentFireInputType();
 
-	WeaponInstance->ConfigureProjectileForInput(Projectile, InputType); // GE를 제외한 모든 투사체 설정
+	WeaponInstance->ConfigureProjectileForLaunch(Projectile, InputType, LaunchChargingTime); // GE를 제외한 모든 투사체 설정
 
-	ConfigureProjectileDamageEffect(Projectile, WeaponInstance, SourceCharacter);
+	ConfigureProjectileDamageEffect(Projectile, WeaponInstance, SourceCharacter, LaunchChargingTime);
 
 	// AOE 설정 추가
 	ConfigureProjectileAOE(Projectile, WeaponInstance, SourceCharacter);
 }
 
-void UHaroGameplayAbility_ProjectileWeapon::ConfigureProjectileDamageEffect(AHaroProjectileBase* Projectile, UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter)
+void UHaroGameplayAbility_ProjectileWeapon::ConfigureProjectileDamageEffect(AHaroProjectileBase* Projectile, UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter, float LaunchChargingTime)
 {
 	// 데미지 이펙트 스펙 생성 및 설정
-	UAbilitySystemComponent* SourceASC = SourceCharacter->GetAbilitySystemComponent();
+	FGameplayEffectSpecHandle DamageSpec = MakeProjectileDamageSpec(WeaponInstance, SourceCharacter, LaunchChargingTime);
+	if (DamageSpec.IsValid())
+	{
+		// 투사체에 데미지 스펙 설정
+		Projectile->SetDamageEffectSpec(DamageSpec);
+	}
+}
+
+FGameplayEffectSpecHandle UHaroGameplayAbility_ProjectileWeapon::MakeProjectileDamageSpec(UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter, float LaunchChargingTime)
+{
+	UAbilitySystemComponent* SourceASC = SourceCharacter ? SourceCharacter->GetAbilitySystemComponent() : nullptr;
 	if (SourceASC && DamageEffectClass)
 	{
-		// 현재 어빌리티 컨텍스트로 데미지 GE 스펙 생성
-		// 필요시 더 많은 정보를 추가해도 됨.
-		// 이 함수 내부에서 이미 다음과 같은 정보들이 설정됨:
+		// 템플릿을 만들 때 (장착마다 한 번) 다음과 같은 정보들이 설정됨:
 		// - Instigator (발사자)
 		// - EffectCauser 
-		// - SourceObject (ASC의 소유자)
-		FGameplayEffectContextHandle EffectContext = SourceASC->MakeEffectContext();
-		EffectContext.SetAbility(this);
-		EffectContext.AddSourceObject(WeaponInstance);
-
-		// 데미지 이펙트 스펙 생성
-		FGameplayEffectSpecHandle DamageSpec = SourceASC->MakeOutgoingSpec(
+		// - SourceObject (무기 인스턴스)
+		// - 소스 속성 스냅샷
+		// 발사마다 새로 만들지 않고 템플릿을 그대로 공유함 (히트 결과는 적용할 때 넣음)
+		return EffectSpecCache.GetSpec(
+			SourceASC,
+			this,
 			DamageEffectClass,
 			GetAbilityLevel(),
-			EffectContext
+			WeaponInstance,
+			WeaponInstance ? WeaponInstance->GetEquipSerial() : 0
 		);
+	}
 
-		if (DamageSpec.IsValid())
-		{
-			// 투사체에 데미지 스펙 설정
-			Projectile->SetDamageEffectSpec(DamageSpec);
-		}
+	return FGameplayEffectSpecHandle();
+}
+
+FGameplayEffectSpecHandle UHaroGameplayAbility_ProjectileWeapon::MakeProjectileAOEDamageSpec(UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter)
+{
+	UAbilitySystemComponent* SourceASC = SourceCharacter ? SourceCharacter->GetAbilitySystemComponent() : nullptr;
+	if (SourceASC && AOEDamageEffectClass)
+	{
+		return EffectSpecCache.GetSpec(
+			SourceASC,
+			this,
+			AOEDamageEffectClass,
+			GetAbilityLevel(),
+			WeaponInstance,
+			WeaponInstance ? WeaponInstance->GetEquipSerial() : 0
+		);
 	}
+
+	return FGameplayEffectSpecHandle();
 }
 
 void UHaroGameplayAbility_ProjectileWeapon::ConfigureProjectileAOE(AHaroProjectileBase* Projectile, UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter)
@@ -247,22 +417,65 @@ void UHaroGameplayAbility_ProjectileWeapon::ConfigureProjectileAOE(AHaroProjecti
 	// 2. AOE 데미지 이펙트 스펙 생성
 	if (AOEDamageEffectClass)
 	{
-		UAbilitySystemComponent* SourceASC = SourceCharacter->GetAbilitySystemComponent();
-		if (SourceASC)
+		Projectile->SetAOEDamageSpec(MakeProjectileAOEDamageSpec(WeaponInstance, SourceCharacter));
+	}
+}
+
+bool UHaroGameplayAbility_ProjectileWeapon::UsesSimulatedProjectileBackend(const UHaroRangedWeaponInstance* WeaponInstance) const
+{
+	const FHaroProjectileFireConfig* Config = WeaponInstance ? WeaponInstance->GetProjectileFireConfig(GetCurrentFireInputType()) : nullptr;
+	return Config && (Config->Backend == EHaroProjectileBackend::Simulated);
+}
+
+void UHaroGameplayAbility_ProjectileWeapon::FireSimulatedProjectile(const FTransform& LaunchTransform, UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter, int16 PredictionKey, float LaunchChargingTime, bool bAuthoritative)
+{
+	UHaroSimulatedProjectileSubsystem* SimulatedProjectiles = UWorld::GetSubsystem<UHaroSimulatedProjectileSubsystem>(GetWorld());
+	const FHaroProjectileFireConfig* Config = WeaponInstance ? WeaponInstance->GetProjectileFireConfig(GetCurrentFireInputType()) : nullptr;
+	if (!SimulatedProjectiles || !Config || !SourceCharacter)
+		return;
+
+	const EHaroFireInputType InputType = GetCurrentFireInputType();
+
+	// 발사 이벤트 (네트워크로는 이것만 보냄)
+	FHaroSimulatedProjectileFireEvent FireEvent;
+	FireEvent.Origin = LaunchTransform.GetLocation();
+	FireEvent.Direction = LaunchTransform.GetUnitAxis(EAxis::X);
+	FireEvent.Speed = WeaponInstance->GetProjectileSpeed(InputType, LaunchChargingTime);
+	FireEvent.GravityScale = WeaponInstance->GetProjectileGravityScale(InputType);
+	FireEvent.Lifespan = WeaponInstance->GetProjectileLifespan(InputType);
+	FireEvent.Radius = Config->SimulatedCollisionRadius * WeaponInstance->GetProjectileSizeMultiplier(InputType, LaunchChargingTime);
+	FireEvent.Seed = PredictionKey;
+	FireEvent.TracerSystem = Config->SimulatedTracerSystem;
+
+	AActor* WeaponActor = WeaponInstance->GetPrimaryActor();
+	FireEvent.Instigator = SourceCharacter;
+	FireEvent.Owner = WeaponActor ? WeaponActor : SourceCharacter;
+
+	FHaroSimulatedProjectilePayload Payload;
+	Payload.Instigator = FireEvent.Instigator;
+	Payload.Owner = FireEvent.Owner;
+	if (bAuthoritative)
+	{
+		Payload.DamageEffectSpecHandle = MakeProjectileDamageSpec(WeaponInstance, SourceCharacter, LaunchChargingTime);
+		Payload.HitGameplayCueTag = Config->SimulatedHitGameplayCueTag;
+
+		if (bHasAOE && AOEClass)
 		{
-			FGameplayEffectContextHandle EffectContext = SourceASC->MakeEffectContext();
-			EffectContext.SetAbility(this);
-			EffectContext.AddSourceObject(WeaponInstance);
-
-			FGameplayEffectSpecHandle AOEDamageSpec = SourceASC->MakeOutgoingSpec(
-				AOEDamageEffectClass,
-				GetAbilityLevel(),
-				EffectContext
-			);
+			Payload.AOEClass = AOEClass;
+			Payload.AOEDamageEffectSpecHandle = MakeProjectileAOEDamageSpec(WeaponInstance, SourceCharacter);
+		}
 
-			Projectile->SetAOEDamageSpec(AOEDamageSpec);
+		// 다른 클라이언트에는 발사 이벤트만 전달
+		if (AHaroWeaponBase* HaroWeapon = Cast<AHaroWeaponBase>(WeaponActor))
+		{
+			HaroWeapon->MulticastSimulatedProjectileFired(FireEvent);
 		}
+
+		// 확산 시스템에 발사 추가 (액터 투사체의 OnProjectileSpawned와 동일)
+		WeaponInstance->AddSpread();
 	}
+
+	SimulatedProjectiles->FireProjectile(FireEvent, Payload, bAuthoritative);
 }
 
 // TODO
@@ -282,22 +495,23 @@ void UHaroGameplayAbility_ProjectileWeapon::OnProjectileSpawned(AHaroProjectileB
 
 bool UHaroGameplayAbility_ProjectileWeapon::IsValidLaunchTransform(const FTransform& LaunchTransform, APawn* SourcePawn)
 {
-	// 1. 거리 검증: 플레이어 근처에서 발사되는가?
-	float DistanceFromPlayer = FVector::Dist(LaunchTransform.GetLocation(), SourcePawn->GetActorLocation());
-	if (DistanceFromPlayer > 300.0f) // 3미터 이상 떨어진 곳에서 발사? 의심스러움
+	// 1. 거리/조준 각도 검사
+	const EHaroLaunchValidationResult Result = UHaroLaunchValidationSubsystem::CheckLaunchTransform(LaunchTransform, SourcePawn);
+	if (Result != EHaroLaunchValidationResult::Accepted)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Launch position too far from player: %f"), DistanceFromPlayer);
+		UE_LOG(LogTemp, Warning, TEXT("Invalid launch transform: %s"), UHaroLaunchValidationSubsystem::LexResultToString(Result));
 		return false;
 	}
 
-	// 2. 방향 검증: 플레이어가 실제로 볼 수 있는 방향인가?
-	FVector PlayerForward = SourcePawn->GetActorForwardVector();
-	FVector LaunchForward = LaunchTransform.GetUnitAxis(EAxis::X);
-	float DotProduct = FVector::DotProduct(PlayerForward, LaunchForward);
+	// 2. 벽 검사: 폰 눈높이에서 발사 위치까지 막혀 있지 않은가?
+	FVector TraceStart;
+	FVector TraceEnd;
+	FCollisionQueryParams QueryParams;
+	UHaroLaunchValidationSubsystem::GetObstructionTrace(LaunchTransform, SourcePawn, /*out*/ TraceStart, /*out*/ TraceEnd, /*out*/ QueryParams);
 
-	if (DotProduct < -0.7f) // 거의 뒤쪽으로 쏘려고 함? 의심스러움
+	if (GetWorld()->LineTraceTestByChannel(TraceStart, TraceEnd, ECollisionChannel::ECC_Visibility, QueryParams))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Invalid launch direction: %f"), DotProduct);
+		UE_LOG(LogTemp, Warning, TEXT("Launch position is obstructed"));
 		return false;
 	}
 
@@ -3,11 +3,14 @@
 #pragma once
 
 #include "HaroGameplayAbility_WeaponBase.h"
+#include "AbilitySystem/HaroEffectSpecCache.h"
 #include "HaroGameplayAbility_ProjectileWeapon.generated.h"
 
 class AHaroProjectileBase;
 class AHaroAOEBase;
 class UHaroRangedWeaponInstance;
+struct FHaroPendingLaunch;
+enum class EHaroLaunchValidationResult : uint8;
 
 /**
  * 
@@ -24,16 +27,38 @@ public:
 	virtual bool CanActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayTagContainer* SourceTags = nullptr, const FGameplayTagContainer* TargetTags = nullptr, OUT FGameplayTagContainer* OptionalRelevantTags = nullptr) const override;
 	virtual void ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData) override;
 	virtual void EndAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, bool bReplicateEndAbility, bool bWasCancelled) override;
+	virtual void OnGiveAbility(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec) override;
 	//~End of UGameplayAbility interface
 
+	// UHaroLaunchValidationSubsystem에서 발사 검증이 끝나면 호출됨 (통과했으면 여기서 스폰)
+	void OnLaunchValidated(const FHaroPendingLaunch& Launch, EHaroLaunchValidationResult Result);
+
 protected:
 	void SpawnProjectile();
 	void SpawnProjectileFromTargetData(const FGameplayAbilityTargetDataHandle& TargetData);
 
+	// 검증을 통과한 발사 위치로 투사체 스폰 (서버). 차징 시간은 무기 인스턴스의 현재 값 대신 발사 시점 값을 받음.
+	void SpawnValidatedProjectile(const FTransform& LaunchTransform, int16 PredictionKey, float LaunchChargingTime);
+
+	// 쏜 클라이언트에서 서버 투사체가 올 때까지 대신 보여줄 프록시 스폰 (UHaroPredictedProjectileSubsystem)
+	void SpawnPredictedProjectileProxy(const FTransform& LaunchTransform, UHaroRangedWeaponInstance* WeaponInstance, int16 PredictionKey);
+
 	// 투사체 스폰 전에 설정을 위한 함수
-	virtual void ConfigureProjectilePreSpawn(AHaroProjectileBase* Projectile, UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter);
+	virtual void ConfigureProjectilePreSpawn(AHaroProjectileBase* Projectile, UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter, float LaunchChargingTime);
+
+	virtual void ConfigureProjectileDamageEffect(AHaroProjectileBase* Projectile, UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter, float LaunchChargingTime);
+
+	// 투사체 데미지 GE 스펙 생성 (액터/시뮬레이션 투사체 공용)
+	virtual FGameplayEffectSpecHandle MakeProjectileDamageSpec(UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter, float LaunchChargingTime);
 
-	virtual void ConfigureProjectileDamageEffect(AHaroProjectileBase* Projectile, UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter);
+	// AOE 데미지 GE 스펙 생성 (액터/시뮬레이션 투사체 공용)
+	FGameplayEffectSpecHandle MakeProjectileAOEDamageSpec(UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter);
+
+	// 시뮬레이션 백엔드로 발사 (서버에서는 판정 + 다른 클라이언트에 발사 이벤트 전달, 쏜 클라이언트에서는 보이기만)
+	void FireSimulatedProjectile(const FTransform& LaunchTransform, UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter, int16 PredictionKey, float LaunchChargingTime, bool bAuthoritative);
+
+	// 현재 입력의 투사체 설정이 시뮬레이션 백엔드인지
+	bool UsesSimulatedProjectileBackend(const UHaroRangedWeaponInstance* WeaponInstance) const;
 
 	// AOE 설정 함수
 	virtual void ConfigureProjectileAOE(AHaroProjectileBase* Projectile, UHaroRangedWeaponInstance* WeaponInstance, ALyraCharacter* SourceCharacter);
@@ -41,7 +66,7 @@ protected:
 	// 투사체 스폰 후 호출되는 네이티브 함수
 	virtual void OnProjectileSpawned(AHaroProjectileBase* SpawnedProjectile, UHaroRangedWeaponInstance* WeaponInstance);
 
-	// 서버 검증 함수 (치팅 방지)
+	// 서버 검증 함수 (치팅 방지, 검증 서브시스템이 없을 때 쓰는 동기 버전)
 	bool IsValidLaunchTransform(const FTransform& LaunchTransform, APawn* SourcePawn);
 
 	void OnTargetDataReadyCallback(const FGameplayAbilityTargetDataHandle& InData, FGameplayTag ApplicationTag);  
@@ -69,6 +94,14 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Projectile")
 	TSubclassOf<UGameplayEffect> DamageEffectClass;
 
+	// 투사체를 UHaroProjectilePoolSubsystem으로 재사용할지 (Haro.Projectile.EnablePooling이 꺼져 있으면 무시)
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile|Pool")
+	bool bUseProjectilePool = true;
+
+	// 어빌리티가 부여될 때 미리 만들어 둘 투사체 수
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile|Pool", meta = (EditCondition = "bUseProjectilePool", ClampMin = 0))
+	int32 ProjectilePoolPrewarmCount = 0;
+
 	// AOE
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "AOE")
 	bool bHasAOE = false;
@@ -85,6 +118,9 @@ protected:
 
 protected:
 	FDelegateHandle OnTargetDataReadyCallbackDelegateHandle;
+
+	// 데미지/AOE GE 스펙 템플릿 (무기 장착 단위로 한 번 만들고 발사마다 공유)
+	FHaroEffectSpecCache EffectSpecCache;
 };
 
 
@@ -127,6 +127,38 @@ FTransform UHaroGameplayAbility_WeaponBase::GetTargetingTransform(APawn* SourceP
 }
 
 FVector UHaroGameplayAbility_WeaponBase::VRandConeNormalDistribution_Haro(const FVector& Dir, const float ConeHalfAngleRad, const float Exponent)
+{
+    return VRandConeNormalDistribution_Haro(Dir, ConeHalfAngleRad, Exponent, FMath::FRand(), FMath::FRand());
+}
+
+FVector UHaroGameplayAbility_WeaponBase::GetPelletDirection(const FVector& AimDir, const float ConeHalfAngleRad, const float Exponent, const uint32 CartridgeSeed, const int32 PelletIndex)
+{
+    float RandFromCenter;
+    float RandAround;
+    FHaroSpreadRandom::GetPelletFractions(CartridgeSeed, static_cast<uint32>(PelletIndex), /*out*/ RandFromCenter, /*out*/ RandAround);
+
+    return VRandConeNormalDistribution_Haro(AimDir, ConeHalfAngleRad, Exponent, RandFromCenter, RandAround);
+}
+
+uint32 UHaroGameplayAbility_WeaponBase::MakeCartridgeSeed(uint16 ShotIndex) const
+{
+    const UHaroRangedWeaponInstance* WeaponData = GetWeaponInstance();
+    const uint32 WeaponSeed = WeaponData ? WeaponData->GetSpreadSeed() : 0;
+
+    const FPredictionKey ActivationKey = CurrentActivationInfo.GetActivationPredictionKey();
+    if (!ActivationKey.IsValidKey())
+    {
+        // 서버에서 시작한 활성화(봇, 리슨 호스트, 스탠드얼론)는 예측 키가 항상 0이라 매번 같은 패턴이 나옴
+        // 맞출 클라이언트가 없으므로 서버 난수를 섞음
+        const uint32 ServerRandom = (static_cast<uint32>(FMath::Rand()) << 16) ^ static_cast<uint32>(FMath::Rand());
+        return FHaroSpreadRandom::MakeCartridgeSeed(WeaponSeed ^ ServerRandom, 0, ShotIndex);
+    }
+
+    // 서버는 클라이언트가 보낸 예측 키로 같은 활성화를 돌리므로 양쪽에서 같은 값이 나옴
+    return FHaroSpreadRandom::MakeCartridgeSeed(WeaponSeed, ActivationKey.Current, ShotIndex);
+}
+
+FVector UHaroGameplayAbility_WeaponBase::VRandConeNormalDistribution_Haro(const FVector& Dir, const float ConeHalfAngleRad, const float Exponent, const float RandFromCenter, const float RandAround)
 {
     if (ConeHalfAngleRad > 0.f)
     {
@@ -134,9 +166,9 @@ FVector UHaroGameplayAbility_WeaponBase::VRandConeNormalDistribution_Haro(const
 
         // consider the cone a concatenation of two rotations. one "away" from the center line, and another "around" the circle
         // apply the exponent to the away-from-center rotation. a larger exponent will cluster points more tightly around the center
-        const float FromCenter = FMath::Pow(FMath::FRand(), Exponent);
+        const float FromCenter = FMath::Pow(RandFromCenter, Exponent);
         const float AngleFromCenter = FromCenter * ConeHalfAngleDegrees;
-        const float AngleAround = FMath::FRand() * 360.0f;
+        const float AngleAround = RandAround * 360.0f;
 
         FRotator Rot = Dir.Rotation();
         FQuat DirQuat(Rot);
@@ -53,6 +53,15 @@ protected:
 	// 무기 탄퍼짐용 원뿔 범위 내 랜덤 방향 벡터 생성
 	FVector VRandConeNormalDistribution_Haro(const FVector& Dir, const float ConeHalfAngleRad, const float Exponent);
 
+	// 위와 같지만 난수를 밖에서 받음 (RandFromCenter, RandAround는 [0, 1))
+	static FVector VRandConeNormalDistribution_Haro(const FVector& Dir, const float ConeHalfAngleRad, const float Exponent, const float RandFromCenter, const float RandAround);
+
+	// 카트리지 시드로 펠릿 방향 생성 (클라/서버가 같은 입력이면 같은 방향)
+	static FVector GetPelletDirection(const FVector& AimDir, const float ConeHalfAngleRad, const float Exponent, const uint32 CartridgeSeed, const int32 PelletIndex);
+
+	// 무기 시드 + 현재 활성화 예측 키 (+ 연사 중 발 번호)로 카트리지 시드 생성 (예측 키가 없는 서버 활성화는 서버 난수 사용)
+	uint32 MakeCartridgeSeed(uint16 ShotIndex = 0) const;
+
 private:
 	/** 이 어빌리티가 사용할 발사 입력 타입 (Primary/Secondary) */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Fire Config", meta = (AllowPrivateAccess = "true"))
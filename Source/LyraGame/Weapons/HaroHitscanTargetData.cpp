@@ -0,0 +1,468 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HaroHitscanTargetData.h"
+
+#include "AbilitySystem/LyraGameplayAbilityTargetData_SingleTargetHit.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "LyraLogChannels.h"
+#include "Net/NetBitWriter.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HaroHitscanTargetData)
+
+namespace HaroHitscanTargetData
+{
+	// 탄퍼짐 반각 양자화 단위 (0.01도, 최대 655.35도)
+	static constexpr float SpreadAngleQuantizeScale = 100.0f;
+
+	enum ECompactHitFlags : uint8
+	{
+		HasActor = 1 << 0,
+		HasPhysMaterial = 1 << 1,
+		BlockingHit = 1 << 2,
+		HasComponent = 1 << 3,
+		HasBone = 1 << 4,
+
+		NumFlagBits = 5
+	};
+
+	static float SignNotZero(float Value)
+	{
+		return (Value >= 0.0f) ? 1.0f : -1.0f;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// FHaroHitscanFireInfo
+
+bool FHaroHitscanFireInfo::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bool bOriginSuccess = true;
+	bool bAimDirSuccess = true;
+	Origin.NetSerialize(Ar, Map, bOriginSuccess);
+	AimDir.NetSerialize(Ar, Map, bAimDirSuccess);
+
+	uint16 QuantizedSpread = 0;
+	if (Ar.IsSaving())
+	{
+		QuantizedSpread = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt32(SpreadHalfAngleDegrees * HaroHitscanTargetData::SpreadAngleQuantizeScale), 0, MAX_uint16));
+	}
+	Ar << QuantizedSpread;
+	if (Ar.IsLoading())
+	{
+		SpreadHalfAngleDegrees = static_cast<float>(QuantizedSpread) / HaroHitscanTargetData::SpreadAngleQuantizeScale;
+	}
+
+	Ar << CartridgeSeed;
+	Ar << NumPellets;
+
+	uint8 bHasShotIndex = (ShotIndex != 0) ? 1 : 0;
+	Ar.SerializeBits(&bHasShotIndex, 1);
+	if (bHasShotIndex)
+	{
+		Ar << ShotIndex;
+	}
+	else if (Ar.IsLoading())
+	{
+		ShotIndex = 0;
+	}
+
+	bOutSuccess = bOriginSuccess && bAimDirSuccess;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// FHaroCompactHitscanHit
+
+uint16 FHaroCompactHitscanHit::PackNormal(const FVector& Normal)
+{
+	using namespace HaroHitscanTargetData;
+
+	const FVector3f N = FVector3f(Normal.GetSafeNormal());
+	const float L1 = FMath::Abs(N.X) + FMath::Abs(N.Y) + FMath::Abs(N.Z);
+	if (L1 <= UE_SMALL_NUMBER)
+	{
+		return 0;
+	}
+
+	// 팔면체에 투영한 뒤 아래쪽 반구는 바깥으로 접음
+	float X = N.X / L1;
+	float Y = N.Y / L1;
+	if (N.Z < 0.0f)
+	{
+		const float OldX = X;
+		X = (1.0f - FMath::Abs(Y)) * SignNotZero(OldX);
+		Y = (1.0f - FMath::Abs(OldX)) * SignNotZero(Y);
+	}
+
+	const uint16 QuantizedX = static_cast<uint16>(FMath::RoundToInt32((X * 0.5f + 0.5f) * 255.0f));
+	const uint16 QuantizedY = static_cast<uint16>(FMath::RoundToInt32((Y * 0.5f + 0.5f) * 255.0f));
+	return static_cast<uint16>((QuantizedX << 8) | QuantizedY);
+}
+
+FVector FHaroCompactHitscanHit::UnpackNormal(uint16 Packed)
+{
+	using namespace HaroHitscanTargetData;
+
+	float X = (static_cast<float>(Packed >> 8) / 255.0f) * 2.0f - 1.0f;
+	float Y = (static_cast<float>(Packed & 0xFF) / 255.0f) * 2.0f - 1.0f;
+	const float Z = 1.0f - FMath::Abs(X) - FMath::Abs(Y);
+	if (Z < 0.0f)
+	{
+		const float OldX = X;
+		X = (1.0f - FMath::Abs(Y)) * SignNotZero(OldX);
+		Y = (1.0f - FMath::Abs(OldX)) * SignNotZero(Y);
+	}
+
+	return FVector(X, Y, Z).GetSafeNormal();
+}
+
+bool FHaroCompactHitscanHit::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	using namespace HaroHitscanTargetData;
+
+	uint8 Flags = 0;
+	if (Ar.IsSaving())
+	{
+		Flags |= HitActor.IsValid() ? HasActor : 0;
+		Flags |= PhysMaterial.IsValid() ? HasPhysMaterial : 0;
+		Flags |= bBlockingHit ? BlockingHit : 0;
+		Flags |= HitComponent.IsValid() ? HasComponent : 0;
+		Flags |= (BoneIndex != INDEX_NONE) ? HasBone : 0;
+	}
+	Ar.SerializeBits(&Flags, NumFlagBits);
+
+	if (Flags & HasActor)
+	{
+		Ar << HitActor;
+	}
+	else if (Ar.IsLoading())
+	{
+		HitActor.Reset();
+	}
+
+	if (Flags & HasPhysMaterial)
+	{
+		Ar << PhysMaterial;
+	}
+	else if (Ar.IsLoading())
+	{
+		PhysMaterial.Reset();
+	}
+
+	if (Flags & HasComponent)
+	{
+		Ar << HitComponent;
+	}
+	else if (Ar.IsLoading())
+	{
+		HitComponent.Reset();
+	}
+
+	if (Flags & HasBone)
+	{
+		// 대부분 본이 128개 미만이라 1바이트로 끝남
+		uint32 PackedBoneIndex = static_cast<uint32>(FMath::Max<int32>(BoneIndex, 0));
+		Ar.SerializeIntPacked(PackedBoneIndex);
+		if (Ar.IsLoading())
+		{
+			BoneIndex = static_cast<int16>(FMath::Min<uint32>(PackedBoneIndex, MAX_int16));
+		}
+	}
+	else if (Ar.IsLoading())
+	{
+		BoneIndex = INDEX_NONE;
+	}
+
+	bBlockingHit = (Flags & BlockingHit) != 0;
+
+	ImpactOffset.NetSerialize(Ar, Map, bOutSuccess);
+	Ar << PackedNormal;
+	Ar << PelletIndex;
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// FHaroGameplayAbilityTargetData_HitscanCartridge
+
+void FHaroGameplayAbilityTargetData_HitscanCartridge::AddHit(const FHitResult& HitResult, uint8 PelletIndex)
+{
+	FHaroCompactHitscanHit& Hit = Hits.AddDefaulted_GetRef();
+	Hit.HitActor = HitResult.GetActor();
+	Hit.PhysMaterial = HitResult.PhysMaterial;
+
+	// 루트 컴포넌트는 받는 쪽에서 채울 수 있으므로 보내지 않음
+	UPrimitiveComponent* HitComponent = HitResult.GetComponent();
+	if (HitComponent && (HitComponent != (Hit.HitActor.IsValid() ? Hit.HitActor->GetRootComponent() : nullptr)))
+	{
+		Hit.HitComponent = HitComponent;
+	}
+
+	if (const USkinnedMeshComponent* SkinnedMesh = Cast<USkinnedMeshComponent>(HitComponent))
+	{
+		const int32 BoneIndex = (HitResult.BoneName != NAME_None) ? SkinnedMesh->GetBoneIndex(HitResult.BoneName) : INDEX_NONE;
+		Hit.BoneIndex = ((BoneIndex != INDEX_NONE) && (BoneIndex <= MAX_int16)) ? static_cast<int16>(BoneIndex) : INDEX_NONE;
+	}
+
+	Hit.ImpactOffset = HitResult.ImpactPoint - FVector(FireInfo.Origin);
+	Hit.PackedNormal = FHaroCompactHitscanHit::PackNormal(HitResult.ImpactNormal);
+	Hit.PelletIndex = PelletIndex;
+	Hit.bBlockingHit = HitResult.bBlockingHit;
+}
+
+void FHaroGameplayAbilityTargetData_HitscanCartridge::MakeHitResult(int32 HitIndex, FHitResult& OutHitResult) const
+{
+	const FHaroCompactHitscanHit& Hit = Hits[HitIndex];
+
+	const FVector Origin = FireInfo.Origin;
+	const FVector ImpactPoint = Origin + FVector(Hit.ImpactOffset);
+	const FVector ImpactNormal = FHaroCompactHitscanHit::UnpackNormal(Hit.PackedNormal);
+
+	OutHitResult = FHitResult(ForceInit);
+	OutHitResult.TraceStart = Origin;
+	OutHitResult.TraceEnd = ImpactPoint;
+	OutHitResult.Location = ImpactPoint;
+	OutHitResult.ImpactPoint = ImpactPoint;
+	OutHitResult.Normal = ImpactNormal;
+	OutHitResult.ImpactNormal = ImpactNormal;
+	OutHitResult.Distance = FVector(Hit.ImpactOffset).Size();
+	OutHitResult.bBlockingHit = Hit.bBlockingHit;
+	OutHitResult.PhysMaterial = Hit.PhysMaterial;
+
+	if (AActor* HitActor = Hit.HitActor.Get())
+	{
+		OutHitResult.HitObjectHandle = FActorInstanceHandle(HitActor);
+		OutHitResult.Component = Hit.HitComponent.IsValid() ? Hit.HitComponent.Get() : Cast<UPrimitiveComponent>(HitActor->GetRootComponent());
+	}
+
+	// 같은 스켈레탈 메시 에셋이면 본 인덱스가 같으므로 이름으로 되돌림
+	if (const USkinnedMeshComponent* SkinnedMesh = Cast<USkinnedMeshComponent>(OutHitResult.Component.Get()))
+	{
+		if ((Hit.BoneIndex != INDEX_NONE) && (Hit.BoneIndex < SkinnedMesh->GetNumBones()))
+		{
+			OutHitResult.BoneName = SkinnedMesh->GetBoneName(Hit.BoneIndex);
+		}
+	}
+}
+
+bool FHaroGameplayAbilityTargetData_HitscanCartridge::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	bool bFireInfoSuccess = true;
+	FireInfo.NetSerialize(Ar, Map, bFireInfoSuccess);
+
+	Ar << Timestamp;
+
+	uint8 NumHits = static_cast<uint8>(FMath::Min(Hits.Num(), 255));
+	Ar << NumHits;
+	if (Ar.IsLoading())
+	{
+		Hits.SetNum(NumHits);
+	}
+
+	for (int32 HitIndex = 0; HitIndex < NumHits; ++HitIndex)
+	{
+		bool bHitSuccess = true;
+		Hits[HitIndex].NetSerialize(Ar, Map, bHitSuccess);
+		bOutSuccess &= bHitSuccess;
+	}
+
+	bOutSuccess &= bFireInfoSuccess;
+	return true;
+}
+
+bool FHaroGameplayAbilityTargetData_HitscanCartridge::ExpandHandle(FGameplayAbilityTargetDataHandle& Handle, FHaroHitscanFireInfo& OutFireInfo, TArray<TSharedPtr<FLyraGameplayAbilityTargetData_SingleTargetHit>>& HitPool)
+{
+	for (int32 DataIdx = 0; DataIdx < Handle.Data.Num(); ++DataIdx)
+	{
+		const FGameplayAbilityTargetData* Data = Handle.Get(DataIdx);
+		if ((Data == nullptr) || (Data->GetScriptStruct() != FHaroGameplayAbilityTargetData_HitscanCartridge::StaticStruct()))
+		{
+			continue;
+		}
+
+		// 목록에서 빼는 동안 카트리지가 사라지지 않도록 잡아둠
+		const TSharedPtr<FGameplayAbilityTargetData> CartridgeData = Handle.Data[DataIdx];
+		const FHaroGameplayAbilityTargetData_HitscanCartridge* Cartridge = static_cast<const FHaroGameplayAbilityTargetData_HitscanCartridge*>(CartridgeData.Get());
+
+		OutFireInfo = Cartridge->FireInfo;
+
+		// 카트리지 자리에 히트 수만큼 칸을 만들어 두고 채움
+		const int32 NumHits = Cartridge->Hits.Num();
+		if (NumHits == 0)
+		{
+			Handle.Data.RemoveAt(DataIdx);
+			return true;
+		}
+		Handle.Data.InsertDefaulted(DataIdx + 1, NumHits - 1);
+
+		for (int32 HitIndex = 0; HitIndex < NumHits; ++HitIndex)
+		{
+			TSharedPtr<FLyraGameplayAbilityTargetData_SingleTargetHit>& PooledHit = HitPool.IsValidIndex(HitIndex) ? HitPool[HitIndex] : HitPool.AddDefaulted_GetRef();
+
+			// 지난 발사의 핸들을 누가 아직 들고 있으면 (블루프린트가 보관한 경우 등) 덮어쓰지 않고 새로 만듦
+			if (!PooledHit.IsValid() || !PooledHit.IsUnique())
+			{
+				PooledHit = MakeShared<FLyraGameplayAbilityTargetData_SingleTargetHit>();
+			}
+
+			FLyraGameplayAbilityTargetData_SingleTargetHit& SingleTargetHit = *PooledHit;
+			Cartridge->MakeHitResult(HitIndex, /*out*/ SingleTargetHit.HitResult);
+			SingleTargetHit.bHitReplaced = false;
+			SingleTargetHit.CartridgeID = static_cast<int32>(Cartridge->FireInfo.CartridgeSeed);
+			SingleTargetHit.Timestamp = Cartridge->Timestamp;
+			SingleTargetHit.PelletIndex = Cartridge->Hits[HitIndex].PelletIndex;
+
+			Handle.Data[DataIdx + HitIndex] = PooledHit;
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////
+// 직렬화 크기 비교
+
+#if !UE_BUILD_SHIPPING
+namespace HaroHitscanTargetData
+{
+	static int64 MeasureHandleBits(FGameplayAbilityTargetDataHandle& Handle, UPackageMap* Map)
+	{
+		FNetBitWriter Writer(Map, 8192);
+		bool bSuccess = true;
+		Handle.NetSerialize(Writer, Map, bSuccess);
+		return Writer.GetNumBits();
+	}
+
+	static void CompareTargetDataSizes(const TArray<FString>& Args, UWorld* World)
+	{
+		int32 NumHits = 8;
+		if (Args.Num() > 0)
+		{
+			LexTryParseString<int32>(NumHits, *Args[0]);
+		}
+		NumHits = FMath::Clamp(NumHits, 1, 255);
+
+		// 액터/물리 재질 참조를 실제로 직렬화하려면 연결의 패키지 맵이 필요함
+		UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+		UNetConnection* Connection = nullptr;
+		if (NetDriver)
+		{
+			Connection = NetDriver->ServerConnection ? NetDriver->ServerConnection.Get() : (NetDriver->ClientConnections.Num() > 0 ? NetDriver->ClientConnections[0].Get() : nullptr);
+		}
+
+		if ((Connection == nullptr) || (Connection->PackageMap == nullptr))
+		{
+			UE_LOG(LogLyra, Warning, TEXT("Haro.Weapon.CompareHitscanTargetDataSize needs a networked session (no connection to serialize with)"));
+			return;
+		}
+
+		APawn* HitPawn = nullptr;
+		for (TActorIterator<APawn> It(World); It; ++It)
+		{
+			HitPawn = *It;
+			break;
+		}
+
+		UPhysicalMaterial* HitPhysMaterial = GEngine ? GEngine->DefaultPhysMaterial.Get() : nullptr;
+
+		// 산탄총 한 발 정도의 가짜 히트들
+		FRandomStream RandomStream(12345);
+		const FVector Origin(120.0f, -340.0f, 160.0f);
+		const FVector AimDir = FVector(1.0f, 0.2f, -0.05f).GetSafeNormal();
+
+		FGameplayAbilityTargetDataHandle PerHitHandle;
+
+		FHaroGameplayAbilityTargetData_HitscanCartridge* Cartridge = new FHaroGameplayAbilityTargetData_HitscanCartridge();
+		Cartridge->FireInfo.Origin = Origin;
+		Cartridge->FireInfo.AimDir = AimDir;
+		Cartridge->FireInfo.SpreadHalfAngleDegrees = 4.0f;
+		Cartridge->FireInfo.CartridgeSeed = RandomStream.GetUnsignedInt();
+		Cartridge->FireInfo.NumPellets = static_cast<uint8>(NumHits);
+		Cartridge->Timestamp = 123.456;
+
+		for (int32 HitIndex = 0; HitIndex < NumHits; ++HitIndex)
+		{
+			const FVector PelletDir = RandomStream.VRandCone(AimDir, FMath::DegreesToRadians(4.0f));
+			const FVector ImpactPoint = Origin + PelletDir * RandomStream.FRandRange(300.0f, 3000.0f);
+
+			FHitResult HitResult(ForceInit);
+			HitResult.TraceStart = Origin;
+			HitResult.TraceEnd = Origin + PelletDir * 10000.0f;
+			HitResult.Location = ImpactPoint;
+			HitResult.ImpactPoint = ImpactPoint;
+			HitResult.Normal = -PelletDir;
+			HitResult.ImpactNormal = -PelletDir;
+			HitResult.bBlockingHit = true;
+			HitResult.PhysMaterial = HitPhysMaterial;
+			if (HitPawn)
+			{
+				USkeletalMeshComponent* HitMesh = HitPawn->FindComponentByClass<USkeletalMeshComponent>();
+				HitResult.HitObjectHandle = FActorInstanceHandle(HitPawn);
+				HitResult.Component = HitMesh ? HitMesh : Cast<UPrimitiveComponent>(HitPawn->GetRootComponent());
+				if (HitMesh && (HitMesh->GetNumBones() > 0))
+				{
+					HitResult.BoneName = HitMesh->GetBoneName(RandomStream.RandHelper(HitMesh->GetNumBones()));
+				}
+			}
+
+			FLyraGameplayAbilityTargetData_SingleTargetHit* SingleTargetHit = new FLyraGameplayAbilityTargetData_SingleTargetHit();
+			SingleTargetHit->HitResult = HitResult;
+			SingleTargetHit->CartridgeID = static_cast<int32>(Cartridge->FireInfo.CartridgeSeed);
+			SingleTargetHit->Timestamp = Cartridge->Timestamp;
+			SingleTargetHit->PelletIndex = static_cast<uint8>(HitIndex);
+			PerHitHandle.Add(SingleTargetHit);
+
+			Cartridge->AddHit(HitResult, static_cast<uint8>(HitIndex));
+		}
+
+		FGameplayAbilityTargetDataHandle CartridgeHandle(Cartridge);
+
+		const int64 PerHitBits = MeasureHandleBits(PerHitHandle, Connection->PackageMap);
+		const int64 CartridgeBits = MeasureHandleBits(CartridgeHandle, Connection->PackageMap);
+
+		// 복원 오차 (양자화로 잃는 정도)
+		float MaxPointError = 0.0f;
+		float MaxNormalErrorDegrees = 0.0f;
+		for (int32 HitIndex = 0; HitIndex < NumHits; ++HitIndex)
+		{
+			const FHitResult& Original = *PerHitHandle.Get(HitIndex)->GetHitResult();
+
+			FHitResult Restored;
+			Cartridge->MakeHitResult(HitIndex, /*out*/ Restored);
+
+			MaxPointError = FMath::Max(MaxPointError, static_cast<float>(FVector::Dist(Original.ImpactPoint, Restored.ImpactPoint)));
+			const float NormalDot = FMath::Clamp(static_cast<float>(FVector::DotProduct(Original.ImpactNormal, Restored.ImpactNormal)), -1.0f, 1.0f);
+			MaxNormalErrorDegrees = FMath::Max(MaxNormalErrorDegrees, FMath::RadiansToDegrees(FMath::Acos(NormalDot)));
+
+			ensureMsgf((Original.GetComponent() == Restored.GetComponent()) && (Original.BoneName == Restored.BoneName) && (Original.PhysMaterial == Restored.PhysMaterial),
+				TEXT("Compact hit %d lost its component, bone or physical material"), HitIndex);
+		}
+
+		UE_LOG(LogLyra, Display, TEXT("Hitscan target data for %d hits:"), NumHits);
+		UE_LOG(LogLyra, Display, TEXT("  Per-hit SingleTargetHit : %lld bytes (%.1f bytes/hit), %d target data allocations per shot on each side"),
+			(PerHitBits + 7) / 8, static_cast<double>(PerHitBits) / 8.0 / NumHits, NumHits);
+		UE_LOG(LogLyra, Display, TEXT("  Compact cartridge       : %lld bytes (%.1f bytes/hit), cartridge + hit array per shot, expanded into %d pooled SingleTargetHit entries (allocated only on first use)"),
+			(CartridgeBits + 7) / 8, static_cast<double>(CartridgeBits) / 8.0 / NumHits, NumHits);
+		UE_LOG(LogLyra, Display, TEXT("  Saved %.1f%%, max impact point error %.2f uu, max normal error %.2f deg"),
+			(PerHitBits > 0) ? (100.0 * (1.0 - static_cast<double>(CartridgeBits) / static_cast<double>(PerHitBits))) : 0.0, MaxPointError, MaxNormalErrorDegrees);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs HaroCompareHitscanTargetDataSizeCmd(
+	TEXT("Haro.Weapon.CompareHitscanTargetDataSize"),
+	TEXT("Serializes a synthetic cartridge as per-hit SingleTargetHit data and as one compact cartridge, then logs both sizes. Usage: Haro.Weapon.CompareHitscanTargetDataSize [NumHits=8] (needs a networked session)"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&HaroHitscanTargetData::CompareTargetDataSizes));
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,170 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Abilities/GameplayAbilityTargetTypes.h"
+#include "Engine/NetSerialization.h"
+
+#include "HaroHitscanTargetData.generated.h"
+
+class AActor;
+class FArchive;
+class UPackageMap;
+class UPhysicalMaterial;
+class UPrimitiveComponent;
+struct FLyraGameplayAbilityTargetData_SingleTargetHit;
+
+/**
+ * 히트스캔 카트리지 한 발의 발사 정보
+ * 서버는 이 정보와 카트리지 시드로 펠릿 방향을 다시 만들어서 각 히트가 자기 펠릿 광선 위에 있는지 확인함.
+ */
+USTRUCT()
+struct FHaroHitscanFireInfo
+{
+	GENERATED_BODY()
+
+	/** 트레이스 시작 위치 */
+	UPROPERTY()
+	FVector_NetQuantize10 Origin;
+
+	/** 탄퍼짐 적용 전 조준 방향 */
+	UPROPERTY()
+	FVector_NetQuantizeNormal AimDir;
+
+	/** 발사 시점의 탄퍼짐 반각 (0.01도 단위로 양자화해서 보냄) */
+	UPROPERTY()
+	float SpreadHalfAngleDegrees = 0.0f;
+
+	/** FHaroSpreadRandom::MakeCartridgeSeed 결과 (CartridgeID로도 사용) */
+	UPROPERTY()
+	uint32 CartridgeSeed = 0;
+
+	UPROPERTY()
+	uint8 NumPellets = 0;
+
+	/** 연사 모드에서 활성화 안의 몇 번째 발인지 (단발은 항상 0, 0이면 비트 하나만 보냄) */
+	UPROPERTY()
+	uint16 ShotIndex = 0;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+/**
+ * 양자화된 히트 하나
+ * FHitResult 전체 대신 데미지/검증/이펙트에 필요한 것만 보냄.
+ */
+USTRUCT()
+struct FHaroCompactHitscanHit
+{
+	GENERATED_BODY()
+
+	/** 맞은 액터 (넷 GUID로 직렬화, 없으면 비트 하나) */
+	UPROPERTY()
+	TWeakObjectPtr<AActor> HitActor;
+
+	/** 약점/재질 배율 계산용 물리 재질 (넷 GUID로 직렬화, 없으면 비트 하나) */
+	UPROPERTY()
+	TWeakObjectPtr<UPhysicalMaterial> PhysMaterial;
+
+	/** 맞은 컴포넌트 (넷 GUID로 직렬화, 루트 컴포넌트면 비트 하나만 보내고 받는 쪽에서 루트로 채움) */
+	UPROPERTY()
+	TWeakObjectPtr<UPrimitiveComponent> HitComponent;
+
+	/** 맞은 컴포넌트가 스킨드 메시면 본 인덱스 (헤드샷 판정용, INDEX_NONE이면 비트 하나) */
+	UPROPERTY()
+	int16 BoneIndex = INDEX_NONE;
+
+	/** 발사 위치 기준 상대 위치 (0.1uu 단위, 가까울수록 비트가 적게 듦) */
+	UPROPERTY()
+	FVector_NetQuantize10 ImpactOffset;
+
+	/** 옥타헤드럴 인코딩한 법선 (축당 8비트) */
+	UPROPERTY()
+	uint16 PackedNormal = 0;
+
+	UPROPERTY()
+	uint8 PelletIndex = 0;
+
+	UPROPERTY()
+	bool bBlockingHit = false;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	static uint16 PackNormal(const FVector& Normal);
+	static FVector UnpackNormal(uint16 Packed);
+};
+
+/**
+ * 카트리지 전체를 담는 히트스캔 타겟 데이터
+ *
+ * 펠릿마다 FLyraGameplayAbilityTargetData_SingleTargetHit(FHitResult 전체)를 힙에 하나씩 만들어 보내는 대신,
+ * 발사 정보 + 양자화된 히트 배열을 객체 하나에 담아 보냄.
+ * 받는 쪽에서 ExpandHandle로 히트 단위 타겟 데이터로 풀어서 기존 경로(히트 마커, 블루프린트, 데미지)에 넘김.
+ * (풀 때 쓰는 히트 객체는 호출자의 풀에서 재사용하므로 발사마다 새로 할당하지 않음)
+ */
+USTRUCT()
+struct FHaroGameplayAbilityTargetData_HitscanCartridge : public FGameplayAbilityTargetData
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FHaroHitscanFireInfo FireInfo;
+
+	/** 클라이언트가 쏜 시점의 서버 월드 시간 (랙 보정용) */
+	UPROPERTY()
+	double Timestamp = 0.0;
+
+	UPROPERTY()
+	TArray<FHaroCompactHitscanHit> Hits;
+
+	void AddHit(const FHitResult& HitResult, uint8 PelletIndex);
+
+	/** 양자화된 히트를 FHitResult로 복원 */
+	void MakeHitResult(int32 HitIndex, FHitResult& OutHitResult) const;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	virtual FString ToString() const override
+	{
+		return TEXT("FHaroGameplayAbilityTargetData_HitscanCartridge");
+	}
+
+	virtual UScriptStruct* GetScriptStruct() const override
+	{
+		return FHaroGameplayAbilityTargetData_HitscanCartridge::StaticStruct();
+	}
+
+	/**
+	 * 타겟 데이터 안의 카트리지를 히트마다 FLyraGameplayAbilityTargetData_SingleTargetHit 하나로 풀어서 교체
+	 * HitPool의 항목을 재사용하고, 이전 핸들이 아직 잡고 있는 항목만 새로 만듦
+	 * 카트리지가 없으면 false
+	 */
+	static bool ExpandHandle(FGameplayAbilityTargetDataHandle& Handle, FHaroHitscanFireInfo& OutFireInfo, TArray<TSharedPtr<FLyraGameplayAbilityTargetData_SingleTargetHit>>& HitPool);
+};
+
+template<>
+struct TStructOpsTypeTraits<FHaroHitscanFireInfo> : public TStructOpsTypeTraitsBase2<FHaroHitscanFireInfo>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+template<>
+struct TStructOpsTypeTraits<FHaroCompactHitscanHit> : public TStructOpsTypeTraitsBase2<FHaroCompactHitscanHit>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+template<>
+struct TStructOpsTypeTraits<FHaroGameplayAbilityTargetData_HitscanCartridge> : public TStructOpsTypeTraitsBase2<FHaroGameplayAbilityTargetData_HitscanCartridge>
+{
+	enum
+	{
+		WithNetSerializer = true	// FGameplayAbilityTargetDataHandle 직렬화에 필요
+	};
+};
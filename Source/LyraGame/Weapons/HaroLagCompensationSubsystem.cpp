@@ -0,0 +1,321 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HaroLagCompensationSubsystem.h"
+
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
+#include "LyraLogChannels.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HaroLagCompensationSubsystem)
+
+namespace HaroConsoleVariables
+{
+	static bool bEnableLagCompensation = true;
+	static FAutoConsoleVariableRef CVarEnableLagCompensation(
+		TEXT("Haro.LagCompensation.Enable"),
+		bEnableLagCompensation,
+		TEXT("Should the server re-validate client hitscan hits against rewound pawn hitboxes"),
+		ECVF_Default);
+
+	static float MaxRewindSeconds = 0.25f;
+	static FAutoConsoleVariableRef CVarMaxRewindSeconds(
+		TEXT("Haro.LagCompensation.MaxRewindSeconds"),
+		MaxRewindSeconds,
+		TEXT("Latency budget: how far back (in seconds) the server is willing to rewind to validate a hit"),
+		ECVF_Default);
+
+	static float HitboxTolerance = 30.0f;
+	static FAutoConsoleVariableRef CVarHitboxTolerance(
+		TEXT("Haro.LagCompensation.HitboxTolerance"),
+		HitboxTolerance,
+		TEXT("Extra distance (in uu) allowed between a client impact point and the rewound hitbox"),
+		ECVF_Default);
+
+	static float InterpDelaySeconds = 0.1f;
+	static FAutoConsoleVariableRef CVarInterpDelaySeconds(
+		TEXT("Haro.LagCompensation.InterpDelay"),
+		InterpDelaySeconds,
+		TEXT("How far behind the server (in seconds) remote clients render simulated pawns, added to RTT/2 when estimating the client fire time"),
+		ECVF_Default);
+
+	static float ClientTimeTolerance = 0.05f;
+	static FAutoConsoleVariableRef CVarClientTimeTolerance(
+		TEXT("Haro.LagCompensation.ClientTimeTolerance"),
+		ClientTimeTolerance,
+		TEXT("How far (in seconds) a reported client fire time may drift from the server's estimate before it is clamped"),
+		ECVF_Default);
+}
+
+UHaroLagCompensationSubsystem::UHaroLagCompensationSubsystem()
+{
+	static_assert(FMath::IsPowerOfTwo(MaxHistoryFrames), "MaxHistoryFrames must be a power of two");
+}
+
+void UHaroLagCompensationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// 모든 버퍼는 여기서 한 번만 할당
+	FrameTimes.SetNumZeroed(MaxHistoryFrames);
+	SampleLocations.SetNumZeroed(MaxHistoryFrames * MaxTrackedPawns);
+	SampleHalfHeights.SetNumZeroed(MaxHistoryFrames * MaxTrackedPawns);
+
+	SlotPawns.SetNum(MaxTrackedPawns);
+	SlotRadii.SetNumZeroed(MaxTrackedPawns);
+	SlotValidSince.SetNumZeroed(MaxTrackedPawns);
+
+	ActiveSlots.Reserve(MaxTrackedPawns);
+	FreeSlots.Reserve(MaxTrackedPawns);
+	for (int32 Slot = MaxTrackedPawns - 1; Slot >= 0; --Slot)
+	{
+		FreeSlots.Add(Slot);
+	}
+}
+
+void UHaroLagCompensationSubsystem::Deinitialize()
+{
+	PawnToSlot.Reset();
+	ActiveSlots.Reset();
+	FreeSlots.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UHaroLagCompensationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+ETickableTickType UHaroLagCompensationSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UHaroLagCompensationSubsystem::IsTickable() const
+{
+	// 클라이언트는 기록할 필요 없음
+	const UWorld* World = GetWorld();
+	return (World != nullptr) && (World->GetNetMode() != NM_Client) && (ActiveSlots.Num() > 0);
+}
+
+TStatId UHaroLagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHaroLagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+void UHaroLagCompensationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	RecordFrame(GetWorld()->GetTimeSeconds());
+}
+
+void UHaroLagCompensationSubsystem::RegisterPawn(APawn* Pawn)
+{
+	if (!Pawn || PawnToSlot.Contains(Pawn))
+	{
+		return;
+	}
+
+	if (FreeSlots.Num() == 0)
+	{
+		UE_LOG(LogLyra, Warning, TEXT("UHaroLagCompensationSubsystem: no free slot for %s (MaxTrackedPawns=%d), its hits won't be validated"), *GetNameSafe(Pawn), MaxTrackedPawns);
+		return;
+	}
+
+	const int32 Slot = FreeSlots.Pop(EAllowShrinking::No);
+	PawnToSlot.Add(Pawn, Slot);
+	ActiveSlots.Add(Slot);
+
+	SlotPawns[Slot] = Pawn;
+	SlotRadii[Slot] = 0.0f;
+
+	// 다음에 기록되는 프레임부터 유효
+	SlotValidSince[Slot] = TNumericLimits<double>::Max();
+}
+
+void UHaroLagCompensationSubsystem::UnregisterPawn(APawn* Pawn)
+{
+	int32 Slot = INDEX_NONE;
+	if (PawnToSlot.RemoveAndCopyValue(Pawn, Slot))
+	{
+		SlotPawns[Slot].Reset();
+		ActiveSlots.RemoveSingleSwap(Slot, EAllowShrinking::No);
+		FreeSlots.Add(Slot);
+	}
+}
+
+void UHaroLagCompensationSubsystem::RecordFrame(double WorldTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_HaroLagCompensation_RecordFrame);
+
+	HeadFrame = (HeadFrame + 1) & (MaxHistoryFrames - 1);
+	NumRecordedFrames = FMath::Min(NumRecordedFrames + 1, MaxHistoryFrames);
+	FrameTimes[HeadFrame] = WorldTime;
+
+	const int32 FrameBase = GetSampleIndex(HeadFrame, 0);
+
+	for (int32 ActiveIndex = ActiveSlots.Num() - 1; ActiveIndex >= 0; --ActiveIndex)
+	{
+		const int32 Slot = ActiveSlots[ActiveIndex];
+
+		const APawn* Pawn = SlotPawns[Slot].Get();
+		if (Pawn == nullptr)
+		{
+			// EndPlay 없이 사라진 폰
+			for (auto It = PawnToSlot.CreateIterator(); It; ++It)
+			{
+				if (It.Value() == Slot)
+				{
+					It.RemoveCurrent();
+					break;
+				}
+			}
+			ActiveSlots.RemoveAtSwap(ActiveIndex, 1, EAllowShrinking::No);
+			FreeSlots.Add(Slot);
+			continue;
+		}
+
+		if (const UCapsuleComponent* Capsule = Cast<UCapsuleComponent>(Pawn->GetRootComponent()))
+		{
+			SampleLocations[FrameBase + Slot] = FVector3f(Capsule->GetComponentLocation());
+			SampleHalfHeights[FrameBase + Slot] = Capsule->GetScaledCapsuleHalfHeight();
+			SlotRadii[Slot] = Capsule->GetScaledCapsuleRadius();
+		}
+		else
+		{
+			SampleLocations[FrameBase + Slot] = FVector3f(Pawn->GetActorLocation());
+
+			float Radius;
+			float HalfHeight;
+			Pawn->GetSimpleCollisionCylinder(/*out*/ Radius, /*out*/ HalfHeight);
+			SampleHalfHeights[FrameBase + Slot] = HalfHeight;
+			SlotRadii[Slot] = Radius;
+		}
+
+		if (SlotValidSince[Slot] > WorldTime)
+		{
+			SlotValidSince[Slot] = WorldTime;
+		}
+	}
+}
+
+bool UHaroLagCompensationSubsystem::FindRewindFrames(double Time, int32& OutOlderFrame, int32& OutNewerFrame, float& OutAlpha) const
+{
+	if (NumRecordedFrames == 0)
+	{
+		return false;
+	}
+
+	// 최근 프레임부터 거꾸로 탐색
+	int32 NewerFrame = HeadFrame;
+	if (Time >= FrameTimes[NewerFrame])
+	{
+		OutOlderFrame = NewerFrame;
+		OutNewerFrame = NewerFrame;
+		OutAlpha = 0.0f;
+		return true;
+	}
+
+	for (int32 Step = 1; Step < NumRecordedFrames; ++Step)
+	{
+		const int32 OlderFrame = (HeadFrame - Step) & (MaxHistoryFrames - 1);
+		const double OlderTime = FrameTimes[OlderFrame];
+		if (Time >= OlderTime)
+		{
+			const double Span = FrameTimes[NewerFrame] - OlderTime;
+			OutOlderFrame = OlderFrame;
+			OutNewerFrame = NewerFrame;
+			OutAlpha = (Span > UE_SMALL_NUMBER) ? static_cast<float>((Time - OlderTime) / Span) : 0.0f;
+			return true;
+		}
+		NewerFrame = OlderFrame;
+	}
+
+	return false;
+}
+
+double UHaroLagCompensationSubsystem::GetEstimatedViewDelay(const APawn* Shooter)
+{
+	// 서버에서 직접 조종하는 폰(호스트, 봇)은 서버 시간 그대로 봄
+	if ((Shooter == nullptr) || Shooter->IsLocallyControlled())
+	{
+		return 0.0;
+	}
+
+	const APlayerState* PlayerState = Shooter->GetPlayerState();
+	const double RoundTripSeconds = PlayerState ? (PlayerState->GetPingInMilliseconds() * 0.001) : 0.0;
+
+	return (RoundTripSeconds * 0.5) + HaroConsoleVariables::InterpDelaySeconds;
+}
+
+EHaroHitValidationResult UHaroLagCompensationSubsystem::ValidateHit(const AActor* HitActor, const FVector& ImpactPoint, double ClientFireTime, const APawn* Shooter) const
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_HaroLagCompensation_ValidateHit);
+
+	if (!HaroConsoleVariables::bEnableLagCompensation || (HitActor == nullptr))
+	{
+		return EHaroHitValidationResult::NotTracked;
+	}
+
+	// 폰에 붙은 액터(무기 등)를 맞췄으면 부모 폰으로 검증
+	const APawn* HitPawn = Cast<APawn>(HitActor);
+	if ((HitPawn == nullptr) && (HitActor->GetAttachParentActor() != nullptr))
+	{
+		HitPawn = Cast<APawn>(HitActor->GetAttachParentActor());
+	}
+
+	const int32* pSlot = HitPawn ? PawnToSlot.Find(HitPawn) : nullptr;
+	if (pSlot == nullptr)
+	{
+		return EHaroHitValidationResult::NotTracked;
+	}
+	const int32 Slot = *pSlot;
+
+	// 클라이언트가 보낸 시각은 그대로 믿지 않고, 서버가 추정한 클라이언트 시각(RTT/2 + 보간 지연) 근처로 제한
+	const double Now = GetWorld()->GetTimeSeconds();
+	const double EstimatedFireTime = Now - GetEstimatedViewDelay(Shooter);
+	const double FireTime = FMath::Clamp(ClientFireTime,
+		EstimatedFireTime - HaroConsoleVariables::ClientTimeTolerance,
+		FMath::Min(EstimatedFireTime + HaroConsoleVariables::ClientTimeTolerance, Now));
+
+	// 지연 예산을 넘어선 히트는 거부
+	if ((Now - FireTime) > HaroConsoleVariables::MaxRewindSeconds)
+	{
+		return EHaroHitValidationResult::RejectedTooOld;
+	}
+
+	// 슬롯이 현재 폰에 할당되기 전의 프레임은 사용할 수 없음
+	const double RewindTime = FMath::Clamp(FireTime, SlotValidSince[Slot], Now);
+
+	int32 OlderFrame;
+	int32 NewerFrame;
+	float Alpha;
+	if (!FindRewindFrames(RewindTime, /*out*/ OlderFrame, /*out*/ NewerFrame, /*out*/ Alpha))
+	{
+		// 아직 기록이 없으면 검증할 수 없음
+		return EHaroHitValidationResult::NotTracked;
+	}
+
+	const int32 OlderIndex = GetSampleIndex(OlderFrame, Slot);
+	const int32 NewerIndex = GetSampleIndex(NewerFrame, Slot);
+
+	const FVector Center = FVector(FMath::Lerp(SampleLocations[OlderIndex], SampleLocations[NewerIndex], Alpha));
+	const float HalfHeight = FMath::Lerp(SampleHalfHeights[OlderIndex], SampleHalfHeights[NewerIndex], Alpha);
+	const float Radius = SlotRadii[Slot];
+
+	// 캡슐 = 선분 + 반지름
+	const FVector SegmentOffset(0.0, 0.0, FMath::Max(HalfHeight - Radius, 0.0f));
+	const FVector ClosestPoint = FMath::ClosestPointOnSegment(ImpactPoint, Center - SegmentOffset, Center + SegmentOffset);
+	const double AllowedDistance = Radius + HaroConsoleVariables::HitboxTolerance;
+
+	if (FVector::DistSquared(ImpactPoint, ClosestPoint) > FMath::Square(AllowedDistance))
+	{
+		return EHaroHitValidationResult::RejectedOutsideHitbox;
+	}
+
+	return EHaroHitValidationResult::Accepted;
+}
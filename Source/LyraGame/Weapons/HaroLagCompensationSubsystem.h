@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+
+#include "HaroLagCompensationSubsystem.generated.h"
+
+class APawn;
+class UObject;
+
+/** 서버 히트 검증 결과 */
+enum class EHaroHitValidationResult : uint8
+{
+	// 리와인드된 히트박스와 일치함
+	Accepted,
+	// 기록되지 않은 대상이라 검증할 수 없음 (월드 지형, 등록되지 않은 액터 등) - 신뢰함
+	NotTracked,
+	// 클라이언트 발사 시각이 허용 지연 범위를 벗어남
+	RejectedTooOld,
+	// 리와인드된 히트박스에서 임팩트 지점이 너무 멂
+	RejectedOutsideHitbox,
+};
+
+/**
+ * 서버에서 매 틱 폰 히트박스(캡슐)를 기록해 두고,
+ * 클라이언트가 보낸 히트를 발사 시각 기준으로 되감아서 검증하는 서브시스템
+ *
+ * 기록은 고정 크기 링 버퍼에 SoA(프레임 단위 연속 블록)로 저장하므로
+ * 틱당 기록 비용은 등록된 폰 수에만 비례하고 할당이 발생하지 않음
+ */
+UCLASS()
+class LYRAGAME_API UHaroLagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** 링 버퍼에 보관하는 프레임 수 (2의 거듭제곱) */
+	static constexpr int32 MaxHistoryFrames = 64;
+
+	/** 동시에 추적할 수 있는 최대 폰 수 */
+	static constexpr int32 MaxTrackedPawns = 64;
+
+	UHaroLagCompensationSubsystem();
+
+	//~USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	//~FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	//~End of FTickableGameObject interface
+
+	/** 히트박스 기록 대상으로 등록 (서버에서만 의미 있음) */
+	void RegisterPawn(APawn* Pawn);
+	void UnregisterPawn(APawn* Pawn);
+
+	/**
+	 * 클라이언트 히트를 발사 시각(서버 월드 시간)으로 되감아 검증
+	 * @param HitActor		클라이언트가 맞췄다고 주장하는 액터 (폰에 붙은 액터면 부모 폰으로 검증)
+	 * @param ImpactPoint	클라이언트가 보고한 임팩트 지점
+	 * @param ClientFireTime	클라이언트가 발사한 시각 (GetServerWorldTimeSeconds 기준, 서버 추정치 근처로 제한됨)
+	 * @param Shooter		발사한 폰 (핑으로 클라이언트 시각을 추정함)
+	 */
+	EHaroHitValidationResult ValidateHit(const AActor* HitActor, const FVector& ImpactPoint, double ClientFireTime, const APawn* Shooter) const;
+
+	static bool IsAccepted(EHaroHitValidationResult Result)
+	{
+		return (Result == EHaroHitValidationResult::Accepted) || (Result == EHaroHitValidationResult::NotTracked);
+	}
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void RecordFrame(double WorldTime);
+
+	/** Time 이전(또는 같은)의 가장 최근 프레임과 보간 비율을 찾음. 못 찾으면 false */
+	bool FindRewindFrames(double Time, int32& OutOlderFrame, int32& OutNewerFrame, float& OutAlpha) const;
+
+	/** 서버 시각 기준으로 발사자 화면이 얼마나 뒤처져 있는지 추정 (RTT/2 + 보간 지연, 로컬 조종이면 0) */
+	static double GetEstimatedViewDelay(const APawn* Shooter);
+
+	FORCEINLINE int32 GetSampleIndex(int32 Frame, int32 Slot) const
+	{
+		return (Frame * MaxTrackedPawns) + Slot;
+	}
+
+private:
+	// ========== 프레임 단위 데이터 ==========
+
+	/** 각 프레임이 기록된 서버 월드 시간 */
+	TArray<double> FrameTimes;
+
+	/** 가장 최근에 기록한 프레임 인덱스 */
+	int32 HeadFrame = INDEX_NONE;
+
+	/** 링 버퍼에 유효하게 기록된 프레임 수 */
+	int32 NumRecordedFrames = 0;
+
+	// ========== 샘플 데이터 (Frame * MaxTrackedPawns + Slot) ==========
+
+	/** 캡슐 중심 위치 */
+	TArray<FVector3f> SampleLocations;
+
+	/** 캡슐 반높이 (웅크리기 등으로 변함) */
+	TArray<float> SampleHalfHeights;
+
+	// ========== 슬롯 단위 데이터 ==========
+
+	TArray<TWeakObjectPtr<APawn>> SlotPawns;
+	TArray<float> SlotRadii;
+
+	/** 슬롯이 현재 폰에 할당된 뒤 처음 기록된 시각 (이전 프레임은 다른 폰의 데이터일 수 있음) */
+	TArray<double> SlotValidSince;
+
+	/** 기록 루프가 빈 슬롯을 건너뛰지 않도록 사용 중인 슬롯만 모아둠 */
+	TArray<int32> ActiveSlots;
+	TArray<int32> FreeSlots;
+
+	TMap<TObjectKey<APawn>, int32> PawnToSlot;
+};
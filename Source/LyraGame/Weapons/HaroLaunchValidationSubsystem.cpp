@@ -0,0 +1,248 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HaroLaunchValidationSubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "HaroGameplayAbility_ProjectileWeapon.h"
+#include "LyraLogChannels.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HaroLaunchValidationSubsystem)
+
+DECLARE_STATS_GROUP(TEXT("HaroLaunchValidation"), STATGROUP_HaroLaunchValidation, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Requested"), STAT_HaroLaunchValidation_Requested, STATGROUP_HaroLaunchValidation);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Fast Path"), STAT_HaroLaunchValidation_FastPath, STATGROUP_HaroLaunchValidation);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async Traces"), STAT_HaroLaunchValidation_AsyncTraces, STATGROUP_HaroLaunchValidation);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Rejected"), STAT_HaroLaunchValidation_Rejected, STATGROUP_HaroLaunchValidation);
+
+namespace HaroConsoleVariables
+{
+	static bool bAsyncLaunchValidation = true;
+	static FAutoConsoleVariableRef CVarAsyncLaunchValidation(
+		TEXT("Haro.Projectile.AsyncLaunchValidation"),
+		bAsyncLaunchValidation,
+		TEXT("Should the server check client projectile launches with an async obstruction trace and spawn them on the next frame (otherwise the trace runs synchronously)"),
+		ECVF_Default);
+
+	static bool bTrustLocalLaunches = true;
+	static FAutoConsoleVariableRef CVarTrustLocalLaunches(
+		TEXT("Haro.Projectile.TrustLocalLaunches"),
+		bTrustLocalLaunches,
+		TEXT("Skip launch validation for pawns controlled on the server itself (listen server host, bots)"),
+		ECVF_Default);
+
+	static float LaunchMaxDistance = 300.0f;
+	static FAutoConsoleVariableRef CVarLaunchMaxDistance(
+		TEXT("Haro.Projectile.LaunchMaxDistance"),
+		LaunchMaxDistance,
+		TEXT("Largest allowed distance (in uu) between a client's launch location and its pawn"),
+		ECVF_Default);
+
+	static float LaunchMaxViewAngle = 90.0f;
+	static FAutoConsoleVariableRef CVarLaunchMaxViewAngle(
+		TEXT("Haro.Projectile.LaunchMaxViewAngle"),
+		LaunchMaxViewAngle,
+		TEXT("Largest allowed angle (in degrees) between a client's launch direction and its pawn's aim rotation"),
+		ECVF_Default);
+}
+
+void UHaroLaunchValidationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	ObstructionTraceDelegate.BindUObject(this, &ThisClass::OnObstructionTraceCompleted);
+}
+
+void UHaroLaunchValidationSubsystem::Deinitialize()
+{
+	PendingLaunches.Reset();
+	ObstructionTraceDelegate.Unbind();
+
+	Super::Deinitialize();
+}
+
+bool UHaroLaunchValidationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+EHaroLaunchValidationResult UHaroLaunchValidationSubsystem::CheckLaunchTransform(const FTransform& LaunchTransform, const APawn* Pawn)
+{
+	// 1. 거리: 폰 근처에서 발사했는지
+	const float DistanceSquared = FVector::DistSquared(LaunchTransform.GetLocation(), Pawn->GetActorLocation());
+	if (DistanceSquared > FMath::Square(HaroConsoleVariables::LaunchMaxDistance))
+	{
+		return EHaroLaunchValidationResult::TooFarFromPawn;
+	}
+
+	// 2. 조준 각도: 서버가 아는 조준 방향과 크게 다르지 않은지
+	const FVector AimDir = Pawn->GetBaseAimRotation().Vector();
+	const FVector LaunchDir = LaunchTransform.GetUnitAxis(EAxis::X);
+	const float MinDot = FMath::Cos(FMath::DegreesToRadians(HaroConsoleVariables::LaunchMaxViewAngle));
+	if (FVector::DotProduct(AimDir, LaunchDir) < MinDot)
+	{
+		return EHaroLaunchValidationResult::ViewAngle;
+	}
+
+	return EHaroLaunchValidationResult::Accepted;
+}
+
+void UHaroLaunchValidationSubsystem::GetObstructionTrace(const FTransform& LaunchTransform, const APawn* Pawn, FVector& OutStart, FVector& OutEnd, FCollisionQueryParams& OutParams)
+{
+	OutStart = Pawn->GetPawnViewLocation();
+	OutEnd = LaunchTransform.GetLocation();
+
+	OutParams = FCollisionQueryParams(SCENE_QUERY_STAT(HaroLaunchObstruction), /*bTraceComplex=*/ false, Pawn);
+
+	// 들고 있는 무기 등 붙어 있는 액터는 무시
+	TArray<AActor*> AttachedActors;
+	Pawn->GetAttachedActors(AttachedActors);
+	OutParams.AddIgnoredActors(AttachedActors);
+}
+
+void UHaroLaunchValidationSubsystem::QueueLaunch(const FHaroPendingLaunch& Launch)
+{
+	APawn* Pawn = Launch.Pawn.Get();
+	UWorld* World = GetWorld();
+	if (!Pawn || !World)
+	{
+		CompleteLaunch(Launch, EHaroLaunchValidationResult::Expired);
+		return;
+	}
+
+	++Stats.NumRequested;
+	INC_DWORD_STAT(STAT_HaroLaunchValidation_Requested);
+
+	// 서버에서 직접 조종하는 폰은 믿음
+	if (HaroConsoleVariables::bTrustLocalLaunches && Pawn->IsLocallyControlled())
+	{
+		++Stats.NumFastPath;
+		INC_DWORD_STAT(STAT_HaroLaunchValidation_FastPath);
+		CompleteLaunch(Launch, EHaroLaunchValidationResult::Accepted);
+		return;
+	}
+
+	const EHaroLaunchValidationResult QuickResult = CheckLaunchTransform(Launch.LaunchTransform, Pawn);
+	if (QuickResult != EHaroLaunchValidationResult::Accepted)
+	{
+		CompleteLaunch(Launch, QuickResult);
+		return;
+	}
+
+	FVector TraceStart;
+	FVector TraceEnd;
+	FCollisionQueryParams QueryParams;
+	GetObstructionTrace(Launch.LaunchTransform, Pawn, /*out*/ TraceStart, /*out*/ TraceEnd, /*out*/ QueryParams);
+
+	if (!HaroConsoleVariables::bAsyncLaunchValidation)
+	{
+		++Stats.NumSynchronous;
+		const bool bObstructed = World->LineTraceTestByChannel(TraceStart, TraceEnd, ECollisionChannel::ECC_Visibility, QueryParams);
+		CompleteLaunch(Launch, bObstructed ? EHaroLaunchValidationResult::MuzzleObstructed : EHaroLaunchValidationResult::Accepted);
+		return;
+	}
+
+	const uint32 RequestId = NextRequestId++;
+	if (NextRequestId == 0)
+	{
+		NextRequestId = 1;
+	}
+
+	PendingLaunches.Add(RequestId, Launch);
+	World->AsyncLineTraceByChannel(EAsyncTraceType::Test, TraceStart, TraceEnd, ECollisionChannel::ECC_Visibility, QueryParams, FCollisionResponseParams::DefaultResponseParam, &ObstructionTraceDelegate, RequestId);
+	INC_DWORD_STAT(STAT_HaroLaunchValidation_AsyncTraces);
+}
+
+void UHaroLaunchValidationSubsystem::OnObstructionTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceData)
+{
+	FHaroPendingLaunch Launch;
+	if (!PendingLaunches.RemoveAndCopyValue(TraceData.UserData, /*out*/ Launch))
+	{
+		return;
+	}
+
+	++Stats.NumAsyncCompleted;
+
+	// Test 트레이스는 막혔을 때만 결과가 하나 들어옴
+	const bool bObstructed = (TraceData.OutHits.Num() > 0);
+	CompleteLaunch(Launch, bObstructed ? EHaroLaunchValidationResult::MuzzleObstructed : EHaroLaunchValidationResult::Accepted);
+}
+
+void UHaroLaunchValidationSubsystem::CompleteLaunch(const FHaroPendingLaunch& Launch, EHaroLaunchValidationResult Result)
+{
+	UHaroGameplayAbility_ProjectileWeapon* Ability = Launch.Ability.Get();
+	if ((Ability == nullptr) || !Launch.Pawn.IsValid())
+	{
+		Result = EHaroLaunchValidationResult::Expired;
+	}
+
+	RecordResult(Result, FPlatformTime::Seconds() - Launch.QueueTime);
+
+	if (Result != EHaroLaunchValidationResult::Accepted)
+	{
+		UE_LOG(LogLyraAbilitySystem, Verbose, TEXT("Server rejected projectile launch from %s (%s)"), *GetNameSafe(Launch.Pawn.Get()), LexResultToString(Result));
+	}
+
+	if (Ability)
+	{
+		Ability->OnLaunchValidated(Launch, Result);
+	}
+}
+
+void UHaroLaunchValidationSubsystem::RecordResult(EHaroLaunchValidationResult Result, double LatencySeconds)
+{
+	++Stats.NumByResult[static_cast<int32>(Result)];
+	Stats.TotalLatencySeconds += LatencySeconds;
+	Stats.MaxLatencySeconds = FMath::Max(Stats.MaxLatencySeconds, LatencySeconds);
+
+	if (Result != EHaroLaunchValidationResult::Accepted)
+	{
+		INC_DWORD_STAT(STAT_HaroLaunchValidation_Rejected);
+	}
+}
+
+const TCHAR* UHaroLaunchValidationSubsystem::LexResultToString(EHaroLaunchValidationResult Result)
+{
+	switch (Result)
+	{
+	case EHaroLaunchValidationResult::Accepted:			return TEXT("Accepted");
+	case EHaroLaunchValidationResult::TooFarFromPawn:	return TEXT("TooFarFromPawn");
+	case EHaroLaunchValidationResult::ViewAngle:		return TEXT("ViewAngle");
+	case EHaroLaunchValidationResult::MuzzleObstructed:	return TEXT("MuzzleObstructed");
+	case EHaroLaunchValidationResult::Expired:			return TEXT("Expired");
+	default:											return TEXT("Unknown");
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommandWithWorldAndArgs HaroPrintLaunchValidationStatsCmd(
+	TEXT("Haro.Projectile.PrintLaunchValidationStats"),
+	TEXT("Logs projectile launch validation counts by result and validation latency. Pass 'reset' to clear them afterwards"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UHaroLaunchValidationSubsystem* Subsystem = UWorld::GetSubsystem<UHaroLaunchValidationSubsystem>(World);
+		if (!Subsystem)
+		{
+			return;
+		}
+
+		const FHaroLaunchValidationStats& Stats = Subsystem->GetStats();
+		const int32 NumCompleted = FMath::Max(Stats.NumRequested, 1);
+
+		UE_LOG(LogLyra, Display, TEXT("Projectile launch validation: %d requested, %d fast path, %d synchronous, %d async"),
+			Stats.NumRequested, Stats.NumFastPath, Stats.NumSynchronous, Stats.NumAsyncCompleted);
+		for (int32 ResultIndex = 0; ResultIndex < static_cast<int32>(EHaroLaunchValidationResult::MAX); ++ResultIndex)
+		{
+			UE_LOG(LogLyra, Display, TEXT("  %-18s %d"), UHaroLaunchValidationSubsystem::LexResultToString(static_cast<EHaroLaunchValidationResult>(ResultIndex)), Stats.NumByResult[ResultIndex]);
+		}
+		UE_LOG(LogLyra, Display, TEXT("  Latency: avg %.2f ms, max %.2f ms"), (Stats.TotalLatencySeconds / NumCompleted) * 1000.0, Stats.MaxLatencySeconds * 1000.0);
+
+		if ((Args.Num() > 0) && Args[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase))
+		{
+			Subsystem->ResetStats();
+		}
+	}));
+#endif // !UE_BUILD_SHIPPING
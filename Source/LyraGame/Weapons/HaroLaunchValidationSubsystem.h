@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+
+#include "HaroLaunchValidationSubsystem.generated.h"
+
+class AActor;
+class APawn;
+class UHaroGameplayAbility_ProjectileWeapon;
+
+/** 투사체 발사 검증 결과 */
+enum class EHaroLaunchValidationResult : uint8
+{
+	Accepted,
+	TooFarFromPawn,     // 발사 위치가 폰에서 너무 멀리 떨어짐
+	ViewAngle,          // 발사 방향이 조준 방향과 너무 다름
+	MuzzleObstructed,   // 폰 눈높이에서 발사 위치까지 벽이 막고 있음
+	Expired,            // 검증이 끝나기 전에 폰/어빌리티가 사라짐
+
+	MAX
+};
+
+/** 검증을 기다리는 발사 하나 */
+struct FHaroPendingLaunch
+{
+	TWeakObjectPtr<UHaroGameplayAbility_ProjectileWeapon> Ability;
+	TWeakObjectPtr<APawn> Pawn;
+	FTransform LaunchTransform;
+
+	/** 발사한 활성화의 예측 키 (다음 프레임에 스폰할 때는 어빌리티가 이미 다시 활성화됐을 수 있음) */
+	int16 PredictionKey = 0;
+
+	/** 큐에 넣을 때의 차징 시간 (스폰 전에 어빌리티가 끝나면서 0으로 초기화될 수 있음) */
+	float ChargingTime = 0.0f;
+
+	double QueueTime = 0.0;
+};
+
+/** 누적 검증 통계 (Haro.Projectile.PrintLaunchValidationStats) */
+struct FHaroLaunchValidationStats
+{
+	int32 NumRequested = 0;
+	int32 NumFastPath = 0;
+	int32 NumSynchronous = 0;
+	int32 NumByResult[static_cast<int32>(EHaroLaunchValidationResult::MAX)] = {};
+	double TotalLatencySeconds = 0.0;
+	double MaxLatencySeconds = 0.0;
+	int32 NumAsyncCompleted = 0;
+};
+
+/**
+ * 클라이언트가 보낸 투사체 발사 위치를 비동기로 검증하는 월드 서브시스템 (서버 전용)
+ *
+ * 거리/조준 각도 검사는 바로 하고, 폰 눈높이 -> 발사 위치 사이의 벽 검사는 비동기 트레이스로 요청함.
+ * 트레이스 결과는 다음 프레임 시작에 나오고, 그때 통과한 발사만 어빌리티로 돌려보내서 스폰함.
+ * 리슨 서버 호스트/봇처럼 서버에서 직접 조종하는 폰은 검증 없이 바로 스폰함 (Haro.Projectile.TrustLocalLaunches).
+ */
+UCLASS()
+class LYRAGAME_API UHaroLaunchValidationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	/**
+	 * 발사 검증 요청
+	 * 바로 판정할 수 있으면 (빠른 경로, 비동기 검증 꺼짐, 거리/각도 실패) 이 안에서 어빌리티의 OnLaunchValidated가 호출됨
+	 */
+	void QueueLaunch(const FHaroPendingLaunch& Launch);
+
+	/** 트레이스 없이 할 수 있는 검사 (거리, 조준 각도) */
+	static EHaroLaunchValidationResult CheckLaunchTransform(const FTransform& LaunchTransform, const APawn* Pawn);
+
+	/** 벽 검사 트레이스 시작/끝 */
+	static void GetObstructionTrace(const FTransform& LaunchTransform, const APawn* Pawn, FVector& OutStart, FVector& OutEnd, FCollisionQueryParams& OutParams);
+
+	/** 결과 기록 (어빌리티에서 직접 판정한 것도 같이 집계) */
+	void RecordResult(EHaroLaunchValidationResult Result, double LatencySeconds);
+
+	const FHaroLaunchValidationStats& GetStats() const { return Stats; }
+	void ResetStats() { Stats = FHaroLaunchValidationStats(); }
+
+	static const TCHAR* LexResultToString(EHaroLaunchValidationResult Result);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void OnObstructionTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceData);
+	void CompleteLaunch(const FHaroPendingLaunch& Launch, EHaroLaunchValidationResult Result);
+
+private:
+	/** 트레이스 요청 ID -> 대기 중인 발사 */
+	TMap<uint32, FHaroPendingLaunch> PendingLaunches;
+	uint32 NextRequestId = 1;
+
+	FTraceDelegate ObstructionTraceDelegate;
+
+	FHaroLaunchValidationStats Stats;
+};
@@ -0,0 +1,336 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HaroPredictedProjectileSubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "HaroProjectileBase.h"
+#include "LyraLogChannels.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HaroPredictedProjectileSubsystem)
+
+DECLARE_STATS_GROUP(TEXT("HaroProjectilePrediction"), STATGROUP_HaroProjectilePrediction, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pending Shots"), STAT_HaroProjectilePrediction_Pending, STATGROUP_HaroProjectilePrediction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Linked Proxies"), STAT_HaroProjectilePrediction_Linked, STATGROUP_HaroProjectilePrediction);
+
+namespace HaroConsoleVariables
+{
+	static bool bPredictProjectiles = true;
+	static FAutoConsoleVariableRef CVarPredictProjectiles(
+		TEXT("Haro.Projectile.PredictProjectiles"),
+		bPredictProjectiles,
+		TEXT("Should the firing client spawn a local proxy projectile immediately instead of waiting for the replicated server projectile"),
+		ECVF_Default);
+
+	static float PredictedProxyTimeout = 0.5f;
+	static FAutoConsoleVariableRef CVarPredictedProxyTimeout(
+		TEXT("Haro.Projectile.PredictedProxyTimeout"),
+		PredictedProxyTimeout,
+		TEXT("Seconds (on top of the owner's round trip time) to wait for the server projectile before a predicted proxy is treated as rejected"),
+		ECVF_Default);
+}
+
+void UHaroPredictedProjectileSubsystem::Deinitialize()
+{
+	for (const TPair<FShotKey, FPendingShot>& Pair : PendingShots)
+	{
+		DestroyProxy(Pair.Value.Proxy);
+	}
+	for (const TPair<TObjectKey<AHaroProjectileBase>, FLinkedProxy>& Pair : LinkedProxies)
+	{
+		DestroyProxy(Pair.Value.Proxy);
+	}
+
+	PendingShots.Reset();
+	LinkedProxies.Reset();
+	AwaitingFirstRender.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UHaroPredictedProjectileSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+ETickableTickType UHaroPredictedProjectileSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UHaroPredictedProjectileSubsystem::IsTickable() const
+{
+	return (PendingShots.Num() > 0) || (LinkedProxies.Num() > 0) || (AwaitingFirstRender.Num() > 0);
+}
+
+TStatId UHaroPredictedProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHaroPredictedProjectileSubsystem, STATGROUP_Tickables);
+}
+
+bool UHaroPredictedProjectileSubsystem::IsPredictionEnabled()
+{
+	return HaroConsoleVariables::bPredictProjectiles;
+}
+
+void UHaroPredictedProjectileSubsystem::RegisterShot(APawn* Pawn, int16 PredictionKey, AHaroProjectileBase* Proxy, double FireTime)
+{
+	if (!Pawn || (PredictionKey == 0))
+	{
+		DestroyProxy(Proxy);
+		return;
+	}
+
+	// 서버 투사체는 적어도 왕복 시간만큼은 늦게 옴
+	const APlayerState* PlayerState = Pawn->GetPlayerState();
+	const double RoundTripSeconds = PlayerState ? (PlayerState->GetPingInMilliseconds() * 0.001) : 0.0;
+
+	FPendingShot& Shot = PendingShots.FindOrAdd(FShotKey{ Pawn, PredictionKey });
+
+	// 같은 키가 아직 남아 있으면 (int16 예측 키가 한 바퀴 돎) 예전 프록시는 버림
+	DestroyProxy(Shot.Proxy);
+
+	Shot.Proxy = Proxy;
+	Shot.FireTime = FireTime;
+	Shot.ExpireTime = FireTime + RoundTripSeconds + HaroConsoleVariables::PredictedProxyTimeout;
+
+	++Stats.NumShots;
+	if (Proxy)
+	{
+		++Stats.NumProxiesSpawned;
+		WaitForFirstRender(Proxy, FireTime);
+	}
+}
+
+bool UHaroPredictedProjectileSubsystem::ReconcileProjectile(AHaroProjectileBase* ServerProjectile)
+{
+	if (!ServerProjectile)
+	{
+		return false;
+	}
+
+	const FShotKey ShotKey{ ServerProjectile->GetInstigator(), ServerProjectile->GetPredictionKey() };
+
+	FPendingShot Shot;
+	if (!PendingShots.RemoveAndCopyValue(ShotKey, Shot))
+	{
+		++Stats.NumUnmatched;
+		return false;
+	}
+
+	const double ServerDelay = FPlatformTime::Seconds() - Shot.FireTime;
+	RecordServerDelay(ServerDelay);
+
+	AHaroProjectileBase* Proxy = Shot.Proxy.Get();
+	if (!Proxy)
+	{
+		// 예측이 꺼져 있었으면 서버 투사체가 처음 보이는 투사체
+		WaitForFirstRender(ServerProjectile, Shot.FireTime);
+		return false;
+	}
+
+	++Stats.NumReconciled;
+
+	// 두 투사체가 클라이언트에서 서로 부딪히지 않게 함
+	Proxy->IgnoreProjectileWhenMoving(ServerProjectile);
+	ServerProjectile->IgnoreProjectileWhenMoving(Proxy);
+
+	// 프록시가 계속 보이고, 서버 투사체는 멈출 때까지 숨김
+	ServerProjectile->SetHiddenByPredictedProxy(true);
+
+	FLinkedProxy& Link = LinkedProxies.FindOrAdd(ServerProjectile);
+	DestroyProxy(Link.Proxy);
+	Link.ServerProjectile = ServerProjectile;
+	Link.Proxy = Proxy;
+
+	return true;
+}
+
+void UHaroPredictedProjectileSubsystem::OnServerProjectileStopped(AHaroProjectileBase* ServerProjectile)
+{
+	if (!ServerProjectile)
+	{
+		return;
+	}
+
+	FLinkedProxy Link;
+	if (LinkedProxies.RemoveAndCopyValue(ServerProjectile, Link))
+	{
+		DestroyProxy(Link.Proxy);
+	}
+
+	// 착탄 지점부터는 서버 투사체를 보여줌 (박히는 투사체 등)
+	ServerProjectile->SetHiddenByPredictedProxy(false);
+}
+
+void UHaroPredictedProjectileSubsystem::HandleShotRejected(TWeakObjectPtr<APawn> Pawn, int16 PredictionKey)
+{
+	FPendingShot Shot;
+	if (PendingShots.RemoveAndCopyValue(FShotKey{ Pawn.Get(), PredictionKey }, Shot))
+	{
+		++Stats.NumRejected;
+		DestroyProxy(Shot.Proxy);
+	}
+}
+
+void UHaroPredictedProjectileSubsystem::Tick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_HaroProjectilePrediction_Tick);
+
+	Super::Tick(DeltaTime);
+
+	const double Now = FPlatformTime::Seconds();
+
+	// 서버 투사체가 끝내 오지 않은 발사 (서버 검증 실패 등)
+	for (auto It = PendingShots.CreateIterator(); It; ++It)
+	{
+		if (Now >= It.Value().ExpireTime)
+		{
+			if (It.Value().Proxy.IsValid())
+			{
+				++Stats.NumRejected;
+				UE_LOG(LogLyra, Verbose, TEXT("Predicted projectile proxy (key %d) expired without a server projectile"), It.Key().PredictionKey);
+			}
+
+			DestroyProxy(It.Value().Proxy);
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = LinkedProxies.CreateIterator(); It; ++It)
+	{
+		AHaroProjectileBase* ServerProjectile = It.Value().ServerProjectile.Get();
+		if (!ServerProjectile)
+		{
+			DestroyProxy(It.Value().Proxy);
+			It.RemoveCurrent();
+			continue;
+		}
+
+		// 프록시가 먼저 사라졌는데 서버 투사체는 아직 날아가는 중이면 서버 투사체를 보여줌
+		if (!It.Value().Proxy.IsValid())
+		{
+			ServerProjectile->SetHiddenByPredictedProxy(false);
+			It.RemoveCurrent();
+		}
+	}
+
+	// 렌더러가 마지막 렌더 시간을 갱신했으면 그 프레임에 처음 화면에 나온 것
+	for (int32 Index = AwaitingFirstRender.Num() - 1; Index >= 0; --Index)
+	{
+		const FAwaitingRender& Awaiting = AwaitingFirstRender[Index];
+		const AHaroProjectileBase* Projectile = Awaiting.Projectile.Get();
+		if (!Projectile)
+		{
+			AwaitingFirstRender.RemoveAtSwap(Index);
+			continue;
+		}
+
+		if (Projectile->GetLastRenderTime() > Awaiting.LastRenderTimeAtStart)
+		{
+			RecordVisualDelay(Now - Awaiting.FireTime);
+			AwaitingFirstRender.RemoveAtSwap(Index);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_HaroProjectilePrediction_Pending, PendingShots.Num());
+	SET_DWORD_STAT(STAT_HaroProjectilePrediction_Linked, LinkedProxies.Num());
+}
+
+void UHaroPredictedProjectileSubsystem::WaitForFirstRender(AHaroProjectileBase* Projectile, double FireTime)
+{
+	FAwaitingRender& Awaiting = AwaitingFirstRender.AddDefaulted_GetRef();
+	Awaiting.Projectile = Projectile;
+	Awaiting.FireTime = FireTime;
+	Awaiting.LastRenderTimeAtStart = Projectile->GetLastRenderTime();
+}
+
+void UHaroPredictedProjectileSubsystem::RecordVisualDelay(double DelaySeconds)
+{
+	Stats.TotalVisualDelaySeconds += DelaySeconds;
+	Stats.MaxVisualDelaySeconds = FMath::Max(Stats.MaxVisualDelaySeconds, DelaySeconds);
+	++Stats.NumVisualSamples;
+}
+
+void UHaroPredictedProjectileSubsystem::RecordServerDelay(double DelaySeconds)
+{
+	Stats.TotalServerDelaySeconds += DelaySeconds;
+	Stats.MaxServerDelaySeconds = FMath::Max(Stats.MaxServerDelaySeconds, DelaySeconds);
+	++Stats.NumServerSamples;
+}
+
+void UHaroPredictedProjectileSubsystem::DestroyProxy(const TWeakObjectPtr<AHaroProjectileBase>& Proxy)
+{
+	if (AHaroProjectileBase* ProxyProjectile = Proxy.Get())
+	{
+		ProxyProjectile->Destroy();
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommandWithWorldAndArgs HaroPrintPredictionStatsCmd(
+	TEXT("Haro.Projectile.PrintPredictionStats"),
+	TEXT("Logs predicted projectile proxy counts and the delay from firing to the first rendered frame of the projectile on this client. Pass 'reset' to clear them afterwards"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UHaroPredictedProjectileSubsystem* Subsystem = UWorld::GetSubsystem<UHaroPredictedProjectileSubsystem>(World);
+		if (!Subsystem)
+		{
+			return;
+		}
+
+		const FHaroProjectilePredictionStats& Stats = Subsystem->GetStats();
+
+		UE_LOG(LogLyra, Display, TEXT("Projectile prediction (%s): %d shots, %d proxies, %d reconciled, %d rejected, %d unmatched"),
+			UHaroPredictedProjectileSubsystem::IsPredictionEnabled() ? TEXT("on") : TEXT("off"),
+			Stats.NumShots, Stats.NumProxiesSpawned, Stats.NumReconciled, Stats.NumRejected, Stats.NumUnmatched);
+		UE_LOG(LogLyra, Display, TEXT("  Fire to first render:      avg %.2f ms, max %.2f ms (%d samples)"),
+			(Stats.TotalVisualDelaySeconds / FMath::Max(Stats.NumVisualSamples, 1)) * 1000.0, Stats.MaxVisualDelaySeconds * 1000.0, Stats.NumVisualSamples);
+		UE_LOG(LogLyra, Display, TEXT("  Fire to server projectile: avg %.2f ms, max %.2f ms (%d samples)"),
+			(Stats.TotalServerDelaySeconds / FMath::Max(Stats.NumServerSamples, 1)) * 1000.0, Stats.MaxServerDelaySeconds * 1000.0, Stats.NumServerSamples);
+
+		if ((Args.Num() > 0) && Args[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase))
+		{
+			Subsystem->ResetStats();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs HaroProjectileLatencyTestCmd(
+	TEXT("Haro.Projectile.LatencyTest"),
+	TEXT("Haro.Projectile.LatencyTest <PktLagMs> [0|1]: emulates outgoing packet lag (NetEmulation.PktLag), optionally toggles Haro.Projectile.PredictProjectiles, and resets the prediction stats. Fire a few shots, then run Haro.Projectile.PrintPredictionStats"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UHaroPredictedProjectileSubsystem* Subsystem = UWorld::GetSubsystem<UHaroPredictedProjectileSubsystem>(World);
+		if (!Subsystem)
+		{
+			return;
+		}
+
+		if (Args.Num() > 0)
+		{
+			const int32 PktLagMs = FMath::Max(FCString::Atoi(*Args[0]), 0);
+			if (IConsoleVariable* PktLagCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("NetEmulation.PktLag")))
+			{
+				PktLagCVar->Set(PktLagMs, ECVF_SetByConsole);
+			}
+			else
+			{
+				UE_LOG(LogLyra, Warning, TEXT("NetEmulation.PktLag is not available in this build; use the editor's network emulation settings instead"));
+			}
+		}
+
+		if (Args.Num() > 1)
+		{
+			HaroConsoleVariables::bPredictProjectiles = FCString::ToBool(*Args[1]);
+		}
+
+		Subsystem->ResetStats();
+
+		UE_LOG(LogLyra, Display, TEXT("Projectile latency test started (prediction %s). Fire, then run Haro.Projectile.PrintPredictionStats"),
+			UHaroPredictedProjectileSubsystem::IsPredictionEnabled() ? TEXT("on") : TEXT("off"));
+	}));
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "HaroPredictedProjectileSubsystem.generated.h"
+
+class AHaroProjectileBase;
+class APawn;
+
+/** 누적 예측 통계 (Haro.Projectile.PrintPredictionStats) */
+struct FHaroProjectilePredictionStats
+{
+	int32 NumShots = 0;
+	int32 NumProxiesSpawned = 0;
+	int32 NumReconciled = 0;
+
+	/** 서버 투사체가 오지 않아서 정리한 프록시 (검증 실패, 시간 초과, 예측 키 거부) */
+	int32 NumRejected = 0;
+
+	/** 대기 기록이 없거나 이미 시간 초과된 뒤에 도착한 서버 투사체 */
+	int32 NumUnmatched = 0;
+
+	/** 발사 -> 투사체가 처음 렌더링된 프레임 (프록시가 있으면 프록시, 없으면 서버 투사체) */
+	double TotalVisualDelaySeconds = 0.0;
+	double MaxVisualDelaySeconds = 0.0;
+	int32 NumVisualSamples = 0;
+
+	/** 발사 -> 복제된 서버 투사체 도착 (예측이 없을 때 보이는 지연) */
+	double TotalServerDelaySeconds = 0.0;
+	double MaxServerDelaySeconds = 0.0;
+	int32 NumServerSamples = 0;
+};
+
+/**
+ * 쏜 클라이언트에서 투사체 프록시를 바로 보여주고, 복제된 서버 투사체가 오면 맞춰주는 월드 서브시스템 (클라이언트 전용)
+ *
+ * 발사는 (폰, 활성화 예측 키)로 구분함. 서버는 스폰한 AHaroProjectileBase에 같은 예측 키를 넣어 복제함.
+ *  - 서버 투사체가 도착하면 프록시와 연결하고, 서버 투사체는 쏜 클라이언트에서만 숨김
+ *  - 서버 투사체가 충돌해서 멈추거나 사라지면 프록시를 지우고 서버 투사체를 다시 보여줌 (착탄 지점에서 합침)
+ *  - 서버 투사체가 끝내 오지 않거나 (검증 실패) 예측 키가 거부되면 프록시를 지움
+ * 시뮬레이션 백엔드 투사체는 이미 쏜 클라이언트에서 바로 시뮬레이션하므로 여기를 거치지 않음.
+ */
+UCLASS()
+class LYRAGAME_API UHaroPredictedProjectileSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~USubsystem interface
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	//~FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	//~End of FTickableGameObject interface
+
+	/** 프록시 투사체를 만들지 (Haro.Projectile.PredictProjectiles) */
+	static bool IsPredictionEnabled();
+
+	/**
+	 * 쏜 클라이언트에서 발사 기록
+	 * Proxy가 없어도 (예측 꺼짐) 기록해둬서 서버 투사체가 도착하기까지의 지연을 잼
+	 */
+	void RegisterShot(APawn* Pawn, int16 PredictionKey, AHaroProjectileBase* Proxy, double FireTime);
+
+	/** 복제된 서버 투사체가 도착함. 프록시와 연결됐으면 true (서버 투사체는 숨겨짐) */
+	bool ReconcileProjectile(AHaroProjectileBase* ServerProjectile);
+
+	/** 연결된 서버 투사체가 충돌/풀 반환/파괴로 멈춤. 프록시를 지우고 서버 투사체를 보여줌 */
+	void OnServerProjectileStopped(AHaroProjectileBase* ServerProjectile);
+
+	/** 서버가 활성화 예측 키를 거부함 (FPredictionKey::NewRejectedDelegate) */
+	void HandleShotRejected(TWeakObjectPtr<APawn> Pawn, int16 PredictionKey);
+
+	const FHaroProjectilePredictionStats& GetStats() const { return Stats; }
+	void ResetStats() { Stats = FHaroProjectilePredictionStats(); }
+
+	int32 GetNumPendingShots() const { return PendingShots.Num(); }
+	int32 GetNumLinkedProxies() const { return LinkedProxies.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** 발사 하나를 구분하는 키 */
+	struct FShotKey
+	{
+		TObjectKey<APawn> Pawn;
+		int16 PredictionKey = 0;
+
+		bool operator==(const FShotKey& Other) const { return (Pawn == Other.Pawn) && (PredictionKey == Other.PredictionKey); }
+		friend uint32 GetTypeHash(const FShotKey& Key) { return HashCombine(GetTypeHash(Key.Pawn), GetTypeHash(Key.PredictionKey)); }
+	};
+
+	/** 서버 투사체를 기다리는 발사 */
+	struct FPendingShot
+	{
+		TWeakObjectPtr<AHaroProjectileBase> Proxy;
+		double FireTime = 0.0;
+		double ExpireTime = 0.0;
+	};
+
+	/** 처음 렌더링되기를 기다리는 투사체 (발사 -> 화면 지연 측정용) */
+	struct FAwaitingRender
+	{
+		TWeakObjectPtr<AHaroProjectileBase> Projectile;
+		double FireTime = 0.0;
+		float LastRenderTimeAtStart = 0.0f;
+	};
+
+	/** 서버 투사체 -> 연결된 프록시 */
+	struct FLinkedProxy
+	{
+		TWeakObjectPtr<AHaroProjectileBase> ServerProjectile;
+		TWeakObjectPtr<AHaroProjectileBase> Proxy;
+	};
+
+	void WaitForFirstRender(AHaroProjectileBase* Projectile, double FireTime);
+	void RecordVisualDelay(double DelaySeconds);
+	void RecordServerDelay(double DelaySeconds);
+
+	static void DestroyProxy(const TWeakObjectPtr<AHaroProjectileBase>& Proxy);
+
+private:
+	TMap<FShotKey, FPendingShot> PendingShots;
+	TMap<TObjectKey<AHaroProjectileBase>, FLinkedProxy> LinkedProxies;
+	TArray<FAwaitingRender> AwaitingFirstRender;
+
+	FHaroProjectilePredictionStats Stats;
+};
@@ -8,9 +8,16 @@
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "System/LyraAssetManager.h"
 #include "System/LyraGameData.h"
+#include "System/LyraSignificanceManager.h"
 #include "LyraGameplayTags.h"
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemGlobals.h"
+#include "HaroProjectilePoolSubsystem.h"
+#include "HaroPredictedProjectileSubsystem.h"
+#include "AbilitySystem/HaroEffectSpecCache.h"
+#include "GameFramework/Pawn.h"
+#include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
 
 
 
@@ -58,10 +65,47 @@ void AHaroProjectileBase::BeginPlay()
 		SphereCollisionComponent->OnComponentBeginOverlap.AddUniqueDynamic(this, &ThisClass::HandleComponentOverlap);
 		break;
 	}
+
+	if (!HasAuthority() && bPoolActive)
+	{
+		TryReconcileWithPredictedProxy();
+	}
+
+	// 로컬 뷰어 기준 중요도 계산 (데디케이티드 서버는 제외)
+	if (!IsNetMode(NM_DedicatedServer))
+	{
+		if (ULyraSignificanceManager* SignificanceManager = USignificanceManager::Get<ULyraSignificanceManager>(GetWorld()))
+		{
+			SignificanceManager->RegisterActor(this, ULyraSignificanceManager::ProjectileTag);
+		}
+	}
+}
+
+void AHaroProjectileBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (!IsNetMode(NM_DedicatedServer))
+	{
+		if (ULyraSignificanceManager* SignificanceManager = USignificanceManager::Get<ULyraSignificanceManager>(GetWorld()))
+		{
+			SignificanceManager->UnregisterActor(this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AHaroProjectileBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ThisClass, bPoolActive);
+	DOREPLIFETIME(ThisClass, PredictionKey);
 }
 
 void AHaroProjectileBase::Destroyed()
 {
+	GetWorldTimerManager().ClearTimer(PooledLifespanTimerHandle);
+
 	if (HasAuthority() && bAttachToHitComponent && AttachingComponent.IsValid())
 	{
 		// 적이 죽을 시 박힌 투사체도 같이 사라지도록.
@@ -69,11 +113,25 @@ void AHaroProjectileBase::Destroyed()
 		AttachingComponent = nullptr; // 약한 참조 초기화
 	}
 
+	if (!HasAuthority())
+	{
+		NotifyPredictedProxyServerStopped();
+	}
+
 	Super::Destroyed();
 }
 
+void AHaroProjectileBase::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// 새로 스폰된 투사체도 풀에서 꺼낸 투사체와 같은 경로로 초기 속도를 정함
+	InitializeLaunchVelocity();
+}
+
 void AHaroProjectileBase::SetSpeed(float Speed)
 {
+	LaunchSpeed = Speed;
 	ProjectileMovementComponent->Velocity = ProjectileMovementComponent->Velocity.GetSafeNormal() * Speed;
 }
 
@@ -114,6 +172,12 @@ void AHaroProjectileBase::HandleComponentHit(UPrimitiveComponent* HitComponent,
 	SphereCollisionComponent->Deactivate();
 	ProjectileMovementComponent->Deactivate();
 
+	// 쏜 클라이언트에서는 여기서부터 프록시 대신 서버 투사체를 보여줌
+	if (!HasAuthority())
+	{
+		NotifyPredictedProxyServerStopped();
+	}
+
 	if (HasAuthority())
 	{
 		// 박히는 경우
@@ -125,7 +189,7 @@ void AHaroProjectileBase::HandleComponentHit(UPrimitiveComponent* HitComponent,
 		}
 		else
 		{
-			SetLifeSpan(2.f);
+			SetProjectileLifespan(2.f);
 		}
 	}
 
@@ -156,7 +220,214 @@ void AHaroProjectileBase::HandleOtherComponentDeactivated(UActorComponent* Other
 {
 	if (HasAuthority())
 	{
-		Destroy();
+		ReleaseProjectile();
+	}
+}
+
+void AHaroProjectileBase::SetProjectileLifespan(float InLifespan)
+{
+	if (!bIsPooled)
+	{
+		SetLifeSpan(InLifespan);
+		return;
+	}
+
+	if (InLifespan > 0.0f)
+	{
+		GetWorldTimerManager().SetTimer(PooledLifespanTimerHandle, this, &ThisClass::ReleaseProjectile, InLifespan, false);
+	}
+	else
+	{
+		GetWorldTimerManager().ClearTimer(PooledLifespanTimerHandle);
+	}
+}
+
+void AHaroProjectileBase::ReleaseProjectile()
+{
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	if (bIsPooled)
+	{
+		if (UHaroProjectilePoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<UHaroProjectilePoolSubsystem>(GetWorld()))
+		{
+			PoolSubsystem->ReleaseProjectile(this);
+			return;
+		}
+	}
+
+	Destroy();
+}
+
+void AHaroProjectileBase::OnAcquiredFromPool()
+{
+	// 초기 속도는 설정이 끝난 뒤 OnActivatedFromPool에서 정함
+	LaunchSpeed = 0.0f;
+	ProjectileMovementComponent->SetUpdatedComponent(SphereCollisionComponent);
+	ProjectileMovementComponent->ProjectileGravityScale = GetDefault<AHaroProjectileBase>(GetClass())->ProjectileMovementComponent->ProjectileGravityScale;
+
+	SphereCollisionComponent->ClearMoveIgnoreActors();
+	SphereCollisionComponent->IgnoreActorWhenMoving(GetInstigator(), true);
+}
+
+void AHaroProjectileBase::OnActivatedFromPool()
+{
+	bPoolActive = true;
+	ApplyPoolActiveState();
+	InitializeLaunchVelocity();
+
+	SetNetDormancy(DORM_Awake);
+	ForceNetUpdate();
+
+	K2_OnActivatedFromPool();
+}
+
+void AHaroProjectileBase::OnReturnedToPool()
+{
+	GetWorldTimerManager().ClearTimer(PooledLifespanTimerHandle);
+
+	if (AttachingComponent.IsValid())
+	{
+		AttachingComponent->OnComponentDeactivated.RemoveDynamic(this, &ThisClass::HandleOtherComponentDeactivated);
+	}
+	AttachingComponent = nullptr;
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+
+	HitActors.Reset();
+	PredictionKey = 0;
+	DamageEffectSpecHandle.Clear();
+	AOEDamageEffectSpecHandle.Clear();
+	AOEClass = nullptr;
+	LaunchSpeed = 0.0f;
+
+	bPoolActive = false;
+	ApplyPoolActiveState();
+
+	K2_OnReturnedToPool();
+
+	// 숨김 상태가 클라이언트에 전달된 뒤 채널이 닫힘
+	ForceNetUpdate();
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void AHaroProjectileBase::InitializeLaunchVelocity()
+{
+	// UProjectileMovementComponent::InitializeComponent와 같은 규칙을 클래스 기본값 기준으로 적용
+	// (풀에서 꺼낸 투사체는 이전 발사의 속도가 남아 있으므로 현재 값을 쓰지 않음)
+	const UProjectileMovementComponent* DefaultMovement = GetDefault<AHaroProjectileBase>(GetClass())->ProjectileMovementComponent;
+
+	FVector LaunchVelocity = DefaultMovement->Velocity;
+	const float Speed = (LaunchSpeed > 0.0f) ? LaunchSpeed : DefaultMovement->InitialSpeed;
+	if (Speed > 0.0f)
+	{
+		LaunchVelocity = LaunchVelocity.GetSafeNormal() * Speed;
+	}
+
+	if (DefaultMovement->bInitialVelocityInLocalSpace)
+	{
+		LaunchVelocity = GetActorTransform().TransformVectorNoScale(LaunchVelocity);
+	}
+
+	ProjectileMovementComponent->Velocity = LaunchVelocity;
+	ProjectileMovementComponent->UpdateComponentVelocity();
+}
+
+void AHaroProjectileBase::ApplyPoolActiveState()
+{
+	SetActorHiddenInGame(!bPoolActive || bHiddenByPredictedProxy);
+	SetActorEnableCollision(bPoolActive);
+
+	if (bPoolActive)
+	{
+		HitActors.Reset();
+		SphereCollisionComponent->Activate(true);
+		ProjectileMovementComponent->SetUpdatedComponent(SphereCollisionComponent);
+		ProjectileMovementComponent->Activate(true);
+	}
+	else
+	{
+		ProjectileMovementComponent->StopMovementImmediately();
+		ProjectileMovementComponent->Deactivate();
+		SphereCollisionComponent->Deactivate();
+	}
+}
+
+void AHaroProjectileBase::OnRep_PoolActive()
+{
+	if (bPoolActive)
+	{
+		// 서버에서 새로 발사된 속도로 클라이언트 시뮬레이션을 다시 시작
+		ProjectileMovementComponent->Velocity = GetReplicatedMovement().LinearVelocity;
+	}
+	else
+	{
+		NotifyPredictedProxyServerStopped();
+	}
+
+	ApplyPoolActiveState();
+
+	if (bPoolActive)
+	{
+		TryReconcileWithPredictedProxy();
+	}
+}
+
+void AHaroProjectileBase::InitPredictedProxy()
+{
+	bIsPredictedProxy = true;
+	SetReplicates(false);
+}
+
+void AHaroProjectileBase::SetHiddenByPredictedProxy(bool bHidden)
+{
+	bHiddenByPredictedProxy = bHidden;
+	SetActorHiddenInGame(!bPoolActive || bHiddenByPredictedProxy);
+}
+
+void AHaroProjectileBase::IgnoreProjectileWhenMoving(AHaroProjectileBase* OtherProjectile)
+{
+	if (OtherProjectile)
+	{
+		SphereCollisionComponent->IgnoreActorWhenMoving(OtherProjectile, true);
+	}
+}
+
+void AHaroProjectileBase::TryReconcileWithPredictedProxy()
+{
+	if (PredictionKey == 0)
+	{
+		return;
+	}
+
+	// 프록시는 쏜 클라이언트에만 있음
+	const APawn* InstigatorPawn = GetInstigator();
+	if (!InstigatorPawn || !InstigatorPawn->IsLocallyControlled())
+	{
+		return;
+	}
+
+	if (UHaroPredictedProjectileSubsystem* PredictedProjectiles = UWorld::GetSubsystem<UHaroPredictedProjectileSubsystem>(GetWorld()))
+	{
+		PredictedProjectiles->ReconcileProjectile(this);
+	}
+}
+
+void AHaroProjectileBase::NotifyPredictedProxyServerStopped()
+{
+	if (!bHiddenByPredictedProxy)
+	{
+		return;
+	}
+
+	if (UHaroPredictedProjectileSubsystem* PredictedProjectiles = UWorld::GetSubsystem<UHaroPredictedProjectileSubsystem>(GetWorld()))
+	{
+		PredictedProjectiles->OnServerProjectileStopped(this);
+	}
+	else
+	{
+		SetHiddenByPredictedProxy(false);
 	}
 }
 
@@ -166,7 +437,8 @@ void AHaroProjectileBase::HandleCollisionDetection(AActor* OtherActor, UPrimitiv
 	if (OtherActor == nullptr || OtherComponent == nullptr)
 		return;
 
-	if (HasAuthority())
+	// 프록시는 보여주기만 함 (판정은 서버 투사체)
+	if (HasAuthority() && !bIsPredictedProxy)
 	{
 		UAbilitySystemComponent* TargetASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(OtherActor);
 		UAbilitySystemComponent* SourceASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(GetInstigator());
@@ -220,22 +492,14 @@ void AHaroProjectileBase::ApplyDamageToTarget(AActor* TargetActor, const FHitRes
 	// DamageEffectSpecHandle이 유효한지 확인
 	if (!DamageEffectSpecHandle.IsValid()) return;
 
-	FGameplayEffectContext* Context = DamageEffectSpecHandle.Data->GetContext().Get();
-	if (Context)
-	{
-		Context->AddHitResult(HitResult);  // 충돌 정보 추가
-		// AddInstigator도 해줘야 할까? // 내가 알기로는 MakeEffectContext할때 함수 안에 AddInstigator도 같이 있는 것으로 암.
-		// AddInstigator(instigator, effectCauser) 여서 effectCauser를 this로 하면 투사체로 설정이 되어 데미지가 들어왔던 것임.
-	}
-
 	// 타겟의 AbilitySystemComponent 찾기
 	UAbilitySystemComponent* TargetASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(TargetActor);
 	if (!TargetASC) return;
 
 	// GameplayEffect 적용
-	FActiveGameplayEffectHandle EffectHandle = TargetASC->ApplyGameplayEffectSpecToSelf(
-		*DamageEffectSpecHandle.Data.Get()
-	);
+	// 스펙은 같은 무기로 쏜 투사체들이 같이 쓰는 템플릿이라 충돌 정보는 적용할 때만 넣음
+	// (AddInstigator는 MakeEffectContext에서 이미 함. effectCauser를 this로 하면 투사체로 설정이 되어 데미지가 들어왔던 것임.)
+	FHaroEffectSpecCache::ApplySpecWithHitResult(TargetASC, DamageEffectSpecHandle, HitResult);
 }
 
 void AHaroProjectileBase::SpawnAOEOnHit(const FHitResult& HitResult)
@@ -26,6 +26,7 @@ class LYRAGAME_API AHaroProjectileBase : public AActor
 public:	
 	AHaroProjectileBase(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
+	// 발사 속도. 스폰/풀 활성화 전에 호출하면 클래스의 InitialSpeed 대신 이 값으로 발사됨.
 	UFUNCTION(BlueprintCallable)
 	void SetSpeed(float Speed);
 
@@ -46,10 +47,60 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "AOE")
 	void SetAOEDamageSpec(const FGameplayEffectSpecHandle& InDamageSpec);
 
+	// ==================== 풀링 관련 ====================
+
+	// 수명 설정. 풀링된 투사체는 Destroy 대신 수명이 끝나면 풀로 돌아감.
+	UFUNCTION(BlueprintCallable, Category = "Projectile")
+	void SetProjectileLifespan(float InLifespan);
+
+	// 풀링된 투사체는 풀로 돌려보내고, 아니면 Destroy
+	UFUNCTION(BlueprintCallable, Category = "Projectile")
+	void ReleaseProjectile();
+
+	bool IsPooled() const { return bIsPooled; }
+	bool IsPoolActive() const { return bPoolActive; }
+
+	// ==================== 클라이언트 예측 관련 ====================
+
+	// 발사한 활성화의 예측 키 (서버에서 설정, 쏜 클라이언트가 자기 프록시를 찾는 데 씀)
+	void SetPredictionKey(int16 InPredictionKey) { PredictionKey = InPredictionKey; }
+	int16 GetPredictionKey() const { return PredictionKey; }
+
+	// 쏜 클라이언트에서만 존재하는 보여주기용 투사체로 만듦 (FinishSpawning 전에 호출, 복제/데미지/AOE 없음)
+	void InitPredictedProxy();
+	bool IsPredictedProxy() const { return bIsPredictedProxy; }
+
+	// 프록시가 대신 보이는 동안 서버 투사체를 숨김 (쏜 클라이언트에서만)
+	void SetHiddenByPredictedProxy(bool bHidden);
+
+	// 다른 투사체와 서로 부딪히지 않게 함 (프록시 <-> 서버 투사체)
+	void IgnoreProjectileWhenMoving(AHaroProjectileBase* OtherProjectile);
+
+	//~AActor interface
+	virtual void PostInitializeComponents() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	//~End of AActor interface
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Destroyed() override;
 
+	// 풀에서 다시 꺼내질 때 (설정 적용 전)
+	virtual void OnAcquiredFromPool();
+
+	// 설정이 끝난 뒤 실제로 활성화될 때 (FinishSpawning에 해당)
+	virtual void OnActivatedFromPool();
+
+	// 풀로 돌아갈 때. HitActors, AttachingComponent, 데미지 스펙 등 발사 단위 상태를 모두 초기화.
+	virtual void OnReturnedToPool();
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "Projectile", meta = (DisplayName = "On Activated From Pool"))
+	void K2_OnActivatedFromPool();
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "Projectile", meta = (DisplayName = "On Returned To Pool"))
+	void K2_OnReturnedToPool();
+
 private:
 	UFUNCTION()
 	void HandleComponentHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComponent, FVector NormalImpulse, const FHitResult& HitResult);
@@ -67,6 +118,23 @@ private:
 
 	virtual void SpawnAOEOnHit(const FHitResult& HitResult);
 
+	// 클래스 기본 속도 방향 + (SetSpeed 값 또는 InitialSpeed)로 초기 속도 설정. 새 스폰과 풀 활성화가 같이 사용.
+	void InitializeLaunchVelocity();
+
+	// 활성/비활성 상태를 컴포넌트에 반영 (서버, 클라 공통)
+	void ApplyPoolActiveState();
+
+	UFUNCTION()
+	void OnRep_PoolActive();
+
+	// 쏜 클라이언트에 도착한 서버 투사체를 프록시와 연결
+	void TryReconcileWithPredictedProxy();
+
+	// 프록시와 연결된 서버 투사체가 멈춤 (충돌, 풀 반환, 파괴)
+	void NotifyPredictedProxyServerStopped();
+
+	friend class UHaroProjectilePoolSubsystem;
+
 protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	TObjectPtr<USphereComponent> SphereCollisionComponent; // 이거 좀 더 다양하게 가능하도록 수정하는 것도 나쁘지 않을 듯.
@@ -102,4 +170,30 @@ private:
 
 	UPROPERTY()
 	FGameplayEffectSpecHandle AOEDamageEffectSpecHandle;
+
+	// ==================== 풀링 관련 ====================
+
+	// UHaroProjectilePoolSubsystem이 만든 투사체인지
+	bool bIsPooled = false;
+
+	// 풀 밖에서 사용 중인지 (클라이언트도 이 값으로 숨김/충돌/이동을 맞춤)
+	UPROPERTY(ReplicatedUsing = OnRep_PoolActive)
+	bool bPoolActive = true;
+
+	// SetSpeed로 지정된 발사 속도 (0이면 InitialSpeed 사용)
+	float LaunchSpeed = 0.0f;
+
+	// 풀링된 투사체의 수명 타이머 (SetLifeSpan은 Destroy하므로 사용하지 않음)
+	FTimerHandle PooledLifespanTimerHandle;
+
+	// ==================== 클라이언트 예측 관련 ====================
+
+	UPROPERTY(Replicated)
+	int16 PredictionKey = 0;
+
+	// 쏜 클라이언트에서 만든 보여주기용 투사체인지
+	bool bIsPredictedProxy = false;
+
+	// 프록시 때문에 숨겨진 서버 투사체인지
+	bool bHiddenByPredictedProxy = false;
 };
@@ -0,0 +1,185 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HaroProjectilePoolSubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HaroProjectileBase.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HaroProjectilePoolSubsystem)
+
+namespace HaroConsoleVariables
+{
+	static bool bEnableProjectilePooling = true;
+	static FAutoConsoleVariableRef CVarEnableProjectilePooling(
+		TEXT("Haro.Projectile.EnablePooling"),
+		bEnableProjectilePooling,
+		TEXT("Should projectiles be recycled through UHaroProjectilePoolSubsystem instead of being spawned/destroyed per shot"),
+		ECVF_Default);
+
+	static int32 MaxPooledProjectilesPerClass = 128;
+	static FAutoConsoleVariableRef CVarMaxPooledProjectilesPerClass(
+		TEXT("Haro.Projectile.MaxPooledPerClass"),
+		MaxPooledProjectilesPerClass,
+		TEXT("Maximum number of inactive projectiles kept per projectile class (extra ones are destroyed on release)"),
+		ECVF_Default);
+}
+
+void UHaroProjectilePoolSubsystem::Deinitialize()
+{
+	Pools.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UHaroProjectilePoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UHaroProjectilePoolSubsystem::IsPoolingEnabled()
+{
+	return HaroConsoleVariables::bEnableProjectilePooling;
+}
+
+AHaroProjectileBase* UHaroProjectilePoolSubsystem::AcquireProjectile(TSubclassOf<AHaroProjectileBase> ProjectileClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator)
+{
+	if (!ProjectileClass)
+	{
+		return nullptr;
+	}
+
+	FHaroProjectilePool& Pool = Pools.FindOrAdd(ProjectileClass);
+
+	while (Pool.InactiveProjectiles.Num() > 0)
+	{
+		AHaroProjectileBase* Projectile = Pool.InactiveProjectiles.Pop(EAllowShrinking::No);
+
+		// 풀에 있는 동안 레벨 정리 등으로 파괴됐을 수 있음
+		if (!IsValid(Projectile))
+		{
+			--Pool.NumCreated;
+			continue;
+		}
+
+		Projectile->SetActorTransform(SpawnTransform, /*bSweep=*/ false, /*OutSweepHitResult=*/ nullptr, ETeleportType::ResetPhysics);
+		Projectile->SetOwner(Owner);
+		Projectile->SetInstigator(Instigator);
+		Projectile->OnAcquiredFromPool();
+
+		return Projectile;
+	}
+
+	return SpawnPooledProjectile(ProjectileClass, SpawnTransform, Owner, Instigator);
+}
+
+void UHaroProjectilePoolSubsystem::FinishAcquire(AHaroProjectileBase* Projectile, const FTransform& SpawnTransform)
+{
+	if (!Projectile)
+	{
+		return;
+	}
+
+	if (!Projectile->HasActorBegunPlay())
+	{
+		// 새로 스폰된 투사체는 일반 경로 그대로
+		Projectile->FinishSpawning(SpawnTransform);
+	}
+	else
+	{
+		Projectile->OnActivatedFromPool();
+	}
+}
+
+void UHaroProjectilePoolSubsystem::ReleaseProjectile(AHaroProjectileBase* Projectile)
+{
+	if (!IsValid(Projectile) || !Projectile->bPoolActive)
+	{
+		return;
+	}
+
+	FHaroProjectilePool* Pool = Pools.Find(Projectile->GetClass());
+
+	const bool bKeepInPool = IsPoolingEnabled()
+		&& Projectile->IsPooled()
+		&& (Pool != nullptr)
+		&& (Pool->InactiveProjectiles.Num() < HaroConsoleVariables::MaxPooledProjectilesPerClass);
+
+	if (!bKeepInPool)
+	{
+		if (Pool && Projectile->IsPooled())
+		{
+			--Pool->NumCreated;
+		}
+		Projectile->Destroy();
+		return;
+	}
+
+	Projectile->OnReturnedToPool();
+	Pool->InactiveProjectiles.Add(Projectile);
+}
+
+void UHaroProjectilePoolSubsystem::PrewarmPool(TSubclassOf<AHaroProjectileBase> ProjectileClass, int32 Count)
+{
+	if (!ProjectileClass || !IsPoolingEnabled())
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	if (!World || (World->GetNetMode() == NM_Client))
+	{
+		return;
+	}
+
+	FHaroProjectilePool& Pool = Pools.FindOrAdd(ProjectileClass);
+	const int32 NumToCreate = FMath::Min(Count, HaroConsoleVariables::MaxPooledProjectilesPerClass) - Pool.NumCreated;
+
+	for (int32 Index = 0; Index < NumToCreate; ++Index)
+	{
+		AHaroProjectileBase* Projectile = SpawnPooledProjectile(ProjectileClass, FTransform::Identity, /*Owner=*/ nullptr, /*Instigator=*/ nullptr);
+		if (!Projectile)
+		{
+			break;
+		}
+
+		// BeginPlay 시점에 아무것과도 충돌/겹침이 생기지 않도록 비활성 상태로 스폰 완료
+		Projectile->SetActorEnableCollision(false);
+		Projectile->SetActorHiddenInGame(true);
+		Projectile->FinishSpawning(FTransform::Identity);
+
+		Projectile->OnReturnedToPool();
+		Pool.InactiveProjectiles.Add(Projectile);
+	}
+}
+
+void UHaroProjectilePoolSubsystem::GetPoolStats(TSubclassOf<AHaroProjectileBase> ProjectileClass, int32& OutNumInactive, int32& OutNumCreated) const
+{
+	OutNumInactive = 0;
+	OutNumCreated = 0;
+
+	if (const FHaroProjectilePool* Pool = Pools.Find(ProjectileClass))
+	{
+		OutNumInactive = Pool->InactiveProjectiles.Num();
+		OutNumCreated = Pool->NumCreated;
+	}
+}
+
+AHaroProjectileBase* UHaroProjectilePoolSubsystem::SpawnPooledProjectile(TSubclassOf<AHaroProjectileBase> ProjectileClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator)
+{
+	AHaroProjectileBase* Projectile = GetWorld()->SpawnActorDeferred<AHaroProjectileBase>(
+		ProjectileClass,
+		SpawnTransform,
+		Owner,
+		Instigator,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+	if (Projectile)
+	{
+		Projectile->bIsPooled = true;
+		++Pools.FindOrAdd(ProjectileClass).NumCreated;
+	}
+
+	return Projectile;
+}
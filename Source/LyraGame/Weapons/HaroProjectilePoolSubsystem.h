@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+
+#include "HaroProjectilePoolSubsystem.generated.h"
+
+class AActor;
+class AHaroProjectileBase;
+class APawn;
+
+/** 투사체 클래스 하나에 대한 풀 */
+USTRUCT()
+struct FHaroProjectilePool
+{
+	GENERATED_BODY()
+
+	/** 대기 중인(비활성) 투사체들 */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AHaroProjectileBase>> InactiveProjectiles;
+
+	/** 이 풀에서 만들어진 투사체 총 개수 (활성 + 비활성) */
+	int32 NumCreated = 0;
+};
+
+/**
+ * 투사체 클래스별로 AHaroProjectileBase를 재사용하는 월드 서브시스템 (서버 전용)
+ *
+ * 매 발사마다 SpawnActorDeferred/Destroy를 하는 대신 비활성 투사체를 꺼내서 재설정하고,
+ * 수명이 끝나면 Destroy 대신 풀로 돌려보냄.
+ * 풀에 들어간 투사체는 숨김 + 충돌/이동 비활성 + DORM_DormantAll 상태가 되어 대역폭을 쓰지 않음.
+ *
+ * 사용 순서는 SpawnActorDeferred/FinishSpawning과 동일함:
+ *   AcquireProjectile -> (설정) -> FinishAcquire
+ */
+UCLASS()
+class LYRAGAME_API UHaroProjectilePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~USubsystem interface
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	/** 풀링이 켜져 있는지 (Haro.Projectile.EnablePooling) */
+	static bool IsPoolingEnabled();
+
+	/**
+	 * 풀에서 투사체를 꺼냄 (없으면 새로 스폰, 아직 BeginPlay/활성화 전 상태)
+	 * 반환된 투사체는 설정을 마친 뒤 반드시 FinishAcquire를 호출해야 함
+	 */
+	AHaroProjectileBase* AcquireProjectile(TSubclassOf<AHaroProjectileBase> ProjectileClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator);
+
+	/** AcquireProjectile로 꺼낸 투사체를 실제로 활성화 (FinishSpawning에 해당) */
+	void FinishAcquire(AHaroProjectileBase* Projectile, const FTransform& SpawnTransform);
+
+	/** 투사체를 풀로 돌려보냄 (풀이 가득 찼으면 Destroy) */
+	void ReleaseProjectile(AHaroProjectileBase* Projectile);
+
+	/** 지정한 개수만큼 미리 만들어둠 (이미 만들어진 개수는 제외) */
+	void PrewarmPool(TSubclassOf<AHaroProjectileBase> ProjectileClass, int32 Count);
+
+	/** 클래스별 (비활성, 생성됨) 개수 */
+	void GetPoolStats(TSubclassOf<AHaroProjectileBase> ProjectileClass, int32& OutNumInactive, int32& OutNumCreated) const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	AHaroProjectileBase* SpawnPooledProjectile(TSubclassOf<AHaroProjectileBase> ProjectileClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator);
+
+private:
+	UPROPERTY(Transient)
+	TMap<TSubclassOf<AHaroProjectileBase>, FHaroProjectilePool> Pools;
+};
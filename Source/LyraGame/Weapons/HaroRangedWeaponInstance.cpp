@@ -7,10 +7,49 @@
 #include "Camera/LyraCameraComponent.h"
 #include "Physics/PhysicalMaterialWithTags.h"
 #include "Weapons/HaroProjectileBase.h"
+#include "Weapons/HaroWeaponSimSubsystem.h"
 #include "Weapons/LyraWeaponInstance.h" // 이건 라이라의 실수일까???
+#include "Net/UnrealNetwork.h"
+#include "LyraLogChannels.h"
+#include "UObject/UObjectIterator.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HaroRangedWeaponInstance)
 
+namespace HaroConsoleVariables
+{
+	static bool bUseBakedWeaponCurves = true;
+	static FAutoConsoleVariableRef CVarUseBakedWeaponCurves(
+		TEXT("Haro.Weapon.UseBakedCurves"),
+		bUseBakedWeaponCurves,
+		TEXT("Should ranged weapons evaluate their spread/heat, charging and falloff curves from baked lookup tables instead of the rich curves"),
+		ECVF_Default);
+
+	static float BakedWeaponCurveTolerance = 0.005f;
+	static FAutoConsoleVariableRef CVarBakedWeaponCurveTolerance(
+		TEXT("Haro.Weapon.BakedCurveTolerance"),
+		BakedWeaponCurveTolerance,
+		TEXT("Largest allowed baked table error, as a fraction of the curve's value range (min 1). Curves over this keep using the rich curve"),
+		ECVF_Default);
+}
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommand HaroValidateBakedCurvesCmd(
+	TEXT("Haro.Weapon.ValidateBakedCurves"),
+	TEXT("Re-bakes the curve tables of every ranged weapon instance with the current tolerance and logs the error of each table against its rich curve"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		for (TObjectIterator<UHaroRangedWeaponInstance> It; It; ++It)
+		{
+			UHaroRangedWeaponInstance* WeaponInstance = *It;
+			if (IsValid(WeaponInstance) && !WeaponInstance->IsTemplate())
+			{
+				WeaponInstance->BakeCurves();
+				WeaponInstance->LogBakedCurves();
+			}
+		}
+	}));
+#endif // !UE_BUILD_SHIPPING
+
 UHaroRangedWeaponInstance::UHaroRangedWeaponInstance(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -23,15 +62,25 @@ void UHaroRangedWeaponInstance::PostLoad()
 {
 	Super::PostLoad();
 
+	BakeCurves();
+
 #if WITH_EDITOR
 	UpdateDebugVisualization();
 #endif
 }
 
+void UHaroRangedWeaponInstance::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ThisClass, SpreadSeed);
+}
+
 #if WITH_EDITOR
 void UHaroRangedWeaponInstance::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
 	Super::PostEditChangeProperty(PropertyChangedEvent);
+	BakeCurves();
 	UpdateDebugVisualization();
 }
 
@@ -46,6 +95,11 @@ void UHaroRangedWeaponInstance::UpdateDebugVisualization()
 #endif
 
 void UHaroRangedWeaponInstance::ConfigureProjectileForInput(AHaroProjectileBase* Projectile, EHaroFireInputType InputType) const
+{
+	ConfigureProjectileForLaunch(Projectile, InputType, ChargingTime);
+}
+
+void UHaroRangedWeaponInstance::ConfigureProjectileForLaunch(AHaroProjectileBase* Projectile, EHaroFireInputType InputType, float InChargingTime) const
 {
 	if (const FHaroFireModeConfig* Mode = GetFireModeForInput(InputType))
 	{
@@ -56,20 +110,21 @@ void UHaroRangedWeaponInstance::ConfigureProjectileForInput(AHaroProjectileBase*
 
 		// 성능 개선을 위해 Getter 함수를 따로 사용하지 않음.
 		const FHaroProjectileFireConfig& Config = Mode->ProjectileConfig;
+		const FBakedFireModeCurves* BakedCurves = GetBakedCurvesForInput(InputType);
 		const bool bHasCharging = Config.MaxChargingTime > 0.0f;
 
 		const float BaseSpeed = Config.ProjectileSpeed;
 		const float FinalSpeed = (bHasCharging && Config.TimeToSpeedCurve.GetRichCurveConst()->HasAnyData())
-			? BaseSpeed * Config.TimeToSpeedCurve.GetRichCurveConst()->Eval(ChargingTime)
+			? BaseSpeed * EvalCurve(BakedCurves ? &BakedCurves->TimeToSpeed : nullptr, Config.TimeToSpeedCurve, InChargingTime)
 			: BaseSpeed;
 
 		const float FinalSizeMultiplier = (bHasCharging && Config.TimeToSizeCurve.GetRichCurveConst()->HasAnyData())
-			? Config.TimeToSizeCurve.GetRichCurveConst()->Eval(ChargingTime)
+			? EvalCurve(BakedCurves ? &BakedCurves->TimeToSize : nullptr, Config.TimeToSizeCurve, InChargingTime)
 			: Config.SizeMultiplier;
 
 		// 투사체에 설정 적용
 		Projectile->SetSpeed(FinalSpeed);
-		Projectile->SetLifeSpan(Config.ProjectileLifespan);
+		Projectile->SetProjectileLifespan(Config.ProjectileLifespan);
 		Projectile->SetGravityScale(Config.ProjectileGravityScale);
 		Projectile->SetActorScale3D(FVector(FinalSizeMultiplier));
 
@@ -81,6 +136,11 @@ void UHaroRangedWeaponInstance::ConfigureProjectileForInput(AHaroProjectileBase*
 
 // TODO : 나중에 히트스캔도 차징이 생기면 수정 필요.
 float UHaroRangedWeaponInstance::GetChargedDamageMultiplier(EHaroFireInputType InputType) const
+{
+	return GetChargedDamageMultiplier(InputType, ChargingTime);
+}
+
+float UHaroRangedWeaponInstance::GetChargedDamageMultiplier(EHaroFireInputType InputType, float InChargingTime) const
 {
 	if (const FHaroFireModeConfig* Mode = GetFireModeForInput(InputType))
 	{
@@ -88,7 +148,8 @@ float UHaroRangedWeaponInstance::GetChargedDamageMultiplier(EHaroFireInputType I
 		{
 			if (Mode->ProjectileConfig.TimeToDamageCurve.GetRichCurveConst()->HasAnyData())
 			{
-				return Mode->ProjectileConfig.TimeToDamageCurve.GetRichCurveConst()->Eval(ChargingTime);
+				const FBakedFireModeCurves* BakedCurves = GetBakedCurvesForInput(InputType);
+				return EvalCurve(BakedCurves ? &BakedCurves->TimeToDamage : nullptr, Mode->ProjectileConfig.TimeToDamageCurve, InChargingTime);
 			}
 		}
 		return Mode->ProjectileConfig.DamageMultiplier; // 기본값
@@ -145,6 +206,11 @@ int32 UHaroRangedWeaponInstance::GetProjectilesPerCartridge(EHaroFireInputType I
 }
 
 float UHaroRangedWeaponInstance::GetProjectileSpeed(EHaroFireInputType InputType) const
+{
+	return GetProjectileSpeed(InputType, ChargingTime);
+}
+
+float UHaroRangedWeaponInstance::GetProjectileSpeed(EHaroFireInputType InputType, float InChargingTime) const
 {
 	if (const FHaroFireModeConfig* Mode = GetFireModeForInput(InputType))
 	{
@@ -158,7 +224,8 @@ float UHaroRangedWeaponInstance::GetProjectileSpeed(EHaroFireInputType InputType
 			// 차징 기능이 있고 차징 시간이 설정되어 있으면 배수 적용
 			if (Config.MaxChargingTime > 0.0f && Config.TimeToSpeedCurve.GetRichCurveConst()->HasAnyData())
 			{
-				float SpeedMultiplier = Config.TimeToSpeedCurve.GetRichCurveConst()->Eval(ChargingTime);
+				const FBakedFireModeCurves* BakedCurves = GetBakedCurvesForInput(InputType);
+				float SpeedMultiplier = EvalCurve(BakedCurves ? &BakedCurves->TimeToSpeed : nullptr, Config.TimeToSpeedCurve, InChargingTime);
 				return BaseSpeed * SpeedMultiplier;
 			}
 
@@ -169,6 +236,11 @@ float UHaroRangedWeaponInstance::GetProjectileSpeed(EHaroFireInputType InputType
 }
 
 float UHaroRangedWeaponInstance::GetProjectileSizeMultiplier(EHaroFireInputType InputType) const
+{
+	return GetProjectileSizeMultiplier(InputType, ChargingTime);
+}
+
+float UHaroRangedWeaponInstance::GetProjectileSizeMultiplier(EHaroFireInputType InputType, float InChargingTime) const
 {
 	if (const FHaroFireModeConfig* Mode = GetFireModeForInput(InputType))
 	{
@@ -178,7 +250,8 @@ float UHaroRangedWeaponInstance::GetProjectileSizeMultiplier(EHaroFireInputType
 			// 차징 기능이 있고 차징 시간이 설정되어 있으면 차징된 크기 배율 반환
 			if (Config.MaxChargingTime > 0.0f && Config.TimeToSizeCurve.GetRichCurveConst()->HasAnyData())
 			{
-				return Config.TimeToSizeCurve.GetRichCurveConst()->Eval(ChargingTime);
+				const FBakedFireModeCurves* BakedCurves = GetBakedCurvesForInput(InputType);
+				return EvalCurve(BakedCurves ? &BakedCurves->TimeToSize : nullptr, Config.TimeToSizeCurve, InChargingTime);
 			}
 			// 일반 크기 배율 반환
 			return Config.SizeMultiplier;
@@ -211,10 +284,37 @@ float UHaroRangedWeaponInstance::GetProjectileLifespan(EHaroFireInputType InputT
 	return 10.0f; // 기본값
 }
 
+const FHaroProjectileFireConfig* UHaroRangedWeaponInstance::GetProjectileFireConfig(EHaroFireInputType InputType) const
+{
+	if (const FHaroFireModeConfig* Mode = GetFireModeForInput(InputType))
+	{
+		if (Mode->FireType == EHaroWeaponFireType::Projectile)
+		{
+			return &Mode->ProjectileConfig;
+		}
+	}
+	return nullptr;
+}
+
 void UHaroRangedWeaponInstance::OnEquipped()
 {
 	Super::OnEquipped();
 
+	// 탄퍼짐 시드는 서버에서 한 번만 정함 (첫 복제에 같이 넘어가도록 장착 시점에)
+	if (SpreadSeed == 0)
+	{
+		if (APawn* Pawn = GetPawn(); Pawn && Pawn->HasAuthority())
+		{
+			SpreadSeed = ((static_cast<uint32>(FMath::Rand()) << 16) ^ static_cast<uint32>(FMath::Rand())) | 1u;
+		}
+	}
+
+	// 장착 중에는 커브가 바뀌지 않으므로 여기서 한 번 구워둠
+	BakeCurves();
+
+	// 이전 장착 때 만든 GE 스펙 템플릿은 더 이상 쓰지 않음
+	++EquipSerial;
+
 	// 열을 중간값에서 시작
 	float MinHeatRange;
 	float MaxHeatRange;
@@ -222,17 +322,36 @@ void UHaroRangedWeaponInstance::OnEquipped()
 	CurrentHeat = (MinHeatRange + MaxHeatRange) * 0.5f;
 
 	// 확산 도출
-	CurrentSpreadAngle = HeatToSpreadCurve.GetRichCurveConst()->Eval(CurrentHeat);
+	CurrentSpreadAngle = EvalCurve(&HeatToSpreadTable, HeatToSpreadCurve, CurrentHeat);
 
 	// 배율들을 기본값 1x로 설정
 	CurrentSpreadAngleMultiplier = 1.0f;
 	StandingStillMultiplier = 1.0f;
 	JumpFallMultiplier = 1.0f;
 	CrouchingMultiplier = 1.0f;
+
+	bHeatSettled = false;
+
+	// 틱은 서브시스템에서 다른 무기들과 함께 돌림
+	if (UWorld* World = GetWorld())
+	{
+		if (UHaroWeaponSimSubsystem* WeaponSim = World->GetSubsystem<UHaroWeaponSimSubsystem>())
+		{
+			WeaponSim->RegisterWeapon(this);
+		}
+	}
 }
 
 void UHaroRangedWeaponInstance::OnUnequipped()
 {
+	if (UWorld* World = GetWorld())
+	{
+		if (UHaroWeaponSimSubsystem* WeaponSim = World->GetSubsystem<UHaroWeaponSimSubsystem>())
+		{
+			WeaponSim->UnregisterWeapon(this);
+		}
+	}
+
 	Super::OnUnequipped();
 }
 
@@ -241,8 +360,14 @@ void UHaroRangedWeaponInstance::Tick(float DeltaSeconds)
 	APawn* Pawn = GetPawn();
 	check(Pawn != nullptr);
 
-	const bool bMinSpread = UpdateSpread(DeltaSeconds);
-	const bool bMinMultipliers = UpdateMultipliers(DeltaSeconds);
+	TickWeaponSim(DeltaSeconds, Cast<UCharacterMovementComponent>(Pawn->GetMovementComponent()), ULyraCameraComponent::FindCameraComponent(Pawn));
+}
+
+void UHaroRangedWeaponInstance::TickWeaponSim(float DeltaSeconds, const UCharacterMovementComponent* CharMovementComp, const ULyraCameraComponent* CameraComponent)
+{
+	// 다 식었으면 다시 쏠 때까지 열/탄퍼짐은 그대로임
+	const bool bMinSpread = bHeatSettled ? bSettledAtMinSpread : UpdateSpread(DeltaSeconds);
+	const bool bMinMultipliers = UpdateMultipliers(DeltaSeconds, CharMovementComp, CameraComponent);
 
 	bHasFirstShotAccuracy = bAllowFirstShotAccuracy && bMinMultipliers && bMinSpread;
 
@@ -253,6 +378,23 @@ void UHaroRangedWeaponInstance::Tick(float DeltaSeconds)
 
 void UHaroRangedWeaponInstance::ComputeHeatRange(float& MinHeat, float& MaxHeat)
 {
+	// 범위는 구울 때 같이 저장해둠 (ClampHeat/UpdateSpread에서 매번 호출됨)
+	if (bCurvesBaked)
+	{
+		float Min1, Max1;
+		HeatToHeatPerShotTable.GetTimeRange(/*out*/ Min1, /*out*/ Max1);
+
+		float Min2, Max2;
+		HeatToCoolDownPerSecondTable.GetTimeRange(/*out*/ Min2, /*out*/ Max2);
+
+		float Min3, Max3;
+		HeatToSpreadTable.GetTimeRange(/*out*/ Min3, /*out*/ Max3);
+
+		MinHeat = FMath::Min(FMath::Min(Min1, Min2), Min3);
+		MaxHeat = FMath::Max(FMath::Max(Max1, Max2), Max3);
+		return;
+	}
+
 	float Min1, Max1;
 	HeatToHeatPerShotCurve.GetRichCurveConst()->GetTimeRange(/*out*/ Min1, /*out*/ Max1);
 
@@ -268,17 +410,91 @@ void UHaroRangedWeaponInstance::ComputeHeatRange(float& MinHeat, float& MaxHeat)
 
 void UHaroRangedWeaponInstance::ComputeSpreadRange(float& MinSpread, float& MaxSpread)
 {
+	if (bCurvesBaked)
+	{
+		HeatToSpreadTable.GetValueRange(/*out*/ MinSpread, /*out*/ MaxSpread);
+		return;
+	}
+
 	HeatToSpreadCurve.GetRichCurveConst()->GetValueRange(/*out*/ MinSpread, /*out*/ MaxSpread);
 }
 
+void UHaroRangedWeaponInstance::BakeCurves()
+{
+	const float Tolerance = HaroConsoleVariables::BakedWeaponCurveTolerance;
+
+	HeatToSpreadTable.Bake(*HeatToSpreadCurve.GetRichCurveConst(), Tolerance);
+	HeatToHeatPerShotTable.Bake(*HeatToHeatPerShotCurve.GetRichCurveConst(), Tolerance);
+	HeatToCoolDownPerSecondTable.Bake(*HeatToCoolDownPerSecondCurve.GetRichCurveConst(), Tolerance);
+
+	BakedFireModeCurves.Reset();
+	for (const TPair<EHaroFireInputType, FHaroFireModeConfig>& Pair : FireModes)
+	{
+		const FHaroFireModeConfig& Mode = Pair.Value;
+		FBakedFireModeCurves& Baked = BakedFireModeCurves.Add(Pair.Key);
+
+		// 발사 타입에 맞는 커브만 구움 (나머지는 평가할 일이 없음)
+		if (Mode.FireType == EHaroWeaponFireType::Hitscan)
+		{
+			Baked.DistanceDamageFalloff.Bake(*Mode.HitscanConfig.DistanceDamageFalloff.GetRichCurveConst(), Tolerance);
+		}
+		else if (Mode.FireType == EHaroWeaponFireType::Projectile)
+		{
+			const FHaroProjectileFireConfig& Config = Mode.ProjectileConfig;
+			Baked.DistanceDamageFalloff.Bake(*Config.DistanceDamageFalloff.GetRichCurveConst(), Tolerance);
+			Baked.TimeToSpeed.Bake(*Config.TimeToSpeedCurve.GetRichCurveConst(), Tolerance);
+			Baked.TimeToDamage.Bake(*Config.TimeToDamageCurve.GetRichCurveConst(), Tolerance);
+			Baked.TimeToSize.Bake(*Config.TimeToSizeCurve.GetRichCurveConst(), Tolerance);
+		}
+	}
+
+	bCurvesBaked = true;
+}
+
+void UHaroRangedWeaponInstance::LogBakedCurves() const
+{
+	auto LogTable = [this](const TCHAR* Name, const FHaroBakedCurve& Table)
+	{
+		if (Table.HasAnyData())
+		{
+			UE_LOG(LogLyra, Display, TEXT("  %-32s %s (max error %.5f)"), Name, Table.IsBaked() ? TEXT("baked") : TEXT("rich curve"), Table.GetMaxError());
+		}
+	};
+
+	UE_LOG(LogLyra, Display, TEXT("Curve tables for %s:"), *GetPathName());
+	LogTable(TEXT("HeatToSpread"), HeatToSpreadTable);
+	LogTable(TEXT("HeatToHeatPerShot"), HeatToHeatPerShotTable);
+	LogTable(TEXT("HeatToCoolDownPerSecond"), HeatToCoolDownPerSecondTable);
+
+	for (const TPair<EHaroFireInputType, FBakedFireModeCurves>& Pair : BakedFireModeCurves)
+	{
+		const FString Prefix = UEnum::GetValueAsString(Pair.Key);
+		LogTable(*(Prefix + TEXT(".DistanceDamageFalloff")), Pair.Value.DistanceDamageFalloff);
+		LogTable(*(Prefix + TEXT(".TimeToSpeed")), Pair.Value.TimeToSpeed);
+		LogTable(*(Prefix + TEXT(".TimeToDamage")), Pair.Value.TimeToDamage);
+		LogTable(*(Prefix + TEXT(".TimeToSize")), Pair.Value.TimeToSize);
+	}
+}
+
+float UHaroRangedWeaponInstance::EvalCurve(const FHaroBakedCurve* Table, const FRuntimeFloatCurve& Curve, float Time)
+{
+	if (Table && Table->IsBaked() && HaroConsoleVariables::bUseBakedWeaponCurves)
+	{
+		return Table->Eval(Time);
+	}
+
+	return Curve.GetRichCurveConst()->Eval(Time);
+}
+
 void UHaroRangedWeaponInstance::AddSpread()
 {
 	// 열 증가 커브 샘플링
-	const float HeatPerShot = HeatToHeatPerShotCurve.GetRichCurveConst()->Eval(CurrentHeat);
+	const float HeatPerShot = EvalCurve(&HeatToHeatPerShotTable, HeatToHeatPerShotCurve, CurrentHeat);
 	CurrentHeat = ClampHeat(CurrentHeat + HeatPerShot);
+	bHeatSettled = false;
 
 	// 열을 확산각도로 매핑
-	CurrentSpreadAngle = HeatToSpreadCurve.GetRichCurveConst()->Eval(CurrentHeat);
+	CurrentSpreadAngle = EvalCurve(&HeatToSpreadTable, HeatToSpreadCurve, CurrentHeat);
 
 #if WITH_EDITOR
 	UpdateDebugVisualization();
@@ -305,8 +521,8 @@ float UHaroRangedWeaponInstance::GetDistanceAttenuation(float Distance, const FG
 
 		if (Curve)
 		{
-			const FRichCurve* RichCurve = Curve->GetRichCurveConst();
-			return RichCurve->HasAnyData() ? RichCurve->Eval(Distance) : 1.0f;
+			const FBakedFireModeCurves* BakedCurves = GetBakedCurvesForInput(EHaroFireInputType::Primary);
+			return Curve->GetRichCurveConst()->HasAnyData() ? EvalCurve(BakedCurves ? &BakedCurves->DistanceDamageFalloff : nullptr, *Curve, Distance) : 1.0f;
 		}
 	}
 	return 1.0f;
@@ -353,25 +569,31 @@ bool UHaroRangedWeaponInstance::UpdateSpread(float DeltaSeconds)
 
 	if (TimeSinceFired > SpreadRecoveryCooldownDelay)
 	{
-		const float CooldownRate = HeatToCoolDownPerSecondCurve.GetRichCurveConst()->Eval(CurrentHeat);
+		const float CooldownRate = EvalCurve(&HeatToCoolDownPerSecondTable, HeatToCoolDownPerSecondCurve, CurrentHeat);
 		CurrentHeat = ClampHeat(CurrentHeat - (CooldownRate * DeltaSeconds));
-		CurrentSpreadAngle = HeatToSpreadCurve.GetRichCurveConst()->Eval(CurrentHeat);
+		CurrentSpreadAngle = EvalCurve(&HeatToSpreadTable, HeatToSpreadCurve, CurrentHeat);
+
+		float MinHeat;
+		float MaxHeat;
+		ComputeHeatRange(/*out*/ MinHeat, /*out*/ MaxHeat);
+		bHeatSettled = (CurrentHeat <= MinHeat);
 	}
 
 	float MinSpread;
 	float MaxSpread;
 	ComputeSpreadRange(/*out*/ MinSpread, /*out*/ MaxSpread);
 
-	return FMath::IsNearlyEqual(CurrentSpreadAngle, MinSpread, KINDA_SMALL_NUMBER);
+	const bool bMinSpread = FMath::IsNearlyEqual(CurrentSpreadAngle, MinSpread, KINDA_SMALL_NUMBER);
+	bSettledAtMinSpread = bMinSpread;
+	return bMinSpread;
 }
 
-bool UHaroRangedWeaponInstance::UpdateMultipliers(float DeltaSeconds)
+bool UHaroRangedWeaponInstance::UpdateMultipliers(float DeltaSeconds, const UCharacterMovementComponent* CharMovementComp, const ULyraCameraComponent* CameraComponent)
 {
 	const float MultiplierNearlyEqualThreshold = 0.05f;
 
 	APawn* Pawn = GetPawn();
 	check(Pawn != nullptr);
-	UCharacterMovementComponent* CharMovementComp = Cast<UCharacterMovementComponent>(Pawn->GetMovementComponent());
 
 	// 정지 상태인지 확인하고, 그렇다면 부드럽게 보너스 적용
 	const float PawnSpeed = Pawn->GetVelocity().Size();
@@ -396,7 +618,7 @@ bool UHaroRangedWeaponInstance::UpdateMultipliers(float DeltaSeconds)
 
 	// 조준 상태인지 확인하고, 카메라 전환 정도에 따라 보너스 적용
 	float AimingAlpha = 0.0f;
-	if (const ULyraCameraComponent* CameraComponent = ULyraCameraComponent::FindCameraComponent(Pawn))
+	if (CameraComponent != nullptr)
 	{
 		float TopCameraWeight;
 		FGameplayTag TopCameraTag;
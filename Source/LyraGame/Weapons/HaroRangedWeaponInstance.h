@@ -12,6 +12,8 @@
 
 class UPhysicalMaterial;
 class AHaroProjectileBase;
+class UCharacterMovementComponent;
+class ULyraCameraComponent;
 
 
 /** 발사 모드 설정 */
@@ -49,6 +51,10 @@ public:
 
     virtual void PostLoad() override;
 
+    //~UObject interface
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+    //~End of UObject interface
+
 #if WITH_EDITOR
     virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
     
@@ -82,7 +88,12 @@ public:
     /** 투사체 설정 (입력 타입 기준) */
     UFUNCTION(BlueprintCallable, Category = "Projectile")
     void ConfigureProjectileForInput(AHaroProjectileBase* Projectile, EHaroFireInputType InputType) const;
+
+    /** 투사체 설정 (현재 차징 시간 대신 발사 시점의 차징 시간 사용, 서버 검증 후 스폰용) */
+    void ConfigureProjectileForLaunch(AHaroProjectileBase* Projectile, EHaroFireInputType InputType, float InChargingTime) const;
+
     float GetChargedDamageMultiplier(EHaroFireInputType InputType) const;
+    float GetChargedDamageMultiplier(EHaroFireInputType InputType, float InChargingTime) const;
 
     // ========== 히트스캔 관련 함수들 (입력 타입별) ==========
     int32 GetBulletsPerCartridge(EHaroFireInputType InputType) const;
@@ -92,15 +103,41 @@ public:
     // ========== 투사체 관련 함수들 (입력 타입별) ==========
     int32 GetProjectilesPerCartridge(EHaroFireInputType InputType) const;
     float GetProjectileSpeed(EHaroFireInputType InputType) const;
+    float GetProjectileSpeed(EHaroFireInputType InputType, float InChargingTime) const;
     float GetProjectileSizeMultiplier(EHaroFireInputType InputType) const;
+    float GetProjectileSizeMultiplier(EHaroFireInputType InputType, float InChargingTime) const;
     float GetProjectileGravityScale(EHaroFireInputType InputType) const;
     float GetProjectileLifespan(EHaroFireInputType InputType) const;
 
+    /** 입력 타입의 투사체 설정 (투사체 모드가 아니면 nullptr) */
+    const FHaroProjectileFireConfig* GetProjectileFireConfig(EHaroFireInputType InputType) const;
+
     // ========== 확산 시스템 관련 함수들 ==========
     float GetCalculatedSpreadAngle() const { return CurrentSpreadAngle; }
     float GetCalculatedSpreadAngleMultiplier() const { return bHasFirstShotAccuracy ? 0.0f : CurrentSpreadAngleMultiplier; }
     bool HasFirstShotAccuracy() const { return bHasFirstShotAccuracy; }
     float GetSpreadExponent() const { return SpreadExponent; }
+    bool AllowsFirstShotAccuracy() const { return bAllowFirstShotAccuracy; }
+
+    /** 열이 최소값까지 식어서 다시 쏠 때까지 열/탄퍼짐 갱신이 필요 없는지 */
+    bool IsHeatSettled() const { return bHeatSettled; }
+
+    /** 탄퍼짐 난수 시드 (서버가 장착할 때 정하고 복제됨, 예측 키와 합쳐서 카트리지 시드를 만듦) */
+    uint32 GetSpreadSeed() const { return SpreadSeed; }
+
+    // 서버가 정한 탄퍼짐 시드가 복제됐는지 (시드는 항상 홀수라 0이면 아직 안 받은 것)
+    bool HasSpreadSeed() const { return SpreadSeed != 0; }
+
+    /** 장착할 때마다 바뀜 (어빌리티의 GE 스펙 템플릿이 장착 단위로 속성을 다시 캡처하는 기준) */
+    uint32 GetEquipSerial() const { return EquipSerial; }
+
+    // ========== 커브 테이블 ==========
+
+    /** 열/차징/거리 감쇠 커브를 고정 크기 테이블로 구움 (PostLoad, OnEquipped, 에디터에서 값이 바뀔 때) */
+    void BakeCurves();
+
+    /** 구운 테이블별 최대 오차와 사용 여부를 로그로 출력 */
+    void LogBakedCurves() const;
     
     
 
@@ -185,6 +222,36 @@ protected:
     float TransitionRate_JumpingOrFalling = 5.0f;
 
 private:
+    UPROPERTY(Replicated)
+    uint32 SpreadSeed = 0;
+
+    uint32 EquipSerial = 0;
+
+    // ========== 구운 커브 테이블 ==========
+
+    /** 발사 모드 하나의 커브 테이블 */
+    struct FBakedFireModeCurves
+    {
+        FHaroBakedCurve DistanceDamageFalloff;
+        FHaroBakedCurve TimeToSpeed;
+        FHaroBakedCurve TimeToDamage;
+        FHaroBakedCurve TimeToSize;
+    };
+
+    FHaroBakedCurve HeatToSpreadTable;
+    FHaroBakedCurve HeatToHeatPerShotTable;
+    FHaroBakedCurve HeatToCoolDownPerSecondTable;
+    TMap<EHaroFireInputType, FBakedFireModeCurves> BakedFireModeCurves;
+    bool bCurvesBaked = false;
+
+    /** 테이블을 쓸 수 있으면 테이블로, 아니면 원래 커브로 평가 */
+    static float EvalCurve(const FHaroBakedCurve* Table, const FRuntimeFloatCurve& Curve, float Time);
+
+    const FBakedFireModeCurves* GetBakedCurvesForInput(EHaroFireInputType InputType) const
+    {
+        return BakedFireModeCurves.Find(InputType);
+    }
+
     // ========== 런타임 상태 변수들 ==========
 
     /** 현재 설정된 차징 시간 (초) */
@@ -199,9 +266,18 @@ private:
     float JumpFallMultiplier = 1.0f;
     float CrouchingMultiplier = 1.0f;
 
+    /** 열이 최소값에 도달했고 그 뒤로 쏘지 않았음 (UpdateSpread를 건너뜀) */
+    bool bHeatSettled = false;
+
+    /** 열이 식은 시점의 탄퍼짐이 최소값인지 (건너뛰는 동안 첫 발 정확도 판정에 그대로 사용) */
+    bool bSettledAtMinSpread = false;
+
 public:
     void Tick(float DeltaSeconds);
 
+    /** UHaroWeaponSimSubsystem에서 호출 (이동/카메라 컴포넌트는 서브시스템이 찾아둔 것을 넘김) */
+    void TickWeaponSim(float DeltaSeconds, const UCharacterMovementComponent* CharMovementComp, const ULyraCameraComponent* CameraComponent);
+
     //~ULyraEquipmentInstance interface
     virtual void OnEquipped();
     virtual void OnUnequipped();
@@ -229,5 +305,5 @@ private:
     }
 
     bool UpdateSpread(float DeltaSeconds);
-    bool UpdateMultipliers(float DeltaSeconds);
+    bool UpdateMultipliers(float DeltaSeconds, const UCharacterMovementComponent* CharMovementComp, const ULyraCameraComponent* CameraComponent);
 };
@@ -0,0 +1,206 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HaroSimulatedProjectileSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "AbilitySystem/HaroEffectSpecCache.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HaroAOEBase.h"
+#include "NiagaraComponent.h"
+#include "NiagaraFunctionLibrary.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HaroSimulatedProjectileSubsystem)
+
+// 액터 투사체와 같은 충돌 프로필 사용
+static FName NAME_HaroSimulatedProjectileCollisionProfile(TEXT("Projectile"));
+
+void UHaroSimulatedProjectileSubsystem::Deinitialize()
+{
+	for (int32 Index = Positions.Num() - 1; Index >= 0; --Index)
+	{
+		RemoveProjectile(Index);
+	}
+
+	Super::Deinitialize();
+}
+
+bool UHaroSimulatedProjectileSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+ETickableTickType UHaroSimulatedProjectileSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UHaroSimulatedProjectileSubsystem::IsTickable() const
+{
+	return Positions.Num() > 0;
+}
+
+TStatId UHaroSimulatedProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHaroSimulatedProjectileSubsystem, STATGROUP_Tickables);
+}
+
+void UHaroSimulatedProjectileSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	StepProjectiles(DeltaTime);
+}
+
+void UHaroSimulatedProjectileSubsystem::FireProjectile(const FHaroSimulatedProjectileFireEvent& FireEvent, const FHaroSimulatedProjectilePayload& Payload, bool bAuthoritative)
+{
+	UWorld* World = GetWorld();
+	if (!World || (FireEvent.Speed <= 0.0f))
+	{
+		return;
+	}
+
+	Positions.Add(FireEvent.Origin);
+	Velocities.Add(FVector(FireEvent.Direction) * FireEvent.Speed);
+	GravityScales.Add(FireEvent.GravityScale);
+	Radii.Add(FMath::Max(FireEvent.Radius, 0.0f));
+	RemainingLifetimes.Add((FireEvent.Lifespan > 0.0f) ? FireEvent.Lifespan : TNumericLimits<float>::Max());
+	AuthoritativeFlags.Add(bAuthoritative);
+	// 보이기만 하는 투사체도 쏜 캐릭터/무기와는 부딪히지 않도록 발사 이벤트의 값으로 채움
+	FHaroSimulatedProjectilePayload& AddedPayload = Payloads.Add_GetRef(Payload);
+	if (!AddedPayload.Instigator.IsValid())
+	{
+		AddedPayload.Instigator = FireEvent.Instigator;
+	}
+	if (!AddedPayload.Owner.IsValid())
+	{
+		AddedPayload.Owner = FireEvent.Owner;
+	}
+
+	// 이펙트는 보이는 곳에서만
+	UNiagaraComponent* Tracer = nullptr;
+	if (FireEvent.TracerSystem && (World->GetNetMode() != NM_DedicatedServer))
+	{
+		Tracer = UNiagaraFunctionLibrary::SpawnSystemAtLocation(World, FireEvent.TracerSystem, FireEvent.Origin, FVector(FireEvent.Direction).Rotation(),
+			FVector(1.0f), /*bAutoDestroy=*/ false, /*bAutoActivate=*/ true, ENCPoolMethod::ManualRelease);
+	}
+	Tracers.Add(Tracer);
+
+	++NumFiredProjectiles;
+}
+
+void UHaroSimulatedProjectileSubsystem::StepProjectiles(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_HaroSimulatedProjectile_Step);
+
+	UWorld* World = GetWorld();
+	const float GravityZ = World->GetGravityZ();
+
+	// 뒤에서부터 돌아야 RemoveAtSwap해도 아직 처리하지 않은 항목이 섞이지 않음
+	for (int32 Index = Positions.Num() - 1; Index >= 0; --Index)
+	{
+		RemainingLifetimes[Index] -= DeltaTime;
+		if (RemainingLifetimes[Index] <= 0.0f)
+		{
+			RemoveProjectile(Index);
+			continue;
+		}
+
+		FVector& Velocity = Velocities[Index];
+		Velocity.Z += GravityZ * GravityScales[Index] * DeltaTime;
+
+		const FVector Start = Positions[Index];
+		const FVector End = Start + (Velocity * DeltaTime);
+
+		const FHaroSimulatedProjectilePayload& Payload = Payloads[Index];
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HaroSimulatedProjectile), /*bTraceComplex=*/ false, Payload.Instigator.Get());
+		QueryParams.AddIgnoredActor(Payload.Owner.Get());
+		QueryParams.bReturnPhysicalMaterial = true;
+
+		FHitResult HitResult;
+		if (World->SweepSingleByProfile(HitResult, Start, End, FQuat::Identity, NAME_HaroSimulatedProjectileCollisionProfile, FCollisionShape::MakeSphere(Radii[Index]), QueryParams))
+		{
+			if (AuthoritativeFlags[Index])
+			{
+				HandleImpact(Index, HitResult);
+			}
+
+			RemoveProjectile(Index);
+			continue;
+		}
+
+		Positions[Index] = End;
+
+		if (UNiagaraComponent* Tracer = Tracers[Index].Get())
+		{
+			Tracer->SetWorldLocationAndRotation(End, Velocity.Rotation());
+		}
+	}
+}
+
+void UHaroSimulatedProjectileSubsystem::HandleImpact(int32 Index, const FHitResult& HitResult)
+{
+	FHaroSimulatedProjectilePayload& Payload = Payloads[Index];
+
+	AActor* HitActor = HitResult.GetActor();
+	APawn* Instigator = Payload.Instigator.Get();
+	UAbilitySystemComponent* SourceASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Instigator);
+
+	// 시각적 효과 (AHaroProjectileBase와 동일)
+	if (SourceASC && Payload.HitGameplayCueTag.IsValid())
+	{
+		FGameplayCueParameters SourceCueParams;
+		SourceCueParams.Location = HitResult.ImpactPoint;
+		SourceCueParams.Normal = HitResult.ImpactNormal;
+		SourceCueParams.PhysicalMaterial = HitResult.PhysMaterial;
+		SourceASC->ExecuteGameplayCue(Payload.HitGameplayCueTag, SourceCueParams);
+	}
+
+	// 데미지 적용
+	if (HitActor && Payload.DamageEffectSpecHandle.IsValid())
+	{
+		if (UAbilitySystemComponent* TargetASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(HitActor))
+		{
+			// 스펙은 어빌리티의 템플릿을 공유하므로 충돌 정보는 적용할 때만 넣음
+			FHaroEffectSpecCache::ApplySpecWithHitResult(TargetASC, Payload.DamageEffectSpecHandle, HitResult);
+		}
+	}
+
+	// AOE 스폰
+	if (Payload.AOEClass)
+	{
+		const FTransform SpawnTransform(FRotator::ZeroRotator, HitResult.ImpactPoint, FVector::OneVector);
+
+		if (AHaroAOEBase* SpawnedAOE = GetWorld()->SpawnActorDeferred<AHaroAOEBase>(
+			Payload.AOEClass,
+			SpawnTransform,
+			Payload.Owner.Get(),
+			Instigator,
+			ESpawnActorCollisionHandlingMethod::AlwaysSpawn))
+		{
+			SpawnedAOE->SetDamageEffectSpec(Payload.AOEDamageEffectSpecHandle);
+			SpawnedAOE->FinishSpawning(SpawnTransform);
+		}
+	}
+}
+
+void UHaroSimulatedProjectileSubsystem::RemoveProjectile(int32 Index)
+{
+	if (UNiagaraComponent* Tracer = Tracers[Index].Get())
+	{
+		Tracer->Deactivate();
+		Tracer->ReleaseToPool();
+	}
+
+	Positions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Velocities.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	GravityScales.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Radii.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	RemainingLifetimes.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	AuthoritativeFlags.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Payloads.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Tracers.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Engine/NetSerialization.h"
+#include "GameplayEffectTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+
+#include "HaroSimulatedProjectileSubsystem.generated.h"
+
+class AActor;
+class AHaroAOEBase;
+class APawn;
+class UNiagaraComponent;
+class UNiagaraSystem;
+struct FHitResult;
+
+/**
+ * 시뮬레이션 투사체 발사 이벤트 (네트워크로 보내는 것은 이것뿐)
+ * 클라이언트는 이 값으로 투사체를 로컬에서 시뮬레이션해서 보여줌
+ */
+USTRUCT()
+struct FHaroSimulatedProjectileFireEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector_NetQuantize10 Origin;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal Direction;
+
+	UPROPERTY()
+	float Speed = 0.0f;
+
+	UPROPERTY()
+	float GravityScale = 1.0f;
+
+	UPROPERTY()
+	float Lifespan = 0.0f;
+
+	UPROPERTY()
+	float Radius = 0.0f;
+
+	/** 발사 시드 (어빌리티 예측 키를 사용하므로 발사한 클라이언트와 서버가 같은 값을 가짐) */
+	UPROPERTY()
+	int32 Seed = 0;
+
+	/** 쏜 캐릭터 (스윕에서 무시함) */
+	UPROPERTY()
+	TObjectPtr<APawn> Instigator = nullptr;
+
+	/** 무기 액터 (스윕에서 무시함) */
+	UPROPERTY()
+	TObjectPtr<AActor> Owner = nullptr;
+
+	UPROPERTY()
+	TObjectPtr<UNiagaraSystem> TracerSystem = nullptr;
+};
+
+/** 서버에서만 필요한 투사체 데이터 (복제되지 않음) */
+struct FHaroSimulatedProjectilePayload
+{
+	TWeakObjectPtr<APawn> Instigator;
+	TWeakObjectPtr<AActor> Owner;
+
+	FGameplayEffectSpecHandle DamageEffectSpecHandle;
+
+	TSubclassOf<AHaroAOEBase> AOEClass;
+	FGameplayEffectSpecHandle AOEDamageEffectSpecHandle;
+
+	FGameplayTag HitGameplayCueTag;
+};
+
+/**
+ * 액터 없이 투사체를 시뮬레이션하는 월드 서브시스템
+ *
+ * 투사체 상태는 평탄한 배열(SoA)에 저장하고, 매 틱 한 번의 패스로 모든 투사체를 스윕 이동시킴.
+ * 서버는 충돌 시 데미지/AOE/게임플레이 큐를 처리하고, 클라이언트는 같은 시뮬레이션을 보이기만 함.
+ * (빠르고 수명이 짧은 탄환용, 발사 이벤트 외에는 복제되지 않음)
+ */
+UCLASS()
+class LYRAGAME_API UHaroSimulatedProjectileSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~USubsystem interface
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	//~FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	//~End of FTickableGameObject interface
+
+	/**
+	 * 투사체 추가
+	 * @param bAuthoritative	true면 충돌 시 데미지 등을 처리 (서버), false면 보이기만 함 (클라이언트)
+	 */
+	void FireProjectile(const FHaroSimulatedProjectileFireEvent& FireEvent, const FHaroSimulatedProjectilePayload& Payload, bool bAuthoritative);
+
+	int32 GetNumActiveProjectiles() const { return Positions.Num(); }
+
+	/** 지금까지 발사된 투사체 수 (액터 백엔드와 비교용) */
+	int32 GetNumFiredProjectiles() const { return NumFiredProjectiles; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void StepProjectiles(float DeltaTime);
+	void HandleImpact(int32 Index, const FHitResult& HitResult);
+	void RemoveProjectile(int32 Index);
+
+private:
+	// ========== 매 틱 접근하는 데이터 ==========
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<float> GravityScales;
+	TArray<float> Radii;
+	TArray<float> RemainingLifetimes;
+	TArray<bool> AuthoritativeFlags;
+
+	// ========== 충돌/정리 시에만 접근하는 데이터 ==========
+	TArray<FHaroSimulatedProjectilePayload> Payloads;
+	TArray<TWeakObjectPtr<UNiagaraComponent>> Tracers;
+
+	int32 NumFiredProjectiles = 0;
+};
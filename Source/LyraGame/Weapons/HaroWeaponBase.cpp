@@ -3,6 +3,7 @@
 
 #include "Weapons/HaroWeaponBase.h"
 #include "Character/LyraCharacter.h"
+#include "Weapons/HaroSimulatedProjectileSubsystem.h"
 
 AHaroWeaponBase::AHaroWeaponBase()
 {
@@ -62,6 +63,27 @@ void AHaroWeaponBase::OnWeaponActivated()
 
 
 
+void AHaroWeaponBase::MulticastSimulatedProjectileFired_Implementation(const FHaroSimulatedProjectileFireEvent& FireEvent)
+{
+	// 서버는 이미 시뮬레이션 중
+	if (HasAuthority())
+	{
+		return;
+	}
+
+	// 쏜 클라이언트는 발사 시점에 이미 로컬로 띄웠음
+	const APawn* PawnOwner = Cast<APawn>(GetOwner());
+	if (PawnOwner && PawnOwner->IsLocallyControlled())
+	{
+		return;
+	}
+
+	if (UHaroSimulatedProjectileSubsystem* SimulatedProjectiles = UWorld::GetSubsystem<UHaroSimulatedProjectileSubsystem>(GetWorld()))
+	{
+		SimulatedProjectiles->FireProjectile(FireEvent, FHaroSimulatedProjectilePayload(), /*bAuthoritative=*/ false);
+	}
+}
+
 USkeletalMeshComponent* AHaroWeaponBase::GetProperWeaponMesh() const
 {
 	const APawn* PawnOwner = Cast<APawn>(GetOwner());
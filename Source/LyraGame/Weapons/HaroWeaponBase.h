@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Weapons/HaroSimulatedProjectileSubsystem.h"
 #include "HaroWeaponBase.generated.h"
 
 class USkeletalMeshComponent;
@@ -31,6 +32,10 @@ public:
 
 	void OnWeaponActivated(); // 무기가 활성화될 때 호출될 함수
 
+	// 시뮬레이션 투사체 발사 이벤트를 다른 클라이언트에 전달 (무기가 relevant한 클라이언트에게만 감)
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastSimulatedProjectileFired(const FHaroSimulatedProjectileFireEvent& FireEvent);
+
 protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
 	USkeletalMeshComponent* WeaponMesh_1P;
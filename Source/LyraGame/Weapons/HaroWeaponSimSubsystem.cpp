@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HaroWeaponSimSubsystem.h"
+
+#include "Camera/LyraCameraComponent.h"
+#include "Engine/World.h"
+#include "Equipment/HaroEquipmentManagerComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "HaroRangedWeaponInstance.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HaroWeaponSimSubsystem)
+
+DECLARE_STATS_GROUP(TEXT("HaroWeaponSim"), STATGROUP_HaroWeaponSim, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Registered"), STAT_HaroWeaponSim_Registered, STATGROUP_HaroWeaponSim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Simulated"), STAT_HaroWeaponSim_Simulated, STATGROUP_HaroWeaponSim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("HeatSettled"), STAT_HaroWeaponSim_HeatSettled, STATGROUP_HaroWeaponSim);
+
+void UHaroWeaponSimSubsystem::Deinitialize()
+{
+	Weapons.Reset();
+	WeaponKeys.Reset();
+	Entries.Reset();
+	WeaponIndexByKey.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UHaroWeaponSimSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+ETickableTickType UHaroWeaponSimSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UHaroWeaponSimSubsystem::IsTickable() const
+{
+	return Weapons.Num() > 0;
+}
+
+TStatId UHaroWeaponSimSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHaroWeaponSimSubsystem, STATGROUP_Tickables);
+}
+
+void UHaroWeaponSimSubsystem::RegisterWeapon(UHaroRangedWeaponInstance* Weapon)
+{
+	if (!Weapon)
+	{
+		return;
+	}
+
+	APawn* Pawn = Weapon->GetPawn();
+	if (!Pawn)
+	{
+		return;
+	}
+
+	int32 Index = INDEX_NONE;
+	if (const int32* ExistingIndex = WeaponIndexByKey.Find(Weapon))
+	{
+		Index = *ExistingIndex;
+	}
+	else
+	{
+		Index = Weapons.Num();
+		WeaponIndexByKey.Add(Weapon, Index);
+		Weapons.Add(Weapon);
+		WeaponKeys.Add(Weapon);
+		Entries.AddDefaulted();
+	}
+
+	FWeaponSimEntry& Entry = Entries[Index];
+	Entry.Pawn = Pawn;
+	Entry.MovementComponent = Cast<UCharacterMovementComponent>(Pawn->GetMovementComponent());
+	Entry.CameraComponent = ULyraCameraComponent::FindCameraComponent(Pawn);
+	Entry.bRequiresActiveSlot = (Pawn->FindComponentByClass<UHaroEquipmentManagerComponent>() != nullptr);
+}
+
+void UHaroWeaponSimSubsystem::UnregisterWeapon(UHaroRangedWeaponInstance* Weapon)
+{
+	if (const int32* Index = WeaponIndexByKey.Find(Weapon))
+	{
+		RemoveWeaponAt(*Index);
+	}
+}
+
+void UHaroWeaponSimSubsystem::RemoveWeaponAt(int32 Index)
+{
+	WeaponIndexByKey.Remove(WeaponKeys[Index]);
+
+	// 마지막 무기를 빈 자리로 옮김
+	const int32 LastIndex = WeaponKeys.Num() - 1;
+	if (Index != LastIndex)
+	{
+		WeaponIndexByKey.Add(WeaponKeys[LastIndex], Index);
+	}
+
+	Weapons.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	WeaponKeys.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Entries.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+void UHaroWeaponSimSubsystem::Tick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_HaroWeaponSim_Tick);
+
+	Super::Tick(DeltaTime);
+
+	FHaroWeaponSimStats Stats;
+
+	// 뒤에서부터 돌아야 도중에 RemoveAtSwap 해도 안 건너뜀
+	for (int32 Index = Weapons.Num() - 1; Index >= 0; --Index)
+	{
+		UHaroRangedWeaponInstance* Weapon = Weapons[Index].Get();
+		const FWeaponSimEntry& Entry = Entries[Index];
+		APawn* Pawn = Entry.Pawn.Get();
+
+		// 해제되지 않고 사라진 무기/폰 정리
+		if (!Weapon || !Pawn)
+		{
+			RemoveWeaponAt(Index);
+			continue;
+		}
+
+		// 비활성 슬롯이거나 컨트롤러가 없는 쪽(시뮬레이티드 프록시)은 시뮬레이션 안 함
+		if ((Entry.bRequiresActiveSlot && !Weapon->bIsActive) || (Pawn->GetController() == nullptr))
+		{
+			continue;
+		}
+
+		Weapon->TickWeaponSim(DeltaTime, Entry.MovementComponent.Get(), Entry.CameraComponent.Get());
+
+		++Stats.NumSimulated;
+		Stats.NumHeatSettled += Weapon->IsHeatSettled() ? 1 : 0;
+	}
+
+	Stats.NumRegistered = Weapons.Num();
+	LastTickStats = Stats;
+
+	SET_DWORD_STAT(STAT_HaroWeaponSim_Registered, Stats.NumRegistered);
+	SET_DWORD_STAT(STAT_HaroWeaponSim_Simulated, Stats.NumSimulated);
+	SET_DWORD_STAT(STAT_HaroWeaponSim_HeatSettled, Stats.NumHeatSettled);
+}
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "HaroWeaponSimSubsystem.generated.h"
+
+class APawn;
+class UCharacterMovementComponent;
+class UHaroRangedWeaponInstance;
+class ULyraCameraComponent;
+
+/** 마지막 무기 시뮬레이션 패스 통계 (stat HaroWeaponSim에도 같은 값이 나옴) */
+struct FHaroWeaponSimStats
+{
+	int32 NumRegistered = 0;
+	int32 NumSimulated = 0;
+	int32 NumHeatSettled = 0;
+};
+
+/**
+ * 장착된 원거리 무기의 탄퍼짐/열/이동 배율을 한곳에서 갱신하는 월드 서브시스템
+ *
+ * 컨트롤러마다 UHaroWeaponStateComponent가 틱을 돌면서 장비 목록에서 무기를 찾아 Tick하던 것을 대체함.
+ *  - 무기는 OnEquipped/OnUnequipped에서 등록/해제되고 촘촘한 배열에 들어감 (제거는 RemoveAtSwap)
+ *  - 폰/이동/카메라 컴포넌트는 등록할 때 한 번만 찾아둠
+ *  - 열이 최소값까지 식은 무기는 다시 쏠 때까지 열/탄퍼짐 갱신을 건너뜀
+ * 예전처럼 컨트롤러가 있는 쪽(서버, 조종하는 클라이언트)에서만 시뮬레이션함.
+ */
+UCLASS()
+class LYRAGAME_API UHaroWeaponSimSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~USubsystem interface
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	//~FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	//~End of FTickableGameObject interface
+
+	/** 무기 등록 (이미 등록돼 있으면 캐시한 컴포넌트만 갱신) */
+	void RegisterWeapon(UHaroRangedWeaponInstance* Weapon);
+
+	/** 무기 제거 */
+	void UnregisterWeapon(UHaroRangedWeaponInstance* Weapon);
+
+	int32 GetNumWeapons() const { return Weapons.Num(); }
+
+	const FHaroWeaponSimStats& GetLastTickStats() const { return LastTickStats; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void RemoveWeaponAt(int32 Index);
+
+private:
+	/** 무기마다 틱에 필요한 것들 (등록할 때 한 번 찾아둠) */
+	struct FWeaponSimEntry
+	{
+		TWeakObjectPtr<APawn> Pawn;
+		TWeakObjectPtr<UCharacterMovementComponent> MovementComponent;
+		TWeakObjectPtr<ULyraCameraComponent> CameraComponent;
+
+		/** UHaroEquipmentManagerComponent가 관리하는 무기는 활성 슬롯일 때만 시뮬레이션 (라이라 장비 매니저는 bIsActive를 쓰지 않음) */
+		bool bRequiresActiveSlot = false;
+	};
+
+	// ========== 무기 (무기 -> 인덱스, 제거는 RemoveAtSwap) ==========
+	TArray<TWeakObjectPtr<UHaroRangedWeaponInstance>> Weapons;
+	TArray<TObjectKey<UHaroRangedWeaponInstance>> WeaponKeys;
+	TArray<FWeaponSimEntry> Entries;
+	TMap<TObjectKey<UHaroRangedWeaponInstance>, int32> WeaponIndexByKey;
+
+	FHaroWeaponSimStats LastTickStats;
+};
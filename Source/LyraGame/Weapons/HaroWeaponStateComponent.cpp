@@ -4,54 +4,67 @@
 #include "HaroWeaponStateComponent.h"
 
 #include "Abilities/GameplayAbilityTargetTypes.h"
-#include "Equipment/HaroEquipmentManagerComponent.h"
-#include "GameFramework/Pawn.h"
 #include "GameplayEffectTypes.h"
 #include "Kismet/GameplayStatics.h"
+#include "LyraLogChannels.h"
 #include "NativeGameplayTags.h"
 #include "Physics/PhysicalMaterialWithTags.h"
 #include "Teams/LyraTeamSubsystem.h"
-#include "Weapons/HaroRangedWeaponInstance.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HaroWeaponStateComponent)
 
 UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Gameplay_Zone, "Gameplay.Zone");
 
+namespace HaroHitMarkers
+{
+	// How many confirmed hits are kept for drawing (older ones are overwritten while firing continuously)
+	static constexpr int32 MaxConfirmedHitMarkers = 32;
+}
+
 UHaroWeaponStateComponent::UHaroWeaponStateComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
 	SetIsReplicatedByDefault(true);
 
-	PrimaryComponentTick.bStartWithTickEnabled = true;
-	PrimaryComponentTick.bCanEverTick = true;
+	// 무기 탄퍼짐/열 갱신은 UHaroWeaponSimSubsystem에서 모든 무기를 한 번에 처리함
+	PrimaryComponentTick.bCanEverTick = false;
 }
 
-void UHaroWeaponStateComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+FGameplayTag UHaroWeaponStateComponent::GetHitZone(const UPhysicalMaterial* PhysMaterial)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	if (PhysMaterial == nullptr)
+	{
+		return FGameplayTag();
+	}
+
+	if (const FGameplayTag* CachedHitZone = HitZoneCache.Find(PhysMaterial))
+	{
+		return *CachedHitZone;
+	}
 
-	if (APawn* Pawn = GetPawn<APawn>())
+	FGameplayTag& HitZone = HitZoneCache.Add(PhysMaterial);
+	if (const UPhysicalMaterialWithTags* PhysMatWithTags = Cast<const UPhysicalMaterialWithTags>(PhysMaterial))
 	{
-		if (UHaroEquipmentManagerComponent* EquipmentManager = Pawn->FindComponentByClass<UHaroEquipmentManagerComponent>())
+		for (const FGameplayTag MaterialTag : PhysMatWithTags->Tags)
 		{
-			// Haro!
-			if (UHaroRangedWeaponInstance* HaroWeapon = Cast<UHaroRangedWeaponInstance>(EquipmentManager->GetFirstActiveInstanceOfType(UHaroRangedWeaponInstance::StaticClass())))
+			if (MaterialTag.MatchesTag(TAG_Gameplay_Zone))
 			{
-				HaroWeapon->Tick(DeltaTime);
+				HitZone = MaterialTag;
+				break;
 			}
 		}
 	}
+
+	return HitZone;
 }
 
-bool UHaroWeaponStateComponent::ShouldShowHitAsSuccess(const FHitResult& Hit) const
+bool UHaroWeaponStateComponent::ShouldShowHitAsSuccess(const AActor* HitActor) const
 {
-	AActor* HitActor = Hit.GetActor();
-
 	//@TODO: Don't treat a hit that dealt no damage (due to invulnerability or similar) as a success
 	UWorld* World = GetWorld();
 	if (ULyraTeamSubsystem* TeamSubsystem = UWorld::GetSubsystem<ULyraTeamSubsystem>(GetWorld()))
 	{
-		return TeamSubsystem->CanCauseDamage(GetController<APlayerController>(), Hit.GetActor());
+		return TeamSubsystem->CanCauseDamage(GetController<APlayerController>(), HitActor);
 	}
 
 	return false;
@@ -67,70 +80,115 @@ bool UHaroWeaponStateComponent::ShouldUpdateDamageInstigatedTime(const FGameplay
 
 void UHaroWeaponStateComponent::ClientConfirmTargetData_Implementation(uint16 UniqueId, bool bSuccess, const TArray<uint8>& HitReplaces)
 {
-	for (int i = 0; i < UnconfirmedServerSideHitMarkers.Num(); i++)
+	FHaroServerSideHitMarkerBatch& Batch = UnconfirmedServerSideHitMarkers[UniqueId % MaxUnconfirmedServerSideHitMarkerBatches];
+	if (!Batch.bPending || (Batch.UniqueId != static_cast<uint8>(UniqueId)))
+	{
+		// Already confirmed, or dropped because too many batches were in flight
+		return;
+	}
+
+	Batch.bPending = false;
+	--NumUnconfirmedServerSideHitMarkers;
+
+	if (bSuccess && (HitReplaces.Num() != Batch.Markers.Num()))
 	{
-		FHaroServerSideHitMarkerBatch& Batch = UnconfirmedServerSideHitMarkers[i];
-		if (Batch.UniqueId == UniqueId)
+		// Hit indices are bytes, so 256 bits cover every possible replace
+		TBitArray<TInlineAllocator<8>> ReplacedHits(false, 256);
+		for (const uint8 HitIndex : HitReplaces)
+		{
+			ReplacedHits[HitIndex] = true;
+		}
+
+		bool bFoundShowAsSuccessHit = false;
+
+		for (int32 HitLocationIndex = 0; HitLocationIndex < Batch.Markers.Num(); ++HitLocationIndex)
 		{
-			if (bSuccess && (HitReplaces.Num() != Batch.Markers.Num()))
+			const FHaroUnconfirmedHitMarker& Marker = Batch.Markers[HitLocationIndex];
+			if (((HitLocationIndex < 256) && ReplacedHits[HitLocationIndex]) || !ShouldShowHitAsSuccess(Marker.HitActor.Get()))
 			{
-				UWorld* World = GetWorld();
-				bool bFoundShowAsSuccessHit = false;
-
-				int32 HitLocationIndex = 0;
-				for (const FHaroScreenSpaceHitLocation& Entry : Batch.Markers)
-				{
-					if (!HitReplaces.Contains(HitLocationIndex) && Entry.bShowAsSuccess)
-					{
-						// Only need to do this once
-						if (!bFoundShowAsSuccessHit)
-						{
-							ActuallyUpdateDamageInstigatedTime();
-						}
-
-						bFoundShowAsSuccessHit = true;
-
-						LastWeaponDamageScreenLocations.Add(Entry);
-					}
-					++HitLocationIndex;
-				}
+				continue;
 			}
 
-			UnconfirmedServerSideHitMarkers.RemoveAt(i);
-			break;
+			// Only need to do this once
+			if (!bFoundShowAsSuccessHit)
+			{
+				ActuallyUpdateDamageInstigatedTime();
+			}
+
+			bFoundShowAsSuccessHit = true;
+
+			FHaroScreenSpaceHitLocation Entry;
+			Entry.WorldLocation = Marker.WorldLocation;
+			Entry.HitZone = GetHitZone(Marker.PhysMaterial.Get());
+			Entry.bShowAsSuccess = true;
+
+			if (LastWeaponDamageScreenLocations.Num() < HaroHitMarkers::MaxConfirmedHitMarkers)
+			{
+				LastWeaponDamageScreenLocations.Add(Entry);
+			}
+			else
+			{
+				LastWeaponDamageScreenLocations[NextLastWeaponDamageIndex] = Entry;
+				NextLastWeaponDamageIndex = (NextLastWeaponDamageIndex + 1) % HaroHitMarkers::MaxConfirmedHitMarkers;
+			}
 		}
 	}
+
+	Batch.Markers.Reset();
 }
 
 void UHaroWeaponStateComponent::AddUnconfirmedServerSideHitMarkers(const FGameplayAbilityTargetDataHandle& InTargetData, const TArray<FHitResult>& FoundHits)
 {
-	FHaroServerSideHitMarkerBatch& NewUnconfirmedHitMarker = UnconfirmedServerSideHitMarkers.Emplace_GetRef(InTargetData.UniqueId);
+	FHaroServerSideHitMarkerBatch& NewUnconfirmedHitMarker = UnconfirmedServerSideHitMarkers[InTargetData.UniqueId % MaxUnconfirmedServerSideHitMarkerBatches];
+	if (NewUnconfirmedHitMarker.bPending)
+	{
+		UE_LOG(LogLyra, Verbose, TEXT("%s dropped unconfirmed hit markers %d (more than %d batches waiting for the server)"),
+			*GetNameSafe(this), NewUnconfirmedHitMarker.UniqueId, MaxUnconfirmedServerSideHitMarkerBatches);
+	}
+	else
+	{
+		++NumUnconfirmedServerSideHitMarkers;
+	}
+
+	NewUnconfirmedHitMarker.UniqueId = InTargetData.UniqueId;
+	NewUnconfirmedHitMarker.bPending = true;
+	NewUnconfirmedHitMarker.Markers.Reset();
 
-	if (APlayerController* OwnerPC = GetController<APlayerController>())
+	NextServerSideHitMarkerId = static_cast<uint8>(InTargetData.UniqueId + 1);
+
+	if (GetController<APlayerController>() != nullptr)
 	{
+		// Only keep what the confirmation needs; classifying and projecting the hits waits until the server answers
+		NewUnconfirmedHitMarker.Markers.Reserve(FoundHits.Num());
 		for (const FHitResult& Hit : FoundHits)
 		{
-			FVector2D HitScreenLocation;
-			if (UGameplayStatics::ProjectWorldToScreen(OwnerPC, Hit.Location, /*out*/ HitScreenLocation, /*bPlayerViewportRelative=*/ false))
-			{
-				FHaroScreenSpaceHitLocation& Entry = NewUnconfirmedHitMarker.Markers.AddDefaulted_GetRef();
-				Entry.Location = HitScreenLocation;
-				Entry.bShowAsSuccess = ShouldShowHitAsSuccess(Hit);
-
-				// Determine the hit zone
-				FGameplayTag HitZone;
-				if (const UPhysicalMaterialWithTags* PhysMatWithTags = Cast<const UPhysicalMaterialWithTags>(Hit.PhysMaterial.Get()))
-				{
-					for (const FGameplayTag MaterialTag : PhysMatWithTags->Tags)
-					{
-						if (MaterialTag.MatchesTag(TAG_Gameplay_Zone))
-						{
-							Entry.HitZone = MaterialTag;
-							break;
-						}
-					}
-				}
-			}
+			FHaroUnconfirmedHitMarker& Marker = NewUnconfirmedHitMarker.Markers.AddDefaulted_GetRef();
+			Marker.WorldLocation = Hit.Location;
+			Marker.HitActor = Hit.GetActor();
+			Marker.PhysMaterial = Hit.PhysMaterial.Get();
+		}
+	}
+}
+
+void UHaroWeaponStateComponent::GetLastWeaponDamageScreenLocations(TArray<FHaroScreenSpaceHitLocation>& WeaponDamageScreenLocations) const
+{
+	WeaponDamageScreenLocations.Reset();
+
+	APlayerController* OwnerPC = GetController<APlayerController>();
+	if ((OwnerPC == nullptr) || (LastWeaponDamageScreenLocations.Num() == 0))
+	{
+		return;
+	}
+
+	// Projected when the UI draws, with the current view
+	WeaponDamageScreenLocations.Reserve(LastWeaponDamageScreenLocations.Num());
+	for (const FHaroScreenSpaceHitLocation& Hit : LastWeaponDamageScreenLocations)
+	{
+		FVector2D HitScreenLocation;
+		if (UGameplayStatics::ProjectWorldToScreen(OwnerPC, Hit.WorldLocation, /*out*/ HitScreenLocation, /*bPlayerViewportRelative=*/ false))
+		{
+			FHaroScreenSpaceHitLocation& Entry = WeaponDamageScreenLocations.Add_GetRef(Hit);
+			Entry.Location = HitScreenLocation;
 		}
 	}
 }
@@ -150,6 +208,7 @@ void UHaroWeaponStateComponent::ActuallyUpdateDamageInstigatedTime()
 	if (World->GetTimeSeconds() - LastWeaponDamageInstigatedTime > 0.1)
 	{
 		LastWeaponDamageScreenLocations.Reset();
+		NextLastWeaponDamageIndex = 0;
 	}
 	LastWeaponDamageInstigatedTime = World->GetTimeSeconds();
 }
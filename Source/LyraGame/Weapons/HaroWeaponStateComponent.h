@@ -3,11 +3,14 @@
 #pragma once
 
 #include "Components/ControllerComponent.h"
+#include "Containers/StaticArray.h"
 #include "GameplayTagContainer.h"
+#include "UObject/ObjectKey.h"
 
 #include "HaroWeaponStateComponent.generated.h"
 
 class UObject;
+class UPhysicalMaterial;
 struct FFrame;
 struct FGameplayAbilityTargetDataHandle;
 struct FGameplayEffectContextHandle;
@@ -17,24 +20,33 @@ struct FHitResult;
 // A 'successful' hit marker is shown for impacts that damaged an enemy
 struct FHaroScreenSpaceHitLocation
 {
-	/** Hit location in viewport screenspace */
-	FVector2D Location;
+	/** Hit location in viewport screenspace (projected from WorldLocation when the markers are read for drawing) */
+	FVector2D Location = FVector2D::ZeroVector;
+
+	/** Hit location in world space */
+	FVector WorldLocation = FVector::ZeroVector;
+
 	FGameplayTag HitZone;
 	bool bShowAsSuccess = false;
 };
 
-struct FHaroServerSideHitMarkerBatch
+// What we keep about a hit until the server confirms it; classification and projection wait until then
+struct FHaroUnconfirmedHitMarker
 {
-	FHaroServerSideHitMarkerBatch() {}
-
-	FHaroServerSideHitMarkerBatch(uint8 InUniqueId) :
-		UniqueId(InUniqueId)
-	{
-	}
+	FVector WorldLocation = FVector::ZeroVector;
+	TWeakObjectPtr<AActor> HitActor;
+	TWeakObjectPtr<const UPhysicalMaterial> PhysMaterial;
+};
 
-	TArray<FHaroScreenSpaceHitLocation> Markers;
+struct FHaroServerSideHitMarkerBatch
+{
+	/** One entry per hit, in the order the hits were added to the target data (HitReplaces indexes into this) */
+	TArray<FHaroUnconfirmedHitMarker> Markers;
 
 	uint8 UniqueId = 0;
+
+	/** Still waiting for ClientConfirmTargetData (slots are reused, so this is what tells a live batch from a finished one) */
+	bool bPending = false;
 };
 
 
@@ -50,8 +62,6 @@ public:
 
 	UHaroWeaponStateComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
-	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-
 	UFUNCTION(Client, Reliable)
 	void ClientConfirmTargetData(uint16 UniqueId, bool bSuccess, const TArray<uint8>& HitReplaces);
 
@@ -60,38 +70,54 @@ public:
 	/** Updates this player's last damage instigated time */
 	void UpdateDamageInstigatedTime(const FGameplayEffectContextHandle& EffectContext);
 
-	/** Gets the array of most recent locations this player instigated damage, in screen-space */
-	void GetLastWeaponDamageScreenLocations(TArray<FHaroScreenSpaceHitLocation>& WeaponDamageScreenLocations)
-	{
-		WeaponDamageScreenLocations = LastWeaponDamageScreenLocations;
-	}
+	/** Gets the array of most recent locations this player instigated damage, projected to screen-space now (hits behind the camera are skipped) */
+	void GetLastWeaponDamageScreenLocations(TArray<FHaroScreenSpaceHitLocation>& WeaponDamageScreenLocations) const;
 
 	/** Returns the elapsed time since the last (outgoing) damage hit notification occurred */
 	double GetTimeSinceLastHitNotification() const;
 
 	int32 GetUnconfirmedServerSideHitMarkerCount() const
 	{
-		return UnconfirmedServerSideHitMarkers.Num();
+		return NumUnconfirmedServerSideHitMarkers;
+	}
+
+	/** UniqueId to give the next target data that will have hit markers added for it */
+	uint8 GetNextServerSideHitMarkerId() const
+	{
+		return NextServerSideHitMarkerId;
 	}
 
 protected:
 	// This is called to filter hit results to determine whether they should be considered as a successful hit or not
 	// The default behavior is to treat it as a success if being done to a team actor that belongs to a different team
 	// to the owning controller's pawn
-	virtual bool ShouldShowHitAsSuccess(const FHitResult& Hit) const;
+	virtual bool ShouldShowHitAsSuccess(const AActor* HitActor) const;
 
 	virtual bool ShouldUpdateDamageInstigatedTime(const FGameplayEffectContextHandle& EffectContext) const;
 
 	void ActuallyUpdateDamageInstigatedTime();
 
+	// Finds the Gameplay.Zone tag on a physical material, remembering the answer for this controller
+	FGameplayTag GetHitZone(const UPhysicalMaterial* PhysMaterial);
+
 private:
 	/** Last time this controller instigated weapon damage */
 	double LastWeaponDamageInstigatedTime = 0.0;
 
-	/** Screen-space locations of our most recently instigated weapon damage (the confirmed hits) */
+	/** Most recently instigated weapon damage (the confirmed hits); wraps around once full, NextLastWeaponDamageIndex is the oldest entry */
 	TArray<FHaroScreenSpaceHitLocation> LastWeaponDamageScreenLocations;
-
-	/** The unconfirmed hits */
-	TArray<FHaroServerSideHitMarkerBatch> UnconfirmedServerSideHitMarkers;
+	int32 NextLastWeaponDamageIndex = 0;
+
+	/** Physical material tags are authored data, so each material's hit zone only has to be looked up once */
+	TMap<FObjectKey, FGameplayTag> HitZoneCache;
+
+	/**
+	 * The unconfirmed hits, in a ring indexed by UniqueId (target data UniqueIds are 8 bits, so the ring size divides 256)
+	 * A batch still pending when its slot comes around again is dropped; the server never confirms that far behind.
+	 */
+	static constexpr int32 MaxUnconfirmedServerSideHitMarkerBatches = 64;
+	TStaticArray<FHaroServerSideHitMarkerBatch, MaxUnconfirmedServerSideHitMarkerBatches> UnconfirmedServerSideHitMarkers;
+	int32 NumUnconfirmedServerSideHitMarkers = 0;
+	uint8 NextServerSideHitMarkerId = 0;
 
 };
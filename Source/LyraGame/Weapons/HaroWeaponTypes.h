@@ -6,6 +6,8 @@
 #include "GameplayTagContainer.h"
 #include "HaroWeaponTypes.generated.h"
 
+class UNiagaraSystem;
+
 
 /** 무기 발사 타입 열거형 */
 UENUM(BlueprintType)
@@ -15,6 +17,14 @@ enum class EHaroWeaponFireType : uint8
     Projectile      // 투사체 (차징 기능 포함, MaxChargingTime=0이면 일반 투사체)
 };
 
+/** 투사체 구현 방식 */
+UENUM(BlueprintType)
+enum class EHaroProjectileBackend : uint8
+{
+    Actor,          // 투사체마다 복제되는 AHaroProjectileBase 액터
+    Simulated       // UHaroSimulatedProjectileSubsystem에서 배열로 일괄 시뮬레이션 (발사 이벤트만 복제)
+};
+
 /** 발사 입력 타입 열거형 */
 UENUM(BlueprintType)
 enum class EHaroFireInputType : uint8
@@ -88,6 +98,23 @@ struct FHaroProjectileFireConfig
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Charging|Fallback", meta = (ForceUnits = x))
     float SizeMultiplier = 1.0f;
 
+    // ========== 투사체 백엔드 ==========
+    /** 액터 투사체 / 시뮬레이션 투사체 선택 (빠르고 수명이 짧은 탄환은 Simulated 권장) */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Projectile Backend")
+    EHaroProjectileBackend Backend = EHaroProjectileBackend::Actor;
+
+    /** 시뮬레이션 투사체의 충돌 구체 반지름 (크기 배율이 곱해짐) */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Projectile Backend", meta = (EditCondition = "Backend == EHaroProjectileBackend::Simulated", EditConditionHides, ForceUnits = cm))
+    float SimulatedCollisionRadius = 5.0f;
+
+    /** 클라이언트에서 시뮬레이션 투사체를 따라가는 이펙트 */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Projectile Backend", meta = (EditCondition = "Backend == EHaroProjectileBackend::Simulated", EditConditionHides))
+    TObjectPtr<UNiagaraSystem> SimulatedTracerSystem;
+
+    /** 시뮬레이션 투사체가 맞았을 때 실행할 게임플레이 큐 */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Projectile Backend", meta = (EditCondition = "Backend == EHaroProjectileBackend::Simulated", EditConditionHides, Categories = "GameplayCue"))
+    FGameplayTag SimulatedHitGameplayCueTag;
+
     // ========== 투사체 설정 ==========
 
     // 단일 카트리지에서 발사할 투사체 수 (일반적으로 1개, 샷건의 경우 더 많을 수 있음)
@@ -117,3 +144,145 @@ struct FHaroProjectileFireConfig
     UPROPERTY(EditAnywhere, Category = "Projectile Config")
     TMap<FGameplayTag, float> MaterialDamageMultiplier;
 };
+
+
+/**
+ * 카운터 기반 탄퍼짐 난수 (Philox2x32-10)
+ *
+ * 내부 상태 없이 (시드, 카운터)만으로 값이 정해지므로
+ * 클라이언트와 서버가 같은 무기 시드 + 예측 키를 알면 카트리지의 펠릿 방향을 똑같이 다시 만들 수 있음.
+ */
+struct FHaroSpreadRandom
+{
+	/**
+	 * 무기 인스턴스 시드와 발사 어빌리티의 예측 키로 카트리지 시드 생성
+	 * 연사 모드는 활성화 하나에서 여러 발을 쏘므로 발 번호를 상위 16비트에 섞음 (0번은 단발 경로와 같은 값)
+	 */
+	static uint32 MakeCartridgeSeed(uint32 WeaponSeed, int16 PredictionKey, uint16 ShotIndex = 0)
+	{
+		uint32 Out0;
+		uint32 Out1;
+		Philox2x32((static_cast<uint32>(ShotIndex) << 16) | static_cast<uint16>(PredictionKey), 0x48415230u /*'HAR0'*/, WeaponSeed, Out0, Out1);
+		return Out0;
+	}
+
+	/** 펠릿 하나에 쓰는 [0, 1) 난수 두 개 (중심에서 벌어지는 정도, 원 둘레 방향) */
+	static void GetPelletFractions(uint32 CartridgeSeed, uint32 PelletIndex, float& OutFromCenter, float& OutAround)
+	{
+		uint32 Out0;
+		uint32 Out1;
+		Philox2x32(PelletIndex, 0x53505244u /*'SPRD'*/, CartridgeSeed, Out0, Out1);
+
+		// 상위 24비트만 사용 (float 가수부에 딱 맞음)
+		OutFromCenter = static_cast<float>(Out0 >> 8) * (1.0f / 16777216.0f);
+		OutAround = static_cast<float>(Out1 >> 8) * (1.0f / 16777216.0f);
+	}
+
+private:
+	static void Philox2x32(uint32 Counter0, uint32 Counter1, uint32 Key, uint32& Out0, uint32& Out1)
+	{
+		for (int32 Round = 0; Round < 10; ++Round)
+		{
+			const uint64 Product = static_cast<uint64>(0xD256D193u) * Counter0;
+			const uint32 Hi = static_cast<uint32>(Product >> 32);
+			const uint32 Lo = static_cast<uint32>(Product);
+
+			Counter0 = Hi ^ Key ^ Counter1;
+			Counter1 = Lo;
+			Key += 0x9E3779B9u;
+		}
+
+		Out0 = Counter0;
+		Out1 = Counter1;
+	}
+};
+
+/**
+ * 균일 샘플링으로 구워둔 커브 테이블
+ *
+ * FRichCurve::Eval은 호출할 때마다 키를 이진 탐색하고 보간 모드별로 분기함.
+ * 무기 커브는 장착 중에 바뀌지 않으므로 고정 크기 테이블로 구워두고 인덱스 계산 + 선형 보간만 함.
+ * 굽고 나서 키 시간/샘플 사이/범위 밖에서 원래 커브와 비교해 허용 오차를 넘으면 (계단 키, 비상수 외삽 등)
+ * 구운 테이블을 쓰지 않고 원래 커브를 그대로 평가함.
+ */
+struct FHaroBakedCurve
+{
+	static constexpr int32 NumSamples = 65;
+
+	/**
+	 * 커브를 테이블로 구움
+	 * @param Tolerance 값 범위(최소 1) 대비 허용 오차 비율
+	 * @return 허용 오차 안이면 true (false면 IsBaked()도 false)
+	 */
+	bool Bake(const FRichCurve& Curve, float Tolerance)
+	{
+		bBaked = false;
+		bHasData = Curve.HasAnyData();
+		Curve.GetTimeRange(/*out*/ MinTime, /*out*/ MaxTime);
+		Curve.GetValueRange(/*out*/ MinValue, /*out*/ MaxValue);
+
+		const float TimeSpan = MaxTime - MinTime;
+		InvStep = (TimeSpan > UE_KINDA_SMALL_NUMBER) ? (static_cast<float>(NumSamples - 1) / TimeSpan) : 0.0f;
+
+		const float Step = (InvStep > 0.0f) ? (1.0f / InvStep) : 0.0f;
+		for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+		{
+			Samples[SampleIndex] = Curve.Eval(MinTime + Step * SampleIndex);
+		}
+
+		// 키 시간, 샘플 사이 중간점, 범위 양쪽 바깥에서 비교
+		TArray<float, TInlineAllocator<NumSamples + 16>> TestTimes;
+		for (const FRichCurveKey& Key : Curve.GetConstRefOfKeys())
+		{
+			TestTimes.Add(Key.Time);
+		}
+		for (int32 SampleIndex = 0; SampleIndex < NumSamples - 1; ++SampleIndex)
+		{
+			TestTimes.Add(MinTime + Step * (SampleIndex + 0.5f));
+		}
+		const float OutsideMargin = FMath::Max(TimeSpan * 0.25f, 1.0f);
+		TestTimes.Add(MinTime - OutsideMargin);
+		TestTimes.Add(MaxTime + OutsideMargin);
+
+		MaxError = 0.0f;
+		for (const float TestTime : TestTimes)
+		{
+			MaxError = FMath::Max(MaxError, FMath::Abs(Eval(TestTime) - Curve.Eval(TestTime)));
+		}
+
+		bBaked = (MaxError <= Tolerance * FMath::Max(MaxValue - MinValue, 1.0f));
+		return bBaked;
+	}
+
+	void Reset()
+	{
+		bBaked = false;
+		bHasData = false;
+	}
+
+	/** 테이블 값 (범위 밖은 양 끝 값으로 고정) */
+	FORCEINLINE float Eval(float Time) const
+	{
+		const float Alpha = FMath::Clamp((Time - MinTime) * InvStep, 0.0f, static_cast<float>(NumSamples - 1));
+		const int32 Index = FMath::Min(static_cast<int32>(Alpha), NumSamples - 2);
+		return FMath::Lerp(Samples[Index], Samples[Index + 1], Alpha - static_cast<float>(Index));
+	}
+
+	bool IsBaked() const { return bBaked; }
+	bool HasAnyData() const { return bHasData; }
+	float GetMaxError() const { return MaxError; }
+
+	void GetTimeRange(float& OutMinTime, float& OutMaxTime) const { OutMinTime = MinTime; OutMaxTime = MaxTime; }
+	void GetValueRange(float& OutMinValue, float& OutMaxValue) const { OutMinValue = MinValue; OutMaxValue = MaxValue; }
+
+private:
+	float Samples[NumSamples] = {};
+	float MinTime = 0.0f;
+	float MaxTime = 0.0f;
+	float InvStep = 0.0f;
+	float MinValue = 0.0f;
+	float MaxValue = 0.0f;
+	float MaxError = 0.0f;
+	bool bBaked = false;
+	bool bHasData = false;
+};
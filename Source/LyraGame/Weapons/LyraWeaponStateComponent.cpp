@@ -11,7 +11,6 @@
 #include "Physics/PhysicalMaterialWithTags.h"
 #include "Teams/LyraTeamSubsystem.h"
 #include "Weapons/LyraRangedWeaponInstance.h"
-#include "Weapons/HaroRangedWeaponInstance.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraWeaponStateComponent)
 
@@ -40,10 +39,8 @@ void ULyraWeaponStateComponent::TickComponent(float DeltaTime, enum ELevelTick T
 			{
 				LyraWeapon->Tick(DeltaTime);
 			}
-			else if (UHaroRangedWeaponInstance* HaroWeapon = Cast<UHaroRangedWeaponInstance>(EquipmentManager->GetFirstInstanceOfType(UHaroRangedWeaponInstance::StaticClass())))
-			{
-				HaroWeapon->Tick(DeltaTime);
-			}
+
+			// UHaroRangedWeaponInstance는 UHaroWeaponSimSubsystem에서 틱함
 		}
 	}
 }